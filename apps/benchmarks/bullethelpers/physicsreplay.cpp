@@ -0,0 +1,273 @@
+#include <apps/openmw/mwphysics/collisiontype.hpp>
+#include <apps/openmw/mwphysics/movementsolver.hpp>
+#include <apps/openmw/mwphysics/physicssystem.hpp>
+
+#include <components/bullethelpers/physicsrecording.hpp>
+#include <components/misc/convert.hpp>
+#include <components/misc/parallelfor.hpp>
+
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcher.h>
+#include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
+#include <BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace BulletHelpers;
+    using namespace BulletHelpers::PhysicsRecording;
+
+    // Actor positions closer than this are considered the same
+    constexpr float maxDivergence = 0.01f;
+
+    struct Object
+    {
+        Shape mShape;
+        std::unique_ptr<btCollisionObject> mCollisionObject;
+        btTransform mTransform;
+    };
+
+    struct Step
+    {
+        float mDuration = 0;
+        std::uint32_t mThreads = 1;
+        double mSeconds = 0;
+        std::optional<WorldFrame> mWorld;
+        std::vector<ActorFrame> mActors;
+        std::map<std::uint32_t, ActorResult> mResults;
+    };
+
+    struct Statistics
+    {
+        std::vector<double> mStepTimes;
+        std::vector<double> mRecordedStepTimes;
+        std::size_t mActors = 0;
+        std::size_t mDivergentActors = 0;
+        std::size_t mGroundMismatches = 0;
+        float mMaxDivergence = 0;
+    };
+
+    double getPercentile(std::vector<double> values, double percentile)
+    {
+        if (values.empty())
+            return 0;
+        const std::size_t index = std::min(values.size() - 1, static_cast<std::size_t>(values.size() * percentile));
+        std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+        return values[index];
+    }
+
+    void printTimes(const std::string& name, const std::vector<double>& values)
+    {
+        if (values.empty())
+            return;
+        const double total = std::accumulate(values.begin(), values.end(), 0.0);
+        std::cout << name << ": mean " << total / values.size() * 1000 << " ms"
+                  << ", p95 " << getPercentile(values, 0.95) * 1000 << " ms"
+                  << ", max " << *std::max_element(values.begin(), values.end()) * 1000 << " ms"
+                  << ", total " << total << " s\n";
+    }
+
+    unsigned getSupportedThreads(unsigned wanted)
+    {
+        btDbvtBroadphase broadphase;
+        if (wanted > 1 && broadphase.m_rayTestStacks.size() <= 1)
+        {
+            std::cerr << "Bullet was not compiled with multithreading support, 1 thread will be used\n";
+            return 1;
+        }
+        return std::max(1u, wanted);
+    }
+
+    btCollisionObject* findObject(std::map<std::uint32_t, Object>& objects, std::uint32_t id)
+    {
+        const auto it = objects.find(id);
+        if (it == objects.end())
+            return nullptr;
+        return it->second.mCollisionObject.get();
+    }
+
+    Statistics replay(PhysicsRecordingReader& reader, std::optional<unsigned> threads)
+    {
+        btDefaultCollisionConfiguration configuration;
+        btCollisionDispatcher dispatcher(&configuration);
+        btDbvtBroadphase broadphase;
+        btCollisionWorld world(&dispatcher, &broadphase, &configuration);
+        world.setForceUpdateAllAabbs(false);
+        Misc::JobPool& pool = Misc::getSharedJobPool();
+        const unsigned maxThreads = getSupportedThreads(std::numeric_limits<unsigned>::max());
+
+        std::map<std::uint32_t, Object> objects;
+        Step step;
+        Statistics result;
+
+        const auto runStep = [&]
+        {
+            if (!step.mWorld.has_value())
+                return;
+            const MWPhysics::WorldFrameData worldData(*step.mWorld);
+            std::vector<MWPhysics::ActorFrameData> actors;
+            actors.reserve(step.mActors.size());
+            std::vector<std::uint32_t> ids;
+            ids.reserve(step.mActors.size());
+            for (const ActorFrame& frame : step.mActors)
+            {
+                btCollisionObject* const collisionObject = findObject(objects, frame.mObject);
+                if (collisionObject == nullptr || !collisionObject->getCollisionShape()->isConvex())
+                    continue;
+                const btCollisionObject* const standingOn = frame.mStandingOn.has_value()
+                    ? findObject(objects, *frame.mStandingOn) : nullptr;
+                actors.emplace_back(frame, collisionObject, standingOn);
+                ids.push_back(frame.mObject);
+            }
+
+            // Same as the scheduler: unstuck actors one by one, then move them in parallel
+            const unsigned stepThreads = std::min(maxThreads, threads.value_or(step.mThreads));
+            const auto start = std::chrono::steady_clock::now();
+            for (MWPhysics::ActorFrameData& actor : actors)
+                if (!actor.mSleeping)
+                    MWPhysics::MovementSolver::unstuck(actor, &world);
+            Misc::parallelFor(pool, actors.size(), stepThreads, [&] (std::size_t i)
+            {
+                if (!actors[i].mSleeping)
+                    MWPhysics::MovementSolver::move(actors[i], step.mDuration, &world, worldData);
+            });
+            result.mStepTimes.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            result.mRecordedStepTimes.push_back(step.mSeconds);
+
+            for (std::size_t i = 0; i < actors.size(); ++i)
+            {
+                // The moves change the actor objects, the recording has where the game put them after the step
+                Object& object = objects[ids[i]];
+                object.mCollisionObject->setWorldTransform(object.mTransform);
+                world.updateSingleAabb(object.mCollisionObject.get());
+
+                const auto recorded = step.mResults.find(ids[i]);
+                if (recorded == step.mResults.end())
+                    continue;
+                ++result.mActors;
+                const float divergence = static_cast<float>(
+                    (Misc::Convert::toBullet(actors[i].mPosition) - recorded->second.mPosition).length());
+                if (divergence > maxDivergence)
+                    ++result.mDivergentActors;
+                if (actors[i].mIsOnGround != recorded->second.mIsOnGround)
+                    ++result.mGroundMismatches;
+                result.mMaxDivergence = std::max(result.mMaxDivergence, divergence);
+            }
+        };
+
+        while (std::optional<Record> record = reader.next())
+        {
+            if (auto* v = std::get_if<BeginStep>(&*record))
+            {
+                step = Step {};
+                step.mDuration = v->mDuration;
+                step.mThreads = std::max<std::uint32_t>(1, v->mThreads);
+            }
+            else if (auto* v = std::get_if<AddObject>(&*record))
+            {
+                Object& object = objects[v->mId];
+                object.mShape = std::move(v->mShape);
+                object.mTransform = v->mTransform;
+                // Collision callbacks of actors take the user pointer of projectiles for the game object
+                if (object.mShape.mShape == nullptr || v->mGroup == MWPhysics::CollisionType_Projectile)
+                    continue;
+                object.mCollisionObject = std::make_unique<btCollisionObject>();
+                object.mCollisionObject->setCollisionShape(object.mShape.mShape.get());
+                object.mCollisionObject->setWorldTransform(v->mTransform);
+                world.addCollisionObject(object.mCollisionObject.get(), v->mGroup, v->mMask);
+            }
+            else if (auto* v = std::get_if<RemoveObject>(&*record))
+            {
+                const auto it = objects.find(v->mId);
+                if (it == objects.end())
+                    continue;
+                if (it->second.mCollisionObject != nullptr)
+                    world.removeCollisionObject(it->second.mCollisionObject.get());
+                objects.erase(it);
+            }
+            else if (auto* v = std::get_if<SetTransform>(&*record))
+            {
+                const auto it = objects.find(v->mId);
+                if (it == objects.end())
+                    continue;
+                it->second.mTransform = v->mTransform;
+                if (it->second.mCollisionObject == nullptr)
+                    continue;
+                it->second.mCollisionObject->setWorldTransform(v->mTransform);
+                world.updateSingleAabb(it->second.mCollisionObject.get());
+            }
+            else if (auto* v = std::get_if<WorldFrame>(&*record))
+                step.mWorld = *v;
+            else if (auto* v = std::get_if<ActorFrame>(&*record))
+                step.mActors.push_back(*v);
+            else if (auto* v = std::get_if<ActorResult>(&*record))
+                step.mResults.emplace(v->mObject, *v);
+            else if (auto* v = std::get_if<EndStep>(&*record))
+            {
+                step.mSeconds = v->mSeconds;
+                runStep();
+            }
+        }
+
+        for (auto& [id, object] : objects)
+            if (object.mCollisionObject != nullptr)
+                world.removeCollisionObject(object.mCollisionObject.get());
+
+        return result;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <recording> [threads]\n"
+                  << "Replays the actor movement of a physics simulation recorded with OPENMW_PHYSICS_RECORD=<recording>"
+                  << " using the recorded number of threads unless given\n";
+        return 1;
+    }
+
+    std::optional<unsigned> threads;
+    if (argc > 2)
+        threads = static_cast<unsigned>(std::max(1, std::atoi(argv[2])));
+
+    try
+    {
+        auto stream = std::make_unique<std::ifstream>(argv[1], std::ios::binary);
+        if (!stream->is_open())
+        {
+            std::cerr << "Failed to open " << argv[1] << '\n';
+            return 1;
+        }
+        PhysicsRecordingReader reader(std::move(stream));
+        const Statistics statistics = replay(reader, threads);
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << "Steps: " << statistics.mStepTimes.size() << ", moved actors: " << statistics.mActors << '\n';
+        printTimes("Replayed unstuck and move", statistics.mStepTimes);
+        printTimes("Recorded unstuck and move", statistics.mRecordedStepTimes);
+        std::cout << "Divergent actors: " << statistics.mDivergentActors
+                  << ", on ground mismatches: " << statistics.mGroundMismatches
+                  << ", max divergence: " << statistics.mMaxDivergence << '\n';
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,185 @@
+#ifndef OPENMW_BENCHMARKS_DETOURNAVIGATOR_GENERATE_H
+#define OPENMW_BENCHMARKS_DETOURNAVIGATOR_GENERATE_H
+
+#include <components/detournavigator/settings.hpp>
+#include <components/detournavigator/tilecachedrecastmeshmanager.hpp>
+#include <components/esm/loadland.hpp>
+#include <components/resource/bulletshape.hpp>
+
+#include <BulletCollision/CollisionShapes/btTriangleMesh.h>
+#include <LinearMath/btTransform.h>
+
+#include <osg/Math>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace DetourNavigator::Benchmarks
+{
+    /// Same values as the defaults of settings-default.cfg except the tile size and output options
+    inline Settings makeSettings(int tileSize = 64)
+    {
+        Settings settings;
+        settings.mEnableWriteRecastMeshToFile = false;
+        settings.mEnableWriteNavMeshToFile = false;
+        settings.mEnableRecastMeshFileNameRevision = false;
+        settings.mEnableNavMeshFileNameRevision = false;
+        settings.mBorderSize = 16;
+        settings.mCellHeight = 0.2f;
+        settings.mCellSize = 0.2f;
+        settings.mDetailSampleDist = 6;
+        settings.mDetailSampleMaxError = 1;
+        settings.mMaxClimb = 34;
+        settings.mMaxSimplificationError = 1.3f;
+        settings.mMaxSlope = 49;
+        settings.mRecastScaleFactor = 0.017647058823529415f;
+        settings.mSwimHeightScale = 0.89999997615814208984375f;
+        settings.mMaxEdgeLen = 12;
+        settings.mMaxNavMeshQueryNodes = 2048;
+        settings.mMaxVertsPerPoly = 6;
+        settings.mRegionMergeSize = 20;
+        settings.mRegionMinSize = 8;
+        settings.mTileSize = tileSize;
+        settings.mWaitUntilMinDistanceToPlayer = 0;
+        settings.mAsyncNavMeshUpdaterThreads = 1;
+        settings.mAsyncPathQueryThreads = 0;
+        settings.mMaxNavMeshTilesCacheSize = 256 * 1024 * 1024;
+        settings.mMaxPolygonPathSize = 1024;
+        settings.mMaxSmoothPathSize = 1024;
+        settings.mMaxPolys = 4096;
+        settings.mMaxTilesNumber = 512;
+        settings.mMinUpdateInterval = std::chrono::milliseconds(50);
+        return settings;
+    }
+
+    /// Exterior cell with terrain and scaled instances of a few static meshes
+    struct Scene
+    {
+        static constexpr int sCellSize = ESM::Land::REAL_SIZE;
+        static constexpr std::size_t sHeightfieldSize = ESM::Land::LAND_SIZE;
+
+        std::vector<float> mHeights;
+        float mMinHeight = 0;
+        float mMaxHeight = 0;
+        std::vector<osg::ref_ptr<const Resource::BulletShape>> mShapes;
+        std::vector<osg::ref_ptr<Resource::BulletShapeInstance>> mObjects;
+        std::vector<btTransform> mTransforms;
+
+        float getHeight(float x, float y) const
+        {
+            const float step = static_cast<float>(sCellSize) / (sHeightfieldSize - 1);
+            const auto index = [&] (float v)
+            {
+                const long result = std::lround((v + sCellSize / 2) / step);
+                return static_cast<std::size_t>(std::clamp<long>(result, 0, sHeightfieldSize - 1));
+            };
+            return mHeights[index(x) + index(y) * sHeightfieldSize];
+        }
+    };
+
+    template <class Random>
+    std::vector<float> generateHeights(std::size_t size, float amplitude, Random& random)
+    {
+        std::uniform_real_distribution<float> phase(0, 2 * osg::PIf);
+        std::uniform_real_distribution<float> frequency(1, 4);
+        std::uniform_real_distribution<float> noise(-amplitude / 16, amplitude / 16);
+        const float phaseX = phase(random);
+        const float phaseY = phase(random);
+        const float frequencyX = frequency(random) * 2 * osg::PIf / size;
+        const float frequencyY = frequency(random) * 2 * osg::PIf / size;
+        std::vector<float> result;
+        result.reserve(size * size);
+        for (std::size_t y = 0; y < size; ++y)
+            for (std::size_t x = 0; x < size; ++x)
+                result.push_back(amplitude * std::sin(x * frequencyX + phaseX) * std::cos(y * frequencyY + phaseY)
+                                 + noise(random));
+        return result;
+    }
+
+    /// Bumpy square grid of quadsPerSide^2 quads centered at the origin
+    template <class Random>
+    std::unique_ptr<btTriangleMesh> generateGridMesh(std::size_t quadsPerSide, float size, Random& random)
+    {
+        std::uniform_real_distribution<float> height(0, size / 4);
+        const float step = size / quadsPerSide;
+        const std::size_t verticesPerSide = quadsPerSide + 1;
+        std::vector<btVector3> vertices;
+        vertices.reserve(verticesPerSide * verticesPerSide);
+        for (std::size_t y = 0; y < verticesPerSide; ++y)
+            for (std::size_t x = 0; x < verticesPerSide; ++x)
+                vertices.emplace_back(x * step - size / 2, y * step - size / 2, height(random));
+        auto result = std::make_unique<btTriangleMesh>();
+        for (std::size_t y = 0; y < quadsPerSide; ++y)
+        {
+            for (std::size_t x = 0; x < quadsPerSide; ++x)
+            {
+                const std::size_t i = x + y * verticesPerSide;
+                result->addTriangle(vertices[i], vertices[i + 1], vertices[i + verticesPerSide]);
+                result->addTriangle(vertices[i + 1], vertices[i + verticesPerSide + 1], vertices[i + verticesPerSide]);
+            }
+        }
+        return result;
+    }
+
+    template <class Random>
+    Scene generateScene(std::size_t objects, std::size_t meshes, std::size_t quadsPerSide, Random& random)
+    {
+        Scene result;
+        result.mHeights = generateHeights(Scene::sHeightfieldSize, 1024, random);
+        const auto [minHeight, maxHeight] = std::minmax_element(result.mHeights.begin(), result.mHeights.end());
+        result.mMinHeight = *minHeight;
+        result.mMaxHeight = *maxHeight;
+
+        for (std::size_t i = 0; i < meshes; ++i)
+        {
+            osg::ref_ptr<Resource::BulletShape> shape(new Resource::BulletShape);
+            shape->mCollisionShape.reset(new Resource::TriangleMeshShape(
+                generateGridMesh(quadsPerSide, 256, random).release(), true));
+            result.mShapes.emplace_back(std::move(shape));
+        }
+
+        std::uniform_int_distribution<std::size_t> mesh(0, meshes - 1);
+        std::uniform_real_distribution<float> position(-Scene::sCellSize / 2.0f, Scene::sCellSize / 2.0f);
+        std::uniform_real_distribution<float> angle(0, 2 * osg::PIf);
+        std::uniform_real_distribution<float> scale(0.5f, 2);
+        for (std::size_t i = 0; i < objects; ++i)
+        {
+            const float objectScale = scale(random);
+            osg::ref_ptr<Resource::BulletShapeInstance> object = Resource::makeInstance(result.mShapes[mesh(random)]);
+            object->setLocalScaling(btVector3(objectScale, objectScale, objectScale));
+            result.mObjects.push_back(std::move(object));
+            const float x = position(random);
+            const float y = position(random);
+            result.mTransforms.emplace_back(btQuaternion(btVector3(0, 0, 1), angle(random)),
+                                            btVector3(x, y, result.getHeight(x, y)));
+        }
+
+        return result;
+    }
+
+    inline CollisionShape getCollisionShape(const Scene& scene, std::size_t object)
+    {
+        return CollisionShape(scene.mObjects[object], *scene.mObjects[object]->mCollisionShape);
+    }
+
+    inline ObjectId getObjectId(const Scene& scene, std::size_t object)
+    {
+        return ObjectId(scene.mObjects[object].get());
+    }
+
+    inline void addScene(const Scene& scene, TileCachedRecastMeshManager& manager)
+    {
+        manager.addHeightfield(osg::Vec2i(0, 0), Scene::sCellSize, osg::Vec3f(),
+            HeightfieldSurface {scene.mHeights.data(), Scene::sHeightfieldSize, scene.mMinHeight, scene.mMaxHeight});
+        for (std::size_t i = 0; i < scene.mObjects.size(); ++i)
+            manager.addObject(getObjectId(scene, i), getCollisionShape(scene, i), scene.mTransforms[i],
+                              AreaType_ground);
+    }
+}
+
+#endif
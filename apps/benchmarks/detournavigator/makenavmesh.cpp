@@ -0,0 +1,95 @@
+#include "generate.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <components/detournavigator/bounds.hpp>
+#include <components/detournavigator/makenavmesh.hpp>
+#include <components/detournavigator/navmeshdata.hpp>
+#include <components/detournavigator/preparednavmeshdata.hpp>
+#include <components/detournavigator/recastmesh.hpp>
+#include <components/detournavigator/settingsutils.hpp>
+#include <components/detournavigator/tilecachedrecastmeshmanager.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    using namespace DetourNavigator;
+    using namespace DetourNavigator::Benchmarks;
+
+    const osg::Vec3f agentHalfExtents(29.27999496459961, 28.479997634887695, 66.5);
+
+    struct Tile
+    {
+        TilePosition mPosition;
+        std::shared_ptr<RecastMesh> mRecastMesh;
+        Bounds mBounds;
+    };
+
+    std::vector<Tile> makeTiles(const Settings& settings)
+    {
+        std::minstd_rand random;
+        const Scene scene = generateScene(256, 16, 16, random);
+        TileCachedRecastMeshManager manager(settings);
+        addScene(scene, manager);
+        std::vector<TilePosition> positions;
+        manager.forEachTile([&] (const TilePosition& tilePosition, const auto&) { positions.push_back(tilePosition); });
+        std::vector<Tile> result;
+        for (const TilePosition& tilePosition : positions)
+        {
+            std::shared_ptr<RecastMesh> recastMesh = manager.getMesh(tilePosition);
+            if (recastMesh == nullptr)
+                continue;
+            Bounds bounds = recastMesh->getBounds();
+            bounds.mMin = toNavMeshCoordinates(settings, bounds.mMin);
+            bounds.mMax = toNavMeshCoordinates(settings, bounds.mMax);
+            if (isEmpty(bounds))
+                continue;
+            result.push_back(Tile {tilePosition, std::move(recastMesh), bounds});
+        }
+        return result;
+    }
+
+    void prepareNavMeshTiles(benchmark::State& state)
+    {
+        const Settings settings = makeSettings(static_cast<int>(state.range(0)));
+        const std::vector<Tile> tiles = makeTiles(settings);
+
+        for (auto _ : state)
+            for (const Tile& tile : tiles)
+                benchmark::DoNotOptimize(prepareNavMeshTileData(*tile.mRecastMesh, tile.mPosition, tile.mBounds,
+                                                                agentHalfExtents, settings));
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(tiles.size()));
+    }
+
+    void makeNavMeshTiles(benchmark::State& state)
+    {
+        const Settings settings = makeSettings(static_cast<int>(state.range(0)));
+        std::vector<std::unique_ptr<PreparedNavMeshData>> prepared;
+        std::vector<TilePosition> positions;
+        for (const Tile& tile : makeTiles(settings))
+        {
+            auto data = prepareNavMeshTileData(*tile.mRecastMesh, tile.mPosition, tile.mBounds, agentHalfExtents,
+                                               settings);
+            if (data == nullptr)
+                continue;
+            prepared.push_back(std::move(data));
+            positions.push_back(tile.mPosition);
+        }
+
+        for (auto _ : state)
+            for (std::size_t i = 0; i < prepared.size(); ++i)
+                benchmark::DoNotOptimize(makeNavMeshTileData(*prepared[i], {}, agentHalfExtents, positions[i],
+                                                             settings));
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(prepared.size()));
+    }
+}
+
+BENCHMARK(prepareNavMeshTiles)->Arg(32)->Arg(64)->Arg(128)->Unit(benchmark::kMillisecond);
+BENCHMARK(makeNavMeshTiles)->Arg(32)->Arg(64)->Arg(128);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,168 @@
+#include "generate.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <components/detournavigator/findsmoothpath.hpp>
+#include <components/detournavigator/navigatorimpl.hpp>
+#include <components/detournavigator/navigatorutils.hpp>
+#include <components/detournavigator/settingsutils.hpp>
+#include <components/loadinglistener/loadinglistener.hpp>
+
+#include <DetourNavMeshQuery.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using namespace DetourNavigator;
+    using namespace DetourNavigator::Benchmarks;
+
+    const osg::Vec3f agentHalfExtents(29.27999496459961, 28.479997634887695, 66.5);
+    constexpr float stepSize = 64;
+    constexpr Flags includeFlags = Flag_walk;
+
+    void addToNavigator(const Scene& scene, Navigator& navigator)
+    {
+        navigator.addAgent(agentHalfExtents);
+        navigator.addHeightfield(osg::Vec2i(0, 0), Scene::sCellSize, osg::Vec3f(),
+            HeightfieldSurface {scene.mHeights.data(), Scene::sHeightfieldSize, scene.mMinHeight, scene.mMaxHeight});
+        for (std::size_t i = 0; i < scene.mObjects.size(); ++i)
+            navigator.addObject(getObjectId(scene, i), ObjectShapes(scene.mObjects[i]), scene.mTransforms[i]);
+        navigator.update(osg::Vec3f());
+    }
+
+    struct Fixture
+    {
+        Scene mScene;
+        NavigatorImpl mNavigator;
+
+        Fixture()
+            : mScene([] { std::minstd_rand random; return generateScene(256, 16, 16, random); } ())
+            , mNavigator(makeSettings())
+        {
+            Loading::Listener listener;
+            addToNavigator(mScene, mNavigator);
+            mNavigator.wait(listener, WaitConditionType::allJobsDone);
+        }
+    };
+
+    const Fixture& getFixture()
+    {
+        static const Fixture fixture;
+        return fixture;
+    }
+
+    /// Points on the terrain of the scene cell not further than maxDistance from each other
+    std::vector<std::pair<osg::Vec3f, osg::Vec3f>> generateQueries(const Scene& scene, float maxDistance,
+        std::size_t count)
+    {
+        std::minstd_rand random;
+        const float halfCellSize = Scene::sCellSize / 2.0f;
+        std::uniform_real_distribution<float> position(-halfCellSize, halfCellSize);
+        std::uniform_real_distribution<float> offset(-maxDistance, maxDistance);
+        const auto onTerrain = [&] (float x, float y)
+        {
+            x = std::clamp(x, -halfCellSize, halfCellSize);
+            y = std::clamp(y, -halfCellSize, halfCellSize);
+            return osg::Vec3f(x, y, scene.getHeight(x, y));
+        };
+        std::vector<std::pair<osg::Vec3f, osg::Vec3f>> result;
+        result.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const osg::Vec3f start = onTerrain(position(random), position(random));
+            const osg::Vec3f end = onTerrain(start.x() + offset(random), start.y() + offset(random));
+            result.emplace_back(start, end);
+        }
+        return result;
+    }
+
+    template <class Query>
+    void runQueries(benchmark::State& state, Query&& query)
+    {
+        const Fixture& fixture = getFixture();
+        const auto queries = generateQueries(fixture.mScene, static_cast<float>(state.range(0)), 128);
+        std::size_t index = 0;
+
+        for (auto _ : state)
+        {
+            const auto& [start, end] = queries[index];
+            query(fixture.mNavigator, start, end);
+            index = (index + 1) % queries.size();
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void findPathWithNewQuery(benchmark::State& state)
+    {
+        std::vector<osg::Vec3f> path;
+        runQueries(state, [&] (const Navigator& navigator, const osg::Vec3f& start, const osg::Vec3f& end)
+        {
+            path.clear();
+            auto out = std::back_inserter(path);
+            benchmark::DoNotOptimize(findPath(navigator, agentHalfExtents, stepSize, start, end, includeFlags,
+                                              AreaCosts {}, 0, out));
+        });
+    }
+
+    void findPathWithReusedQuery(benchmark::State& state)
+    {
+        dtNavMeshQuery navMeshQuery;
+        std::vector<osg::Vec3f> path;
+        runQueries(state, [&] (const Navigator& navigator, const osg::Vec3f& start, const osg::Vec3f& end)
+        {
+            const Settings& settings = navigator.getSettings();
+            const auto navMesh = navigator.getNavMesh(agentHalfExtents);
+            path.clear();
+            auto out = std::back_inserter(path);
+            benchmark::DoNotOptimize(findSmoothPath(navMeshQuery, navMesh->lockConst()->getImpl(),
+                toNavMeshCoordinates(settings, agentHalfExtents), toNavMeshCoordinates(settings, stepSize),
+                toNavMeshCoordinates(settings, start), toNavMeshCoordinates(settings, end), includeFlags,
+                AreaCosts {}, settings, 0, out));
+        });
+    }
+
+    void findRaycast(benchmark::State& state)
+    {
+        runQueries(state, [&] (const Navigator& navigator, const osg::Vec3f& start, const osg::Vec3f& end)
+        {
+            benchmark::DoNotOptimize(raycast(navigator, agentHalfExtents, start, end, includeFlags));
+        });
+    }
+
+    void generateNavMesh(benchmark::State& state)
+    {
+        std::minstd_rand random;
+        const Scene scene = generateScene(256, 16, 16, random);
+        Settings settings = makeSettings(static_cast<int>(state.range(0)));
+        settings.mAsyncNavMeshUpdaterThreads = static_cast<std::size_t>(state.range(1));
+        Loading::Listener listener;
+
+        for (auto _ : state)
+        {
+            NavigatorImpl navigator(settings);
+            addToNavigator(scene, navigator);
+            navigator.wait(listener, WaitConditionType::allJobsDone);
+        }
+    }
+
+    void generateNavMeshArguments(benchmark::internal::Benchmark* benchmark)
+    {
+        for (const int tileSize : {32, 64, 128})
+            for (const int threads : {1, 2, 4})
+                benchmark->Args({tileSize, threads});
+    }
+}
+
+BENCHMARK(findPathWithNewQuery)->Arg(512)->Arg(2048)->Arg(8192);
+BENCHMARK(findPathWithReusedQuery)->Arg(512)->Arg(2048)->Arg(8192);
+BENCHMARK(findRaycast)->Arg(512)->Arg(2048)->Arg(8192);
+BENCHMARK(generateNavMesh)->Apply(generateNavMeshArguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
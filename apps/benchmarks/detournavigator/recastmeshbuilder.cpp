@@ -0,0 +1,219 @@
+#include "generate.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <components/bullethelpers/physicsrecording.hpp>
+#include <components/detournavigator/gettilespositions.hpp>
+#include <components/detournavigator/recastmeshbuilder.hpp>
+#include <components/detournavigator/settingsutils.hpp>
+#include <components/detournavigator/triangulatedshape.hpp>
+
+#include <BulletCollision/CollisionShapes/btCompoundShape.h>
+#include <BulletCollision/CollisionShapes/btConcaveShape.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace
+{
+    using namespace DetourNavigator;
+    using namespace DetourNavigator::Benchmarks;
+
+    // Groups of the objects used for navmesh generation, same as used by the game physics
+    constexpr int collisionTypeWorld = 1 << 0;
+    constexpr int collisionTypeDoor = 1 << 1;
+    constexpr int collisionTypeHeightMap = 1 << 3;
+
+    struct TileObjects
+    {
+        TileBounds mBounds;
+        std::vector<std::size_t> mObjects;
+    };
+
+    /// @param tiles may be already filled with tiles covered by a heightfield
+    template <class GetShape>
+    std::vector<TileObjects> groupByTiles(std::map<TilePosition, std::vector<std::size_t>> tiles,
+        const std::vector<btTransform>& transforms, const Settings& settings, GetShape&& getShape)
+    {
+        for (std::size_t i = 0; i < transforms.size(); ++i)
+            getTilesPositions(getShape(i), transforms[i], settings,
+                [&] (const TilePosition& tilePosition) { tiles[tilePosition].push_back(i); });
+        std::vector<TileObjects> result;
+        result.reserve(tiles.size());
+        for (auto& [tilePosition, objects] : tiles)
+            result.push_back(TileObjects {makeRealTileBoundsWithBorder(settings, tilePosition), std::move(objects)});
+        return result;
+    }
+
+    const Scene& getScene()
+    {
+        static const Scene scene = []
+        {
+            std::minstd_rand random;
+            return generateScene(256, 16, 16, random);
+        } ();
+        return scene;
+    }
+
+    template <class AddObject>
+    void buildRecastMeshes(benchmark::State& state, const Scene& scene, AddObject&& addObject)
+    {
+        const Settings settings = makeSettings(static_cast<int>(state.range(0)));
+        std::map<TilePosition, std::vector<std::size_t>> heightfieldTiles;
+        getTilesPositions(Scene::sCellSize, osg::Vec3f(), settings,
+            [&] (const TilePosition& tilePosition) { heightfieldTiles[tilePosition]; });
+        const std::vector<TileObjects> tiles = groupByTiles(std::move(heightfieldTiles), scene.mTransforms, settings,
+            [&] (std::size_t i) -> const btCollisionShape& { return *scene.mObjects[i]->mCollisionShape; });
+
+        for (auto _ : state)
+        {
+            for (const TileObjects& tile : tiles)
+            {
+                RecastMeshBuilder builder(tile.mBounds);
+                builder.addHeightfield(Scene::sCellSize, osg::Vec3f(), scene.mHeights.data(),
+                                       Scene::sHeightfieldSize, scene.mMinHeight, scene.mMaxHeight);
+                for (const std::size_t object : tile.mObjects)
+                    addObject(builder, object);
+                benchmark::DoNotOptimize(std::move(builder).create(0, 0));
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(tiles.size()));
+    }
+
+    void buildRecastMeshesFromShapes(benchmark::State& state)
+    {
+        const Scene& scene = getScene();
+        buildRecastMeshes(state, scene, [&] (RecastMeshBuilder& builder, std::size_t object)
+        {
+            builder.addObject(*scene.mObjects[object]->mCollisionShape, scene.mTransforms[object],
+                              AreaType_ground);
+        });
+    }
+
+    void buildRecastMeshesFromTriangulatedShapes(benchmark::State& state)
+    {
+        const Scene& scene = getScene();
+        std::vector<std::shared_ptr<const TriangulatedShape>> triangulated;
+        triangulated.reserve(scene.mObjects.size());
+        for (const auto& object : scene.mObjects)
+            triangulated.push_back(getTriangulatedShape(static_cast<const btConcaveShape&>(*object->mCollisionShape)));
+        buildRecastMeshes(state, scene, [&] (RecastMeshBuilder& builder, std::size_t object)
+        {
+            builder.addObject(*triangulated[object], scene.mTransforms[object], AreaType_ground);
+        });
+    }
+
+    bool isSupported(const btCollisionShape* shape)
+    {
+        if (shape == nullptr)
+            return false;
+        if (shape->isCompound())
+        {
+            const auto& compound = static_cast<const btCompoundShape&>(*shape);
+            for (int i = 0, n = compound.getNumChildShapes(); i < n; ++i)
+                if (!isSupported(compound.getChildShape(i)))
+                    return false;
+            return true;
+        }
+        return shape->isConcave() || shape->getShapeType() == BOX_SHAPE_PROXYTYPE;
+    }
+
+    struct RecordedScene
+    {
+        std::vector<BulletHelpers::PhysicsRecording::Shape> mShapes;
+        std::vector<btTransform> mTransforms;
+    };
+
+    /// Static objects left in the world at the end of the recording
+    RecordedScene readRecordedScene(const std::string& path)
+    {
+        using namespace BulletHelpers::PhysicsRecording;
+
+        BulletHelpers::PhysicsRecordingReader reader(std::make_unique<std::ifstream>(path, std::ios::binary));
+        std::map<std::uint32_t, AddObject> objects;
+        while (auto record = reader.next())
+        {
+            if (auto* add = std::get_if<AddObject>(&*record))
+            {
+                if ((add->mGroup & (collisionTypeWorld | collisionTypeDoor | collisionTypeHeightMap)) != 0
+                        && isSupported(add->mShape.mShape.get()))
+                    objects.insert_or_assign(add->mId, std::move(*add));
+            }
+            else if (const auto* remove = std::get_if<RemoveObject>(&*record))
+                objects.erase(remove->mId);
+            else if (const auto* set = std::get_if<SetTransform>(&*record))
+            {
+                const auto it = objects.find(set->mId);
+                if (it != objects.end())
+                    it->second.mTransform = set->mTransform;
+            }
+        }
+        RecordedScene result;
+        for (auto& [id, object] : objects)
+        {
+            result.mShapes.push_back(std::move(object.mShape));
+            result.mTransforms.push_back(object.mTransform);
+        }
+        return result;
+    }
+
+    void buildRecastMeshesFromRecording(benchmark::State& state, const RecordedScene& scene)
+    {
+        const Settings settings = makeSettings(static_cast<int>(state.range(0)));
+        const std::vector<TileObjects> tiles = groupByTiles({}, scene.mTransforms, settings,
+            [&] (std::size_t i) -> const btCollisionShape& { return *scene.mShapes[i].mShape; });
+
+        for (auto _ : state)
+        {
+            for (const TileObjects& tile : tiles)
+            {
+                RecastMeshBuilder builder(tile.mBounds);
+                for (const std::size_t object : tile.mObjects)
+                    builder.addObject(*scene.mShapes[object].mShape, scene.mTransforms[object], AreaType_ground);
+                benchmark::DoNotOptimize(std::move(builder).create(0, 0));
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(tiles.size()));
+    }
+}
+
+BENCHMARK(buildRecastMeshesFromShapes)->Arg(32)->Arg(64)->Arg(128);
+BENCHMARK(buildRecastMeshesFromTriangulatedShapes)->Arg(32)->Arg(64)->Arg(128);
+
+// Set OPENMW_PHYSICS_RECORDING to a file written by the physics recorder to build recast meshes from recorded
+// geometry in addition to the generated one.
+int main(int argc, char** argv)
+{
+    std::unique_ptr<RecordedScene> recorded;
+    if (const char* path = std::getenv("OPENMW_PHYSICS_RECORDING"))
+    {
+        try
+        {
+            recorded = std::make_unique<RecordedScene>(readRecordedScene(path));
+            benchmark::RegisterBenchmark("buildRecastMeshesFromRecording",
+                [scene = recorded.get()] (benchmark::State& state) { buildRecastMeshesFromRecording(state, *scene); })
+                ->Arg(32)->Arg(64)->Arg(128);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Failed to read physics recording " << path << ": " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "generate.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <components/detournavigator/tilecachedrecastmeshmanager.hpp>
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+namespace
+{
+    using namespace DetourNavigator;
+    using namespace DetourNavigator::Benchmarks;
+
+    const Scene& getScene()
+    {
+        static const Scene scene = []
+        {
+            std::minstd_rand random;
+            return generateScene(256, 16, 16, random);
+        } ();
+        return scene;
+    }
+
+    /// Same objects moved by a distance comparable to an object size, like doors or physics driven objects do
+    std::vector<btTransform> generateMovedTransforms(const Scene& scene)
+    {
+        std::minstd_rand random;
+        std::uniform_real_distribution<float> offset(-256, 256);
+        std::vector<btTransform> result = scene.mTransforms;
+        for (btTransform& transform : result)
+            transform.getOrigin() += btVector3(offset(random), offset(random), 0);
+        return result;
+    }
+
+    void addAndRemoveObjects(benchmark::State& state)
+    {
+        const Scene& scene = getScene();
+        const Settings settings = makeSettings(static_cast<int>(state.range(0)));
+        TileCachedRecastMeshManager manager(settings);
+
+        for (auto _ : state)
+        {
+            for (std::size_t i = 0; i < scene.mObjects.size(); ++i)
+                manager.addObject(getObjectId(scene, i), getCollisionShape(scene, i), scene.mTransforms[i],
+                                  AreaType_ground);
+            for (std::size_t i = 0; i < scene.mObjects.size(); ++i)
+                benchmark::DoNotOptimize(manager.removeObject(getObjectId(scene, i)));
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(scene.mObjects.size()));
+    }
+
+    void updateObjects(benchmark::State& state)
+    {
+        const Scene& scene = getScene();
+        const std::vector<btTransform> moved = generateMovedTransforms(scene);
+        const Settings settings = makeSettings(static_cast<int>(state.range(0)));
+        TileCachedRecastMeshManager manager(settings);
+        addScene(scene, manager);
+        std::size_t changedTiles = 0;
+        bool back = false;
+
+        for (auto _ : state)
+        {
+            const std::vector<btTransform>& transforms = back ? scene.mTransforms : moved;
+            for (std::size_t i = 0; i < scene.mObjects.size(); ++i)
+                manager.updateObject(getObjectId(scene, i), getCollisionShape(scene, i), transforms[i],
+                    AreaType_ground, [&] (const TilePosition&) { ++changedTiles; });
+            back = !back;
+        }
+
+        benchmark::DoNotOptimize(changedTiles);
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(scene.mObjects.size()));
+    }
+
+    void updateObjectsAndGetChangedMeshes(benchmark::State& state)
+    {
+        const Scene& scene = getScene();
+        const std::vector<btTransform> moved = generateMovedTransforms(scene);
+        const Settings settings = makeSettings(static_cast<int>(state.range(0)));
+        TileCachedRecastMeshManager manager(settings);
+        addScene(scene, manager);
+        std::set<TilePosition> changedTiles;
+        std::size_t object = 0;
+        bool back = false;
+
+        for (auto _ : state)
+        {
+            const btTransform& transform = back ? scene.mTransforms[object] : moved[object];
+            changedTiles.clear();
+            manager.updateObject(getObjectId(scene, object), getCollisionShape(scene, object), transform,
+                AreaType_ground, [&] (const TilePosition& tilePosition) { changedTiles.insert(tilePosition); });
+            for (const TilePosition& tilePosition : changedTiles)
+                benchmark::DoNotOptimize(manager.getMesh(tilePosition));
+            if (++object == scene.mObjects.size())
+            {
+                object = 0;
+                back = !back;
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+}
+
+BENCHMARK(addAndRemoveObjects)->Arg(32)->Arg(64)->Arg(128);
+BENCHMARK(updateObjects)->Arg(32)->Arg(64)->Arg(128);
+BENCHMARK(updateObjectsAndGetChangedMeshes)->Arg(32)->Arg(64)->Arg(128);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+
+#include <components/sceneutil/occlusionbuffer.hpp>
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    using namespace SceneUtil;
+
+    osg::Matrixf makeViewProjection()
+    {
+        return osg::Matrixf::lookAt(osg::Vec3f(0, 0, 0), osg::Vec3f(0, 1, 0), osg::Vec3f(0, 0, 1))
+            * osg::Matrixf::perspective(60, 16.0 / 9.0, 1, 10000);
+    }
+
+    template <typename Random>
+    std::vector<osg::Vec3f> generateWalls(std::size_t count, Random& random)
+    {
+        std::uniform_real_distribution<float> position(-2000, 2000);
+        std::uniform_real_distribution<float> distance(200, 4000);
+        std::uniform_real_distribution<float> size(100, 1000);
+        std::vector<osg::Vec3f> result;
+        result.reserve(count * 6);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const float x = position(random);
+            const float y = distance(random);
+            const float z = position(random) * 0.25f;
+            const float width = size(random);
+            const float height = size(random);
+            const osg::Vec3f a(x, y, z);
+            const osg::Vec3f b(x + width, y, z);
+            const osg::Vec3f c(x + width, y, z + height);
+            const osg::Vec3f d(x, y, z + height);
+            result.insert(result.end(), {a, b, c, a, c, d});
+        }
+        return result;
+    }
+
+    template <typename Random>
+    std::vector<osg::BoundingBox> generateBoxes(std::size_t count, Random& random)
+    {
+        std::uniform_real_distribution<float> position(-2000, 2000);
+        std::uniform_real_distribution<float> distance(200, 6000);
+        std::uniform_real_distribution<float> size(10, 200);
+        std::vector<osg::BoundingBox> result;
+        result.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const osg::Vec3f center(position(random), distance(random), position(random) * 0.25f);
+            const float half = size(random);
+            result.emplace_back(center - osg::Vec3f(half, half, half), center + osg::Vec3f(half, half, half));
+        }
+        return result;
+    }
+
+    template <int width, int height, std::size_t walls>
+    void drawWalls(benchmark::State& state)
+    {
+        std::minstd_rand random;
+        const std::vector<osg::Vec3f> vertices = generateWalls(walls, random);
+        const osg::Matrixf viewProjection = makeViewProjection();
+        OcclusionBuffer buffer(width, height);
+
+        while (state.KeepRunning())
+        {
+            buffer.clear(viewProjection);
+            buffer.drawTriangles(vertices.data(), vertices.size());
+            benchmark::DoNotOptimize(buffer.getNumDrawnTriangles());
+        }
+    }
+
+    constexpr auto drawWalls_256x128_100 = drawWalls<256, 128, 100>;
+    constexpr auto drawWalls_256x128_1000 = drawWalls<256, 128, 1000>;
+    constexpr auto drawWalls_512x256_1000 = drawWalls<512, 256, 1000>;
+
+    template <int width, int height, std::size_t walls>
+    void testBoxes(benchmark::State& state)
+    {
+        std::minstd_rand random;
+        const std::vector<osg::Vec3f> vertices = generateWalls(walls, random);
+        const std::vector<osg::BoundingBox> boxes = generateBoxes(1000, random);
+        const osg::Matrixf viewProjection = makeViewProjection();
+        OcclusionBuffer buffer(width, height);
+        buffer.clear(viewProjection);
+        buffer.drawTriangles(vertices.data(), vertices.size());
+        std::size_t n = 0;
+
+        while (state.KeepRunning())
+        {
+            const bool result = buffer.isOccluded(boxes[n++ % boxes.size()], viewProjection);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+
+    constexpr auto testBoxes_256x128_100 = testBoxes<256, 128, 100>;
+    constexpr auto testBoxes_256x128_1000 = testBoxes<256, 128, 1000>;
+    constexpr auto testBoxes_512x256_1000 = testBoxes<512, 256, 1000>;
+} // namespace
+
+BENCHMARK(drawWalls_256x128_100);
+BENCHMARK(drawWalls_256x128_1000);
+BENCHMARK(drawWalls_512x256_1000);
+BENCHMARK(testBoxes_256x128_100);
+BENCHMARK(testBoxes_256x128_1000);
+BENCHMARK(testBoxes_512x256_1000);
+
+BENCHMARK_MAIN();
@@ -7,6 +7,7 @@
 #include <map>
 #include <set>
 #include <deque>
+#include <optional>
 
 #include <components/esm/cellid.hpp>
 
@@ -57,6 +58,8 @@ namespace ESM
 namespace MWPhysics
 {
     class RayCastingInterface;
+    struct RayCastingResult;
+    struct RayQuery;
 }
 
 namespace MWRender
@@ -73,6 +76,7 @@ namespace MWMechanics
 namespace DetourNavigator
 {
     struct Navigator;
+    class PathQueryService;
 }
 
 namespace MWWorld
@@ -326,6 +330,14 @@ namespace MWBase
 
             virtual bool castRay(const osg::Vec3f& from, const osg::Vec3f& to, int mask, const MWWorld::ConstPtr& ignore) = 0;
 
+            virtual std::size_t queueRayQuery(const MWPhysics::RayQuery& query) = 0;
+            ///< Queue a ray cast run by the physics threads concurrently with the rest of the frame.
+            /// \return tag to take the result with takeRayQueryResult(), usually on the next frame
+
+            virtual std::optional<MWPhysics::RayCastingResult> takeRayQueryResult(std::size_t tag) = 0;
+            ///< \return nothing while the query is running, or when the result was already taken or
+            /// dropped after not being taken for a few frames
+
             virtual void setActorCollisionMode(const MWWorld::Ptr& ptr, bool internal, bool external) = 0;
             virtual bool isActorCollisionEnabled(const MWWorld::Ptr& ptr) = 0;
 
@@ -640,6 +652,9 @@ namespace MWBase
 
             virtual DetourNavigator::Navigator* getNavigator() const = 0;
 
+            /// @return nullptr when paths are not found asynchronously
+            virtual DetourNavigator::PathQueryService* getPathQueryService() const = 0;
+
             virtual void updateActorPath(const MWWorld::ConstPtr& actor, const std::deque<osg::Vec3f>& path,
                     const osg::Vec3f& halfExtents, const osg::Vec3f& start, const osg::Vec3f& end) const = 0;
 
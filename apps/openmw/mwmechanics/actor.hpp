@@ -5,8 +5,6 @@
 
 #include "../mwmechanics/actorutil.hpp"
 
-#include <components/misc/timer.hpp>
-
 namespace MWRender
 {
     class Animation;
@@ -43,11 +41,6 @@ namespace MWMechanics
         bool isTurningToPlayer() const;
         void setTurningToPlayer(bool turning);
 
-        Misc::TimerStatus updateEngageCombatTimer(float duration)
-        {
-            return mEngageCombat.update(duration);
-        }
-
         void setPositionAdjusted(bool adjusted);
         bool getPositionAdjusted() const;
 
@@ -57,7 +50,6 @@ namespace MWMechanics
         float mTargetAngleRadians{0.f};
         GreetingState mGreetingState{Greet_None};
         bool mIsTurningToPlayer{false};
-        Misc::DeviatingPeriodicTimer mEngageCombat{1.0f, 0.25f, Misc::Rng::deviate(0, 0.25f)};
         bool mPositionAdjusted;
     };
 
@@ -0,0 +1,201 @@
+#include "actorregistry.hpp"
+
+#include <cassert>
+
+#include "../mwworld/class.hpp"
+
+#include "actor.hpp"
+#include "creaturestats.hpp"
+
+namespace MWMechanics
+{
+    namespace
+    {
+        Misc::DeviatingPeriodicTimer makeEngageCombatTimer()
+        {
+            return Misc::DeviatingPeriodicTimer(1.0f, 0.25f, Misc::Rng::deviate(0, 0.25f));
+        }
+
+        template <class T>
+        void swapRemove(std::vector<T>& values, std::size_t index)
+        {
+            if (index + 1 != values.size())
+                values[index] = std::move(values.back());
+            values.pop_back();
+        }
+    }
+
+    ActorRegistry::ActorRegistry()
+        : mSlots([this] (std::size_t index) { erase(index); })
+    {
+    }
+
+    ActorRegistry::~ActorRegistry() = default;
+
+    std::size_t ActorRegistry::find(const MWWorld::ConstPtr& ptr) const
+    {
+        return mSlots.find(ptr.mRef);
+    }
+
+    Actor* ActorRegistry::findActor(const MWWorld::ConstPtr& ptr) const
+    {
+        const std::size_t index = find(ptr);
+        if (index == npos)
+            return nullptr;
+        return mActors[index].get();
+    }
+
+    ActorHandle ActorRegistry::add(const MWWorld::Ptr& ptr, std::unique_ptr<Actor> actor)
+    {
+        assert(actor != nullptr);
+
+        remove(ptr);
+
+        std::uint8_t flags = ActorFlag_None;
+        if (ptr.getClass().isNpc())
+            flags |= ActorFlag_Npc;
+
+        const ActorHandle handle = mSlots.add(ptr.mRef, ptr.getRefData().getPosition().asVec3());
+
+        mPtrs.push_back(ptr);
+        mActors.push_back(std::move(actor));
+        mStats.push_back(&ptr.getClass().getCreatureStats(ptr));
+        mDistancesSqr.push_back(0);
+        mFlags.push_back(flags);
+        mEngageCombatTimers.push_back(makeEngageCombatTimer());
+        mEngageCombatTimerStatuses.push_back(Misc::TimerStatus::Waiting);
+        mPendingUpdateDurations.push_back(0);
+        mSkippedUpdates.push_back(0);
+        mAiMovements.emplace_back();
+
+        return handle;
+    }
+
+    std::unique_ptr<Actor> ActorRegistry::remove(const MWWorld::ConstPtr& ptr)
+    {
+        const std::size_t index = find(ptr);
+        if (index == npos)
+            return nullptr;
+        return removeAt(index);
+    }
+
+    std::unique_ptr<Actor> ActorRegistry::removeAt(std::size_t index)
+    {
+        std::unique_ptr<Actor> result = std::move(mActors[index]);
+        if (result == nullptr)
+            return nullptr;
+
+        mPtrs[index] = MWWorld::Ptr();
+        mStats[index] = nullptr;
+        mFlags[index] = ActorFlag_None;
+        // Erases the data of the actor unless removal is deferred
+        mSlots.remove(index);
+
+        return result;
+    }
+
+    bool ActorRegistry::updatePtr(const MWWorld::ConstPtr& old, const MWWorld::Ptr& ptr)
+    {
+        if (find(old) == npos)
+            return false;
+
+        // Would be unreachable by its Ptr once the slot is taken
+        if (ptr.mRef != old.mRef)
+            remove(ptr);
+
+        mSlots.updateRef(old.mRef, ptr.mRef);
+
+        const std::size_t index = find(ptr);
+        mPtrs[index] = ptr;
+        mStats[index] = &ptr.getClass().getCreatureStats(ptr);
+        mSlots.setPosition(index, ptr.getRefData().getPosition().asVec3());
+        mActors[index]->updatePtr(ptr);
+
+        return true;
+    }
+
+    void ActorRegistry::clear()
+    {
+        mSlots.clear();
+        mPtrs.clear();
+        mActors.clear();
+        mStats.clear();
+        mDistancesSqr.clear();
+        mFlags.clear();
+        mEngageCombatTimers.clear();
+        mEngageCombatTimerStatuses.clear();
+        mPendingUpdateDurations.clear();
+        mSkippedUpdates.clear();
+        mAiMovements.clear();
+    }
+
+    void ActorRegistry::updatePosition(std::size_t index)
+    {
+        mSlots.setPosition(index, mPtrs[index].getRefData().getPosition().asVec3());
+    }
+
+    void ActorRegistry::refresh(const MWWorld::ConstPtr& player, float processingRange)
+    {
+        const osg::Vec3f playerPosition = player.getRefData().getPosition().asVec3();
+        const float processingRangeSqr = processingRange * processingRange;
+
+        for (std::size_t i = 0, n = mPtrs.size(); i < n; ++i)
+        {
+            if (mActors[i] == nullptr)
+                continue;
+
+            const MWWorld::Ptr& ptr = mPtrs[i];
+            const osg::Vec3f position = ptr.getRefData().getPosition().asVec3();
+            const float distanceSqr = (playerPosition - position).length2();
+            // Custom data holding the stats is recreated when the actor respawns
+            CreatureStats& stats = ptr.getClass().getCreatureStats(ptr);
+
+            std::uint8_t flags = mFlags[i] & ActorFlag_Npc;
+            if (ptr.mRef == player.mRef)
+                flags |= ActorFlag_Player;
+            if (stats.isDead())
+                flags |= ActorFlag_Dead;
+            if (stats.getAiSequence().isInCombat())
+                flags |= ActorFlag_InCombat;
+            if (distanceSqr <= processingRangeSqr)
+                flags |= ActorFlag_InProcessingRange;
+
+            mStats[i] = &stats;
+            mSlots.setPosition(i, position);
+            mDistancesSqr[i] = distanceSqr;
+            mFlags[i] = flags;
+        }
+    }
+
+    void ActorRegistry::updateEngageCombatTimers(float duration)
+    {
+        for (std::size_t i = 0, n = mEngageCombatTimers.size(); i < n; ++i)
+            mEngageCombatTimerStatuses[i] = mEngageCombatTimers[i].update(duration);
+    }
+
+    void ActorRegistry::addUpdateDuration(float duration)
+    {
+        for (float& pendingDuration : mPendingUpdateDurations)
+            pendingDuration += duration;
+    }
+
+    void ActorRegistry::finishUpdate(std::size_t index)
+    {
+        mPendingUpdateDurations[index] = 0;
+        mSkippedUpdates[index] = 0;
+    }
+
+    void ActorRegistry::erase(std::size_t index)
+    {
+        swapRemove(mPtrs, index);
+        swapRemove(mActors, index);
+        swapRemove(mStats, index);
+        swapRemove(mDistancesSqr, index);
+        swapRemove(mFlags, index);
+        swapRemove(mEngageCombatTimers, index);
+        swapRemove(mEngageCombatTimerStatuses, index);
+        swapRemove(mPendingUpdateDurations, index);
+        swapRemove(mSkippedUpdates, index);
+        swapRemove(mAiMovements, index);
+    }
+}
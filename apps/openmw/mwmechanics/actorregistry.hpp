@@ -0,0 +1,163 @@
+#ifndef OPENMW_MECHANICS_ACTORREGISTRY_H
+#define OPENMW_MECHANICS_ACTORREGISTRY_H
+
+#include "../mwworld/ptr.hpp"
+
+#include "actorslots.hpp"
+
+#include <components/misc/timer.hpp>
+
+#include <osg/Vec2f>
+#include <osg/Vec3f>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace MWMechanics
+{
+    class Actor;
+    class CreatureStats;
+
+    enum ActorFlags : std::uint8_t
+    {
+        ActorFlag_None = 0,
+        ActorFlag_Player = 1 << 0,
+        ActorFlag_Npc = 1 << 1,
+        ActorFlag_Dead = 1 << 2,
+        ActorFlag_InCombat = 1 << 3,
+        ActorFlag_InProcessingRange = 1 << 4,
+    };
+
+    /// @brief Dense storage of the actors in the scene.
+    /// @par Actors are addressed by index for iteration and by handle or Ptr otherwise. Data read by each actor update
+    /// phase is stored in separate arrays and is refreshed once per frame by refresh(), so phases do not have to
+    /// query the actor class for it again.
+    /// @par Actors are also bucketed by position into a uniform grid on the horizontal plane to answer proximity
+    /// queries without visiting every actor. The grid follows the stored positions, which are also updated whenever the
+    /// world moves an actor, teleports included. Indices, handles and the grid are kept by ActorSlots.
+    class ActorRegistry
+    {
+    public:
+        static constexpr std::size_t npos = ActorSlots::npos;
+
+        /// @brief Defers removal of actors while alive so indices stay valid during iteration.
+        /// @par Removed actors are destroyed immediately and their index is skipped by isRemoved(). Actors added
+        /// meanwhile are appended after the existing ones.
+        class IterationScope
+        {
+        public:
+            explicit IterationScope(ActorRegistry& registry) : mScope(registry.mSlots) {}
+
+        private:
+            ActorSlots::IterationScope mScope;
+        };
+
+        ActorRegistry();
+        ~ActorRegistry();
+
+        ActorRegistry(const ActorRegistry&) = delete;
+        ActorRegistry& operator=(const ActorRegistry&) = delete;
+
+        std::size_t size() const { return mSlots.size(); }
+
+        /// Number of actors not removed
+        std::size_t count() const { return mSlots.count(); }
+
+        bool isRemoved(std::size_t index) const { return mSlots.isRemoved(index); }
+
+        /// @return npos if the actor is not registered
+        std::size_t find(const MWWorld::ConstPtr& ptr) const;
+
+        /// @return nullptr if the actor is not registered
+        Actor* findActor(const MWWorld::ConstPtr& ptr) const;
+
+        ActorHandle getHandle(std::size_t index) const { return mSlots.getHandle(index); }
+
+        /// @return npos if the actor was removed
+        std::size_t getIndex(ActorHandle handle) const { return mSlots.getIndex(handle); }
+
+        /// Replaces the actor registered for the same Ptr
+        ActorHandle add(const MWWorld::Ptr& ptr, std::unique_ptr<Actor> actor);
+
+        /// @return removed actor, nullptr if it is not registered
+        std::unique_ptr<Actor> remove(const MWWorld::ConstPtr& ptr);
+
+        std::unique_ptr<Actor> removeAt(std::size_t index);
+
+        /// Keeps the index and the handle of the actor, an actor registered for the new Ptr is removed
+        bool updatePtr(const MWWorld::ConstPtr& old, const MWWorld::Ptr& ptr);
+
+        void clear();
+
+        const MWWorld::Ptr& getPtr(std::size_t index) const { return mPtrs[index]; }
+
+        Actor& getActor(std::size_t index) const { return *mActors[index]; }
+
+        CreatureStats& getStats(std::size_t index) const { return *mStats[index]; }
+
+        /// As of the last refresh() or updatePosition()
+        const osg::Vec3f& getPosition(std::size_t index) const { return mSlots.getPosition(index); }
+
+        /// To the player as of the last refresh()
+        float getDistanceSqr(std::size_t index) const { return mDistancesSqr[index]; }
+
+        /// As of the last refresh(), except for the player and npc flags that are always up to date
+        bool hasFlags(std::size_t index, std::uint8_t flags) const { return (mFlags[index] & flags) == flags; }
+
+        /// As of the last updateEngageCombatTimers()
+        Misc::TimerStatus getEngageCombatTimerStatus(std::size_t index) const { return mEngageCombatTimerStatuses[index]; }
+
+        /// Time passed since the last finishUpdate() of the actor
+        float getPendingUpdateDuration(std::size_t index) const { return mPendingUpdateDurations[index]; }
+
+        /// Frames passed since the last finishUpdate() of the actor, not counting the current one
+        std::uint32_t getSkippedUpdates(std::size_t index) const { return mSkippedUpdates[index]; }
+
+        /// Differs for actors added together
+        std::uint32_t getUpdatePhase(std::size_t index) const { return mSlots.getUpdatePhase(index); }
+
+        /// Sideways and forward movement requested by the last AI update of the actor
+        const osg::Vec2f& getAiMovement(std::size_t index) const { return mAiMovements[index]; }
+
+        void setAiMovement(std::size_t index, const osg::Vec2f& movement) { mAiMovements[index] = movement; }
+
+        void updatePosition(std::size_t index);
+
+        /// See ActorSlots::findNear()
+        void findNear(const osg::Vec3f& position, float radius, std::vector<std::size_t>& out) const
+        {
+            mSlots.findNear(position, radius, out);
+        }
+
+        void refresh(const MWWorld::ConstPtr& player, float processingRange);
+
+        void updateEngageCombatTimers(float duration);
+
+        /// Adds the frame duration to the pending update duration of every actor
+        void addUpdateDuration(float duration);
+
+        void skipUpdate(std::size_t index) { ++mSkippedUpdates[index]; }
+
+        void finishUpdate(std::size_t index);
+
+    private:
+        ActorSlots mSlots;
+
+        // Indexed by actor index
+        std::vector<MWWorld::Ptr> mPtrs;
+        std::vector<std::unique_ptr<Actor>> mActors;
+        std::vector<CreatureStats*> mStats;
+        std::vector<float> mDistancesSqr;
+        std::vector<std::uint8_t> mFlags;
+        std::vector<Misc::DeviatingPeriodicTimer> mEngageCombatTimers;
+        std::vector<Misc::TimerStatus> mEngageCombatTimerStatuses;
+        std::vector<float> mPendingUpdateDurations;
+        std::vector<std::uint32_t> mSkippedUpdates;
+        std::vector<osg::Vec2f> mAiMovements;
+
+        void erase(std::size_t index);
+    };
+}
+
+#endif
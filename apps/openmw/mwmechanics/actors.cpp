@@ -1,5 +1,6 @@
 #include "actors.hpp"
 
+#include <chrono>
 #include <optional>
 
 #include <components/esm/esmreader.hpp>
@@ -8,6 +9,7 @@
 #include <components/sceneutil/positionattitudetransform.hpp>
 #include <components/debug/debuglog.hpp>
 #include <components/misc/rng.hpp>
+#include <components/misc/jobpool.hpp>
 #include <components/misc/mathutil.hpp>
 #include <components/settings/settings.hpp>
 
@@ -44,6 +46,7 @@
 #include "actor.hpp"
 #include "summoning.hpp"
 #include "actorutil.hpp"
+#include "collisionprediction.hpp"
 
 namespace
 {
@@ -105,15 +108,18 @@ void getRestorationPerHourOfSleep (const MWWorld::Ptr& ptr, float& health, float
 }
 
 template<class T>
-void forEachFollowingPackage(MWMechanics::Actors::PtrActorMap& actors, const MWWorld::Ptr& actor, const MWWorld::Ptr& player, T&& func)
+void forEachFollowingPackage(const MWMechanics::ActorRegistry& actors, const MWWorld::Ptr& actor, const MWWorld::Ptr& player, T&& func)
 {
-    for(auto& iter : actors)
+    for (std::size_t i = 0; i < actors.size(); ++i)
     {
-        const MWWorld::Ptr &iteratedActor = iter.first;
+        if (actors.isRemoved(i))
+            continue;
+
+        const MWWorld::Ptr &iteratedActor = actors.getPtr(i);
         if (iteratedActor == player || iteratedActor == actor)
             continue;
 
-        const MWMechanics::CreatureStats &stats = iteratedActor.getClass().getCreatureStats(iteratedActor);
+        const MWMechanics::CreatureStats &stats = actors.getStats(i);
         if (stats.isDead())
             continue;
 
@@ -121,7 +127,7 @@ void forEachFollowingPackage(MWMechanics::Actors::PtrActorMap& actors, const MWW
         // or there are only Combat and Wander packages before the AiFollow package
         for (const auto& package : stats.getAiSequence())
         {
-            if(!func(iter, package))
+            if(!func(iteratedActor, package))
                 break;
         }
     }
@@ -763,30 +769,30 @@ namespace MWMechanics
 
     bool Actors::isAttackPreparing(const MWWorld::Ptr& ptr)
     {
-        PtrActorMap::iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        Actor* actor = mActors.findActor(ptr);
+        if (actor == nullptr)
             return false;
-        CharacterController* ctrl = it->second->getCharacterController();
+        CharacterController* ctrl = actor->getCharacterController();
 
         return ctrl->isAttackPreparing();
     }
 
     bool Actors::isRunning(const MWWorld::Ptr& ptr)
     {
-        PtrActorMap::iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        Actor* actor = mActors.findActor(ptr);
+        if (actor == nullptr)
             return false;
-        CharacterController* ctrl = it->second->getCharacterController();
+        CharacterController* ctrl = actor->getCharacterController();
 
         return ctrl->isRunning();
     }
 
     bool Actors::isSneaking(const MWWorld::Ptr& ptr)
     {
-        PtrActorMap::iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        Actor* actor = mActors.findActor(ptr);
+        if (actor == nullptr)
             return false;
-        CharacterController* ctrl = it->second->getCharacterController();
+        CharacterController* ctrl = actor->getCharacterController();
 
         return ctrl->isSneaking();
     }
@@ -1010,10 +1016,20 @@ namespace MWMechanics
     }
 
     Actors::Actors() : mSmoothMovement(Settings::Manager::getBool("smooth movement", "Game"))
+        , mAnimationLodDistance(Settings::Manager::getFloat("animation lod distance", "Game"))
+        , mAnimationLodMaxInterval(static_cast<unsigned int>(std::max(1, Settings::Manager::getInt("animation lod max interval", "Game"))))
+        , mAnimationLodMinPixelSize(Settings::Manager::getFloat("animation lod min pixel size", "Game"))
+        , mUpdateScheduler(Settings::Manager::getFloat("ai lod distance", "Game"),
+                           static_cast<unsigned int>(std::max(1, Settings::Manager::getInt("ai lod max interval", "Game"))),
+                           Settings::Manager::getFloat("ai update budget", "Game") / 1000.f)
     {
         mTimerDisposeSummonsCorpses = 0.2f; // We should add a delay between summoned creature death and its corpse despawning
 
         updateProcessingRange();
+
+        const int predictionThreads = Settings::Manager::getInt("collision prediction threads", "Game");
+        if (predictionThreads > 0)
+            mCollisionPredictionJobPool = std::make_unique<Misc::JobPool>(static_cast<std::size_t>(predictionThreads));
     }
 
     Actors::~Actors()
@@ -1042,9 +1058,9 @@ namespace MWMechanics
         MWRender::Animation *anim = MWBase::Environment::get().getWorld()->getAnimation(ptr);
         if (!anim)
             return;
-        mActors.emplace(ptr, new Actor(ptr, anim));
+        mActors.add(ptr, std::make_unique<Actor>(ptr, anim));
 
-        CharacterController* ctrl = mActors[ptr]->getCharacterController();
+        CharacterController* ctrl = mActors.findActor(ptr)->getCharacterController();
         if (updateImmediately)
             ctrl->update(0);
 
@@ -1087,21 +1103,17 @@ namespace MWMechanics
 
     void Actors::removeActor (const MWWorld::Ptr& ptr, bool keepActive)
     {
-        PtrActorMap::iterator iter = mActors.find(ptr);
-        if(iter != mActors.end())
-        {
-            if(!keepActive)
-                removeTemporaryEffects(iter->first);
-            delete iter->second;
-            mActors.erase(iter);
-        }
+        if (mActors.findActor(ptr) == nullptr)
+            return;
+        if (!keepActive)
+            removeTemporaryEffects(ptr);
+        mActors.remove(ptr);
     }
 
     void Actors::castSpell(const MWWorld::Ptr& ptr, const std::string& spellId, bool manualSpell)
     {
-        PtrActorMap::iterator iter = mActors.find(ptr);
-        if(iter != mActors.end())
-            iter->second->getCharacterController()->castSpell(spellId, manualSpell);
+        if (Actor* actor = mActors.findActor(ptr))
+            actor->getCharacterController()->castSpell(spellId, manualSpell);
     }
 
     bool Actors::isActorDetected(const MWWorld::Ptr& actor, const MWWorld::Ptr& observer)
@@ -1138,50 +1150,47 @@ namespace MWMechanics
 
     void Actors::updateActor(const MWWorld::Ptr &old, const MWWorld::Ptr &ptr)
     {
-        PtrActorMap::iterator iter = mActors.find(old);
-        if(iter != mActors.end())
-        {
-            Actor *actor = iter->second;
-            mActors.erase(iter);
+        mActors.updatePtr(old, ptr);
+    }
 
-            actor->updatePtr(ptr);
-            mActors.insert(std::make_pair(ptr, actor));
-        }
+    void Actors::updateActorPosition(const MWWorld::Ptr& ptr)
+    {
+        const std::size_t index = mActors.find(ptr);
+        if (index != ActorRegistry::npos)
+            mActors.updatePosition(index);
     }
 
     void Actors::dropActors (const MWWorld::CellStore *cellStore, const MWWorld::Ptr& ignore)
     {
-        PtrActorMap::iterator iter = mActors.begin();
-        while(iter != mActors.end())
+        ActorRegistry::IterationScope scope(mActors);
+        for (std::size_t i = 0; i < mActors.size(); ++i)
         {
-            if((iter->first.isInCell() && iter->first.getCell()==cellStore) && iter->first != ignore)
+            if (mActors.isRemoved(i))
+                continue;
+            const MWWorld::Ptr ptr = mActors.getPtr(i);
+            if ((ptr.isInCell() && ptr.getCell() == cellStore) && ptr != ignore)
             {
-                removeTemporaryEffects(iter->first);
-                delete iter->second;
-                mActors.erase(iter++);
+                removeTemporaryEffects(ptr);
+                mActors.removeAt(i);
             }
-            else
-                ++iter;
         }
     }
 
     void Actors::updateCombatMusic ()
     {
         MWWorld::Ptr player = getPlayer();
-        const osg::Vec3f playerPos = player.getRefData().getPosition().asVec3();
         bool hasHostiles = false; // need to know this to play Battle music
         bool aiActive = MWBase::Environment::get().getMechanicsManager()->isAIActive();
 
         if (aiActive)
         {
-            for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+            for (std::size_t i = 0; i < mActors.size(); ++i)
             {
-                if (iter->first == player) continue;
+                if (mActors.isRemoved(i) || mActors.hasFlags(i, ActorFlag_Player)) continue;
 
-                bool inProcessingRange = (playerPos - iter->first.getRefData().getPosition().asVec3()).length2() <= mActorsProcessingRange*mActorsProcessingRange;
-                if (inProcessingRange)
+                if (mActors.hasFlags(i, ActorFlag_InProcessingRange))
                 {
-                    MWMechanics::CreatureStats& stats = iter->first.getClass().getCreatureStats(iter->first);
+                    const MWMechanics::CreatureStats& stats = mActors.getStats(i);
                     if (!stats.isDead() && stats.getAiSequence().isInCombat())
                     {
                         hasHostiles = true;
@@ -1213,25 +1222,41 @@ namespace MWMechanics
         if (!MWBase::Environment::get().getMechanicsManager()->isAIActive())
             return;
 
-        const float minGap = 10.f;
-        const float maxDistForPartialAvoiding = 200.f;
-        const float maxDistForStrictAvoiding = 100.f;
         const float maxTimeToCheck = 2.0f;
         static const bool giveWayWhenIdle = Settings::Manager::getBool("NPCs give way", "Game");
 
-        MWWorld::Ptr player = getPlayer();
         MWBase::World* world = MWBase::Environment::get().getWorld();
-        for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+
+        // Snapshot of every actor taken before any movement is corrected. Actors have been moved by the AI since the
+        // last refresh.
+        mCollisionPredictionActors.resize(mActors.size());
+        mCollisionPredictionQueries.clear();
+        for (std::size_t i = 0; i < mActors.size(); ++i)
         {
-            const MWWorld::Ptr& ptr = iter->first;
-            if (ptr == player)
+            if (mActors.isRemoved(i))
+                continue;
+
+            mActors.updatePosition(i);
+
+            const MWWorld::Ptr ptr = mActors.getPtr(i);
+            const float maxSpeed = ptr.getClass().getMaxSpeed(ptr);
+            const Movement& movement = ptr.getClass().getMovementSettings(ptr);
+            const osg::Vec3f halfExtents = world->getHalfExtents(ptr);
+
+            CollisionPredictionActor& snapshot = mCollisionPredictionActors[i];
+            snapshot.mPosition = mActors.getPosition(i);
+            snapshot.mHalfExtents = halfExtents;
+            snapshot.mVelocity = movement.asVec3() * maxSpeed;
+            snapshot.mMaxSpeed = maxSpeed;
+            snapshot.mRotationZ = ptr.getRefData().getPosition().rot[2];
+            snapshot.mDead = mActors.getStats(i).isDead();
+
+            if (mActors.hasFlags(i, ActorFlag_Player))
                 continue; // Don't interfere with player controls.
 
-            float maxSpeed = ptr.getClass().getMaxSpeed(ptr);
             if (maxSpeed == 0.0)
                 continue; // Can't move, so there is no sense to predict collisions.
 
-            Movement& movement = ptr.getClass().getMovementSettings(ptr);
             osg::Vec2f origMovement(movement.mPosition[0], movement.mPosition[1]);
             bool isMoving = origMovement.length2() > 0.01;
             if (movement.mPosition[1] < 0)
@@ -1244,7 +1269,7 @@ namespace MWMechanics
             bool shouldGiveWay = false;
             bool shouldTurnToApproachingActor = !isMoving;
             MWWorld::Ptr currentTarget; // Combat or pursue target (NPCs should not avoid collision with their targets).
-            const auto& aiSequence = ptr.getClass().getCreatureStats(ptr).getAiSequence();
+            const auto& aiSequence = mActors.getStats(i).getAiSequence();
             for (const auto& package : aiSequence)
             {
                 if (package->getTypeId() == AiPackageTypeId::Follow)
@@ -1265,95 +1290,127 @@ namespace MWMechanics
             if (!shouldAvoidCollision && !shouldGiveWay)
                 continue;
 
-            osg::Vec2f baseSpeed = origMovement * maxSpeed;
-            osg::Vec3f basePos = ptr.getRefData().getPosition().asVec3();
-            float baseRotZ = ptr.getRefData().getPosition().rot[2];
-            const osg::Vec3f halfExtents = world->getHalfExtents(ptr);
-            float maxDistToCheck = isMoving ? maxDistForPartialAvoiding : maxDistForStrictAvoiding;
-
             float timeToCheck = maxTimeToCheck;
             if (!shouldGiveWay && !aiSequence.isEmpty())
-                timeToCheck = std::min(timeToCheck, getTimeToDestination(**aiSequence.begin(), basePos, maxSpeed, duration, halfExtents));
-
-            float timeToCollision = timeToCheck;
-            osg::Vec2f movementCorrection(0, 0);
-            float angleToApproachingActor = 0;
+                timeToCheck = std::min(timeToCheck, getTimeToDestination(**aiSequence.begin(), snapshot.mPosition, maxSpeed, duration, halfExtents));
+
+            CollisionPredictionQuery query;
+            query.mActor = i;
+            query.mIgnored = currentTarget.isEmpty() ? ActorRegistry::npos : mActors.find(currentTarget);
+            query.mIsMoving = isMoving;
+            query.mShouldTurnToApproachingActor = shouldTurnToApproachingActor;
+            query.mMaxTime = timeToCheck;
+            mCollisionPredictionQueries.push_back(query);
+        }
 
-            // Iterate through all other actors and predict collisions.
-            for(PtrActorMap::iterator otherIter(mActors.begin()); otherIter != mActors.end(); ++otherIter)
+        // Predict collisions of each actor, possibly on multiple threads. Only the snapshot and the registry positions
+        // are read meanwhile.
+        const std::size_t queriesCount = mCollisionPredictionQueries.size();
+        mPredictedCollisions.resize(std::max(mPredictedCollisions.size(), queriesCount));
+        const auto predict = [&] (std::size_t begin, std::size_t end)
+        {
+            std::vector<std::size_t> nearbyActors;
+            for (std::size_t i = begin; i < end; ++i)
             {
-                const MWWorld::Ptr& otherPtr = otherIter->first;
-                if (otherPtr == ptr || otherPtr == currentTarget)
-                    continue;
-
-                const osg::Vec3f otherHalfExtents = world->getHalfExtents(otherPtr);
-                osg::Vec3f deltaPos = otherPtr.getRefData().getPosition().asVec3() - basePos;
-                osg::Vec2f relPos = Misc::rotateVec2f(osg::Vec2f(deltaPos.x(), deltaPos.y()), baseRotZ);
-                float dist = deltaPos.length();
-
-                // Ignore actors which are not close enough or come from behind.
-                if (dist > maxDistToCheck || relPos.y() < 0)
-                    continue;
-
-                // Don't check for a collision if vertical distance is greater then the actor's height.
-                if (deltaPos.z() > halfExtents.z() * 2 || deltaPos.z() < -otherHalfExtents.z() * 2)
-                    continue;
-
-                osg::Vec3f speed = otherPtr.getClass().getMovementSettings(otherPtr).asVec3() *
-                                   otherPtr.getClass().getMaxSpeed(otherPtr);
-                float rotZ = otherPtr.getRefData().getPosition().rot[2];
-                osg::Vec2f relSpeed = Misc::rotateVec2f(osg::Vec2f(speed.x(), speed.y()), baseRotZ - rotZ) - baseSpeed;
+                const CollisionPredictionQuery& query = mCollisionPredictionQueries[i];
+                std::vector<PredictedCollision>& collisions = mPredictedCollisions[i];
+                collisions.clear();
+                nearbyActors.clear();
+                mActors.findNear(mCollisionPredictionActors[query.mActor].mPosition,
+                                 getCollisionCheckDistance(query.mIsMoving), nearbyActors);
+                predictCollisions(mCollisionPredictionActors, query, nearbyActors, collisions);
+            }
+        };
 
-                float collisionDist = minGap + halfExtents.x() + otherHalfExtents.x();
-                collisionDist = std::min(collisionDist, relPos.length());
+        constexpr std::size_t queriesPerJob = 16;
+        if (mCollisionPredictionJobPool == nullptr || queriesCount <= queriesPerJob)
+            predict(0, queriesCount);
+        else
+        {
+            Misc::JobGraph graph;
+            for (std::size_t begin = 0; begin < queriesCount; begin += queriesPerJob)
+            {
+                const std::size_t end = std::min(begin + queriesPerJob, queriesCount);
+                graph.add([&predict, begin, end] { predict(begin, end); });
+            }
+            graph.start(*mCollisionPredictionJobPool);
+            graph.wait();
+        }
 
-                // Find the earliest `t` when |relPos + relSpeed * t| == collisionDist.
-                float vr = relPos.x() * relSpeed.x() + relPos.y() * relSpeed.y();
-                float v2 = relSpeed.length2();
-                float Dh = vr * vr - v2 * (relPos.length2() - collisionDist * collisionDist);
-                if (Dh <= 0 || v2 == 0)
-                    continue; // No solution; distance is always >= collisionDist.
-                float t = (-vr - std::sqrt(Dh)) / v2;
+        // Evade the nearest collision with an actor that sees the approaching one. Applied in actor order so the result
+        // does not depend on the number of threads.
+        MWBase::MechanicsManager* mechanicsManager = MWBase::Environment::get().getMechanicsManager();
+        for (std::size_t i = 0; i < queriesCount; ++i)
+        {
+            const CollisionPredictionQuery& query = mCollisionPredictionQueries[i];
+            const MWWorld::Ptr ptr = mActors.getPtr(query.mActor);
 
-                if (t < 0 || t > timeToCollision)
-                    continue;
+            for (const PredictedCollision& collision : mPredictedCollisions[i])
+            {
+                const MWWorld::Ptr& otherPtr = mActors.getPtr(collision.mOther);
 
                 // Check visibility and awareness last as it's expensive.
-                if (!MWBase::Environment::get().getWorld()->getLOS(otherPtr, ptr))
+                if (!world->getLOS(otherPtr, ptr))
                     continue;
-                if (!MWBase::Environment::get().getMechanicsManager()->awarenessCheck(otherPtr, ptr))
+                if (!mechanicsManager->awarenessCheck(otherPtr, ptr))
                     continue;
 
-                timeToCollision = t;
-                angleToApproachingActor = std::atan2(deltaPos.x(), deltaPos.y());
-                osg::Vec2f posAtT = relPos + relSpeed * t;
-                float coef = (posAtT.x() * relSpeed.x() + posAtT.y() * relSpeed.y()) / (collisionDist * collisionDist * maxSpeed);
-                coef *= std::clamp((maxDistForPartialAvoiding - dist) / (maxDistForPartialAvoiding - maxDistForStrictAvoiding), 0.f, 1.f);
-                movementCorrection = posAtT * coef;
-                if (otherPtr.getClass().getCreatureStats(otherPtr).isDead())
-                    // In case of dead body still try to go around (it looks natural), but reduce the correction twice.
-                    movementCorrection.y() *= 0.5f;
-            }
-
-            if (timeToCollision < timeToCheck)
-            {
                 // Try to evade the nearest collision.
-                osg::Vec2f newMovement = origMovement + movementCorrection;
+                Movement& movement = ptr.getClass().getMovementSettings(ptr);
+                const osg::Vec2f origMovement(movement.mPosition[0], movement.mPosition[1]);
+                osg::Vec2f newMovement = origMovement + collision.mMovementCorrection;
                 // Step to the side rather than backward. Otherwise player will be able to push the NPC far away from it's original location.
                 newMovement.y() = std::max(newMovement.y(), 0.f);
                 newMovement.normalize();
-                if (isMoving)
+                if (query.mIsMoving)
                     newMovement *= origMovement.length(); // Keep the original speed.
                 movement.mPosition[0] = newMovement.x();
                 movement.mPosition[1] = newMovement.y();
-                if (shouldTurnToApproachingActor)
-                    zTurn(ptr, angleToApproachingActor);
+                if (query.mShouldTurnToApproachingActor)
+                    zTurn(ptr, collision.mAngle);
+                break;
             }
         }
     }
 
+    void Actors::scheduleActorUpdates(const MWWorld::ConstPtr& player)
+    {
+        const osg::Vec3f playerPosition = player.getRefData().getPosition().asVec3();
+        const float playerRotationZ = player.getRefData().getPosition().rot[2];
+
+        mUpdateScheduler.beginFrame();
+        mActorUpdates.assign(mActors.size(), ActorUpdate::Skip);
+
+        for (std::size_t i = 0; i < mActors.size(); ++i)
+        {
+            if (mActors.isRemoved(i))
+                continue;
+
+            unsigned int interval = 1;
+            if (!mActors.hasFlags(i, ActorFlag_Player) && !mActors.hasFlags(i, ActorFlag_Dead)
+                && !mActors.hasFlags(i, ActorFlag_InCombat))
+            {
+                // Actors behind the player are less likely to be seen
+                const osg::Vec3f delta = mActors.getPosition(i) - playerPosition;
+                const bool inView = Misc::rotateVec2f(osg::Vec2f(delta.x(), delta.y()), playerRotationZ).y() >= 0;
+                interval = mUpdateScheduler.getUpdateInterval(std::sqrt(mActors.getDistanceSqr(i)), inView);
+            }
+
+            if (interval <= 1)
+                mActorUpdates[i] = ActorUpdate::Now;
+            else if (mUpdateScheduler.isDue(mActors.getUpdatePhase(i), mActors.getSkippedUpdates(i), interval))
+                mUpdateScheduler.addDeferred(i, mActors.getSkippedUpdates(i), interval);
+        }
+
+        for (const std::size_t i : mUpdateScheduler.selectDeferred())
+            mActorUpdates[i] = ActorUpdate::Deferred;
+    }
+
     void Actors::update (float duration, bool paused)
     {
+        MWWorld::Ptr player = getPlayer();
+        mActors.refresh(player, mActorsProcessingRange);
+
         if(!paused)
         {
             static float timerUpdateHeadTrack = 0;
@@ -1368,66 +1425,88 @@ namespace MWMechanics
 
             // show torches only when there are darkness and no precipitations
             MWBase::World* world = MWBase::Environment::get().getWorld();
+            MWBase::LuaManager* luaManager = MWBase::Environment::get().getLuaManager();
             bool showTorches = world->useTorches();
 
-            MWWorld::Ptr player = getPlayer();
-            const osg::Vec3f playerPos = player.getRefData().getPosition().asVec3();
-
             /// \todo move update logic to Actor class where appropriate
 
             std::map<const MWWorld::Ptr, const std::set<MWWorld::Ptr> > cachedAllies; // will be filled as engageCombat iterates
+            std::vector<std::size_t> nearbyActors;
+
+            // Indices stay valid until the end of the update, actors removed meanwhile are skipped
+            ActorRegistry::IterationScope scope(mActors);
 
             bool aiActive = MWBase::Environment::get().getMechanicsManager()->isAIActive();
-            int attackedByPlayerId = player.getClass().getCreatureStats(player).getHitAttemptActorId();
+            CreatureStats& playerStats = player.getClass().getCreatureStats(player);
+            int attackedByPlayerId = playerStats.getHitAttemptActorId();
             if (attackedByPlayerId != -1)
             {
                 const MWWorld::Ptr playerHitAttemptActor = world->searchPtrViaActorId(attackedByPlayerId);
 
                 if (!playerHitAttemptActor.isInCell())
-                    player.getClass().getCreatureStats(player).setHitAttemptActorId(-1);
+                    playerStats.setHitAttemptActorId(-1);
             }
             bool godmode = MWBase::Environment::get().getWorld()->getGodModeState();
 
+            // If dead or no longer in combat, no longer store any actors who attempted to hit us. Also remove for the player.
+            for (std::size_t i = 0; i < mActors.size(); ++i)
+            {
+                if (mActors.isRemoved(i) || mActors.hasFlags(i, ActorFlag_Player))
+                    continue;
+
+                CreatureStats& stats = mActors.getStats(i);
+                if (stats.isDead() || !stats.getAiSequence().isInCombat()
+                    || !mActors.hasFlags(i, ActorFlag_InProcessingRange))
+                {
+                    stats.setHitAttemptActorId(-1);
+                    if (playerStats.getHitAttemptActorId() == stats.getActorId())
+                        playerStats.setHitAttemptActorId(-1);
+                }
+            }
+
+            mActors.updateEngageCombatTimers(duration);
+            mActors.addUpdateDuration(duration);
+            scheduleActorUpdates(player);
+
              // AI and magic effects update
-            for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+            for (std::size_t i = 0; i < mActors.size(); ++i)
             {
-                bool isPlayer = iter->first == player;
-                CharacterController* ctrl = iter->second->getCharacterController();
-                MWBase::LuaManager::ActorControls* luaControls =
-                    MWBase::Environment::get().getLuaManager()->getActorControls(iter->first);
+                if (mActors.isRemoved(i))
+                    continue;
 
-                float distSqr = (playerPos - iter->first.getRefData().getPosition().asVec3()).length2();
+                const auto updateStart = std::chrono::steady_clock::now();
+                const ActorUpdate update = i < mActorUpdates.size() ? mActorUpdates[i] : ActorUpdate::Now;
+                // Distant actors skipped in some frames get the time passed since their last update
+                const bool fullUpdate = update == ActorUpdate::Now
+                    || (update == ActorUpdate::Deferred && mUpdateScheduler.hasBudget());
+                const float updateDuration = mActors.getPendingUpdateDuration(i);
+
+                // make a copy of the Ptr to avoid it being invalidated when the player teleports
+                const MWWorld::Ptr ptr = mActors.getPtr(i);
+                const bool isPlayer = mActors.hasFlags(i, ActorFlag_Player);
                 // AI processing is only done within given distance to the player.
-                bool inProcessingRange = distSqr <= mActorsProcessingRange*mActorsProcessingRange;
+                const bool inProcessingRange = mActors.hasFlags(i, ActorFlag_InProcessingRange);
+                Actor& actor = mActors.getActor(i);
+                CharacterController* ctrl = actor.getCharacterController();
+                CreatureStats& stats = mActors.getStats(i);
+                MWBase::LuaManager::ActorControls* luaControls = luaManager->getActorControls(ptr);
 
                 if (isPlayer)
                     ctrl->setAttackingOrSpell(world->getPlayer().getAttackingOrSpell());
 
-                // If dead or no longer in combat, no longer store any actors who attempted to hit us. Also remove for the player.
-                if (iter->first != player && (iter->first.getClass().getCreatureStats(iter->first).isDead()
-                    || !iter->first.getClass().getCreatureStats(iter->first).getAiSequence().isInCombat()
-                    || !inProcessingRange))
-                {
-                    iter->first.getClass().getCreatureStats(iter->first).setHitAttemptActorId(-1);
-                    if (player.getClass().getCreatureStats(player).getHitAttemptActorId() == iter->first.getClass().getCreatureStats(iter->first).getActorId())
-                        player.getClass().getCreatureStats(player).setHitAttemptActorId(-1);
-                }
-
-                const Misc::TimerStatus engageCombatTimerStatus = iter->second->updateEngageCombatTimer(duration);
-
                 // For dead actors we need to update looping spell particles
-                if (iter->first.getClass().getCreatureStats(iter->first).isDead())
+                if (stats.isDead())
                 {
                     // They can be added during the death animation
-                    if (!iter->first.getClass().getCreatureStats(iter->first).isDeathAnimationFinished())
-                        adjustMagicEffects(iter->first, duration);
+                    if (!stats.isDeathAnimationFinished())
+                        adjustMagicEffects(ptr, updateDuration);
                     ctrl->updateContinuousVfx();
                 }
                 else
                 {
                     bool cellChanged = world->hasCellChanged();
-                    MWWorld::Ptr actor = iter->first; // make a copy of the map key to avoid it being invalidated when the player teleports
-                    updateActor(actor, duration);
+                    if (fullUpdate)
+                        updateActor(ptr, updateDuration);
 
                     // Looping magic VFX update
                     // Note: we need to do this before any of the animations are updated.
@@ -1443,24 +1522,29 @@ namespace MWMechanics
                     }
                     if (aiActive && inProcessingRange)
                     {
-                        if (engageCombatTimerStatus == Misc::TimerStatus::Elapsed)
+                        if (mActors.getEngageCombatTimerStatus(i) == Misc::TimerStatus::Elapsed)
                         {
+                            // player is not AI-controlled
                             if (!isPlayer)
-                                adjustCommandedActor(iter->first);
-
-                            for(PtrActorMap::iterator it(mActors.begin()); it != mActors.end(); ++it)
                             {
-                                if (it->first == iter->first || isPlayer) // player is not AI-controlled
-                                    continue;
-                                engageCombat(iter->first, it->first, cachedAllies, it->first == player);
+                                adjustCommandedActor(ptr);
+
+                                // engageCombat ignores actors outside of the processing range from each other
+                                nearbyActors.clear();
+                                mActors.findNear(ptr.getRefData().getPosition().asVec3(), mActorsProcessingRange, nearbyActors);
+                                for (const std::size_t j : nearbyActors)
+                                {
+                                    if (j == i || mActors.isRemoved(j))
+                                        continue;
+                                    engageCombat(ptr, mActors.getPtr(j), cachedAllies, mActors.hasFlags(j, ActorFlag_Player));
+                                }
                             }
                         }
-                        if (timerUpdateHeadTrack == 0)
+                        if (fullUpdate && timerUpdateHeadTrack == 0)
                         {
                             float sqrHeadTrackDistance = std::numeric_limits<float>::max();
                             MWWorld::Ptr headTrackTarget;
 
-                            MWMechanics::CreatureStats& stats = iter->first.getClass().getCreatureStats(iter->first);
                             bool firstPersonPlayer = isPlayer && world->isFirstPerson();
                             bool inCombatOrPursue = stats.getAiSequence().isInCombat() || stats.getAiSequence().hasPackage(AiPackageTypeId::Pursue);
                             MWWorld::Ptr activePackageTarget;
@@ -1473,54 +1557,68 @@ namespace MWMechanics
                                 if (inCombatOrPursue)
                                     activePackageTarget = stats.getAiSequence().getActivePackage().getTarget();
 
-                                for (PtrActorMap::iterator it(mActors.begin()); it != mActors.end(); ++it)
+                                for (std::size_t j = 0; j < mActors.size(); ++j)
                                 {
-                                    if (it->first == iter->first)
+                                    if (j == i || mActors.isRemoved(j))
                                         continue;
 
-                                    if (inCombatOrPursue && it->first != activePackageTarget)
+                                    const MWWorld::Ptr& target = mActors.getPtr(j);
+                                    if (inCombatOrPursue && target != activePackageTarget)
                                         continue;
 
-                                    updateHeadTracking(iter->first, it->first, headTrackTarget, sqrHeadTrackDistance, inCombatOrPursue);
+                                    updateHeadTracking(ptr, target, headTrackTarget, sqrHeadTrackDistance, inCombatOrPursue);
                                 }
                             }
 
                             ctrl->setHeadTrackTarget(headTrackTarget);
                         }
 
-                        if (iter->first.getClass().isNpc() && iter->first != player)
-                            updateCrimePursuit(iter->first, duration);
+                        if (fullUpdate && mActors.hasFlags(i, ActorFlag_Npc) && !isPlayer)
+                            updateCrimePursuit(ptr, updateDuration);
 
-                        if (iter->first != player)
+                        if (fullUpdate && !isPlayer)
                         {
-                            CreatureStats &stats = iter->first.getClass().getCreatureStats(iter->first);
-                            if (isConscious(iter->first) && !(luaControls && luaControls->mDisableAI))
+                            if (isConscious(ptr) && !(luaControls && luaControls->mDisableAI))
                             {
-                                stats.getAiSequence().execute(iter->first, *ctrl, duration);
-                                updateGreetingState(iter->first, *iter->second, timerUpdateHello > 0);
-                                playIdleDialogue(iter->first);
-                                updateMovementSpeed(iter->first);
+                                stats.getAiSequence().execute(ptr, *ctrl, updateDuration);
+                                updateGreetingState(ptr, actor, timerUpdateHello > 0);
+                                playIdleDialogue(ptr);
+                                updateMovementSpeed(ptr);
                             }
                         }
                     }
-                    else if (aiActive && iter->first != player && isConscious(iter->first) && !(luaControls && luaControls->mDisableAI))
+                    else if (fullUpdate && aiActive && !isPlayer && isConscious(ptr) && !(luaControls && luaControls->mDisableAI))
+                    {
+                        stats.getAiSequence().execute(ptr, *ctrl, updateDuration, /*outOfRange*/true);
+                    }
+
+                    if (aiActive && !isPlayer && isConscious(ptr) && !(luaControls && luaControls->mDisableAI))
                     {
-                        CreatureStats &stats = iter->first.getClass().getCreatureStats(iter->first);
-                        stats.getAiSequence().execute(iter->first, *ctrl, duration, /*outOfRange*/true);
+                        // The character update consumes the movement every frame, so skipped actors would stand still.
+                        // The rotation is not repeated: it is one frame long step towards a heading only the AI knows,
+                        // so repeating it would turn past that heading.
+                        Movement& movement = ptr.getClass().getMovementSettings(ptr);
+                        if (fullUpdate)
+                            mActors.setAiMovement(i, osg::Vec2f(movement.mPosition[0], movement.mPosition[1]));
+                        else
+                        {
+                            const osg::Vec2f& aiMovement = mActors.getAiMovement(i);
+                            movement.mPosition[0] = aiMovement.x();
+                            movement.mPosition[1] = aiMovement.y();
+                        }
                     }
 
-                    if(inProcessingRange && iter->first.getClass().isNpc())
+                    if(fullUpdate && inProcessingRange && mActors.hasFlags(i, ActorFlag_Npc))
                     {
                         // We can not update drowning state for actors outside of AI distance - they can not resurface to breathe
-                        updateDrowning(iter->first, duration, ctrl->isKnockedOut(), isPlayer);
+                        updateDrowning(ptr, updateDuration, ctrl->isKnockedOut(), isPlayer);
                     }
-                    if(timerUpdateEquippedLight == 0 && iter->first.getClass().hasInventoryStore(iter->first))
-                        updateEquippedLight(iter->first, updateEquippedLightInterval, showTorches);
+                    if(timerUpdateEquippedLight == 0 && ptr.getClass().hasInventoryStore(ptr))
+                        updateEquippedLight(ptr, updateEquippedLightInterval, showTorches);
 
-                    if (luaControls && isConscious(iter->first))
+                    if (luaControls && isConscious(ptr))
                     {
-                        Movement& mov = iter->first.getClass().getMovementSettings(iter->first);
-                        CreatureStats& stats = iter->first.getClass().getCreatureStats(iter->first);
+                        Movement& mov = ptr.getClass().getMovementSettings(ptr);
                         float speedFactor = isPlayer ? 1.f : mov.mSpeedFactor;
                         osg::Vec2f movement = osg::Vec2f(mov.mPosition[0], mov.mPosition[1]) * speedFactor;
                         float rotationZ = mov.mRotation[2];
@@ -1544,8 +1642,19 @@ namespace MWMechanics
                         luaControls->mRun = runFlag;
                     }
                 }
+
+                if (fullUpdate)
+                {
+                    mActors.finishUpdate(i);
+                    const std::chrono::duration<float> cost = std::chrono::steady_clock::now() - updateStart;
+                    mUpdateScheduler.reportUpdate(update == ActorUpdate::Deferred, cost.count());
+                }
+                else
+                    mActors.skipUpdate(i);
             }
 
+            mUpdateScheduler.endFrame();
+
             static const bool avoidCollisions = Settings::Manager::getBool("NPCs avoid collisions", "Game");
             if (avoidCollisions)
                 predictAndAvoidCollisions(duration);
@@ -1557,59 +1666,69 @@ namespace MWMechanics
 
             // Animation/movement update
             CharacterController* playerCharacter = nullptr;
-            for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+            for (std::size_t i = 0; i < mActors.size(); ++i)
             {
-                const float dist = (playerPos - iter->first.getRefData().getPosition().asVec3()).length();
-                bool isPlayer = iter->first == player;
-                CreatureStats &stats = iter->first.getClass().getCreatureStats(iter->first);
+                if (mActors.isRemoved(i))
+                    continue;
+
+                const MWWorld::Ptr ptr = mActors.getPtr(i);
+                const float dist = std::sqrt(mActors.getDistanceSqr(i));
+                const bool isPlayer = mActors.hasFlags(i, ActorFlag_Player);
+                Actor& actor = mActors.getActor(i);
+                CreatureStats &stats = mActors.getStats(i);
                 // Actors with active AI should be able to move.
                 bool alwaysActive = false;
-                if (!isPlayer && isConscious(iter->first) && !stats.isParalyzed())
+                if (!isPlayer && isConscious(ptr) && !stats.isParalyzed())
                 {
                     MWMechanics::AiSequence& seq = stats.getAiSequence();
                     alwaysActive = !seq.isEmpty() && seq.getActivePackage().alwaysActive();
                 }
-                bool inRange = isPlayer || dist <= mActorsProcessingRange || alwaysActive;
+                bool inRange = isPlayer || mActors.hasFlags(i, ActorFlag_InProcessingRange) || alwaysActive;
                 int activeFlag = 1; // Can be changed back to '2' to keep updating bounding boxes off screen (more accurate, but slower)
                 if (isPlayer)
                     activeFlag = 2;
                 int active = inRange ? activeFlag : 0;
 
-                CharacterController* ctrl = iter->second->getCharacterController();
+                CharacterController* ctrl = actor.getCharacterController();
                 ctrl->setActive(active);
+                if (isPlayer)
+                    ctrl->setAnimationLod(1, 0.f);
+                else
+                    ctrl->setAnimationLod(getLodUpdateInterval(dist, mAnimationLodDistance, mAnimationLodMaxInterval),
+                                          mAnimationLodMinPixelSize);
 
                 if (!inRange)
                 {
-                    iter->first.getRefData().getBaseNode()->setNodeMask(0);
-                    world->setActorCollisionMode(iter->first, false, false);
+                    ptr.getRefData().getBaseNode()->setNodeMask(0);
+                    world->setActorCollisionMode(ptr, false, false);
                     continue;
                 }
                 else if (!isPlayer)
                 {
-                    iter->first.getRefData().getBaseNode()->setNodeMask(MWRender::Mask_Actor);
-                    if (!iter->second->getPositionAdjusted())
+                    ptr.getRefData().getBaseNode()->setNodeMask(MWRender::Mask_Actor);
+                    if (!actor.getPositionAdjusted())
                     {
-                        iter->first.getClass().adjustPosition(iter->first, false);
-                        iter->second->setPositionAdjusted(true);
+                        ptr.getClass().adjustPosition(ptr, false);
+                        actor.setPositionAdjusted(true);
                     }
                 }
 
-                const bool isDead = iter->first.getClass().getCreatureStats(iter->first).isDead();
-                if (!isDead && (!godmode || !isPlayer) && iter->first.getClass().getCreatureStats(iter->first).isParalyzed())
+                const bool isDead = stats.isDead();
+                if (!isDead && (!godmode || !isPlayer) && stats.isParalyzed())
                     ctrl->skipAnim();
 
                 // Handle player last, in case a cell transition occurs by casting a teleportation spell
                 // (would invalidate the iterator)
-                if (iter->first == getPlayer())
+                if (isPlayer)
                 {
                     playerCharacter = ctrl;
                     continue;
                 }
 
-                world->setActorCollisionMode(iter->first, true, !iter->first.getClass().getCreatureStats(iter->first).isDeathAnimationFinished());
+                world->setActorCollisionMode(ptr, true, !stats.isDeathAnimationFinished());
                 ctrl->update(duration);
 
-                updateVisibility(iter->first, ctrl);
+                updateVisibility(ptr, ctrl);
             }
 
             if (playerCharacter)
@@ -1619,10 +1738,12 @@ namespace MWMechanics
                 playerCharacter->setVisibility(1.f);
             }
 
-            for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+            for (std::size_t i = 0; i < mActors.size(); ++i)
             {
-                const MWWorld::Class &cls = iter->first.getClass();
-                CreatureStats &stats = cls.getCreatureStats(iter->first);
+                if (mActors.isRemoved(i))
+                    continue;
+
+                CreatureStats &stats = mActors.getStats(i);
 
                 //KnockedOutOneFrameLogic
                 //Used for "OnKnockedOut" command
@@ -1654,53 +1775,58 @@ namespace MWMechanics
 
     void Actors::resurrect(const MWWorld::Ptr &ptr)
     {
-        PtrActorMap::iterator iter = mActors.find(ptr);
-        if(iter != mActors.end())
+        Actor* actor = mActors.findActor(ptr);
+        if (actor != nullptr)
         {
-            if(iter->second->getCharacterController()->isDead())
+            if(actor->getCharacterController()->isDead())
             {
                 // Actor has been resurrected. Notify the CharacterController and re-enable collision.
-                MWBase::Environment::get().getWorld()->enableActorCollision(iter->first, true);
-                iter->second->getCharacterController()->resurrect();
+                MWBase::Environment::get().getWorld()->enableActorCollision(ptr, true);
+                actor->getCharacterController()->resurrect();
             }
         }
     }
 
     void Actors::killDeadActors()
     {
-        for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+        ActorRegistry::IterationScope scope(mActors);
+        for (std::size_t i = 0; i < mActors.size(); ++i)
         {
-            const MWWorld::Class &cls = iter->first.getClass();
-            CreatureStats &stats = cls.getCreatureStats(iter->first);
+            if (mActors.isRemoved(i))
+                continue;
+
+            const MWWorld::Ptr ptr = mActors.getPtr(i);
+            const MWWorld::Class &cls = ptr.getClass();
+            CreatureStats &stats = mActors.getStats(i);
 
             if(!stats.isDead())
                 continue;
 
-            MWBase::Environment::get().getWorld()->removeActorPath(iter->first);
-            CharacterController::KillResult killResult = iter->second->getCharacterController()->kill();
+            MWBase::Environment::get().getWorld()->removeActorPath(ptr);
+            CharacterController::KillResult killResult = mActors.getActor(i).getCharacterController()->kill();
             if (killResult == CharacterController::Result_DeathAnimStarted)
             {
                 // Play dying words
                 // Note: It's not known whether the soundgen tags scream, roar, and moan are reliable
                 // for NPCs since some of the npc death animation files are missing them.
-                MWBase::Environment::get().getDialogueManager()->say(iter->first, "hit");
+                MWBase::Environment::get().getDialogueManager()->say(ptr, "hit");
 
                 // Apply soultrap
-                if (iter->first.getType() == ESM::Creature::sRecordId)
-                    soulTrap(iter->first);
+                if (ptr.getType() == ESM::Creature::sRecordId)
+                    soulTrap(ptr);
 
-                if (cls.isEssential(iter->first))
+                if (cls.isEssential(ptr))
                     MWBase::Environment::get().getWindowManager()->messageBox("#{sKilledEssential}");
             }
             else if (killResult == CharacterController::Result_DeathAnimJustFinished)
             {
-                bool isPlayer = iter->first == getPlayer();
-                notifyDied(iter->first);
+                bool isPlayer = mActors.hasFlags(i, ActorFlag_Player);
+                notifyDied(ptr);
 
                 // Reset magic effects and recalculate derived effects
                 // One case where we need this is to make sure bound items are removed upon death
                 float vampirism = stats.getMagicEffects().get(ESM::MagicEffect::Vampirism).getMagnitude();
-                stats.getActiveSpells().clear(iter->first);
+                stats.getActiveSpells().clear(ptr);
                 // Make sure spell effects are removed
                 purgeSpellEffects(stats.getActorId());
 
@@ -1716,7 +1842,7 @@ namespace MWMechanics
                 else
                 {
                     // NPC death animation is over, disable actor collision
-                    MWBase::Environment::get().getWorld()->enableActorCollision(iter->first, false);
+                    MWBase::Environment::get().getWorld()->enableActorCollision(ptr, false);
                 }
             }
         }
@@ -1755,10 +1881,12 @@ namespace MWMechanics
 
     void Actors::purgeSpellEffects(int casterActorId)
     {
-        for (PtrActorMap::iterator iter(mActors.begin());iter != mActors.end();++iter)
+        for (std::size_t i = 0; i < mActors.size(); ++i)
         {
-            MWMechanics::ActiveSpells& spells = iter->first.getClass().getCreatureStats(iter->first).getActiveSpells();
-            spells.purge(iter->first, casterActorId);
+            if (mActors.isRemoved(i))
+                continue;
+            MWMechanics::ActiveSpells& spells = mActors.getStats(i).getActiveSpells();
+            spells.purge(mActors.getPtr(i), casterActorId);
         }
     }
 
@@ -1772,28 +1900,33 @@ namespace MWMechanics
         const MWWorld::Ptr player = MWBase::Environment::get().getWorld()->getPlayerPtr();
         const osg::Vec3f playerPos = player.getRefData().getPosition().asVec3();
 
-        for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+        ActorRegistry::IterationScope scope(mActors);
+        for (std::size_t i = 0; i < mActors.size(); ++i)
         {
-            if (iter->first.getClass().getCreatureStats(iter->first).isDead())
+            if (mActors.isRemoved(i))
+                continue;
+
+            const MWWorld::Ptr ptr = mActors.getPtr(i);
+            if (mActors.getStats(i).isDead())
             {
-                adjustMagicEffects (iter->first, duration);
+                adjustMagicEffects (ptr, duration);
                 continue;
             }
 
-            if (!sleep || iter->first == player)
-                restoreDynamicStats(iter->first, hours, sleep);
+            if (!sleep || ptr == player)
+                restoreDynamicStats(ptr, hours, sleep);
 
-            if ((!iter->first.getRefData().getBaseNode()) ||
-                    (playerPos - iter->first.getRefData().getPosition().asVec3()).length2() > mActorsProcessingRange*mActorsProcessingRange)
+            if ((!ptr.getRefData().getBaseNode()) ||
+                    (playerPos - ptr.getRefData().getPosition().asVec3()).length2() > mActorsProcessingRange*mActorsProcessingRange)
                 continue;
 
-            adjustMagicEffects (iter->first, duration);
+            adjustMagicEffects (ptr, duration);
 
-            MWRender::Animation* animation = MWBase::Environment::get().getWorld()->getAnimation(iter->first);
+            MWRender::Animation* animation = MWBase::Environment::get().getWorld()->getAnimation(ptr);
             if (animation)
             {
                 animation->removeEffects();
-                MWBase::Environment::get().getWorld()->applyLoopingParticles(iter->first);
+                MWBase::Environment::get().getWorld()->applyLoopingParticles(ptr);
             }
         }
 
@@ -1909,17 +2042,15 @@ namespace MWMechanics
 
     void Actors::forceStateUpdate(const MWWorld::Ptr & ptr)
     {
-        PtrActorMap::iterator iter = mActors.find(ptr);
-        if(iter != mActors.end())
-            iter->second->getCharacterController()->forceStateUpdate();
+        if (Actor* actor = mActors.findActor(ptr))
+            actor->getCharacterController()->forceStateUpdate();
     }
 
     bool Actors::playAnimationGroup(const MWWorld::Ptr& ptr, const std::string& groupName, int mode, int number, bool persist)
     {
-        PtrActorMap::iterator iter = mActors.find(ptr);
-        if(iter != mActors.end())
+        if (Actor* actor = mActors.findActor(ptr))
         {
-            return iter->second->getCharacterController()->playGroup(groupName, mode, number, persist);
+            return actor->getCharacterController()->playGroup(groupName, mode, number, persist);
         }
         else
         {
@@ -1929,39 +2060,43 @@ namespace MWMechanics
     }
     void Actors::skipAnimation(const MWWorld::Ptr& ptr)
     {
-        PtrActorMap::iterator iter = mActors.find(ptr);
-        if(iter != mActors.end())
-            iter->second->getCharacterController()->skipAnim();
+        if (Actor* actor = mActors.findActor(ptr))
+            actor->getCharacterController()->skipAnim();
     }
 
     bool Actors::checkAnimationPlaying(const MWWorld::Ptr& ptr, const std::string& groupName)
     {
-        PtrActorMap::iterator iter = mActors.find(ptr);
-        if(iter != mActors.end())
-            return iter->second->getCharacterController()->isAnimPlaying(groupName);
+        if (Actor* actor = mActors.findActor(ptr))
+            return actor->getCharacterController()->isAnimPlaying(groupName);
         return false;
     }
 
     void Actors::persistAnimationStates()
     {
-        for (PtrActorMap::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
-            iter->second->getCharacterController()->persistAnimationState();
+        for (std::size_t i = 0; i < mActors.size(); ++i)
+            if (!mActors.isRemoved(i))
+                mActors.getActor(i).getCharacterController()->persistAnimationState();
     }
 
     void Actors::getObjectsInRange(const osg::Vec3f& position, float radius, std::vector<MWWorld::Ptr>& out)
     {
-        for (PtrActorMap::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
+        std::vector<std::size_t> nearbyActors;
+        mActors.findNear(position, radius, nearbyActors);
+        for (const std::size_t i : nearbyActors)
         {
-            if ((iter->first.getRefData().getPosition().asVec3() - position).length2() <= radius*radius)
-                out.push_back(iter->first);
+            const MWWorld::Ptr& ptr = mActors.getPtr(i);
+            if ((ptr.getRefData().getPosition().asVec3() - position).length2() <= radius*radius)
+                out.push_back(ptr);
         }
     }
 
     bool Actors::isAnyObjectInRange(const osg::Vec3f& position, float radius)
     {
-        for (PtrActorMap::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
+        std::vector<std::size_t> nearbyActors;
+        mActors.findNear(position, radius, nearbyActors);
+        for (const std::size_t i : nearbyActors)
         {
-            if ((iter->first.getRefData().getPosition().asVec3() - position).length2() <= radius*radius)
+            if ((mActors.getPtr(i).getRefData().getPosition().asVec3() - position).length2() <= radius*radius)
                 return true;
         }
 
@@ -1971,15 +2106,18 @@ namespace MWMechanics
     std::list<MWWorld::Ptr> Actors::getActorsSidingWith(const MWWorld::Ptr& actor)
     {
         std::list<MWWorld::Ptr> list;
-        for(PtrActorMap::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
+        for (std::size_t i = 0; i < mActors.size(); ++i)
         {
-            const MWWorld::Ptr &iteratedActor = iter->first;
+            if (mActors.isRemoved(i))
+                continue;
+
+            const MWWorld::Ptr &iteratedActor = mActors.getPtr(i);
             if (iteratedActor == getPlayer())
                 continue;
 
             const bool sameActor = (iteratedActor == actor);
 
-            const CreatureStats &stats = iteratedActor.getClass().getCreatureStats(iteratedActor);
+            const CreatureStats &stats = mActors.getStats(i);
             if (stats.isDead())
                 continue;
 
@@ -2009,10 +2147,10 @@ namespace MWMechanics
     std::list<MWWorld::Ptr> Actors::getActorsFollowing(const MWWorld::Ptr& actor)
     {
         std::list<MWWorld::Ptr> list;
-        forEachFollowingPackage(mActors, actor, getPlayer(), [&] (auto& iter, const std::unique_ptr<AiPackage>& package)
+        forEachFollowingPackage(mActors, actor, getPlayer(), [&] (const MWWorld::Ptr& follower, const std::unique_ptr<AiPackage>& package)
         {
             if (package->followTargetThroughDoors() && package->getTarget() == actor)
-                list.push_back(iter.first);
+                list.push_back(follower);
             else if (package->getTypeId() != AiPackageTypeId::Combat && package->getTypeId() != AiPackageTypeId::Wander)
                 return false;
             return true;
@@ -2060,7 +2198,7 @@ namespace MWMechanics
     std::list<int> Actors::getActorsFollowingIndices(const MWWorld::Ptr &actor)
     {
         std::list<int> list;
-        forEachFollowingPackage(mActors, actor, getPlayer(), [&] (auto& iter, const std::unique_ptr<AiPackage>& package)
+        forEachFollowingPackage(mActors, actor, getPlayer(), [&] (const MWWorld::Ptr& follower, const std::unique_ptr<AiPackage>& package)
         {
             if (package->followTargetThroughDoors() && package->getTarget() == actor)
             {
@@ -2077,12 +2215,12 @@ namespace MWMechanics
     std::map<int, MWWorld::Ptr> Actors::getActorsFollowingByIndex(const MWWorld::Ptr &actor)
     {
         std::map<int, MWWorld::Ptr> map;
-        forEachFollowingPackage(mActors, actor, getPlayer(), [&] (auto& iter, const std::unique_ptr<AiPackage>& package)
+        forEachFollowingPackage(mActors, actor, getPlayer(), [&] (const MWWorld::Ptr& follower, const std::unique_ptr<AiPackage>& package)
         {
             if (package->followTargetThroughDoors() && package->getTarget() == actor)
             {
                 int index = static_cast<const AiFollow*>(package.get())->getFollowIndex();
-                map[index] = iter.first;
+                map[index] = follower;
                 return false;
             }
             else if (package->getTypeId() != AiPackageTypeId::Combat && package->getTypeId() != AiPackageTypeId::Wander)
@@ -2164,12 +2302,6 @@ namespace MWMechanics
 
     void Actors::clear()
     {
-        PtrActorMap::iterator it(mActors.begin());
-        for (; it != mActors.end(); ++it)
-        {
-            delete it->second;
-            it->second = nullptr;
-        }
         mActors.clear();
         mDeathCount.clear();
     }
@@ -2181,66 +2313,66 @@ namespace MWMechanics
 
     bool Actors::isReadyToBlock(const MWWorld::Ptr &ptr) const
     {
-        PtrActorMap::const_iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        Actor* actor = mActors.findActor(ptr);
+        if (actor == nullptr)
             return false;
 
-        return it->second->getCharacterController()->isReadyToBlock();
+        return actor->getCharacterController()->isReadyToBlock();
     }
 
     bool Actors::isCastingSpell(const MWWorld::Ptr &ptr) const
     {
-        PtrActorMap::const_iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        Actor* actor = mActors.findActor(ptr);
+        if (actor == nullptr)
             return false;
 
-        return it->second->getCharacterController()->isCastingSpell();
+        return actor->getCharacterController()->isCastingSpell();
     }
 
     bool Actors::isAttackingOrSpell(const MWWorld::Ptr& ptr) const
     {
-        PtrActorMap::const_iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        Actor* actor = mActors.findActor(ptr);
+        if (actor == nullptr)
             return false;
-        CharacterController* ctrl = it->second->getCharacterController();
+        CharacterController* ctrl = actor->getCharacterController();
 
         return ctrl->isAttackingOrSpell();
     }
 
     int Actors::getGreetingTimer(const MWWorld::Ptr& ptr) const
     {
-        PtrActorMap::const_iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        Actor* actor = mActors.findActor(ptr);
+        if (actor == nullptr)
             return 0;
 
-        return it->second->getGreetingTimer();
+        return actor->getGreetingTimer();
     }
 
     float Actors::getAngleToPlayer(const MWWorld::Ptr& ptr) const
     {
-        PtrActorMap::const_iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        Actor* actor = mActors.findActor(ptr);
+        if (actor == nullptr)
             return 0.f;
 
-        return it->second->getAngleToPlayer();
+        return actor->getAngleToPlayer();
     }
 
     GreetingState Actors::getGreetingState(const MWWorld::Ptr& ptr) const
     {
-        PtrActorMap::const_iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        Actor* actor = mActors.findActor(ptr);
+        if (actor == nullptr)
             return Greet_None;
 
-        return it->second->getGreetingState();
+        return actor->getGreetingState();
     }
 
     bool Actors::isTurningToPlayer(const MWWorld::Ptr& ptr) const
     {
-        PtrActorMap::const_iterator it = mActors.find(ptr);
-        if (it == mActors.end())
+        Actor* actor = mActors.findActor(ptr);
+        if (actor == nullptr)
             return false;
 
-        return it->second->isTurningToPlayer();
+        return actor->isTurningToPlayer();
     }
 
     void Actors::fastForwardAi()
@@ -2248,17 +2380,15 @@ namespace MWMechanics
         if (!MWBase::Environment::get().getMechanicsManager()->isAIActive())
             return;
 
-        // making a copy since fast-forward could move actor to a different cell and invalidate the mActors iterator
-        PtrActorMap map = mActors;
-        for (PtrActorMap::iterator it = map.begin(); it != map.end(); ++it)
+        // fast-forward could move actor to a different cell and remove it from the scene
+        forEachActor([&] (const MWWorld::Ptr& ptr)
         {
-            MWWorld::Ptr ptr = it->first;
             if (ptr == getPlayer()
                     || !isConscious(ptr)
                     || ptr.getClass().getCreatureStats(ptr).isParalyzed())
-                continue;
+                return;
             MWMechanics::AiSequence& seq = ptr.getClass().getCreatureStats(ptr).getAiSequence();
             seq.fastForward(ptr);
-        }
+        });
     }
 }
@@ -6,9 +6,14 @@
 #include <string>
 #include <list>
 #include <map>
+#include <memory>
 
 #include "../mwmechanics/actorutil.hpp"
 
+#include "actorregistry.hpp"
+#include "actorupdatescheduler.hpp"
+#include "collisionprediction.hpp"
+
 namespace ESM
 {
     class ESMReader;
@@ -25,6 +30,11 @@ namespace Loading
     class Listener;
 }
 
+namespace Misc
+{
+    class JobPool;
+}
+
 namespace MWWorld
 {
     class Ptr;
@@ -57,16 +67,34 @@ namespace MWMechanics
 
             void predictAndAvoidCollisions(float duration);
 
+            void scheduleActorUpdates(const MWWorld::ConstPtr& player);
+
         public:
 
             Actors();
             ~Actors();
 
-            typedef std::map<MWWorld::Ptr,Actor*> PtrActorMap;
+            std::size_t size() const { return mActors.count(); }
+
+            /// Actors which got the full update in the last frame
+            std::size_t getUpdatedCount() const { return mUpdateScheduler.getUpdatedCount(); }
+
+            /// Actors due for an update which did not fit into the budget in the last frame
+            std::size_t getStarvedCount() const { return mUpdateScheduler.getStarvedCount(); }
 
-            PtrActorMap::const_iterator begin() { return mActors.begin(); }
-            PtrActorMap::const_iterator end() { return mActors.end(); }
-            std::size_t size() const { return mActors.size(); }
+            /// Actors may be added or removed by the function
+            template <class Function>
+            void forEachActor(Function&& function)
+            {
+                ActorRegistry::IterationScope scope(mActors);
+                for (std::size_t i = 0; i < mActors.size(); ++i)
+                {
+                    if (mActors.isRemoved(i))
+                        continue;
+                    const MWWorld::Ptr ptr = mActors.getPtr(i);
+                    function(ptr);
+                }
+            }
 
             void notifyDied(const MWWorld::Ptr &actor);
 
@@ -98,6 +126,9 @@ namespace MWMechanics
             void updateActor(const MWWorld::Ptr &old, const MWWorld::Ptr& ptr);
             ///< Updates an actor with a new Ptr
 
+            void updateActorPosition(const MWWorld::Ptr& ptr);
+            ///< Updates the stored position of a moved actor
+
             void dropActors (const MWWorld::CellStore *cellStore, const MWWorld::Ptr& ignore);
             ///< Deregister all actors (except for \a ignore) in the given cell.
 
@@ -201,13 +232,36 @@ namespace MWMechanics
             bool isTurningToPlayer(const MWWorld::Ptr& ptr) const;
 
     private:
+        enum class ActorUpdate : std::uint8_t
+        {
+            Skip,
+            Now,
+            Deferred,
+        };
+
         void updateVisibility (const MWWorld::Ptr& ptr, CharacterController* ctrl);
 
-        PtrActorMap mActors;
+        ActorRegistry mActors;
         float mTimerDisposeSummonsCorpses;
         float mActorsProcessingRange;
 
         bool mSmoothMovement;
+
+        float mAnimationLodDistance;
+        unsigned int mAnimationLodMaxInterval;
+        float mAnimationLodMinPixelSize;
+
+        /// Runs the collision prediction of predictAndAvoidCollisions, nullptr to run it in the main thread
+        std::unique_ptr<Misc::JobPool> mCollisionPredictionJobPool;
+
+        // Reused by predictAndAvoidCollisions to avoid allocations every frame
+        std::vector<CollisionPredictionActor> mCollisionPredictionActors;
+        std::vector<CollisionPredictionQuery> mCollisionPredictionQueries;
+        std::vector<std::vector<PredictedCollision>> mPredictedCollisions;
+
+        ActorUpdateScheduler mUpdateScheduler;
+        /// Indexed by actor index, actors added during the update are updated now
+        std::vector<ActorUpdate> mActorUpdates;
     };
 }
 
@@ -0,0 +1,244 @@
+#include "actorslots.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace MWMechanics
+{
+    namespace
+    {
+        osg::Vec2i getGridCell(const osg::Vec3f& position)
+        {
+            return osg::Vec2i(static_cast<int>(std::floor(position.x() / ActorSlots::sGridCellSize)),
+                              static_cast<int>(std::floor(position.y() / ActorSlots::sGridCellSize)));
+        }
+
+        std::uint64_t getGridKey(const osg::Vec2i& cell)
+        {
+            return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cell.x())) << 32)
+                | static_cast<std::uint32_t>(cell.y());
+        }
+
+        template <class T>
+        void swapRemove(std::vector<T>& values, std::size_t index)
+        {
+            if (index + 1 != values.size())
+                values[index] = std::move(values.back());
+            values.pop_back();
+        }
+    }
+
+    ActorSlots::IterationScope::IterationScope(ActorSlots& slots)
+        : mSlots(slots)
+    {
+        ++mSlots.mIterationDepth;
+    }
+
+    ActorSlots::IterationScope::~IterationScope()
+    {
+        if (--mSlots.mIterationDepth == 0)
+            mSlots.compact();
+    }
+
+    ActorSlots::ActorSlots(std::function<void (std::size_t index)> erase)
+        : mErase(std::move(erase))
+    {
+    }
+
+    std::size_t ActorSlots::find(const void* ref) const
+    {
+        const auto it = mSlotsByRef.find(ref);
+        if (it == mSlotsByRef.end())
+            return npos;
+        return mSlots[it->second].mIndex;
+    }
+
+    ActorHandle ActorSlots::getHandle(std::size_t index) const
+    {
+        const std::uint32_t slot = mSlotIndices[index];
+        return ActorHandle {slot, mSlots[slot].mGeneration};
+    }
+
+    std::size_t ActorSlots::getIndex(ActorHandle handle) const
+    {
+        if (handle.mSlot >= mSlots.size())
+            return npos;
+        const Slot& slot = mSlots[handle.mSlot];
+        if (slot.mGeneration != handle.mGeneration || slot.mIndex >= mRefs.size() || mRefs[slot.mIndex] == nullptr)
+            return npos;
+        return slot.mIndex;
+    }
+
+    ActorHandle ActorSlots::add(const void* ref, const osg::Vec3f& position)
+    {
+        assert(ref != nullptr);
+
+        std::uint32_t slot;
+        if (mFreeSlots.empty())
+        {
+            slot = static_cast<std::uint32_t>(mSlots.size());
+            mSlots.push_back(Slot {0, 0});
+        }
+        else
+        {
+            slot = mFreeSlots.back();
+            mFreeSlots.pop_back();
+        }
+
+        [[maybe_unused]] const bool inserted = mSlotsByRef.emplace(ref, slot).second;
+        assert(inserted);
+        mSlots[slot].mIndex = static_cast<std::uint32_t>(mRefs.size());
+
+        const osg::Vec2i cell = getGridCell(position);
+        addToGrid(slot, cell);
+
+        mSlotIndices.push_back(slot);
+        mRefs.push_back(ref);
+        mPositions.push_back(position);
+        mGridCells.push_back(cell);
+
+        return ActorHandle {slot, mSlots[slot].mGeneration};
+    }
+
+    void ActorSlots::remove(std::size_t index)
+    {
+        if (mRefs[index] == nullptr)
+            return;
+
+        const std::uint32_t slot = mSlotIndices[index];
+        mSlotsByRef.erase(mRefs[index]);
+        removeFromGrid(slot, mGridCells[index]);
+        ++mSlots[slot].mGeneration;
+        mFreeSlots.push_back(slot);
+        mRefs[index] = nullptr;
+
+        if (mIterationDepth > 0)
+            mRemoved.push_back(index);
+        else
+            erase(index);
+    }
+
+    bool ActorSlots::updateRef(const void* old, const void* ref)
+    {
+        assert(ref != nullptr);
+
+        const auto it = mSlotsByRef.find(old);
+        if (it == mSlotsByRef.end())
+            return false;
+
+        const std::uint32_t slot = it->second;
+        mSlotsByRef.erase(it);
+        // Replacing the slot of other actor would leave that one unreachable by its reference
+        [[maybe_unused]] const bool inserted = mSlotsByRef.emplace(ref, slot).second;
+        assert(inserted);
+        mRefs[mSlots[slot].mIndex] = ref;
+
+        return true;
+    }
+
+    void ActorSlots::setPosition(std::size_t index, const osg::Vec3f& position)
+    {
+        mPositions[index] = position;
+
+        const osg::Vec2i cell = getGridCell(position);
+        if (cell == mGridCells[index])
+            return;
+
+        const std::uint32_t slot = mSlotIndices[index];
+        removeFromGrid(slot, mGridCells[index]);
+        addToGrid(slot, cell);
+        mGridCells[index] = cell;
+    }
+
+    void ActorSlots::findNear(const osg::Vec3f& position, float radius, std::vector<std::size_t>& out) const
+    {
+        const float extent = radius + sMaxMovement;
+        const float cellsPerSide = 2 * extent / sGridCellSize + 1;
+
+        if (cellsPerSide * cellsPerSide >= static_cast<float>(count()))
+        {
+            // Visiting every actor is cheaper than looking up each grid cell
+            for (std::size_t i = 0, n = mRefs.size(); i < n; ++i)
+            {
+                if (mRefs[i] == nullptr)
+                    continue;
+                const osg::Vec3f delta = mPositions[i] - position;
+                if (std::abs(delta.x()) <= extent && std::abs(delta.y()) <= extent)
+                    out.push_back(i);
+            }
+            return;
+        }
+
+        const osg::Vec2i min = getGridCell(position - osg::Vec3f(extent, extent, 0));
+        const osg::Vec2i max = getGridCell(position + osg::Vec3f(extent, extent, 0));
+
+        for (int x = min.x(); x <= max.x(); ++x)
+        {
+            for (int y = min.y(); y <= max.y(); ++y)
+            {
+                const auto it = mGrid.find(getGridKey(osg::Vec2i(x, y)));
+                if (it == mGrid.end())
+                    continue;
+                for (const std::uint32_t slot : it->second)
+                    out.push_back(mSlots[slot].mIndex);
+            }
+        }
+    }
+
+    void ActorSlots::clear()
+    {
+        assert(mIterationDepth == 0);
+
+        mSlots.clear();
+        mFreeSlots.clear();
+        mSlotsByRef.clear();
+        mRemoved.clear();
+        mGrid.clear();
+        mSlotIndices.clear();
+        mRefs.clear();
+        mPositions.clear();
+        mGridCells.clear();
+    }
+
+    void ActorSlots::addToGrid(std::uint32_t slot, const osg::Vec2i& cell)
+    {
+        mGrid[getGridKey(cell)].push_back(slot);
+    }
+
+    void ActorSlots::removeFromGrid(std::uint32_t slot, const osg::Vec2i& cell)
+    {
+        const auto it = mGrid.find(getGridKey(cell));
+        assert(it != mGrid.end());
+        std::vector<std::uint32_t>& slots = it->second;
+        const auto slotIt = std::find(slots.begin(), slots.end(), slot);
+        assert(slotIt != slots.end());
+        *slotIt = slots.back();
+        slots.pop_back();
+        if (slots.empty())
+            mGrid.erase(it);
+    }
+
+    void ActorSlots::erase(std::size_t index)
+    {
+        const std::size_t last = mRefs.size() - 1;
+        if (index != last)
+            mSlots[mSlotIndices[last]].mIndex = static_cast<std::uint32_t>(index);
+
+        swapRemove(mSlotIndices, index);
+        swapRemove(mRefs, index);
+        swapRemove(mPositions, index);
+        swapRemove(mGridCells, index);
+
+        mErase(index);
+    }
+
+    void ActorSlots::compact()
+    {
+        // Erase from the back so swapped in actors are never the removed ones
+        std::sort(mRemoved.begin(), mRemoved.end(), std::greater<>());
+        for (const std::size_t index : mRemoved)
+            erase(index);
+        mRemoved.clear();
+    }
+}
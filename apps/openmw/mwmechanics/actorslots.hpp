@@ -0,0 +1,124 @@
+#ifndef OPENMW_MECHANICS_ACTORSLOTS_H
+#define OPENMW_MECHANICS_ACTORSLOTS_H
+
+#include <osg/Vec2i>
+#include <osg/Vec3f>
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace MWMechanics
+{
+    /// Stays valid until the actor is removed, unlike its index that changes when other actors are removed
+    struct ActorHandle
+    {
+        std::uint32_t mSlot = std::numeric_limits<std::uint32_t>::max();
+        std::uint32_t mGeneration = 0;
+    };
+
+    /// @brief Bookkeeping of dense actor indices for ActorRegistry.
+    /// @par Maps actor references and handles to indices, defers removal while iterating and buckets actors by
+    /// position into a uniform grid on the horizontal plane. Removing an actor moves the last one into its index, the
+    /// owner of the per actor data is told to do the same through the erase function.
+    class ActorSlots
+    {
+    public:
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        static constexpr float sGridCellSize = 1024.0f;
+
+        /// Actors are expected to move less than this since their position was stored, larger moves have to update it
+        static constexpr float sMaxMovement = 256.0f;
+
+        /// @brief Defers removal of actors while alive so indices stay valid during iteration.
+        /// @par Removed actors are skipped by isRemoved() until the outermost scope ends. Actors added meanwhile are
+        /// appended after the existing ones.
+        class IterationScope
+        {
+        public:
+            explicit IterationScope(ActorSlots& slots);
+            ~IterationScope();
+
+            IterationScope(const IterationScope&) = delete;
+            IterationScope& operator=(const IterationScope&) = delete;
+
+        private:
+            ActorSlots& mSlots;
+        };
+
+        /// @param erase moves the data of the last actor to the given index and drops the last one
+        explicit ActorSlots(std::function<void (std::size_t index)> erase);
+
+        std::size_t size() const { return mRefs.size(); }
+
+        /// Number of actors not removed
+        std::size_t count() const { return mSlotsByRef.size(); }
+
+        bool isRemoved(std::size_t index) const { return mRefs[index] == nullptr; }
+
+        /// @return npos if the reference is not registered
+        std::size_t find(const void* ref) const;
+
+        ActorHandle getHandle(std::size_t index) const;
+
+        /// @return npos if the actor was removed
+        std::size_t getIndex(ActorHandle handle) const;
+
+        /// Differs for actors added together
+        std::uint32_t getUpdatePhase(std::size_t index) const { return mSlotIndices[index]; }
+
+        const osg::Vec3f& getPosition(std::size_t index) const { return mPositions[index]; }
+
+        /// The actor gets index size(), the reference must not be registered
+        ActorHandle add(const void* ref, const osg::Vec3f& position);
+
+        void remove(std::size_t index);
+
+        /// Keeps the index and the handle of the actor, the new reference must not be registered for other actor
+        /// @return false if old is not registered
+        bool updateRef(const void* old, const void* ref);
+
+        void setPosition(std::size_t index, const osg::Vec3f& position);
+
+        /// @brief Appends indices of the actors that may be within radius from position.
+        /// @par Includes all actors with stored position within radius plus sMaxMovement, so actors moved since
+        /// then are not missed. The caller has to check the actual distance.
+        void findNear(const osg::Vec3f& position, float radius, std::vector<std::size_t>& out) const;
+
+        void clear();
+
+    private:
+        struct Slot
+        {
+            std::uint32_t mIndex;
+            std::uint32_t mGeneration;
+        };
+
+        std::function<void (std::size_t index)> mErase;
+        std::vector<Slot> mSlots;
+        std::vector<std::uint32_t> mFreeSlots;
+        std::unordered_map<const void*, std::uint32_t> mSlotsByRef;
+        std::size_t mIterationDepth = 0;
+        std::vector<std::size_t> mRemoved;
+        std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> mGrid;
+
+        // Indexed by actor index
+        std::vector<std::uint32_t> mSlotIndices;
+        std::vector<const void*> mRefs;
+        std::vector<osg::Vec3f> mPositions;
+        std::vector<osg::Vec2i> mGridCells;
+
+        void addToGrid(std::uint32_t slot, const osg::Vec2i& cell);
+
+        void removeFromGrid(std::uint32_t slot, const osg::Vec2i& cell);
+
+        void erase(std::size_t index);
+
+        void compact();
+    };
+}
+
+#endif
@@ -0,0 +1,101 @@
+#include "actorupdatescheduler.hpp"
+
+#include <algorithm>
+
+namespace MWMechanics
+{
+    namespace
+    {
+        // Weight of the last frame in the average cost of a deferred update
+        constexpr float costSmoothing = 0.1f;
+    }
+
+    unsigned getLodUpdateInterval(float distance, float lodDistance, unsigned maxInterval, unsigned extraBands)
+    {
+        if (lodDistance <= 0.f || distance < lodDistance)
+            return 1;
+        const unsigned bands = static_cast<unsigned>(distance / lodDistance) + extraBands;
+        return std::min(std::max(1u, maxInterval), bands + 1);
+    }
+
+    ActorUpdateScheduler::ActorUpdateScheduler(float lodDistance, unsigned maxInterval, float budget)
+        : mLodDistance(lodDistance)
+        , mMaxInterval(std::max(1u, maxInterval))
+        , mBudget(budget)
+    {
+    }
+
+    unsigned ActorUpdateScheduler::getUpdateInterval(float distance, bool inView) const
+    {
+        return getLodUpdateInterval(distance, mLodDistance, mMaxInterval, inView ? 0 : 1);
+    }
+
+    bool ActorUpdateScheduler::isDue(std::uint32_t phase, std::uint32_t skippedFrames, unsigned interval) const
+    {
+        if (interval <= 1)
+            return true;
+        // Catch up on updates missed because of starvation or a changed interval
+        return skippedFrames >= interval || (mFrame + phase) % interval == 0;
+    }
+
+    void ActorUpdateScheduler::beginFrame()
+    {
+        ++mFrame;
+        mDeferred.clear();
+        mSelected.clear();
+        mUpdates = 0;
+        mDeferredUpdates = 0;
+        mDeferredUpdatesTime = 0;
+    }
+
+    void ActorUpdateScheduler::addDeferred(std::size_t actor, std::uint32_t skippedFrames, unsigned interval)
+    {
+        const std::uint32_t overdueFrames = skippedFrames >= interval ? skippedFrames + 1 - interval : 0;
+        mDeferred.push_back(DeferredUpdate {actor, overdueFrames});
+    }
+
+    const std::vector<std::size_t>& ActorUpdateScheduler::selectDeferred()
+    {
+        // Starved actors become more overdue every frame, so they are not starved forever
+        std::stable_sort(mDeferred.begin(), mDeferred.end(),
+            [] (const DeferredUpdate& lhs, const DeferredUpdate& rhs) { return lhs.mOverdueFrames > rhs.mOverdueFrames; });
+
+        std::size_t count = mDeferred.size();
+        if (mBudget > 0.f && mDeferredUpdateCost > 0.f)
+            count = std::min(count, std::max<std::size_t>(1, static_cast<std::size_t>(mBudget / mDeferredUpdateCost)));
+
+        mSelected.clear();
+        for (std::size_t i = 0; i < count; ++i)
+            mSelected.push_back(mDeferred[i].mActor);
+        return mSelected;
+    }
+
+    bool ActorUpdateScheduler::hasBudget() const
+    {
+        return mBudget <= 0.f || mDeferredUpdates == 0 || mDeferredUpdatesTime < mBudget;
+    }
+
+    void ActorUpdateScheduler::reportUpdate(bool deferred, float cost)
+    {
+        ++mUpdates;
+        if (!deferred)
+            return;
+        ++mDeferredUpdates;
+        mDeferredUpdatesTime += cost;
+    }
+
+    void ActorUpdateScheduler::endFrame()
+    {
+        if (mDeferredUpdates > 0)
+        {
+            const float cost = mDeferredUpdatesTime / static_cast<float>(mDeferredUpdates);
+            if (mDeferredUpdateCost > 0.f)
+                mDeferredUpdateCost += (cost - mDeferredUpdateCost) * costSmoothing;
+            else
+                mDeferredUpdateCost = cost;
+        }
+
+        mUpdatedCount = mUpdates;
+        mStarvedCount = mDeferred.size() - std::min(mDeferred.size(), mDeferredUpdates);
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef OPENMW_MECHANICS_ACTORUPDATESCHEDULER_H
+#define OPENMW_MECHANICS_ACTORUPDATESCHEDULER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MWMechanics
+{
+    /// @brief Number of frames between two updates of something at the given distance from the player.
+    /// @par Every further band of lodDistance units skips one more frame, capped by maxInterval. Beyond lodDistance
+    /// extraBands are added to the band of the distance.
+    /// @param lodDistance 0 to update every frame
+    unsigned getLodUpdateInterval(float distance, float lodDistance, unsigned maxInterval, unsigned extraBands = 0);
+
+    /// @brief Decides which actors get the full AI and magic effects update in the current frame.
+    /// @par Actors beyond the lod distance from the player are due every few frames depending on the distance and
+    /// whether they are in view. The time accumulated since their last update is to be passed to the next one.
+    /// @par Updates of distant actors are deferred: they are done while the time spent on them in the frame is within
+    /// the budget, the most overdue first. Deferred updates not done in the frame are starved and stay due.
+    class ActorUpdateScheduler
+    {
+    public:
+        /// @param lodDistance 0 to update every actor every frame
+        /// @param budget In seconds, 0 for no limit
+        ActorUpdateScheduler(float lodDistance, unsigned maxInterval, float budget);
+
+        /// Number of frames between two updates of an actor, actors not in view are treated as one band further
+        unsigned getUpdateInterval(float distance, bool inView) const;
+
+        /// @param phase Spreads updates of actors with the same interval over different frames
+        /// @param skippedFrames Frames passed since the last update of the actor, not counting the current one
+        bool isDue(std::uint32_t phase, std::uint32_t skippedFrames, unsigned interval) const;
+
+        /// Starts a new frame, forgets the deferred updates of the previous one
+        void beginFrame();
+
+        void addDeferred(std::size_t actor, std::uint32_t skippedFrames, unsigned interval);
+
+        /// @return actors whose deferred update is expected to fit into the budget, the most overdue first,
+        /// at least one if any
+        const std::vector<std::size_t>& selectDeferred();
+
+        /// Whether a selected deferred update may still be done in the current frame
+        bool hasBudget() const;
+
+        /// @param cost Time spent on the update in seconds
+        void reportUpdate(bool deferred, float cost);
+
+        void endFrame();
+
+        /// As of the last endFrame()
+        std::size_t getUpdatedCount() const { return mUpdatedCount; }
+
+        /// As of the last endFrame()
+        std::size_t getStarvedCount() const { return mStarvedCount; }
+
+    private:
+        struct DeferredUpdate
+        {
+            std::size_t mActor;
+            std::uint32_t mOverdueFrames;
+        };
+
+        float mLodDistance;
+        unsigned mMaxInterval;
+        float mBudget;
+        /// Average time of a deferred update over the previous frames
+        float mDeferredUpdateCost = 0;
+        std::uint32_t mFrame = 0;
+
+        std::vector<DeferredUpdate> mDeferred;
+        std::vector<std::size_t> mSelected;
+        std::size_t mUpdates = 0;
+        std::size_t mDeferredUpdates = 0;
+        float mDeferredUpdatesTime = 0;
+
+        std::size_t mUpdatedCount = 0;
+        std::size_t mStarvedCount = 0;
+    };
+}
+
+#endif
@@ -11,6 +11,7 @@
 #include <components/detournavigator/navigatorutils.hpp>
 
 #include "../mwphysics/collisiontype.hpp"
+#include "../mwphysics/raycasting.hpp"
 
 #include "../mwworld/class.hpp"
 #include "../mwworld/esmstore.hpp"
@@ -136,6 +137,7 @@ namespace MWMechanics
                 if (is_target_reached) storage.mReadyToAttack = true;
             }
 
+            storage.updateBackUp();
             storage.updateCombatMove(duration);
             storage.mRotateMove = false;
             if (storage.mReadyToAttack) updateActorsMovement(actor, duration, storage);
@@ -500,31 +502,30 @@ namespace MWMechanics
             if (MWBase::Environment::get().getWorld()->isUnderwater(MWWorld::ConstPtr(actor), 0.5f))
                 return;
 
-            int mask = MWPhysics::CollisionType_World | MWPhysics::CollisionType_HeightMap | MWPhysics::CollisionType_Door;
+            MWBase::World* world = MWBase::Environment::get().getWorld();
+            const int mask = MWPhysics::CollisionType_World | MWPhysics::CollisionType_HeightMap | MWPhysics::CollisionType_Door;
 
+            // The rays are cast by the physics threads, the actor backs up in updateBackUp() when both are clear.
             // Actor can not back up if there is no free space behind
             // Currently we take the 35% of actor's height from the ground as vector height.
             // This approach allows us to detect small obstacles (e.g. crates) and curved walls.
-            osg::Vec3f halfExtents = MWBase::Environment::get().getWorld()->getHalfExtents(actor);
+            osg::Vec3f halfExtents = world->getHalfExtents(actor);
             osg::Vec3f pos = actor.getRefData().getPosition().asVec3();
-            osg::Vec3f source = pos + osg::Vec3f(0, 0, 0.75f * halfExtents.z());
+            MWPhysics::RayQuery obstacleQuery;
+            obstacleQuery.mFrom = pos + osg::Vec3f(0, 0, 0.75f * halfExtents.z());
             osg::Vec3f fallbackDirection = actor.getRefData().getBaseNode()->getAttitude() * osg::Vec3f(0,-1,0);
-            osg::Vec3f destination = source + fallbackDirection * (halfExtents.y() + 16);
-
-            bool isObstacleDetected = MWBase::Environment::get().getWorld()->castRay(source.x(), source.y(), source.z(), destination.x(), destination.y(), destination.z(), mask);
-            if (isObstacleDetected)
-                return;
+            obstacleQuery.mTo = obstacleQuery.mFrom + fallbackDirection * (halfExtents.y() + 16);
+            obstacleQuery.mMask = mask;
+            mBackUpObstacleQuery = world->queueRayQuery(obstacleQuery);
 
             // Check if there is nothing behind - probably actor is near cliff.
             // A current approach: cast ray 1.5-yard ray down in 1.5 yard behind actor from 35% of actor's height.
             // If we did not hit anything, there is a cliff behind actor.
-            source = pos + osg::Vec3f(0, 0, 0.75f * halfExtents.z()) + fallbackDirection * (halfExtents.y() + 96);
-            destination = source - osg::Vec3f(0, 0, 0.75f * halfExtents.z() + 96);
-            bool isCliffDetected = !MWBase::Environment::get().getWorld()->castRay(source.x(), source.y(), source.z(), destination.x(), destination.y(), destination.z(), mask);
-            if (isCliffDetected)
-                return;
-
-            mMovement.mPosition[1] = -1;
+            MWPhysics::RayQuery cliffQuery;
+            cliffQuery.mFrom = pos + osg::Vec3f(0, 0, 0.75f * halfExtents.z()) + fallbackDirection * (halfExtents.y() + 96);
+            cliffQuery.mTo = cliffQuery.mFrom - osg::Vec3f(0, 0, 0.75f * halfExtents.z() + 96);
+            cliffQuery.mMask = mask;
+            mBackUpCliffQuery = world->queueRayQuery(cliffQuery);
         }
         // dodge movements (for NPCs and bipedal creatures)
         // Note: do not use for ranged combat yet since in couple with back up behaviour can move actor out of cliff
@@ -560,6 +561,24 @@ namespace MWMechanics
         }
     }
 
+    void AiCombatStorage::updateBackUp()
+    {
+        if (mBackUpObstacleQuery == 0)
+            return;
+        MWBase::World* world = MWBase::Environment::get().getWorld();
+        // Both queries are run together, a result dropped before it was taken is replaced on the next reaction
+        const std::optional<MWPhysics::RayCastingResult> obstacle = world->takeRayQueryResult(mBackUpObstacleQuery);
+        const std::optional<MWPhysics::RayCastingResult> cliff = world->takeRayQueryResult(mBackUpCliffQuery);
+        if (!obstacle.has_value() || !cliff.has_value())
+            return;
+        mBackUpObstacleQuery = 0;
+        mBackUpCliffQuery = 0;
+        const bool isObstacleDetected = obstacle->mHit;
+        const bool isCliffDetected = !cliff->mHit;
+        if (!isObstacleDetected && !isCliffDetected)
+            mMovement.mPosition[1] = -1;
+    }
+
     void AiCombatStorage::stopCombatMove()
     {
         mTimerCombatMove = 0;
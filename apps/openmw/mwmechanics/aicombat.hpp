@@ -59,6 +59,10 @@ namespace MWMechanics
         bool mUseCustomDestination;
         osg::Vec3f mCustomDestination;
 
+        // Tags of the queued ray queries checking whether the actor can back up, 0 when none is queued
+        std::size_t mBackUpObstacleQuery;
+        std::size_t mBackUpCliffQuery;
+
         AiCombatStorage():
         mAttackCooldown(0.0f),
         mTimerCombatMove(0.0f),
@@ -80,11 +84,15 @@ namespace MWMechanics
         mUpdateLOSTimer(0.0f),
         mFleeBlindRunTimer(0.0f),
         mUseCustomDestination(false),
-        mCustomDestination()
+        mCustomDestination(),
+        mBackUpObstacleQuery(0),
+        mBackUpCliffQuery(0)
         {}
 
         void startCombatMove(bool isDistantCombat, float distToTarget, float rangeAttack, const MWWorld::Ptr& actor, const MWWorld::Ptr& target);
         void updateCombatMove(float duration);
+        /// Start backing up once the rays queued by startCombatMove() found free space behind the actor
+        void updateBackUp();
         void stopCombatMove();
         void startAttackIfReady(const MWWorld::Ptr& actor, CharacterController& characterController,
             const ESM::Weapon* weapon, bool distantCombat);
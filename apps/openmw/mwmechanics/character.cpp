@@ -2899,6 +2899,11 @@ void CharacterController::setActive(int active)
     mAnimation->setActive(active);
 }
 
+void CharacterController::setAnimationLod(unsigned int updateInterval, float minPixelSize)
+{
+    mAnimation->setLod(updateInterval, minPixelSize);
+}
+
 void CharacterController::setHeadTrackTarget(const MWWorld::ConstPtr &target)
 {
     mHeadTrackTarget = target;
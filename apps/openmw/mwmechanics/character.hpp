@@ -298,6 +298,9 @@ public:
     /// @see Animation::setActive
     void setActive(int active);
 
+    /// @see Animation::setLod
+    void setAnimationLod(unsigned int updateInterval, float minPixelSize);
+
     /// Make this character turn its head towards \a target. To turn off head tracking, pass an empty Ptr.
     void setHeadTrackTarget(const MWWorld::ConstPtr& target);
 
@@ -0,0 +1,84 @@
+#include "collisionprediction.hpp"
+
+#include <components/misc/mathutil.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace MWMechanics
+{
+    namespace
+    {
+        constexpr float minGap = 10.f;
+        constexpr float maxDistForPartialAvoiding = 200.f;
+        constexpr float maxDistForStrictAvoiding = 100.f;
+    }
+
+    float getCollisionCheckDistance(bool isMoving)
+    {
+        return isMoving ? maxDistForPartialAvoiding : maxDistForStrictAvoiding;
+    }
+
+    void predictCollisions(const std::vector<CollisionPredictionActor>& actors, const CollisionPredictionQuery& query,
+        const std::vector<std::size_t>& others, std::vector<PredictedCollision>& out)
+    {
+        const CollisionPredictionActor& base = actors[query.mActor];
+        const osg::Vec2f baseSpeed(base.mVelocity.x(), base.mVelocity.y());
+        const float maxDistToCheck = getCollisionCheckDistance(query.mIsMoving);
+        const std::size_t firstCollision = out.size();
+
+        for (const std::size_t other : others)
+        {
+            if (other == query.mActor || other == query.mIgnored)
+                continue;
+
+            const CollisionPredictionActor& otherActor = actors[other];
+            const osg::Vec3f deltaPos = otherActor.mPosition - base.mPosition;
+            const float dist = deltaPos.length();
+
+            // Ignore actors which are not close enough.
+            if (dist > maxDistToCheck)
+                continue;
+
+            const osg::Vec2f relPos = Misc::rotateVec2f(osg::Vec2f(deltaPos.x(), deltaPos.y()), base.mRotationZ);
+
+            // Ignore actors which come from behind.
+            if (relPos.y() < 0)
+                continue;
+
+            // Don't check for a collision if vertical distance is greater then the actor's height.
+            if (deltaPos.z() > base.mHalfExtents.z() * 2 || deltaPos.z() < -otherActor.mHalfExtents.z() * 2)
+                continue;
+
+            const osg::Vec2f relSpeed = Misc::rotateVec2f(osg::Vec2f(otherActor.mVelocity.x(), otherActor.mVelocity.y()),
+                                                          base.mRotationZ - otherActor.mRotationZ) - baseSpeed;
+
+            float collisionDist = minGap + base.mHalfExtents.x() + otherActor.mHalfExtents.x();
+            collisionDist = std::min(collisionDist, relPos.length());
+
+            // Find the earliest `t` when |relPos + relSpeed * t| == collisionDist.
+            const float vr = relPos.x() * relSpeed.x() + relPos.y() * relSpeed.y();
+            const float v2 = relSpeed.length2();
+            const float Dh = vr * vr - v2 * (relPos.length2() - collisionDist * collisionDist);
+            if (Dh <= 0 || v2 == 0)
+                continue; // No solution; distance is always >= collisionDist.
+            const float t = (-vr - std::sqrt(Dh)) / v2;
+
+            if (t < 0 || t >= query.mMaxTime)
+                continue;
+
+            const osg::Vec2f posAtT = relPos + relSpeed * t;
+            float coef = (posAtT.x() * relSpeed.x() + posAtT.y() * relSpeed.y()) / (collisionDist * collisionDist * base.mMaxSpeed);
+            coef *= std::clamp((maxDistForPartialAvoiding - dist) / (maxDistForPartialAvoiding - maxDistForStrictAvoiding), 0.f, 1.f);
+            osg::Vec2f movementCorrection = posAtT * coef;
+            if (otherActor.mDead)
+                // In case of dead body still try to go around (it looks natural), but reduce the correction twice.
+                movementCorrection.y() *= 0.5f;
+
+            out.push_back(PredictedCollision {other, t, std::atan2(deltaPos.x(), deltaPos.y()), movementCorrection});
+        }
+
+        std::stable_sort(out.begin() + static_cast<std::ptrdiff_t>(firstCollision), out.end(),
+            [] (const PredictedCollision& lhs, const PredictedCollision& rhs) { return lhs.mTime < rhs.mTime; });
+    }
+}
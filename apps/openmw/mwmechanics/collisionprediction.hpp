@@ -0,0 +1,55 @@
+#ifndef OPENMW_MECHANICS_COLLISIONPREDICTION_H
+#define OPENMW_MECHANICS_COLLISIONPREDICTION_H
+
+#include <osg/Vec2f>
+#include <osg/Vec3f>
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace MWMechanics
+{
+    /// State of an actor read by the collision prediction, captured before any movement is corrected
+    struct CollisionPredictionActor
+    {
+        osg::Vec3f mPosition;
+        osg::Vec3f mHalfExtents;
+        /// Movement settings multiplied by the max speed, in actor local space
+        osg::Vec3f mVelocity;
+        float mMaxSpeed = 0;
+        float mRotationZ = 0;
+        bool mDead = false;
+    };
+
+    struct CollisionPredictionQuery
+    {
+        std::size_t mActor = 0;
+        /// Actor not to avoid, like a combat target
+        std::size_t mIgnored = std::numeric_limits<std::size_t>::max();
+        bool mIsMoving = false;
+        bool mShouldTurnToApproachingActor = false;
+        float mMaxTime = 0;
+    };
+
+    struct PredictedCollision
+    {
+        std::size_t mOther = 0;
+        float mTime = 0;
+        /// Direction to the other actor
+        float mAngle = 0;
+        /// To be added to the movement of the actor to evade the collision
+        osg::Vec2f mMovementCorrection;
+    };
+
+    /// Other actors further than this are not considered
+    float getCollisionCheckDistance(bool isMoving);
+
+    /// @brief Predicts collisions of the actor with the others assuming everyone keeps moving the same way.
+    /// @par Collisions happening before query.mMaxTime are appended to out sorted by time. Only the arguments are read,
+    /// so it may be called concurrently for different queries.
+    void predictCollisions(const std::vector<CollisionPredictionActor>& actors, const CollisionPredictionQuery& query,
+        const std::vector<std::size_t>& others, std::vector<PredictedCollision>& out);
+}
+
+#endif
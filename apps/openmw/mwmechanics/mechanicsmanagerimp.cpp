@@ -277,6 +277,12 @@ namespace MWMechanics
             mObjects.updateObject(old, ptr);
     }
 
+    void MechanicsManager::updatePosition(const MWWorld::Ptr& ptr)
+    {
+        if (ptr.getClass().isActor())
+            mActors.updateActorPosition(ptr);
+    }
+
     void MechanicsManager::drop(const MWWorld::CellStore *cellStore)
     {
         mActors.dropActors(cellStore, getPlayer());
@@ -1588,19 +1594,19 @@ namespace MWMechanics
             if (ptr.getClass().isClass(ptr, "Guard"))
             {
                 stats.setHitAttemptActorId(target.getClass().getCreatureStats(target).getActorId()); // Stops guard from ending combat if player is unreachable
-                for (Actors::PtrActorMap::const_iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
+                mActors.forEachActor([&] (const MWWorld::Ptr& actor)
                 {
-                    if (iter->first.getClass().isClass(iter->first, "Guard"))
+                    if (actor.getClass().isClass(actor, "Guard"))
                     {
-                        MWMechanics::AiSequence& aiSeq = iter->first.getClass().getCreatureStats(iter->first).getAiSequence();
+                        MWMechanics::AiSequence& aiSeq = actor.getClass().getCreatureStats(actor).getAiSequence();
                         if (aiSeq.getTypeId() == MWMechanics::AiPackageTypeId::Pursue)
                         {
                             aiSeq.stopPursuit();
                             aiSeq.stack(MWMechanics::AiCombat(target), ptr);
-                            iter->first.getClass().getCreatureStats(iter->first).setHitAttemptActorId(target.getClass().getCreatureStats(target).getActorId()); // Stops guard from ending combat if player is unreachable
+                            actor.getClass().getCreatureStats(actor).setHitAttemptActorId(target.getClass().getCreatureStats(target).getActorId()); // Stops guard from ending combat if player is unreachable
                         }
                     }
-                }
+                });
             }
         }
 
@@ -1867,6 +1873,8 @@ namespace MWMechanics
     void MechanicsManager::reportStats(unsigned int frameNumber, osg::Stats& stats) const
     {
         stats.setAttribute(frameNumber, "Mechanics Actors", mActors.size());
+        stats.setAttribute(frameNumber, "Mechanics Updated", mActors.getUpdatedCount());
+        stats.setAttribute(frameNumber, "Mechanics Starved", mActors.getStarvedCount());
         stats.setAttribute(frameNumber, "Mechanics Objects", mObjects.size());
     }
 
@@ -1,9 +1,12 @@
 #include "pathfinding.hpp"
 
+#include <algorithm>
 #include <iterator>
 #include <limits>
 
+#include <components/detournavigator/findcoarsepath.hpp>
 #include <components/detournavigator/navigatorutils.hpp>
+#include <components/detournavigator/pathqueryservice.hpp>
 #include <components/debug/debuglog.hpp>
 #include <components/misc/coordinateconverter.hpp>
 
@@ -105,6 +108,24 @@ namespace
         return checkAngle && checkDist;
     }
 
+    float getLimitedPathMaxDistance(const DetourNavigator::Navigator& navigator)
+    {
+        return std::min(navigator.getMaxNavmeshAreaRealRadius(), static_cast<float>(Constants::CellSizeInUnits));
+    }
+
+    osg::Vec3f findLimitedPathEnd(const osg::Vec3f& startPoint, const osg::Vec3f& endPoint,
+        const osg::Vec3f& halfExtents, const DetourNavigator::Flags flags)
+    {
+        const auto navigator = MWBase::Environment::get().getWorld()->getNavigator();
+        const float maxDistance = getLimitedPathMaxDistance(*navigator);
+        if ((endPoint - startPoint).length() <= maxDistance)
+            return endPoint;
+        // Head to the last waypoint of the route over navmesh tiles before it goes out of reach
+        const auto route = DetourNavigator::findCoarsePath(*navigator, halfExtents, startPoint, endPoint, flags);
+        return DetourNavigator::getLimitedPathEnd(startPoint, endPoint, maxDistance,
+                                                  route.value_or(std::vector<osg::Vec3f>()));
+    }
+
     struct IsValidShortcut
     {
         const DetourNavigator::Navigator* mNavigator;
@@ -152,7 +173,7 @@ namespace MWMechanics
      *
      * NOTE: startPoint & endPoint are in world coordinates
      *
-     * Updates mPath using aStarSearch() or ray test (if shortcut allowed).
+     * Updates mPath using findPath() or ray test (if shortcut allowed).
      * mPath consists of pathgrid points, except the last element which is
      * endPoint.  This may be useful where the endPoint is not on a pathgrid
      * point (e.g. combat).  However, if the caller has already chosen a
@@ -219,7 +240,7 @@ namespace MWMechanics
         // AiWander has logic that depends on whether a path was created,
         // deleting allowed nodes if not.  Hence a path needs to be created
         // even if the start and the end points are the same.
-        // NOTE: aStarSearch will return an empty path if the start and end
+        // NOTE: findPath will return an empty path if the start and end
         //       nodes are the same
         if(startNode == endNode.first)
         {
@@ -229,13 +250,14 @@ namespace MWMechanics
         }
         else
         {
-            auto path = pathgridGraph.aStarSearch(startNode, endNode.first);
+            pathgridGraph.findPath(startNode, endNode.first, mPathgridPoints);
+            auto pathBegin = mPathgridPoints.begin();
 
             // If nearest path node is in opposite direction from second, remove it from path.
             // Especially useful for wandering actors, if the nearest node is blocked for some reason.
-            if (path.size() > 1)
+            if (mPathgridPoints.size() > 1)
             {
-                ESM::Pathgrid::Point secondNode = *(++path.begin());
+                const ESM::Pathgrid::Point& secondNode = pathgrid->mPoints[mPathgridPoints[1]];
                 osg::Vec3f firstNodeVec3f = makeOsgVec3(pathgrid->mPoints[startNode]);
                 osg::Vec3f secondNodeVec3f = makeOsgVec3(secondNode);
                 osg::Vec3f toSecondNodeVec3f = secondNodeVec3f - firstNodeVec3f;
@@ -250,14 +272,15 @@ namespace MWMechanics
                     bool isPathClear = !MWBase::Environment::get().getWorld()->castRay(
                         startPoint.x(), startPoint.y(), startPoint.z() + 16, temp.mX, temp.mY, temp.mZ + 16, mask);
                     if (isPathClear)
-                        path.pop_front();
+                        ++pathBegin;
                 }
             }
 
             // convert supplied path to world coordinates
-            std::transform(path.begin(), path.end(), out,
-                [&] (ESM::Pathgrid::Point& point)
+            std::transform(pathBegin, mPathgridPoints.end(), out,
+                [&] (int index)
                 {
+                    ESM::Pathgrid::Point point(pathgrid->mPoints[index]);
                     converter.toWorld(point);
                     return makeOsgVec3(point);
                 });
@@ -343,6 +366,7 @@ namespace MWMechanics
 
     void PathFinder::buildStraightPath(const osg::Vec3f& endPoint)
     {
+        mPendingPath = nullptr;
         mPath.clear();
         mPath.push_back(endPoint);
         mConstructed = true;
@@ -351,6 +375,7 @@ namespace MWMechanics
     void PathFinder::buildPathByPathgrid(const osg::Vec3f& startPoint, const osg::Vec3f& endPoint,
         const MWWorld::CellStore* cell, const PathgridGraph& pathgridGraph)
     {
+        mPendingPath = nullptr;
         mPath.clear();
         mCell = cell;
 
@@ -363,6 +388,7 @@ namespace MWMechanics
         const osg::Vec3f& endPoint, const osg::Vec3f& halfExtents, const DetourNavigator::Flags flags,
         const DetourNavigator::AreaCosts& areaCosts, float endTolerance, PathType pathType)
     {
+        mPendingPath = nullptr;
         mPath.clear();
 
         // If it's not possible to build path over navmesh due to disabled navmesh generation fallback to straight path
@@ -383,6 +409,7 @@ namespace MWMechanics
         const DetourNavigator::Flags flags, const DetourNavigator::AreaCosts& areaCosts, float endTolerance,
         PathType pathType)
     {
+        mPendingPath = nullptr;
         mPath.clear();
         mCell = cell;
 
@@ -483,17 +510,70 @@ namespace MWMechanics
         const DetourNavigator::Flags flags, const DetourNavigator::AreaCosts& areaCosts, float endTolerance,
         PathType pathType)
     {
-        const auto navigator = MWBase::Environment::get().getWorld()->getNavigator();
-        const auto maxDistance = std::min(
-            navigator->getMaxNavmeshAreaRealRadius(),
-            static_cast<float>(Constants::CellSizeInUnits)
-        );
-        const auto startToEnd = endPoint - startPoint;
-        const auto distance = startToEnd.length();
-        if (distance <= maxDistance)
-            return buildPath(actor, startPoint, endPoint, cell, pathgridGraph, halfExtents, flags, areaCosts,
-                             endTolerance, pathType);
-        const auto end = startPoint + startToEnd * maxDistance / distance;
-        buildPath(actor, startPoint, end, cell, pathgridGraph, halfExtents, flags, areaCosts, endTolerance, pathType);
+        buildPath(actor, startPoint, findLimitedPathEnd(startPoint, endPoint, halfExtents, flags), cell, pathgridGraph,
+                  halfExtents, flags, areaCosts, endTolerance, pathType);
+    }
+
+    void PathFinder::requestLimitedPath(const MWWorld::ConstPtr& actor, const osg::Vec3f& startPoint,
+        const osg::Vec3f& endPoint, const MWWorld::CellStore* cell, const PathgridGraph& pathgridGraph,
+        const osg::Vec3f& halfExtents, const DetourNavigator::Flags flags, const DetourNavigator::AreaCosts& areaCosts,
+        float endTolerance, PathType pathType)
+    {
+        const auto pathQueryService = MWBase::Environment::get().getWorld()->getPathQueryService();
+
+        if (pathQueryService == nullptr || actor.getClass().isPureWaterCreature(actor)
+                || actor.getClass().isPureFlyingCreature(actor))
+            return buildLimitedPath(actor, startPoint, endPoint, cell, pathgridGraph, halfExtents, flags, areaCosts,
+                                    endTolerance, pathType);
+
+        DetourNavigator::PathQuery query;
+        query.mAgentHalfExtents = halfExtents;
+        query.mStepSize = getPathStepSize(actor);
+        query.mStart = startPoint;
+        query.mEnd = endPoint;
+        query.mMaxDistance = getLimitedPathMaxDistance(*MWBase::Environment::get().getWorld()->getNavigator());
+        query.mIncludeFlags = flags;
+        query.mAreaCosts = areaCosts;
+        query.mEndTolerance = endTolerance;
+        query.mAcceptPartialPath = pathType == PathType::Partial;
+        query.mRetryWithPathgrid = true;
+
+        mPendingPath = pathQueryService->request(query);
+
+        takePendingPath(actor, cell, pathgridGraph);
+    }
+
+    bool PathFinder::takePendingPath(const MWWorld::ConstPtr& actor, const MWWorld::CellStore* cell,
+        const PathgridGraph& pathgridGraph)
+    {
+        if (mPendingPath == nullptr || !mPendingPath->isReady())
+            return false;
+
+        const std::shared_ptr<const DetourNavigator::PendingPath> pendingPath = std::move(mPendingPath);
+        mPendingPath = nullptr;
+        const DetourNavigator::PathQuery& query = pendingPath->getQuery();
+        const DetourNavigator::PathQueryResult& result = pendingPath->getResult();
+
+        if (result.mStatus != DetourNavigator::Status::Success
+                && result.mStatus != DetourNavigator::Status::NavMeshNotFound)
+        {
+            Log(Debug::Debug) << "Build path by navigator error: \"" << DetourNavigator::getMessage(result.mStatus)
+                << "\" for \"" << actor.getClass().getName(actor) << "\" (" << actor.getBase()
+                << ") from " << query.mStart << " to " << result.mEnd << " with flags ("
+                << DetourNavigator::WriteFlags {result.mIncludeFlags} << ")";
+        }
+
+        mPath.assign(result.mPath.begin(), result.mPath.end());
+        mCell = cell;
+
+        if (mPath.empty())
+            buildPathByPathgridImpl(query.mStart, result.mEnd, pathgridGraph, std::back_inserter(mPath));
+
+        if (result.mStatus == DetourNavigator::Status::NavMeshNotFound && mPath.empty())
+            mPath.push_back(result.mEnd);
+
+        mConstructed = !mPath.empty();
+
+        return true;
     }
 }
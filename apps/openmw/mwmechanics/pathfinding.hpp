@@ -4,6 +4,8 @@
 #include <deque>
 #include <cassert>
 #include <iterator>
+#include <memory>
+#include <vector>
 
 #include <components/detournavigator/flags.hpp>
 #include <components/detournavigator/areatype.hpp>
@@ -11,6 +13,11 @@
 #include <components/esm/defs.hpp>
 #include <components/esm/loadpgrd.hpp>
 
+namespace DetourNavigator
+{
+    class PendingPath;
+}
+
 namespace MWWorld
 {
     class CellStore;
@@ -90,6 +97,7 @@ namespace MWMechanics
                 mConstructed = false;
                 mPath.clear();
                 mCell = nullptr;
+                mPendingPath = nullptr;
             }
 
             void buildStraightPath(const osg::Vec3f& endPoint);
@@ -114,14 +122,33 @@ namespace MWMechanics
                 const DetourNavigator::Flags flags, const DetourNavigator::AreaCosts& areaCosts, float endTolerance,
                 PathType pathType);
 
+            /// @brief Same as buildLimitedPath but the path over navmesh is found by the path query service.
+            /// @par The current path is kept until the result is taken by takePendingPath(), a new request replaces the
+            /// pending one. Falls back to buildLimitedPath when there is no service.
+            void requestLimitedPath(const MWWorld::ConstPtr& actor, const osg::Vec3f& startPoint, const osg::Vec3f& endPoint,
+                const MWWorld::CellStore* cell, const PathgridGraph& pathgridGraph, const osg::Vec3f& halfExtents,
+                const DetourNavigator::Flags flags, const DetourNavigator::AreaCosts& areaCosts, float endTolerance,
+                PathType pathType);
+
+            bool hasPendingPath() const
+            {
+                return mPendingPath != nullptr;
+            }
+
+            /// Replace the path by the result of requestLimitedPath if it is ready
+            /// @return true if the path was replaced
+            bool takePendingPath(const MWWorld::ConstPtr& actor, const MWWorld::CellStore* cell,
+                const PathgridGraph& pathgridGraph);
+
             /// Remove front point if exist and within tolerance
             void update(const osg::Vec3f& position, float pointTolerance, float destinationTolerance,
                         bool shortenIfAlmostStraight, bool canMoveByZ, const osg::Vec3f& halfExtents,
                         const DetourNavigator::Flags flags);
 
+            /// A path followed while a new one is pending is not completed, the actor has to wait for the new one
             bool checkPathCompleted() const
             {
-                return mConstructed && mPath.empty();
+                return mConstructed && mPath.empty() && mPendingPath == nullptr;
             }
 
             /// In radians
@@ -214,6 +241,9 @@ namespace MWMechanics
             std::deque<osg::Vec3f> mPath;
 
             const MWWorld::CellStore* mCell;
+            std::shared_ptr<const DetourNavigator::PendingPath> mPendingPath;
+            // reused to not allocate for each path built by pathgrid
+            std::vector<int> mPathgridPoints;
 
             void buildPathByPathgridImpl(const osg::Vec3f& startPoint, const osg::Vec3f& endPoint,
                 const PathgridGraph& pathgridGraph, std::back_insert_iterator<std::deque<osg::Vec3f>> out);
@@ -1,10 +1,9 @@
 #include "pathgrid.hpp"
 
-#include "../mwbase/world.hpp"
-#include "../mwbase/environment.hpp"
-
-#include "../mwworld/cellstore.hpp"
-#include "../mwworld/esmstore.hpp"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
 
 namespace
 {
@@ -49,16 +48,6 @@ namespace
 
 namespace MWMechanics
 {
-    PathgridGraph::PathgridGraph(const MWWorld::CellStore *cell)
-        : mCell(nullptr)
-        , mPathgrid(nullptr)
-        , mGraph(0)
-        , mIsGraphConstructed(false)
-        , mSCCId(0)
-        , mSCCIndex(0)
-    {
-        load(cell);
-    }
 
     /*
      * mGraph is populated with the cost of each allowed edge.
@@ -96,19 +85,14 @@ namespace MWMechanics
      *    +---------------->
      *      high cost
      */
-    bool PathgridGraph::load(const MWWorld::CellStore *cell)
+    PathgridGraph::PathgridGraph(const ESM::Pathgrid* pathgrid)
+        : mPathgrid(pathgrid)
+        , mGraph(0)
+        , mSCCId(0)
+        , mSCCIndex(0)
     {
-        if(!cell)
-            return false;
-
-        if(mIsGraphConstructed)
-            return true;
-
-        mCell = cell->getCell();
-        mPathgrid = MWBase::Environment::get().getWorld()->getStore().get<ESM::Pathgrid>().search(*cell->getCell());
         if(!mPathgrid)
-            return false;
-
+            return;
 
         mGraph.resize(mPathgrid->mPoints.size());
         for(int i = 0; i < static_cast<int> (mPathgrid->mEdges.size()); i++)
@@ -119,14 +103,16 @@ namespace MWMechanics
             // forward path of the edge
             neighbour.index = mPathgrid->mEdges[i].mV1;
             mGraph[mPathgrid->mEdges[i].mV0].edges.push_back(neighbour);
+            // the same edge seen from its destination, used to find routes to it
+            neighbour.index = mPathgrid->mEdges[i].mV0;
+            mGraph[mPathgrid->mEdges[i].mV1].reverseEdges.push_back(neighbour);
             // reverse path of the edge
             // NOTE: These are redundant, ESM already contains the required reverse paths
             //neighbour.index = mPathgrid->mEdges[i].mV0;
             //mGraph[mPathgrid->mEdges[i].mV1].edges.push_back(neighbour);
         }
         buildConnectedPoints();
-        mIsGraphConstructed = true;
-        return true;
+        mNextPoints.resize(mGraph.size());
     }
 
     const ESM::Pathgrid *PathgridGraph::getPathgrid() const
@@ -229,112 +215,78 @@ namespace MWMechanics
     }
 
     /*
-     * NOTE: Based on buildPath2(), please check git history if interested
-     *       Should consider using a 3rd party library version (e.g. boost)
-     *
-     * Find the shortest path to the target goal using a well known algorithm.
-     * Uses mGraph which has pre-computed costs for allowed edges.  It is assumed
-     * that mGraph is already constructed.
-     *
-     * Should be possible to make this MT safe.
+     * Find the shortest paths to the end point from all the points using
+     * Dijkstra's algorithm over reversed edges.  Uses mGraph which has
+     * pre-computed costs for allowed edges.  It is assumed that mGraph is
+     * already constructed.
      *
-     * Returns path which may be empty.  path contains pathgrid points in local
-     * cell coordinates (indoors) or world coordinates (external).
-     *
-     * Input params:
-     *   start, goal - pathgrid point indexes (for this cell)
+     * Pathgrids are small and static, so the result is kept for the following
+     * requests of the same end point.  Each path request then only walks
+     * through the next points.
      *
      * Variables:
-     *   openset - point indexes to be traversed, lowest cost at the front
-     *   closedset - point indexes already traversed
-     *   gScore - past accumulated costs vector indexed by point index
-     *   fScore - future estimated costs vector indexed by point index
-     *
-     * TODO: An intersting exercise might be to cache the paths created for a
-     *       start/goal pair.  To cache the results the paths need to be in
-     *       pathgrid points form (currently they are converted to world
-     *       coordinates).  Essentially trading speed w/ memory.
+     *   openset - point indexes to be traversed, lowest cost at the top
+     *   cost - accumulated costs to the end point indexed by point index
+     *   nextPoints - next point on the way to the end point indexed by point index
      */
-    std::deque<ESM::Pathgrid::Point> PathgridGraph::aStarSearch(const int start, const int goal) const
+    const std::vector<int>& PathgridGraph::getNextPoints(const int end) const
     {
-        std::deque<ESM::Pathgrid::Point> path;
-        if(!isPointConnected(start, goal))
-        {
-            return path; // there is no path, return an empty path
-        }
+        std::vector<int>& nextPoints = mNextPoints[end];
+        if (!nextPoints.empty())
+            return nextPoints;
 
-        int graphSize = static_cast<int> (mGraph.size());
-        std::vector<float> gScore (graphSize, -1);
-        std::vector<float> fScore (graphSize, -1);
-        std::vector<int> graphParent (graphSize, -1);
+        const std::size_t graphSize = mGraph.size();
+        nextPoints.resize(graphSize, -1);
+        std::vector<float> cost(graphSize, std::numeric_limits<float>::max());
 
-        // gScore & fScore keep costs for each pathgrid point in mPoints
-        gScore[start] = 0;
-        fScore[start] = costAStar(mPathgrid->mPoints[start], mPathgrid->mPoints[goal]);
+        using Entry = std::pair<float, int>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> openset;
 
-        std::list<int> openset;
-        std::list<int> closedset;
-        openset.push_back(start);
+        cost[end] = 0;
+        nextPoints[end] = end;
+        openset.emplace(0.0f, end);
 
-        int current = -1;
-
-        while(!openset.empty())
+        while (!openset.empty())
         {
-            current = openset.front(); // front has the lowest cost
-            openset.pop_front();
-
-            if(current == goal)
-                break;
+            const auto [currentCost, current] = openset.top();
+            openset.pop();
 
-            closedset.push_back(current); // remember we've been here
+            if (currentCost > cost[current])
+                continue; // already reached with lower cost
 
-            // check all edges for the current point index
-            for(int j = 0; j < static_cast<int> (mGraph[current].edges.size()); j++)
+            for (const ConnectedPoint& edge : mGraph[current].reverseEdges)
             {
-                if(std::find(closedset.begin(), closedset.end(), mGraph[current].edges[j].index) ==
-                   closedset.end())
-                {
-                    // not in closedset - i.e. have not traversed this edge destination
-                    int dest = mGraph[current].edges[j].index;
-                    float tentative_g = gScore[current] + mGraph[current].edges[j].cost;
-                    bool isInOpenSet = std::find(openset.begin(), openset.end(), dest) != openset.end();
-                    if(!isInOpenSet
-                        || tentative_g < gScore[dest])
-                    {
-                        graphParent[dest] = current;
-                        gScore[dest] = tentative_g;
-                        fScore[dest] = tentative_g + costAStar(mPathgrid->mPoints[dest],
-                                                               mPathgrid->mPoints[goal]);
-                        if(!isInOpenSet)
-                        {
-                            // add this edge to openset, lowest cost goes to the front
-                            // TODO: if this causes performance problems a hash table may help
-                            std::list<int>::iterator it = openset.begin();
-                            for(it = openset.begin(); it!= openset.end(); ++it)
-                            {
-                                if(fScore[*it] > fScore[dest])
-                                    break;
-                            }
-                            openset.insert(it, dest);
-                        }
-                    }
-                } // if in closedset, i.e. traversed this edge already, try the next edge
+                const float tentativeCost = currentCost + edge.cost;
+                if (tentativeCost >= cost[edge.index])
+                    continue;
+                cost[edge.index] = tentativeCost;
+                nextPoints[edge.index] = current;
+                openset.emplace(tentativeCost, edge.index);
             }
         }
 
-        if(current != goal)
-            return path; // for some reason couldn't build a path
+        return nextPoints;
+    }
+
+    void PathgridGraph::findPath(const int start, const int end, std::vector<int>& path) const
+    {
+        path.clear();
+
+        if (start == end || !isPointConnected(start, end))
+            return; // there is no path, return an empty path
 
-        // reconstruct path to return, using local coordinates
-        while(graphParent[current] != -1)
+        const std::vector<int>& nextPoints = getNextPoints(end);
+
+        // a path can not be longer than the number of points, the limit only guards against broken tables
+        for (int current = start; path.size() <= nextPoints.size(); current = nextPoints[current])
         {
-            path.push_front(mPathgrid->mPoints[current]);
-            current = graphParent[current];
+            if (current == -1)
+                break;
+            path.push_back(current);
+            if (current == end)
+                return;
         }
 
-        // add first node to path explicitly
-        path.push_front(mPathgrid->mPoints[start]);
-        return path;
+        path.clear(); // for some reason couldn't build a path
     }
 }
-
@@ -1,28 +1,17 @@
 #ifndef GAME_MWMECHANICS_PATHGRID_H
 #define GAME_MWMECHANICS_PATHGRID_H
 
-#include <deque>
+#include <vector>
 
 #include <components/esm/loadpgrd.hpp>
 
-namespace ESM
-{
-    struct Cell;
-}
-
-namespace MWWorld
-{
-    class CellStore;
-}
-
 namespace MWMechanics
 {
     class PathgridGraph
     {
         public:
-            PathgridGraph(const MWWorld::CellStore* cell);
-
-            bool load(const MWWorld::CellStore *cell);
+            /// @param pathgrid nullptr for a cell without pathgrid, otherwise has to outlive the graph
+            explicit PathgridGraph(const ESM::Pathgrid* pathgrid);
 
             const ESM::Pathgrid* getPathgrid() const;
 
@@ -34,15 +23,17 @@ namespace MWMechanics
             void getNeighbouringPoints(const int index, ESM::Pathgrid::PointList &nodes) const;
 
             // the input parameters are pathgrid point indexes
-            // the output list is in local (internal cells) or world (external
-            // cells) coordinates
+            // the output list contains pathgrid point indexes from start to end
+            // and is cleared when there is no path
+            //
+            // routes to each end point are computed once and then reused,
+            // so this is not thread safe
             //
             // NOTE: if start equals end an empty path is returned
-            std::deque<ESM::Pathgrid::Point> aStarSearch(const int start, const int end) const;
+            void findPath(const int start, const int end, std::vector<int>& path) const;
 
         private:
 
-            const ESM::Cell *mCell;
             const ESM::Pathgrid *mPathgrid;
 
             struct ConnectedPoint // edge
@@ -55,6 +46,7 @@ namespace MWMechanics
             {
                 int componentId;
                 std::vector<ConnectedPoint> edges; // neighbours
+                std::vector<ConnectedPoint> reverseEdges; // points having this one as a neighbour
             };
 
             // componentId is an integer indicating the groups of connected
@@ -67,7 +59,12 @@ namespace MWMechanics
             //   all other pathgrid points are the third set
             //
             std::vector<Node> mGraph;
-            bool mIsGraphConstructed;
+
+            // for each end point the next point on the shortest path from each
+            // point, -1 when there is no path; empty until the first request
+            mutable std::vector<std::vector<int>> mNextPoints;
+
+            const std::vector<int>& getNextPoints(const int end) const;
 
             // variables used to calculate connected components
             int mSCCId;
@@ -125,6 +125,7 @@ void Actor::updatePosition()
     mPositionOffset = osg::Vec3f();
     mStandingOnPtr = nullptr;
     mSkipSimulation = true;
+    wakeUp();
 }
 
 void Actor::setSimulationPosition(const osg::Vec3f& position)
@@ -175,6 +176,7 @@ void Actor::adjustPosition(const osg::Vec3f& offset)
 {
     std::scoped_lock lock(mPositionMutex);
     mPositionOffset += offset;
+    wakeUp();
 }
 
 void Actor::applyOffsetChange()
@@ -191,6 +193,8 @@ void Actor::applyOffsetChange()
 void Actor::setRotation(osg::Quat quat)
 {
     std::scoped_lock lock(mPositionMutex);
+    if (mRotation != quat)
+        wakeUp();
     mRotation = quat;
 }
 
@@ -212,6 +216,7 @@ void Actor::updateScale()
     scaleVec = osg::Vec3f(scale,scale,scale);
     mPtr.getClass().adjustScale(mPtr, scaleVec, true);
     mRenderingHalfExtents = osg::componentMultiply(mOriginalHalfExtents, scaleVec);
+    wakeUp();
 }
 
 osg::Vec3f Actor::getHalfExtents() const
@@ -4,6 +4,7 @@
 #include <memory>
 #include <mutex>
 
+#include "actorrest.hpp"
 #include "ptrholder.hpp"
 
 #include <LinearMath/btTransform.h>
@@ -158,6 +159,33 @@ namespace MWPhysics
 
         bool canMoveToWaterSurface(float waterlevel, const btCollisionWorld* world) const;
 
+        /**
+         * Returns true if the actor has been resting on the same object for a few simulation steps, so the movement
+         * solver can skip it until it is woken up.
+         */
+        bool isSleeping() const
+        {
+            return mRest.isSleeping();
+        }
+
+        /// Returns the object the actor is sleeping on, nullptr if it is not sleeping
+        const btCollisionObject* getSleepingOn() const
+        {
+            return mRest.getSleepingOn();
+        }
+
+        /// Makes the actor go through the whole simulation again on the next step
+        void wakeUp()
+        {
+            mRest.wakeUp();
+        }
+
+        /// Counts the simulation steps the actor spent resting on the given object, nullptr means it is not at rest
+        void updateRest(const btCollisionObject* standingOn)
+        {
+            mRest.update(standingOn);
+        }
+
     private:
         MWWorld::Ptr mStandingOnPtr;
         /// Removes then re-adds the collision object to the dynamics world
@@ -192,6 +220,7 @@ namespace MWPhysics
         osg::Vec3f mLastStuckPosition;
 
         osg::Vec3f mForce;
+        ActorRest mRest;
         bool mOnGround;
         bool mOnSlope;
         bool mInternalCollisionMode;
@@ -0,0 +1,23 @@
+#include "actorrest.hpp"
+
+namespace MWPhysics
+{
+    void ActorRest::wakeUp()
+    {
+        mSleeping = false;
+        mRestingOn = nullptr;
+        mRestFrames = 0;
+    }
+
+    void ActorRest::update(const btCollisionObject* standingOn)
+    {
+        if (standingOn == nullptr || standingOn != mRestingOn)
+        {
+            wakeUp();
+            mRestingOn = standingOn;
+            return;
+        }
+        if (!mSleeping && ++mRestFrames >= stepsBeforeSleeping)
+            mSleeping = true;
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef OPENMW_MWPHYSICS_ACTORREST_H
+#define OPENMW_MWPHYSICS_ACTORREST_H
+
+class btCollisionObject;
+
+namespace MWPhysics
+{
+    /// Tracks the simulation steps an actor spent resting on the same object, so the movement solver can skip it
+    /// once it is asleep. A sleeping actor is woken up when it moves or its surroundings change.
+    class ActorRest
+    {
+    public:
+        /// A few steps are needed to be sure that the actor has settled and is not about to slide or fall
+        static constexpr unsigned stepsBeforeSleeping = 3;
+
+        bool isSleeping() const
+        {
+            return mSleeping;
+        }
+
+        /// Returns the object the actor is sleeping on, nullptr if it is not sleeping
+        const btCollisionObject* getSleepingOn() const
+        {
+            return mSleeping ? mRestingOn : nullptr;
+        }
+
+        void wakeUp();
+
+        /// @param standingOn nullptr when the actor is not at rest
+        void update(const btCollisionObject* standingOn);
+
+    private:
+        const btCollisionObject* mRestingOn = nullptr;
+        unsigned mRestFrames = 0;
+        bool mSleeping = false;
+    };
+}
+
+#endif
@@ -0,0 +1,85 @@
+#include "cellstatics.hpp"
+#include "compoundchild.hpp"
+#include "mtphysics.hpp"
+#include "object.hpp"
+
+#include <components/resource/bulletshape.hpp>
+
+#include <BulletCollision/CollisionShapes/btCompoundShape.h>
+#include <BulletCollision/CollisionDispatch/btCollisionObject.h>
+
+#include <cassert>
+
+namespace MWPhysics
+{
+    CellStatics::CellStatics(PhysicsTaskScheduler* scheduler)
+        : mShape(std::make_unique<btCompoundShape>())
+        , mCollisionObject(std::make_unique<btCollisionObject>())
+        , mTaskScheduler(scheduler)
+        , mInWorld(false)
+    {
+        // Child shapes are placed in world space, hits on them have to be resolved with getObject() or findObject()
+        mCollisionObject->setCollisionShape(mShape.get());
+        mCollisionObject->setWorldTransform(btTransform::getIdentity());
+    }
+
+    CellStatics::~CellStatics()
+    {
+        if (mInWorld)
+            mTaskScheduler->removeCellStatics(mCollisionObject.get());
+    }
+
+    void CellStatics::add(Object& object)
+    {
+        assert(mChildIndices.find(&object) == mChildIndices.end());
+        const auto addChild = [&] (btCompoundShape& shape)
+        {
+            mChildIndices.emplace(&object, shape.getNumChildShapes());
+            mObjects.push_back(&object);
+            shape.addChildShape(object.getTransform(), object.getShapeInstance()->mCollisionShape.get());
+        };
+        if (mInWorld)
+            mTaskScheduler->updateCompoundShape(mCollisionObject.get(), addChild);
+        else
+        {
+            addChild(*mShape);
+            mTaskScheduler->addCellStatics(mCollisionObject.get(), this);
+            mInWorld = true;
+        }
+    }
+
+    void CellStatics::remove(const Object& object)
+    {
+        const auto found = mChildIndices.find(&object);
+        if (found == mChildIndices.end())
+            return;
+        const int index = found->second;
+        mChildIndices.erase(found);
+        // mObjects is read by getObject() and findObject() from the physics threads, so it is changed along with the shape.
+        // The bounds of the compound are not shrunk, the whole cell is usually unloaded soon after.
+        mTaskScheduler->updateCompoundShape(mCollisionObject.get(), [&] (btCompoundShape& shape)
+        {
+            // The last child takes the place of the removed one, same as in btCompoundShape
+            mObjects[index] = mObjects.back();
+            mObjects.pop_back();
+            shape.removeChildShapeByIndex(index);
+        });
+        if (index < static_cast<int>(mObjects.size()))
+            mChildIndices[mObjects[index]] = index;
+    }
+
+    Object* CellStatics::getObject(int childIndex) const
+    {
+        if (childIndex < 0 || childIndex >= static_cast<int>(mObjects.size()))
+            return nullptr;
+        return mObjects[childIndex];
+    }
+
+    Object* CellStatics::findObject(const btVector3& from, const btVector3& to) const
+    {
+        const int index = findCompoundChildIndex(*mShape, from, to);
+        if (index < 0)
+            return nullptr;
+        return mObjects[index];
+    }
+}
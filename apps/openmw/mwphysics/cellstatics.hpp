@@ -0,0 +1,54 @@
+#ifndef OPENMW_MWPHYSICS_CELLSTATICS_H
+#define OPENMW_MWPHYSICS_CELLSTATICS_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class btCollisionObject;
+class btCompoundShape;
+class btVector3;
+
+namespace MWPhysics
+{
+    class Object;
+    class PhysicsTaskScheduler;
+
+    /// @brief Static objects of a cell merged into one compound collision object.
+    /// @par The broadphase only sees the compound, so loading and unloading a cell does not insert and remove a proxy
+    /// per object. Hits on the compound are mapped back to the objects with getObject() and findObject(). The objects
+    /// keep their own collision object outside of the collision world, with the transform of their child shape.
+    class CellStatics
+    {
+    public:
+        explicit CellStatics(PhysicsTaskScheduler* scheduler);
+        ~CellStatics();
+
+        void add(Object& object);
+        void remove(const Object& object);
+
+        bool isEmpty() const { return mObjects.empty(); }
+
+        const btCollisionObject* getCollisionObject() const { return mCollisionObject.get(); }
+
+        /// @param childIndex as returned by getCompoundChildIndex() for a contact with the compound
+        Object* getObject(int childIndex) const;
+
+        /// @param from and to in world space, the segment crossing the surface at a ray or sweep hit point
+        /// @return the object whose shape the segment hits first
+        Object* findObject(const btVector3& from, const btVector3& to) const;
+
+    private:
+        std::unique_ptr<btCompoundShape> mShape;
+        std::unique_ptr<btCollisionObject> mCollisionObject;
+        std::vector<Object*> mObjects; // indexed by child shape
+        std::unordered_map<const Object*, int> mChildIndices;
+        PhysicsTaskScheduler* mTaskScheduler;
+        bool mInWorld;
+
+        CellStatics(const CellStatics&) = delete;
+        CellStatics& operator=(const CellStatics&) = delete;
+    };
+}
+
+#endif
@@ -0,0 +1,112 @@
+#include "compoundchild.hpp"
+
+#include <BulletCollision/BroadphaseCollision/btDbvt.h>
+#include <BulletCollision/CollisionDispatch/btCollisionObject.h>
+#include <BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h>
+#include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
+#include <BulletCollision/CollisionShapes/btCompoundShape.h>
+#include <LinearMath/btAabbUtil2.h>
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace MWPhysics
+{
+    namespace
+    {
+        struct CollectLeaves : btDbvt::ICollide
+        {
+            std::vector<int> mChildIndices;
+
+            void Process(const btDbvtNode* leaf) override
+            {
+                mChildIndices.push_back(leaf->dataAsInt);
+            }
+        };
+
+        std::vector<int> getChildIndices(const btCompoundShape& shape, const btVector3& min, const btVector3& max)
+        {
+            if (const btDbvt* tree = shape.getDynamicAabbTree())
+            {
+                CollectLeaves collect;
+                if (tree->m_root != nullptr)
+                    tree->collideTV(tree->m_root, btDbvtVolume::FromMM(min, max), collect);
+                return std::move(collect.mChildIndices);
+            }
+            std::vector<int> result;
+            for (int i = 0; i < shape.getNumChildShapes(); ++i)
+            {
+                btVector3 childMin;
+                btVector3 childMax;
+                shape.getChildShape(i)->getAabb(shape.getChildTransform(i), childMin, childMax);
+                if (TestAabbAgainstAabb2(min, max, childMin, childMax))
+                    result.push_back(i);
+            }
+            return result;
+        }
+
+        btScalar getVolume(const btCompoundShape& shape, int index)
+        {
+            btVector3 min;
+            btVector3 max;
+            shape.getChildShape(index)->getAabb(shape.getChildTransform(index), min, max);
+            const btVector3 lengths = max - min;
+            return lengths.x() * lengths.y() * lengths.z();
+        }
+    }
+
+    int getCompoundChildIndex(const btCollisionObjectWrapper& wrapper)
+    {
+        // The wrapper of the collision object itself has no parent, those of its compound children have it as parent
+        const btCollisionObjectWrapper* child = &wrapper;
+        while (child->m_parent != nullptr && child->m_parent->m_parent != nullptr)
+            child = child->m_parent;
+        if (child->m_parent == nullptr || child->m_parent->getCollisionShape()->getShapeType() != COMPOUND_SHAPE_PROXYTYPE)
+            return -1;
+        return child->m_index;
+    }
+
+    int findCompoundChildIndex(const btCompoundShape& shape, const btVector3& from, const btVector3& to)
+    {
+        btVector3 min = from;
+        min.setMin(to);
+        btVector3 max = from;
+        max.setMax(to);
+        const std::vector<int> candidates = getChildIndices(shape, min, max);
+        if (candidates.size() <= 1)
+            return candidates.empty() ? -1 : candidates.front();
+
+        const btTransform fromTransform(btQuaternion::getIdentity(), from);
+        const btTransform toTransform(btQuaternion::getIdentity(), to);
+        btCollisionObject collisionObject;
+        int result = -1;
+        btScalar minFraction = std::numeric_limits<btScalar>::max();
+        for (int index : candidates)
+        {
+            btCollisionWorld::ClosestRayResultCallback callback(from, to);
+            btCollisionWorld::rayTestSingle(fromTransform, toTransform, &collisionObject, shape.getChildShape(index),
+                                            shape.getChildTransform(index), callback);
+            if (callback.hasHit() && callback.m_closestHitFraction < minFraction)
+            {
+                minFraction = callback.m_closestHitFraction;
+                result = index;
+            }
+        }
+        if (result != -1)
+            return result;
+
+        // Points found by sweeps of wide shapes may be a bit off the surface
+        btScalar minVolume = std::numeric_limits<btScalar>::max();
+        for (int index : candidates)
+        {
+            const btScalar volume = getVolume(shape, index);
+            if (volume < minVolume)
+            {
+                minVolume = volume;
+                result = index;
+            }
+        }
+        return result;
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef OPENMW_MWPHYSICS_COMPOUNDCHILD_H
+#define OPENMW_MWPHYSICS_COMPOUNDCHILD_H
+
+class btCompoundShape;
+class btVector3;
+struct btCollisionObjectWrapper;
+
+namespace MWPhysics
+{
+    /// @brief Find the child of the compound shape of a collision object a contact callback was called for.
+    /// @par The part and index arguments of the callback and the manifold point only tell the innermost shape, for a
+    /// mesh child it is the triangle, so the child index is taken from the wrapper of the child shape instead.
+    /// @return index of the child or -1 when the wrapper is not for a part of a compound
+    int getCompoundChildIndex(const btCollisionObjectWrapper& wrapper);
+
+    /// @brief Find the child of a compound shape placed in world space hit first by the segment.
+    /// @par Ray and sweep results do not report the child of a compound the hit is on, so a short segment through the
+    /// hit point is tested against the children whose bounds it touches.
+    /// @return index of the child, the one with the smallest bounds when the segment misses them all, -1 when there
+    /// are no children nearby
+    int findCompoundChildIndex(const btCompoundShape& shape, const btVector3& from, const btVector3& to);
+}
+
+#endif
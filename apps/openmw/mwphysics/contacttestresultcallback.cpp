@@ -1,15 +1,19 @@
 #include "contacttestresultcallback.hpp"
 
 #include <BulletCollision/CollisionDispatch/btCollisionObject.h>
+#include <BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h>
 
 #include "components/misc/convert.hpp"
 
+#include "compoundchild.hpp"
+#include "mtphysics.hpp"
 #include "ptrholder.hpp"
 
 namespace MWPhysics
 {
-    ContactTestResultCallback::ContactTestResultCallback(const btCollisionObject* testedAgainst)
+    ContactTestResultCallback::ContactTestResultCallback(const btCollisionObject* testedAgainst, const PhysicsTaskScheduler& scheduler)
         : mTestedAgainst(testedAgainst)
+        , mScheduler(scheduler)
     {
     }
 
@@ -17,10 +21,10 @@ namespace MWPhysics
                                                         const btCollisionObjectWrapper* col0Wrap,int partId0,int index0,
                                                         const btCollisionObjectWrapper* col1Wrap,int partId1,int index1)
     {
-        const btCollisionObject* collisionObject = col0Wrap->m_collisionObject;
-        if (collisionObject == mTestedAgainst)
-            collisionObject = col1Wrap->m_collisionObject;
-        PtrHolder* holder = static_cast<PtrHolder*>(collisionObject->getUserPointer());
+        const btCollisionObjectWrapper* wrapper = col0Wrap;
+        if (wrapper->m_collisionObject == mTestedAgainst)
+            wrapper = col1Wrap;
+        PtrHolder* holder = static_cast<PtrHolder*>(mScheduler.getUserPointer(wrapper->m_collisionObject, getCompoundChildIndex(*wrapper)));
         if (holder)
             mResult.emplace_back(ContactPoint{holder->getPtr(), Misc::Convert::toOsg(cp.m_positionWorldOnB), Misc::Convert::toOsg(cp.m_normalWorldOnB)});
         return 0.f;
@@ -12,12 +12,15 @@ struct btCollisionObjectWrapper;
 
 namespace MWPhysics
 {
+    class PhysicsTaskScheduler;
+
     class ContactTestResultCallback : public btCollisionWorld::ContactResultCallback
     {
         const btCollisionObject* mTestedAgainst;
+        const PhysicsTaskScheduler& mScheduler;
 
     public:
-        ContactTestResultCallback(const btCollisionObject* testedAgainst);
+        ContactTestResultCallback(const btCollisionObject* testedAgainst, const PhysicsTaskScheduler& scheduler);
 
         btScalar addSingleResult(btManifoldPoint& cp,
                                          const btCollisionObjectWrapper* col0Wrap,int partId0,int index0,
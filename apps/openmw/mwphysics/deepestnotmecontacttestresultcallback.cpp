@@ -7,6 +7,7 @@
 #include "../mwworld/class.hpp"
 
 #include "collisiontype.hpp"
+#include "compoundchild.hpp"
 #include "ptrholder.hpp"
 
 namespace MWPhysics
@@ -37,6 +38,7 @@ namespace MWPhysics
                 mLeastDistSqr = distsqr;
                 mContactPoint = cp.getPositionWorldOnA();
                 mContactNormal = cp.m_normalWorldOnB;
+                mChildIndex = getCompoundChildIndex(*col1Wrap);
             }
         }
 
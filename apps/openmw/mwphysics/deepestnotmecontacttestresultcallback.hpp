@@ -21,6 +21,7 @@ namespace MWPhysics
         const btCollisionObject *mObject{nullptr};
         btVector3 mContactPoint{0,0,0};
         btVector3 mContactNormal{0,0,0};
+        int mChildIndex{-1}; // of mObject when it is a compound
         btScalar mLeastDistSqr;
 
         DeepestNotMeContactTestResultCallback(const btCollisionObject* me, const std::vector<const btCollisionObject*>& targets, const btVector3 &origin);
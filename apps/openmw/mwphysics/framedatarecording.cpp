@@ -0,0 +1,78 @@
+#include "framedatarecording.hpp"
+
+#include <components/misc/convert.hpp>
+
+#include "physicssystem.hpp"
+
+namespace MWPhysics
+{
+    BulletHelpers::PhysicsRecording::ActorFrame makeActorFrame(const ActorFrameData& data)
+    {
+        BulletHelpers::PhysicsRecording::ActorFrame result;
+        result.mObject = 0;
+        result.mPosition = Misc::Convert::toBullet(data.mPosition);
+        result.mInertia = Misc::Convert::toBullet(data.mInertia);
+        result.mMovement = Misc::Convert::toBullet(data.mMovement);
+        result.mLastStuckPosition = Misc::Convert::toBullet(data.mLastStuckPosition);
+        result.mRotationX = data.mRotation.x();
+        result.mRotationZ = data.mRotation.y();
+        result.mSwimLevel = data.mSwimLevel;
+        result.mSlowFall = data.mSlowFall;
+        result.mWaterlevel = data.mWaterlevel;
+        result.mHalfExtentsZ = data.mHalfExtentsZ;
+        result.mOldHeight = data.mOldHeight;
+        result.mStuckFrames = data.mStuckFrames;
+        result.mIsOnGround = data.mIsOnGround;
+        result.mIsOnSlope = data.mIsOnSlope;
+        result.mWalkingOnWater = data.mWalkingOnWater;
+        result.mInert = data.mInert;
+        result.mFlying = data.mFlying;
+        result.mWasOnGround = data.mWasOnGround;
+        result.mIsAquatic = data.mIsAquatic;
+        result.mWaterCollision = data.mWaterCollision;
+        result.mSkipCollisionDetection = data.mSkipCollisionDetection;
+        result.mSleeping = data.mSleeping;
+        return result;
+    }
+
+    BulletHelpers::PhysicsRecording::WorldFrame makeWorldFrame(const WorldFrameData& data)
+    {
+        return BulletHelpers::PhysicsRecording::WorldFrame {data.mIsInStorm, Misc::Convert::toBullet(data.mStormDirection),
+            data.mStormWalkMult};
+    }
+
+    ActorFrameData::ActorFrameData(const BulletHelpers::PhysicsRecording::ActorFrame& frame,
+            btCollisionObject* collisionObject, const btCollisionObject* standingOn)
+        : mPosition(Misc::Convert::toOsg(frame.mPosition))
+        , mInertia(Misc::Convert::toOsg(frame.mInertia))
+        , mStandingOn(standingOn)
+        , mIsOnGround(frame.mIsOnGround)
+        , mIsOnSlope(frame.mIsOnSlope)
+        , mWalkingOnWater(frame.mWalkingOnWater)
+        , mInert(frame.mInert)
+        , mCollisionObject(collisionObject)
+        , mSwimLevel(frame.mSwimLevel)
+        , mSlowFall(frame.mSlowFall)
+        , mRotation(frame.mRotationX, frame.mRotationZ)
+        , mMovement(Misc::Convert::toOsg(frame.mMovement))
+        , mLastStuckPosition(Misc::Convert::toOsg(frame.mLastStuckPosition))
+        , mWaterlevel(frame.mWaterlevel)
+        , mHalfExtentsZ(frame.mHalfExtentsZ)
+        , mOldHeight(frame.mOldHeight)
+        , mStuckFrames(frame.mStuckFrames)
+        , mFlying(frame.mFlying)
+        , mWasOnGround(frame.mWasOnGround)
+        , mIsAquatic(frame.mIsAquatic)
+        , mWaterCollision(frame.mWaterCollision)
+        , mSkipCollisionDetection(frame.mSkipCollisionDetection)
+        , mSleeping(frame.mSleeping)
+    {
+    }
+
+    WorldFrameData::WorldFrameData(const BulletHelpers::PhysicsRecording::WorldFrame& frame)
+        : mIsInStorm(frame.mIsInStorm)
+        , mStormDirection(Misc::Convert::toOsg(frame.mStormDirection))
+        , mStormWalkMult(frame.mStormWalkMult)
+    {
+    }
+}
@@ -0,0 +1,17 @@
+#ifndef OPENMW_MWPHYSICS_FRAMEDATARECORDING_H
+#define OPENMW_MWPHYSICS_FRAMEDATARECORDING_H
+
+#include <components/bullethelpers/physicsrecording.hpp>
+
+namespace MWPhysics
+{
+    struct ActorFrameData;
+    struct WorldFrameData;
+
+    /// @return the recorded state of the actor, the object ids are set by BulletHelpers::PhysicsRecorder
+    BulletHelpers::PhysicsRecording::ActorFrame makeActorFrame(const ActorFrameData& data);
+
+    BulletHelpers::PhysicsRecording::WorldFrame makeWorldFrame(const WorldFrameData& data);
+}
+
+#endif
@@ -2,6 +2,7 @@
 #include "mtphysics.hpp"
 
 #include <components/bullethelpers/heightfield.hpp>
+#include <components/bullethelpers/quantizedheightfield.hpp>
 
 #include <osg/Object>
 
@@ -13,40 +14,15 @@
 #include <type_traits>
 
 #if BT_BULLET_VERSION < 310
-// Older Bullet versions only support `btScalar` heightfields.
+// Older Bullet versions only support `btScalar` and integer heightfields.
 // Our heightfield data is `float`.
 //
-// These functions handle conversion from `float` to `double` when
-// `btScalar` is `double` (`BT_USE_DOUBLE_PRECISION`).
+// When `btScalar` is `double` (`BT_USE_DOUBLE_PRECISION`) the heights
+// are quantized to `short` instead of being copied as `double`, which
+// takes a quarter of the memory.
 namespace
 {
-    template <class T>
-    auto makeHeights(const T* heights, int verts)
-        -> std::enable_if_t<std::is_same<btScalar, T>::value, std::vector<btScalar>>
-    {
-        return {};
-    }
-
-    template <class T>
-    auto makeHeights(const T* heights, int verts)
-        -> std::enable_if_t<!std::is_same<btScalar, T>::value, std::vector<btScalar>>
-    {
-        return std::vector<btScalar>(heights, heights + static_cast<std::ptrdiff_t>(verts * verts));
-    }
-
-    template <class T>
-    auto getHeights(const T* floatHeights, const std::vector<btScalar>&)
-        -> std::enable_if_t<std::is_same<btScalar, T>::value, const btScalar*>
-    {
-        return floatHeights;
-    }
-
-    template <class T>
-    auto getHeights(const T*, const std::vector<btScalar>& btScalarHeights)
-        -> std::enable_if_t<!std::is_same<btScalar, T>::value, const btScalar*>
-    {
-        return btScalarHeights.data();
-    }
+    constexpr bool quantizeHeights = !std::is_same_v<btScalar, float>;
 }
 #endif
 
@@ -55,19 +31,31 @@ namespace MWPhysics
     HeightField::HeightField(const float* heights, int x, int y, int size, int verts, float minH, float maxH,
                              const osg::Object* holdObject, PhysicsTaskScheduler* scheduler)
         : mHoldObject(holdObject)
-#if BT_BULLET_VERSION < 310
-        , mHeights(makeHeights(heights, verts))
-#endif
         , mTaskScheduler(scheduler)
     {
 #if BT_BULLET_VERSION < 310
-        mShape = std::make_unique<btHeightfieldTerrainShape>(
-            verts, verts,
-            getHeights(heights, mHeights),
-            1,
-            minH, maxH, 2,
-            PHY_FLOAT, false
-        );
+        if constexpr (quantizeHeights)
+        {
+            mQuantizedHeights = BulletHelpers::quantizeHeightfield(heights, static_cast<std::size_t>(verts * verts),
+                                                                   minH, maxH);
+            mShape = std::make_unique<btHeightfieldTerrainShape>(
+                verts, verts,
+                mQuantizedHeights.mSamples.data(),
+                mQuantizedHeights.mScale,
+                mQuantizedHeights.mMinHeight, mQuantizedHeights.mMaxHeight, 2,
+                PHY_SHORT, false
+            );
+        }
+        else
+        {
+            mShape = std::make_unique<btHeightfieldTerrainShape>(
+                verts, verts,
+                heights,
+                1,
+                minH, maxH, 2,
+                PHY_FLOAT, false
+            );
+        }
 #else
         mShape = std::make_unique<btHeightfieldTerrainShape>(
             verts, verts, heights, minH, maxH, 2, false);
@@ -5,8 +5,9 @@
 
 #include <LinearMath/btScalar.h>
 
+#include <components/bullethelpers/quantizedheightfield.hpp>
+
 #include <memory>
-#include <vector>
 
 class btCollisionObject;
 class btHeightfieldTerrainShape;
@@ -36,7 +37,7 @@ namespace MWPhysics
         std::unique_ptr<btCollisionObject> mCollisionObject;
         osg::ref_ptr<const osg::Object> mHoldObject;
 #if BT_BULLET_VERSION < 310
-        std::vector<btScalar> mHeights;
+        BulletHelpers::QuantizedHeightfield mQuantizedHeights;
 #endif
 
         PhysicsTaskScheduler* mTaskScheduler;
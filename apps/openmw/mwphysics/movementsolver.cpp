@@ -5,23 +5,12 @@
 #include <BulletCollision/CollisionShapes/btCollisionShape.h>
 #include <BulletCollision/CollisionShapes/btConvexShape.h>
 
-#include <components/esm/loadgmst.hpp>
 #include <components/misc/convert.hpp>
 
-#include "../mwbase/world.hpp"
-#include "../mwbase/environment.hpp"
-
-#include "../mwworld/class.hpp"
-#include "../mwworld/esmstore.hpp"
-#include "../mwworld/refdata.hpp"
-
-#include "actor.hpp"
 #include "collisiontype.hpp"
 #include "constants.hpp"
 #include "contacttestwrapper.h"
 #include "physicssystem.hpp"
-#include "projectile.hpp"
-#include "projectileconvexcallback.hpp"
 #include "stepper.hpp"
 #include "trace.h"
 
@@ -80,44 +69,6 @@ namespace MWPhysics
         const btCollisionObject * mMe;
     };
 
-    osg::Vec3f MovementSolver::traceDown(const MWWorld::Ptr &ptr, const osg::Vec3f& position, Actor* actor, btCollisionWorld* collisionWorld, float maxHeight)
-    {
-        osg::Vec3f offset = actor->getCollisionObjectPosition() - ptr.getRefData().getPosition().asVec3();
-
-        ActorTracer tracer;
-        tracer.findGround(actor, position + offset, position + offset - osg::Vec3f(0,0,maxHeight), collisionWorld);
-        if (tracer.mFraction >= 1.0f)
-        {
-            actor->setOnGround(false);
-            return position;
-        }
-
-        actor->setOnGround(true);
-
-        // Check if we actually found a valid spawn point (use an infinitely thin ray this time).
-        // Required for some broken door destinations in Morrowind.esm, where the spawn point
-        // intersects with other geometry if the actor's base is taken into account
-        btVector3 from = Misc::Convert::toBullet(position);
-        btVector3 to = from - btVector3(0,0,maxHeight);
-
-        btCollisionWorld::ClosestRayResultCallback resultCallback1(from, to);
-        resultCallback1.m_collisionFilterGroup = 0xff;
-        resultCallback1.m_collisionFilterMask = CollisionType_World|CollisionType_HeightMap;
-
-        collisionWorld->rayTest(from, to, resultCallback1);
-
-        if (resultCallback1.hasHit() && ((Misc::Convert::toOsg(resultCallback1.m_hitPointWorld) - tracer.mEndPos + offset).length2() > 35*35
-            || !isWalkableSlope(tracer.mPlaneNormal)))
-        {
-            actor->setOnSlope(!isWalkableSlope(resultCallback1.m_hitNormalWorld));
-            return Misc::Convert::toOsg(resultCallback1.m_hitPointWorld) + osg::Vec3f(0.f, 0.f, sGroundOffset);
-        }
-
-        actor->setOnSlope(!isWalkableSlope(tracer.mPlaneNormal));
-
-        return tracer.mEndPos-offset + osg::Vec3f(0.f, 0.f, sGroundOffset);
-    }
-
     void MovementSolver::move(ActorFrameData& actor, float time, const btCollisionWorld* collisionWorld,
                                            const WorldFrameData& worldData)
     {
@@ -170,8 +121,7 @@ namespace MWPhysics
         {
             osg::Vec3f stormDirection = worldData.mStormDirection;
             float angleDegrees = osg::RadiansToDegrees(std::acos(stormDirection * velocity / (stormDirection.length() * velocity.length())));
-            static const float fStromWalkMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("fStromWalkMult")->mValue.getFloat();
-            velocity *= 1.f-(fStromWalkMult * (angleDegrees/180.f));
+            velocity *= 1.f-(worldData.mStormWalkMult * (angleDegrees/180.f));
         }
 
         Stepper stepper(collisionWorld, actor.mCollisionObject);
@@ -401,29 +351,6 @@ namespace MWPhysics
         actor.mPosition.z() -= actor.mHalfExtentsZ; // vanilla-accurate
     }
 
-    void MovementSolver::move(ProjectileFrameData& projectile, float time, const btCollisionWorld* collisionWorld)
-    {
-        btVector3 btFrom = Misc::Convert::toBullet(projectile.mPosition);
-        btVector3 btTo = Misc::Convert::toBullet(projectile.mPosition + projectile.mMovement * time);
-
-        if (btFrom == btTo)
-            return;
-
-        ProjectileConvexCallback resultCallback(projectile.mCaster, projectile.mCollisionObject, btFrom, btTo, projectile.mProjectile);
-        resultCallback.m_collisionFilterMask = 0xff;
-        resultCallback.m_collisionFilterGroup = CollisionType_Projectile;
-
-        const btQuaternion btrot = btQuaternion::getIdentity();
-        btTransform from_ (btrot, btFrom);
-        btTransform to_ (btrot, btTo);
-
-        const btCollisionShape* shape = projectile.mCollisionObject->getCollisionShape();
-        assert(shape->isConvex());
-        collisionWorld->convexSweepTest(static_cast<const btConvexShape*>(shape), from_, to_, resultCallback);
-
-        projectile.mPosition = Misc::Convert::toOsg(projectile.mProjectile->isActive() ? btTo : resultCallback.m_hitPointWorld);
-    }
-
     btVector3 addMarginToDelta(btVector3 delta)
     {
         if(delta.length2() == 0.0)
@@ -5,15 +5,10 @@
 
 #include <components/misc/constants.hpp>
 
-#include "../mwworld/ptr.hpp"
+#include <cmath>
 
 class btCollisionWorld;
 
-namespace MWWorld
-{
-    class Ptr;
-}
-
 namespace MWPhysics
 {
     /// Vector projection
@@ -35,17 +30,15 @@ namespace MWPhysics
         return (normal.z() > sMaxSlopeCos);
     }
 
-    class Actor;
     struct ActorFrameData;
-    struct ProjectileFrameData;
     struct WorldFrameData;
 
+    /// Moves actors using only their frame data and the collision world, so a recorded simulation can be replayed
+    /// without the game
     class MovementSolver
     {
     public:
-        static osg::Vec3f traceDown(const MWWorld::Ptr &ptr, const osg::Vec3f& position, Actor* actor, btCollisionWorld* collisionWorld, float maxHeight);
         static void move(ActorFrameData& actor, float time, const btCollisionWorld* collisionWorld, const WorldFrameData& worldData);
-        static void move(ProjectileFrameData& projectile, float time, const btCollisionWorld* collisionWorld);
         static void unstuck(ActorFrameData& actor, const btCollisionWorld* collisionWorld);
     };
 }
@@ -1,10 +1,13 @@
 #include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
 #include <BulletCollision/CollisionShapes/btCollisionShape.h>
+#include <BulletCollision/CollisionShapes/btCompoundShape.h>
+#include <BulletCollision/CollisionShapes/btConvexShape.h>
+#include <BulletCollision/CollisionShapes/btSphereShape.h>
 
 #include <osg/Stats>
 
+#include "components/bullethelpers/physicsrecording.hpp"
 #include "components/debug/debuglog.hpp"
-#include <components/misc/barrier.hpp>
 #include "components/misc/convert.hpp"
 #include "components/settings/settings.hpp"
 #include "../mwmechanics/actorutil.hpp"
@@ -13,12 +16,17 @@
 #include "../mwworld/class.hpp"
 
 #include "actor.hpp"
+#include "cellstatics.hpp"
+#include "closestnotmerayresultcallback.hpp"
+#include "constants.hpp"
 #include "contacttestwrapper.h"
+#include "framedatarecording.hpp"
 #include "movementsolver.hpp"
 #include "mtphysics.hpp"
 #include "object.hpp"
 #include "physicssystem.hpp"
 #include "projectile.hpp"
+#include "projectileconvexcallback.hpp"
 
 namespace
 {
@@ -105,6 +113,38 @@ namespace
         return actorData.mPosition.z() < actorData.mSwimLevel;
     }
 
+    // Whether nothing but a change of its surroundings could move the actor. Actors floating on top of other actors
+    // are not on ground, so they never sleep: nothing would wake them up when the actor below moves.
+    bool canSleep(const MWPhysics::ActorFrameData& actorData)
+    {
+        return !actorData.mSkipCollisionDetection && !actorData.mFlying && !actorData.mWaterCollision
+            && actorData.mIsOnGround && !actorData.mIsOnSlope && actorData.mStuckFrames == 0
+            && actorData.mMovement.length2() == 0 && actorData.mInertia.length2() == 0 && !isUnderWater(actorData);
+    }
+
+    void moveProjectile(MWPhysics::ProjectileFrameData& projectile, float time, const btCollisionWorld* collisionWorld)
+    {
+        btVector3 btFrom = Misc::Convert::toBullet(projectile.mPosition);
+        btVector3 btTo = Misc::Convert::toBullet(projectile.mPosition + projectile.mMovement * time);
+
+        if (btFrom == btTo)
+            return;
+
+        MWPhysics::ProjectileConvexCallback resultCallback(projectile.mCaster, projectile.mCollisionObject, btFrom, btTo, projectile.mProjectile);
+        resultCallback.m_collisionFilterMask = 0xff;
+        resultCallback.m_collisionFilterGroup = MWPhysics::CollisionType_Projectile;
+
+        const btQuaternion btrot = btQuaternion::getIdentity();
+        btTransform from_ (btrot, btFrom);
+        btTransform to_ (btrot, btTo);
+
+        const btCollisionShape* shape = projectile.mCollisionObject->getCollisionShape();
+        assert(shape->isConvex());
+        collisionWorld->convexSweepTest(static_cast<const btConvexShape*>(shape), from_, to_, resultCallback);
+
+        projectile.mPosition = Misc::Convert::toOsg(projectile.mProjectile->isActive() ? btTo : resultCallback.m_hitPointWorld);
+    }
+
     osg::Vec3f interpolateMovements(const MWPhysics::PtrHolder& ptr, float timeAccum, float physicsDt)
     {
         const float interpolationFactor = std::clamp(timeAccum / physicsDt, 0.0f, 1.0f);
@@ -116,6 +156,7 @@ namespace
         struct InitPosition
         {
             const btCollisionWorld* mCollisionWorld;
+            const bool mActorSleeping;
             void operator()(MWPhysics::ActorSimulation& sim) const
             {
                 auto& [actor, frameData] = sim;
@@ -134,6 +175,11 @@ namespace
                 frameData.mInertia = actor->getInertialForce();
                 frameData.mStuckFrames = actor->getStuckFrames();
                 frameData.mLastStuckPosition = actor->getLastStuckPosition();
+                if (!mActorSleeping || !canSleep(frameData))
+                    actor->wakeUp();
+                frameData.mSleeping = actor->isSleeping();
+                if (frameData.mSleeping)
+                    frameData.mStandingOn = actor->getSleepingOn();
             }
             void operator()(MWPhysics::ProjectileSimulation& sim) const
             {
@@ -145,7 +191,8 @@ namespace
             btCollisionWorld* mCollisionWorld;
             void operator()(MWPhysics::ActorSimulation& sim) const
             {
-                MWPhysics::MovementSolver::unstuck(sim.second, mCollisionWorld);
+                if (!sim.second.mSleeping)
+                    MWPhysics::MovementSolver::unstuck(sim.second, mCollisionWorld);
             }
             void operator()(MWPhysics::ProjectileSimulation& sim) const
             {
@@ -181,11 +228,12 @@ namespace
             const MWPhysics::WorldFrameData& mWorldFrameData;
             void operator()(MWPhysics::ActorSimulation& sim) const
             {
-                MWPhysics::MovementSolver::move(sim.second, mPhysicsDt, mCollisionWorld, mWorldFrameData);
+                if (!sim.second.mSleeping)
+                    MWPhysics::MovementSolver::move(sim.second, mPhysicsDt, mCollisionWorld, mWorldFrameData);
             }
             void operator()(MWPhysics::ProjectileSimulation& sim) const
             {
-                MWPhysics::MovementSolver::move(sim.second, mPhysicsDt, mCollisionWorld);
+                moveProjectile(sim.second, mPhysicsDt, mCollisionWorld);
             }
         };
 
@@ -195,6 +243,7 @@ namespace
             const float mTimeAccum;
             const float mPhysicsDt;
             const MWPhysics::PhysicsTaskScheduler* scheduler;
+            const bool mActorSleeping;
             void operator()(MWPhysics::ActorSimulation& sim) const
             {
                 auto& [actor, frameData] = sim;
@@ -215,7 +264,9 @@ namespace
                 if (mAdvanceSimulation)
                 {
                     MWWorld::Ptr standingOn;
-                    auto* ptrHolder = static_cast<MWPhysics::PtrHolder*>(scheduler->getUserPointer(frameData.mStandingOn));
+                    const btVector3 up(0, 0, 1);
+                    const btVector3 groundPoint = Misc::Convert::toBullet(frameData.mPosition) - up * MWPhysics::sGroundOffset;
+                    auto* ptrHolder = static_cast<MWPhysics::PtrHolder*>(scheduler->getUserPointer(frameData.mStandingOn, groundPoint, up));
                     if (ptrHolder)
                         standingOn = ptrHolder->getPtr();
                     actor->setStandingOnPtr(standingOn);
@@ -225,6 +276,9 @@ namespace
                     actor->setOnSlope(frameData.mIsOnSlope);
                     actor->setWalkingOnWater(frameData.mWalkingOnWater);
                     actor->setInertialForce(frameData.mInertia);
+                    const bool atRest = frameData.mSleeping || (mActorSleeping && canSleep(frameData)
+                        && actor->getPosition() == actor->getPreviousPosition());
+                    actor->updateRest(atRest ? frameData.mStandingOn : nullptr);
                 }
             }
             void operator()(MWPhysics::ProjectileSimulation& sim) const
@@ -264,14 +318,12 @@ namespace MWPhysics
           , mCollisionWorld(collisionWorld)
           , mDebugDrawer(debugDrawer)
           , mNumThreads(Config::computeNumThreads())
-          , mNumJobs(0)
           , mRemainingSteps(0)
           , mLOSCacheExpiry(Settings::Manager::getInt("lineofsight keep inactive cache", "Physics"))
-          , mFrameCounter(0)
           , mAdvanceSimulation(false)
-          , mQuit(false)
-          , mNextJob(0)
+          , mActorSleeping(Settings::Manager::getBool("actor sleeping", "Physics"))
           , mNextLOS(0)
+          , mJobPool(std::make_shared<Misc::JobPool>(mNumThreads))
           , mFrameNumber(0)
           , mTimer(osg::Timer::instance())
           , mPrevStepCount(1)
@@ -282,36 +334,16 @@ namespace MWPhysics
           , mTimeBegin(0)
           , mTimeEnd(0)
           , mFrameStart(0)
+          , mStepStart(0)
     {
-        if (mNumThreads >= 1)
-        {
-            for (int i = 0; i < mNumThreads; ++i)
-                mThreads.emplace_back([&] { worker(); } );
-        }
-        else
-        {
+        if (mNumThreads == 0)
             mLOSCacheExpiry = 0;
-        }
-
-        mPreStepBarrier = std::make_unique<Misc::Barrier>(mNumThreads);
-
-        mPostStepBarrier = std::make_unique<Misc::Barrier>(mNumThreads);
-
-        mPostSimBarrier = std::make_unique<Misc::Barrier>(mNumThreads);
     }
 
     PhysicsTaskScheduler::~PhysicsTaskScheduler()
     {
         waitForWorkers();
-        {
-            MaybeExclusiveLock lock(mSimulationMutex, mNumThreads);
-            mQuit = true;
-            mNumJobs = 0;
-            mRemainingSteps = 0;
-            mHasJob.notify_all();
-        }
-        for (auto& thread : mThreads)
-            thread.join();
+        waitForRayQueries();
     }
 
     std::tuple<int, float> PhysicsTaskScheduler::calculateStepConfig(float timeAccum) const
@@ -362,12 +394,9 @@ namespace MWPhysics
 
     void PhysicsTaskScheduler::applyQueuedMovements(float & timeAccum, std::vector<Simulation>&& simulations, osg::Timer_t frameStart, unsigned int frameNumber, osg::Stats& stats)
     {
-        waitForWorkers();
-
         // This function run in the main thread.
-        // While the mSimulationMutex is held, background physics threads can't run.
-
-        MaybeExclusiveLock lock(mSimulationMutex, mNumThreads);
+        // Jobs of the previous frame read and write the simulations, so they must be done before these are touched.
+        waitForWorkers();
 
         double timeStart = mTimer->tick();
 
@@ -385,7 +414,7 @@ namespace MWPhysics
         timeAccum -= numSteps*newDelta;
 
         // init
-        const Visitors::InitPosition vis{mCollisionWorld};
+        const Visitors::InitPosition vis{mCollisionWorld, mActorSleeping};
         for (auto& sim : simulations)
         {
             std::visit(vis, sim);
@@ -396,10 +425,7 @@ namespace MWPhysics
         mPhysicsDt = newDelta;
         mSimulations = std::move(simulations);
         mAdvanceSimulation = (mRemainingSteps != 0);
-        ++mFrameCounter;
-        mNumJobs = mSimulations.size();
         mNextLOS.store(0, std::memory_order_relaxed);
-        mNextJob.store(0, std::memory_order_release);
 
         if (mAdvanceSimulation)
             mWorldFrameData = std::make_unique<WorldFrameData>();
@@ -410,6 +436,7 @@ namespace MWPhysics
         if (mNumThreads == 0)
         {
             doSimulation();
+            waitForWorkers();
             syncWithMainThread();
             if(mAdvanceSimulation)
                 mBudget.update(mTimer->delta_s(timeStart, mTimer->tick()), numSteps, mBudgetCursor);
@@ -417,7 +444,7 @@ namespace MWPhysics
         }
 
         mAsyncStartTime = mTimer->tick();
-        mHasJob.notify_all();
+        doSimulation();
         if (mAdvanceSimulation)
             mBudget.update(mTimer->delta_s(timeStart, mTimer->tick()), 1, mBudgetCursor);
     }
@@ -425,7 +452,6 @@ namespace MWPhysics
     void PhysicsTaskScheduler::resetSimulation(const ActorMap& actors)
     {
         waitForWorkers();
-        MaybeExclusiveLock lock(mSimulationMutex, mNumThreads);
         mBudget.reset(mDefaultPhysicsDt);
         mAsyncBudget.reset(0.0f);
         mSimulations.clear();
@@ -436,6 +462,91 @@ namespace MWPhysics
         }
     }
 
+    void PhysicsTaskScheduler::startRayQueries(std::vector<RayQueryTask>&& queries)
+    {
+        constexpr std::size_t queriesPerJob = 16;
+
+        waitForRayQueries();
+        mRunningRayQueries = std::move(queries);
+        mRayQueryGraph = std::make_unique<Misc::JobGraph>();
+        for (std::size_t begin = 0; begin < mRunningRayQueries.size(); begin += queriesPerJob)
+        {
+            const std::size_t end = std::min(begin + queriesPerJob, mRunningRayQueries.size());
+            mRayQueryGraph->add([this, begin, end]
+            {
+                MaybeLock lockColWorld(mCollisionWorldMutex, mNumThreads);
+                for (std::size_t i = begin; i < end; ++i)
+                    runRayQuery(mRunningRayQueries[i]);
+            });
+        }
+        mRayQueryGraph->start(*mJobPool);
+    }
+
+    void PhysicsTaskScheduler::waitForRayQueries()
+    {
+        if (mRayQueryGraph == nullptr)
+            return;
+        mRayQueryGraph->wait();
+        mRayQueryGraph = nullptr;
+        mFinishedRayQueries.insert(mFinishedRayQueries.end(), mRunningRayQueries.begin(), mRunningRayQueries.end());
+        mRunningRayQueries.clear();
+    }
+
+    std::vector<RayQueryTask> PhysicsTaskScheduler::takeRayQueries()
+    {
+        waitForRayQueries();
+        return std::exchange(mFinishedRayQueries, {});
+    }
+
+    void PhysicsTaskScheduler::runRayQuery(RayQueryTask& query) const
+    {
+        const btVector3 from = Misc::Convert::toBullet(query.mFrom);
+        const btVector3 to = Misc::Convert::toBullet(query.mTo);
+        if (query.mRadius > 0)
+        {
+            btCollisionWorld::ClosestConvexResultCallback callback(from, to);
+            callback.m_collisionFilterGroup = query.mGroup;
+            callback.m_collisionFilterMask = query.mMask;
+            const btSphereShape shape(query.mRadius);
+            const btQuaternion rotation = btQuaternion::getIdentity();
+            mCollisionWorld->convexSweepTest(&shape, btTransform(rotation, from), btTransform(rotation, to), callback);
+            query.mHit = callback.hasHit();
+            if (query.mHit)
+            {
+                query.mHitPos = Misc::Convert::toOsg(callback.m_hitPointWorld);
+                query.mHitNormal = Misc::Convert::toOsg(callback.m_hitNormalWorld);
+                query.mHitObject = getPtrHolder(callback.m_hitCollisionObject, callback.m_hitPointWorld, callback.m_hitNormalWorld);
+            }
+            return;
+        }
+
+        if (from == to)
+            return;
+        // The ignored holder is not locked, a physics thread must not keep an object alive. Objects are removed from
+        // the collision world before their collision object is destroyed, so while the world is locked the collision
+        // object of a holder that has not expired yet can't be replaced by another one at the same address.
+        const btCollisionObject* ignore = query.mIgnore.expired() ? nullptr : query.mIgnoreObject;
+        ClosestNotMeRayResultCallback callback(ignore, {}, from, to);
+        callback.m_collisionFilterGroup = query.mGroup;
+        callback.m_collisionFilterMask = query.mMask;
+        mCollisionWorld->rayTest(from, to, callback);
+        query.mHit = callback.hasHit();
+        if (query.mHit)
+        {
+            query.mHitPos = Misc::Convert::toOsg(callback.m_hitPointWorld);
+            query.mHitNormal = Misc::Convert::toOsg(callback.m_hitNormalWorld);
+            query.mHitObject = getPtrHolder(callback.m_collisionObject, callback.m_hitPointWorld, callback.m_hitNormalWorld);
+        }
+    }
+
+    std::weak_ptr<PtrHolder> PhysicsTaskScheduler::getPtrHolder(const btCollisionObject* object, const btVector3& hitPoint, const btVector3& hitNormal) const
+    {
+        // Must be called with the collision world locked, the holder may be destroyed as soon as it is unlocked
+        if (auto* ptrHolder = static_cast<PtrHolder*>(getUserPointer(object, hitPoint, hitNormal)))
+            return ptrHolder->weak_from_this();
+        return {};
+    }
+
     void PhysicsTaskScheduler::rayTest(const btVector3& rayFromWorld, const btVector3& rayToWorld, btCollisionWorld::RayResultCallback& resultCallback) const
     {
         MaybeLock lock(mCollisionWorldMutex, mNumThreads);
@@ -454,6 +565,12 @@ namespace MWPhysics
         ContactTestWrapper::contactTest(mCollisionWorld, colObj, resultCallback);
     }
 
+    void PhysicsTaskScheduler::aabbTest(const btVector3& aabbMin, const btVector3& aabbMax, btBroadphaseAabbCallback& callback)
+    {
+        MaybeSharedLock lock(mCollisionWorldMutex, mNumThreads);
+        mCollisionWorld->getBroadphase()->aabbTest(aabbMin, aabbMax, callback);
+    }
+
     std::optional<btVector3> PhysicsTaskScheduler::getHitPoint(const btTransform& from, btCollisionObject* target)
     {
         MaybeLock lock(mCollisionWorldMutex, mNumThreads);
@@ -491,15 +608,15 @@ namespace MWPhysics
 
     void PhysicsTaskScheduler::addCollisionObject(btCollisionObject* collisionObject, int collisionFilterGroup, int collisionFilterMask)
     {
-        mCollisionObjects.insert(collisionObject);
         MaybeExclusiveLock lock(mCollisionWorldMutex, mNumThreads);
+        mCollisionObjects.insert(collisionObject);
         mCollisionWorld->addCollisionObject(collisionObject, collisionFilterGroup, collisionFilterMask);
     }
 
     void PhysicsTaskScheduler::removeCollisionObject(btCollisionObject* collisionObject)
     {
-        mCollisionObjects.erase(collisionObject);
         MaybeExclusiveLock lock(mCollisionWorldMutex, mNumThreads);
+        mCollisionObjects.erase(collisionObject);
         mCollisionWorld->removeCollisionObject(collisionObject);
     }
 
@@ -579,22 +696,6 @@ namespace MWPhysics
         }
     }
 
-    void PhysicsTaskScheduler::worker()
-    {
-        std::size_t lastFrame = 0;
-        std::shared_lock lock(mSimulationMutex);
-        while (!mQuit)
-        {
-            if (lastFrame == mFrameCounter)
-            {
-                mHasJob.wait(lock, [&] { return mQuit || lastFrame != mFrameCounter; });
-                lastFrame = mFrameCounter;
-            }
-
-            doSimulation();
-        }
-    }
-
     void PhysicsTaskScheduler::updateActorsPositions()
     {
         const Visitors::UpdatePosition vis{mCollisionWorld};
@@ -622,22 +723,71 @@ namespace MWPhysics
 
     void PhysicsTaskScheduler::doSimulation()
     {
-        while (mRemainingSteps)
+        mStepTimes.clear();
+        mFrameGraph = &getFrameGraph(mRemainingSteps);
+        mFrameGraph->start(*mJobPool);
+    }
+
+    Misc::JobGraph& PhysicsTaskScheduler::getFrameGraph(int steps)
+    {
+        if (static_cast<std::size_t>(steps) >= mFrameGraphs.size())
+            mFrameGraphs.resize(steps + 1);
+        std::unique_ptr<Misc::JobGraph>& result = mFrameGraphs[steps];
+        if (result != nullptr)
+            return *result;
+
+        // The steps are separated by barriers: every sweep of a step has to see the other actors where the previous
+        // step left them, and their collision objects can't be moved while the sweeps read them. Unsticking actors
+        // and updating positions change the collision world, so they run alone. The simulations of a step are moved
+        // independently of each other, taken one by one by as many jobs as there are threads, and a thread done with
+        // its share takes other jobs instead of waiting.
+        result = std::make_unique<Misc::JobGraph>();
+        Misc::JobGraph& graph = *result;
+        std::optional<Misc::JobGraph::Id> lastStep;
+        for (int step = 0; step < steps; ++step)
         {
-            mPreStepBarrier->wait([this] { afterPreStep(); });
-            int job = 0;
-            const Visitors::Move vis{mPhysicsDt, mCollisionWorld, *mWorldFrameData};
-            while ((job = mNextJob.fetch_add(1, std::memory_order_relaxed)) < mNumJobs)
+            const Misc::JobGraph::Id preStep = graph.add([this] { afterPreStep(); });
+            if (lastStep.has_value())
+                graph.addDependency(preStep, *lastStep);
+            const Misc::JobGraph::Id postStep = graph.add([this] { afterPostStep(); });
+            graph.addDependency(postStep, preStep);
+            for (int i = 0; i < std::max(1, mNumThreads); ++i)
             {
-                MaybeLock lockColWorld(mCollisionWorldMutex, mNumThreads);
-                std::visit(vis, mSimulations[job]);
+                const Misc::JobGraph::Id move = graph.add([this] { moveSimulations(); });
+                graph.addDependency(move, preStep);
+                graph.addDependency(postStep, move);
             }
+            lastStep = postStep;
+        }
 
-            mPostStepBarrier->wait([this] { afterPostStep(); });
+        std::vector<Misc::JobGraph::Id> refreshJobs;
+        for (int i = 0; i < std::max(1, mNumThreads); ++i)
+        {
+            const Misc::JobGraph::Id refresh = graph.add([this] { refreshLOSCache(); });
+            if (lastStep.has_value())
+                graph.addDependency(refresh, *lastStep);
+            refreshJobs.push_back(refresh);
         }
 
-        refreshLOSCache();
-        mPostSimBarrier->wait([this] { afterPostSim(); });
+        const Misc::JobGraph::Id postSim = graph.add([this] { afterPostSim(); });
+        for (const Misc::JobGraph::Id job : refreshJobs)
+            graph.addDependency(postSim, job);
+
+        return graph;
+    }
+
+    void PhysicsTaskScheduler::moveSimulations()
+    {
+        for (std::size_t i = mNextSimulation.fetch_add(1, std::memory_order_relaxed); i < mSimulations.size();
+             i = mNextSimulation.fetch_add(1, std::memory_order_relaxed))
+            moveSimulation(i);
+    }
+
+    void PhysicsTaskScheduler::moveSimulation(std::size_t index)
+    {
+        const Visitors::Move vis{mPhysicsDt, mCollisionWorld, *mWorldFrameData};
+        MaybeLock lockColWorld(mCollisionWorldMutex, mNumThreads);
+        std::visit(vis, mSimulations[index]);
     }
 
     void PhysicsTaskScheduler::updateStats(osg::Timer_t frameStart, unsigned int frameNumber, osg::Stats& stats)
@@ -649,6 +799,9 @@ namespace MWPhysics
             stats.setAttribute(mFrameNumber, "physicsworker_time_begin", mTimer->delta_s(mFrameStart, mTimeBegin));
             stats.setAttribute(mFrameNumber, "physicsworker_time_taken", mTimer->delta_s(mTimeBegin, mTimeEnd));
             stats.setAttribute(mFrameNumber, "physicsworker_time_end", mTimer->delta_s(mFrameStart, mTimeEnd));
+            stats.setAttribute(mFrameNumber, "physicsworker_steps", mStepTimes.size());
+            if (!mStepTimes.empty())
+                stats.setAttribute(mFrameNumber, "physicsworker_step_time", *std::max_element(mStepTimes.begin(), mStepTimes.end()));
         }
         mFrameStart = frameStart;
         mTimeBegin = mTimer->tick();
@@ -669,19 +822,82 @@ namespace MWPhysics
         return (*it)->getUserPointer();
     }
 
+    void* PhysicsTaskScheduler::getUserPointer(const btCollisionObject* object, const btVector3& hitPoint, const btVector3& hitNormal) const
+    {
+        const auto statics = mCellStatics.find(object);
+        if (statics == mCellStatics.end())
+            return getUserPointer(object);
+        // Hit points may lie slightly off the surface
+        static constexpr btScalar tolerance = 1;
+        return statics->second->findObject(hitPoint + hitNormal * tolerance, hitPoint - hitNormal * tolerance);
+    }
+
+    void* PhysicsTaskScheduler::getUserPointer(const btCollisionObject* object, int childIndex) const
+    {
+        const auto statics = mCellStatics.find(object);
+        if (statics == mCellStatics.end())
+            return getUserPointer(object);
+        return statics->second->getObject(childIndex);
+    }
+
+    void PhysicsTaskScheduler::addCellStatics(btCollisionObject* collisionObject, const CellStatics* statics)
+    {
+        MaybeExclusiveLock lock(mCollisionWorldMutex, mNumThreads);
+        mCellStatics.emplace(collisionObject, statics);
+        mCollisionObjects.insert(collisionObject);
+        mCollisionWorld->addCollisionObject(collisionObject, CollisionType_World, CollisionType_Actor|CollisionType_HeightMap|CollisionType_Projectile);
+    }
+
+    void PhysicsTaskScheduler::removeCellStatics(btCollisionObject* collisionObject)
+    {
+        MaybeExclusiveLock lock(mCollisionWorldMutex, mNumThreads);
+        mCellStatics.erase(collisionObject);
+        mCollisionObjects.erase(collisionObject);
+        mCollisionWorld->removeCollisionObject(collisionObject);
+    }
+
+    void PhysicsTaskScheduler::updateCompoundShape(btCollisionObject* collisionObject, const std::function<void(btCompoundShape&)>& change)
+    {
+        MaybeExclusiveLock lock(mCollisionWorldMutex, mNumThreads);
+        change(*static_cast<btCompoundShape*>(collisionObject->getCollisionShape()));
+        mCollisionWorld->updateSingleAabb(collisionObject);
+    }
+
+    void PhysicsTaskScheduler::setRecorder(std::unique_ptr<BulletHelpers::PhysicsRecorder> recorder)
+    {
+        waitForWorkers();
+        mRecorder = std::move(recorder);
+    }
+
     void PhysicsTaskScheduler::releaseSharedStates()
     {
         waitForWorkers();
-        std::scoped_lock lock(mSimulationMutex, mUpdateAabbMutex);
+        waitForRayQueries();
+        mFinishedRayQueries.clear();
+        std::scoped_lock lock(mUpdateAabbMutex);
         mSimulations.clear();
         mUpdateAabb.clear();
     }
 
     void PhysicsTaskScheduler::afterPreStep()
     {
+        mStepStart = mTimer->tick();
+        mNextSimulation.store(0, std::memory_order_relaxed);
         updateAabbs();
         if (!mRemainingSteps)
             return;
+        if (mRecorder != nullptr)
+        {
+            MaybeSharedLock lock(mCollisionWorldMutex, mNumThreads);
+            mRecorder->beginStep(*mCollisionWorld, mPhysicsDt, static_cast<std::uint32_t>(std::max(1, mNumThreads)));
+            mRecorder->recordWorld(makeWorldFrame(*mWorldFrameData));
+            for (const auto& sim : mSimulations)
+                if (const auto* actorSim = std::get_if<ActorSimulation>(&sim))
+                    mRecorder->recordActor(*actorSim->second.mCollisionObject, actorSim->second.mStandingOn,
+                        makeActorFrame(actorSim->second));
+            // Recording is not a part of the simulation, the replay compares its own time with the rest of the step
+            mRecordingStepStart = mTimer->tick();
+        }
         const Visitors::PreStep vis{mCollisionWorld};
         for (auto& sim : mSimulations)
         {
@@ -692,12 +908,21 @@ namespace MWPhysics
 
     void PhysicsTaskScheduler::afterPostStep()
     {
+        const osg::Timer_t moved = mTimer->tick();
         if (mRemainingSteps)
         {
+            if (mRecorder != nullptr)
+            {
+                for (const auto& sim : mSimulations)
+                    if (const auto* actorSim = std::get_if<ActorSimulation>(&sim))
+                        mRecorder->recordActorResult(*actorSim->second.mCollisionObject,
+                            Misc::Convert::toBullet(actorSim->second.mPosition), actorSim->second.mIsOnGround);
+                mRecorder->endStep(mTimer->delta_s(mRecordingStepStart, moved));
+            }
             --mRemainingSteps;
             updateActorsPositions();
         }
-        mNextJob.store(0, std::memory_order_release);
+        mStepTimes.push_back(mTimer->delta_s(mStepStart, mTimer->tick()));
     }
 
     void PhysicsTaskScheduler::afterPostSim()
@@ -710,31 +935,18 @@ namespace MWPhysics
                     mLOSCache.end());
         }
         mTimeEnd = mTimer->tick();
-
-        std::unique_lock lock(mWorkersDoneMutex);
-        ++mWorkersFrameCounter;
-        mWorkersDone.notify_all();
     }
 
     void PhysicsTaskScheduler::syncWithMainThread()
     {
-        const Visitors::Sync vis{mAdvanceSimulation, mTimeAccum, mPhysicsDt, this};
+        const Visitors::Sync vis{mAdvanceSimulation, mTimeAccum, mPhysicsDt, this, mActorSleeping};
         for (auto& sim : mSimulations)
             std::visit(vis, sim);
     }
 
-    // Attempt to acquire unique lock on mSimulationMutex while not all worker
-    // threads are holding shared lock but will have to may lead to a deadlock because
-    // C++ standard does not guarantee priority for exclusive and shared locks
-    // for std::shared_mutex. For example microsoft STL implementation points out
-    // for the absence of such priority:
-    // https://docs.microsoft.com/en-us/windows/win32/sync/slim-reader-writer--srw--locks
     void PhysicsTaskScheduler::waitForWorkers()
     {
-        if (mNumThreads == 0)
-            return;
-        std::unique_lock lock(mWorkersDoneMutex);
-        if (mFrameCounter != mWorkersFrameCounter)
-            mWorkersDone.wait(lock);
+        if (mFrameGraph != nullptr)
+            mFrameGraph->wait();
     }
 }
@@ -2,12 +2,14 @@
 #define OPENMW_MWPHYSICS_MTPHYSICS_H
 
 #include <atomic>
-#include <condition_variable>
+#include <functional>
+#include <memory>
 #include <optional>
 #include <shared_mutex>
-#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <variant>
+#include <vector>
 
 #include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
 
@@ -16,19 +18,24 @@
 #include "physicssystem.hpp"
 #include "ptrholder.hpp"
 #include "components/misc/budgetmeasurement.hpp"
+#include "components/misc/jobpool.hpp"
 
-namespace Misc
+namespace MWRender
 {
-    class Barrier;
+    class DebugDrawer;
 }
 
-namespace MWRender
+class btCompoundShape;
+
+namespace BulletHelpers
 {
-    class DebugDrawer;
+    class PhysicsRecorder;
 }
 
 namespace MWPhysics
 {
+    class CellStatics;
+
     class PhysicsTaskScheduler
     {
         public:
@@ -48,6 +55,7 @@ namespace MWPhysics
             void rayTest(const btVector3& rayFromWorld, const btVector3& rayToWorld, btCollisionWorld::RayResultCallback& resultCallback) const;
             void convexSweepTest(const btConvexShape* castShape, const btTransform& from, const btTransform& to, btCollisionWorld::ConvexResultCallback& resultCallback) const;
             void contactTest(btCollisionObject* colObj, btCollisionWorld::ContactResultCallback& resultCallback);
+            void aabbTest(const btVector3& aabbMin, const btVector3& aabbMax, btBroadphaseAabbCallback& callback);
             std::optional<btVector3> getHitPoint(const btTransform& from, btCollisionObject* target);
             void aabbTest(const btVector3& aabbMin, const btVector3& aabbMax, btBroadphaseAabbCallback& callback);
             void getAabb(const btCollisionObject* obj, btVector3& min, btVector3& max);
@@ -58,11 +66,40 @@ namespace MWPhysics
             bool getLineOfSight(const std::shared_ptr<Actor>& actor1, const std::shared_ptr<Actor>& actor2);
             void debugDraw();
             void* getUserPointer(const btCollisionObject* object) const;
+            /// Same as getUserPointer(), but ray and sweep hits on merged cell statics are resolved to the object whose
+            /// surface is at the hit point
+            void* getUserPointer(const btCollisionObject* object, const btVector3& hitPoint, const btVector3& hitNormal) const;
+            /// Same as getUserPointer(), but contacts with merged cell statics are resolved to the object of the child
+            /// @param childIndex as returned by getCompoundChildIndex() for the contact
+            void* getUserPointer(const btCollisionObject* object, int childIndex) const;
+            void addCellStatics(btCollisionObject* collisionObject, const CellStatics* statics);
+            void removeCellStatics(btCollisionObject* collisionObject);
+            /// Change the children of a compound shape while the physics threads don't use it
+            void updateCompoundShape(btCollisionObject* collisionObject, const std::function<void(btCompoundShape&)>& change);
             void releaseSharedStates(); // destroy all objects whose destructor can't be safely called from ~PhysicsTaskScheduler()
 
+            /// Run the queries in the physics threads, concurrently with the simulation.
+            void startRayQueries(std::vector<RayQueryTask>&& queries);
+
+            void waitForRayQueries();
+
+            /// @return the started queries with their results, in the order they were started
+            std::vector<RayQueryTask> takeRayQueries();
+
+            /// Write the collision world and the input and output of the actor movement of each simulation step with
+            /// the recorder
+            void setRecorder(std::unique_ptr<BulletHelpers::PhysicsRecorder> recorder);
+
+            /// Pool running the simulation, other jobs pushed to it run when the simulation leaves threads idle
+            const std::shared_ptr<Misc::JobPool>& getJobPool() const { return mJobPool; }
+
         private:
             void doSimulation();
-            void worker();
+            void moveSimulations();
+            void moveSimulation(std::size_t index);
+            Misc::JobGraph& getFrameGraph(int steps);
+            void runRayQuery(RayQueryTask& query) const;
+            std::weak_ptr<PtrHolder> getPtrHolder(const btCollisionObject* object, const btVector3& hitPoint, const btVector3& hitNormal) const;
             void updateActorsPositions();
             bool hasLineOfSight(const Actor* actor1, const Actor* actor2);
             void refreshLOSCache();
@@ -78,7 +115,9 @@ namespace MWPhysics
 
             std::unique_ptr<WorldFrameData> mWorldFrameData;
             std::vector<Simulation> mSimulations;
+            // Changed with mCollisionWorldMutex locked, so hits of the ray queries can be resolved by the physics threads
             std::unordered_set<const btCollisionObject*> mCollisionObjects;
+            std::unordered_map<const btCollisionObject*, const CellStatics*> mCellStatics;
             float mDefaultPhysicsDt;
             float mPhysicsDt;
             float mTimeAccum;
@@ -87,31 +126,27 @@ namespace MWPhysics
             std::vector<LOSRequest> mLOSCache;
             std::set<std::shared_ptr<PtrHolder>> mUpdateAabb;
 
-            // TODO: use std::experimental::flex_barrier or std::barrier once it becomes a thing
-            std::unique_ptr<Misc::Barrier> mPreStepBarrier;
-            std::unique_ptr<Misc::Barrier> mPostStepBarrier;
-            std::unique_ptr<Misc::Barrier> mPostSimBarrier;
-
             int mNumThreads;
-            int mNumJobs;
             int mRemainingSteps;
             int mLOSCacheExpiry;
-            std::size_t mFrameCounter;
             bool mAdvanceSimulation;
-            bool mQuit;
-            std::atomic<int> mNextJob;
+            bool mActorSleeping;
             std::atomic<int> mNextLOS;
-            std::vector<std::thread> mThreads;
-
-            std::size_t mWorkersFrameCounter = 0;
-            std::condition_variable mWorkersDone;
-            std::mutex mWorkersDoneMutex;
+            std::atomic<std::size_t> mNextSimulation {0};
+            std::shared_ptr<Misc::JobPool> mJobPool;
+            // Jobs of a frame: per step, unsticking actors, moving the simulations and updating the positions in the
+            // collision world, then refreshing the line of sight cache. The simulations and the step state are only
+            // used by these jobs and by the main thread after waitForWorkers(), so they are not locked. The jobs only
+            // depend on the number of steps, so a graph is built once for each step count and reused.
+            std::vector<std::unique_ptr<Misc::JobGraph>> mFrameGraphs;
+            Misc::JobGraph* mFrameGraph = nullptr;
+            std::unique_ptr<Misc::JobGraph> mRayQueryGraph;
+            std::vector<RayQueryTask> mRunningRayQueries;
+            std::vector<RayQueryTask> mFinishedRayQueries;
 
-            mutable std::shared_mutex mSimulationMutex;
             mutable std::shared_mutex mCollisionWorldMutex;
             mutable std::shared_mutex mLOSCacheMutex;
             mutable std::mutex mUpdateAabbMutex;
-            std::condition_variable_any mHasJob;
 
             unsigned int mFrameNumber;
             const osg::Timer* mTimer;
@@ -124,6 +159,10 @@ namespace MWPhysics
             osg::Timer_t mTimeBegin;
             osg::Timer_t mTimeEnd;
             osg::Timer_t mFrameStart;
+            osg::Timer_t mStepStart;
+            osg::Timer_t mRecordingStepStart;
+            std::vector<double> mStepTimes;
+            std::unique_ptr<BulletHelpers::PhysicsRecorder> mRecorder;
     };
 
 }
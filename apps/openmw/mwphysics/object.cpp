@@ -1,4 +1,5 @@
 #include "object.hpp"
+#include "cellstatics.hpp"
 #include "mtphysics.hpp"
 
 #include <components/debug/debuglog.hpp>
@@ -15,12 +16,15 @@
 
 namespace MWPhysics
 {
-    Object::Object(const MWWorld::Ptr& ptr, osg::ref_ptr<Resource::BulletShapeInstance> shapeInstance, osg::Quat rotation, int collisionType, PhysicsTaskScheduler* scheduler)
+    Object::Object(const MWWorld::Ptr& ptr, osg::ref_ptr<Resource::BulletShapeInstance> shapeInstance, osg::Quat rotation, int collisionType,
+                   PhysicsTaskScheduler* scheduler, std::shared_ptr<CellStatics> cellStatics)
         : mShapeInstance(std::move(shapeInstance))
         , mSolid(true)
         , mScale(ptr.getCellRef().getScale(), ptr.getCellRef().getScale(), ptr.getCellRef().getScale())
         , mPosition(ptr.getRefData().getPosition().asVec3())
         , mRotation(rotation)
+        , mCollisionType(collisionType)
+        , mCellStatics(std::move(cellStatics))
         , mTaskScheduler(scheduler)
     {
         mPtr = ptr;
@@ -28,12 +32,18 @@ namespace MWPhysics
             Misc::Convert::toBullet(mPosition), Misc::Convert::toBullet(rotation));
         mCollisionObject->setUserPointer(this);
         mShapeInstance->setLocalScaling(mScale);
-        mTaskScheduler->addCollisionObject(mCollisionObject.get(), collisionType, CollisionType_Actor|CollisionType_HeightMap|CollisionType_Projectile);
+        if (mCellStatics != nullptr)
+            mCellStatics->add(*this);
+        else
+            mTaskScheduler->addCollisionObject(mCollisionObject.get(), collisionType, CollisionType_Actor|CollisionType_HeightMap|CollisionType_Projectile);
     }
 
     Object::~Object()
     {
-        mTaskScheduler->removeCollisionObject(mCollisionObject.get());
+        if (mCellStatics != nullptr)
+            mCellStatics->remove(*this);
+        else
+            mTaskScheduler->removeCollisionObject(mCollisionObject.get());
     }
 
     const Resource::BulletShapeInstance* Object::getShapeInstance() const
@@ -149,4 +159,18 @@ namespace MWPhysics
         }
         return true;
     }
+
+    const std::shared_ptr<CellStatics>& Object::getCellStatics() const
+    {
+        return mCellStatics;
+    }
+
+    void Object::detachFromCellStatics()
+    {
+        if (mCellStatics == nullptr)
+            return;
+        mCellStatics->remove(*this);
+        mCellStatics = nullptr;
+        mTaskScheduler->addCollisionObject(mCollisionObject.get(), mCollisionType, CollisionType_Actor|CollisionType_HeightMap|CollisionType_Projectile);
+    }
 }
@@ -20,12 +20,15 @@ class btVector3;
 
 namespace MWPhysics
 {
+    class CellStatics;
     class PhysicsTaskScheduler;
 
     class Object final : public PtrHolder
     {
     public:
-        Object(const MWWorld::Ptr& ptr, osg::ref_ptr<Resource::BulletShapeInstance> shapeInstance, osg::Quat rotation, int collisionType, PhysicsTaskScheduler* scheduler);
+        /// @param cellStatics to merge the collision shape into instead of adding a collision object to the world, may be nullptr
+        Object(const MWWorld::Ptr& ptr, osg::ref_ptr<Resource::BulletShapeInstance> shapeInstance, osg::Quat rotation, int collisionType,
+               PhysicsTaskScheduler* scheduler, std::shared_ptr<CellStatics> cellStatics);
         ~Object() override;
 
         const Resource::BulletShapeInstance* getShapeInstance() const;
@@ -41,6 +44,9 @@ namespace MWPhysics
         /// @brief update object shape
         /// @return true if shape changed
         bool animateCollisionShapes();
+        const std::shared_ptr<CellStatics>& getCellStatics() const;
+        /// Take the collision shape out of the merged cell statics and add the own collision object to the world
+        void detachFromCellStatics();
 
     private:
         osg::ref_ptr<Resource::BulletShapeInstance> mShapeInstance;
@@ -51,6 +57,8 @@ namespace MWPhysics
         osg::Quat mRotation;
         bool mScaleUpdatePending = false;
         bool mTransformUpdatePending = false;
+        int mCollisionType;
+        std::shared_ptr<CellStatics> mCellStatics;
         mutable std::mutex mPositionMutex;
         PhysicsTaskScheduler* mTaskScheduler;
     };
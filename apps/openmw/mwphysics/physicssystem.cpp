@@ -2,6 +2,7 @@
 
 #include <LinearMath/btIDebugDraw.h>
 #include <LinearMath/btVector3.h>
+#include <fstream>
 #include <memory>
 #include <osg/Group>
 #include <osg/Stats>
@@ -18,13 +19,17 @@
 
 #include <LinearMath/btQuickprof.h>
 
+#include <components/bullethelpers/physicsrecording.hpp>
 #include <components/nifbullet/bulletnifloader.hpp>
 #include <components/resource/resourcesystem.hpp>
 #include <components/resource/bulletshapemanager.hpp>
 #include <components/debug/debuglog.hpp>
 #include <components/esm/loadgmst.hpp>
+#include <components/esm/loadstat.hpp>
 #include <components/sceneutil/positionattitudetransform.hpp>
 #include <components/misc/convert.hpp>
+#include <components/resource/bulletshape.hpp>
+#include <components/settings/settings.hpp>
 
 #include <components/nifosg/particle.hpp> // FindRecIndexVisitor
 
@@ -44,7 +49,9 @@
 #include "../mwworld/class.hpp"
 
 #include "collisiontype.hpp"
+#include "constants.hpp"
 #include "actor.hpp"
+#include "cellstatics.hpp"
 
 #include "projectile.hpp"
 #include "trace.h"
@@ -89,6 +96,17 @@ namespace
         ptr.getClass().getMovementSettings(ptr).mPosition[2] = 0;
     }
 
+    struct WakeUpActorsCallback final : btBroadphaseAabbCallback
+    {
+        bool process(const btBroadphaseProxy* proxy) override
+        {
+            if (proxy->m_collisionFilterGroup != MWPhysics::CollisionType_Actor)
+                return true;
+            const auto* collisionObject = static_cast<const btCollisionObject*>(proxy->m_clientObject);
+            static_cast<MWPhysics::Actor*>(collisionObject->getUserPointer())->wakeUp();
+            return true;
+        }
+    };
 }
 
 namespace MWPhysics
@@ -103,6 +121,7 @@ namespace MWPhysics
         , mWaterEnabled(false)
         , mParentNode(parentNode)
         , mPhysicsDt(1.f / 60.f)
+        , mMergeCellStatics(Settings::Manager::getBool("merge cell statics", "Physics"))
     {
         mResourceSystem->addResourceManager(mShapeManager.get());
 
@@ -130,6 +149,19 @@ namespace MWPhysics
 
         mDebugDrawer = std::make_unique<MWRender::DebugDrawer>(mParentNode, mCollisionWorld.get(), mDebugDrawEnabled);
         mTaskScheduler = std::make_unique<PhysicsTaskScheduler>(mPhysicsDt, mCollisionWorld.get(), mDebugDrawer.get());
+
+        // Record the simulation to replay it with openmw_physics_replay
+        if (const char* recordPath = getenv("OPENMW_PHYSICS_RECORD"))
+        {
+            auto stream = std::make_unique<std::ofstream>(recordPath, std::ios::binary);
+            if (stream->is_open())
+            {
+                mTaskScheduler->setRecorder(std::make_unique<BulletHelpers::PhysicsRecorder>(std::move(stream)));
+                Log(Debug::Info) << "Recording physics simulation to " << recordPath;
+            }
+            else
+                Log(Debug::Error) << "Failed to open physics recording file " << recordPath;
+        }
     }
 
     PhysicsSystem::~PhysicsSystem()
@@ -243,7 +275,7 @@ namespace MWPhysics
 
         if (resultCallback.mObject)
         {
-            PtrHolder* holder = static_cast<PtrHolder*>(resultCallback.mObject->getUserPointer());
+            PtrHolder* holder = static_cast<PtrHolder*>(mTaskScheduler->getUserPointer(resultCallback.mObject, resultCallback.mChildIndex));
             if (holder)
             {
                 reportCollision(resultCallback.mContactPoint, resultCallback.mContactNormal);
@@ -323,12 +355,61 @@ namespace MWPhysics
         {
             result.mHitPos = Misc::Convert::toOsg(resultCallback.m_hitPointWorld);
             result.mHitNormal = Misc::Convert::toOsg(resultCallback.m_hitNormalWorld);
-            if (PtrHolder* ptrHolder = static_cast<PtrHolder*>(resultCallback.m_collisionObject->getUserPointer()))
+            if (PtrHolder* ptrHolder = static_cast<PtrHolder*>(mTaskScheduler->getUserPointer(resultCallback.m_collisionObject, resultCallback.m_hitPointWorld, resultCallback.m_hitNormalWorld)))
                 result.mHitObject = ptrHolder->getPtr();
         }
         return result;
     }
 
+    std::size_t PhysicsSystem::queueRayQuery(const RayQuery& query)
+    {
+        const PtrHolder* ignore = nullptr;
+        if (!query.mIgnore.isEmpty())
+        {
+            if (const Actor* actor = getActor(query.mIgnore))
+                ignore = actor;
+            else if (const Object* object = getObject(query.mIgnore))
+                ignore = object;
+        }
+        const std::size_t tag = mRayQueryResults.makeTag();
+        mRayQueries.push_back(RayQueryTask {tag, query.mFrom, query.mTo, query.mRadius,
+            ignore != nullptr ? ignore->weak_from_this() : std::weak_ptr<const PtrHolder>(),
+            ignore != nullptr ? ignore->getCollisionObject() : nullptr, query.mMask, query.mGroup});
+        return tag;
+    }
+
+    std::vector<RayQueryResult> PhysicsSystem::takeFinishedRayQueries()
+    {
+        std::vector<RayQueryResult> results;
+        for (RayQueryTask& query : mTaskScheduler->takeRayQueries())
+        {
+            RayQueryResult& result = results.emplace_back(RayQueryResult {query.mTag, RayCastingResult {query.mHit, query.mHitPos, query.mHitNormal, {}}});
+            // The hit object may have been removed since the query was run
+            if (const std::shared_ptr<PtrHolder> ptrHolder = query.mHitObject.lock())
+                result.mResult.mHitObject = ptrHolder->getPtr();
+        }
+        return results;
+    }
+
+    std::optional<RayCastingResult> PhysicsSystem::takeRayQueryResult(std::size_t tag)
+    {
+        // Only the first call after the queries were started may wait for them
+        if (mRayQueriesStarted)
+        {
+            mRayQueriesStarted = false;
+            mRayQueryResults.update(takeFinishedRayQueries());
+        }
+        return mRayQueryResults.take(tag);
+    }
+
+    void PhysicsSystem::flushRayQueries()
+    {
+        if (!mRayQueries.empty())
+            mTaskScheduler->startRayQueries(std::exchange(mRayQueries, {}));
+        // Also takes the queries started with the simulation, their results are not aged until the next update
+        mRayQueryResults.add(takeFinishedRayQueries());
+    }
+
     RayCastingResult PhysicsSystem::castSphere(const osg::Vec3f &from, const osg::Vec3f &to, float radius, int mask, int group) const
     {
         btCollisionWorld::ClosestConvexResultCallback callback(Misc::Convert::toBullet(from), Misc::Convert::toBullet(to));
@@ -349,7 +430,7 @@ namespace MWPhysics
         {
             result.mHitPos = Misc::Convert::toOsg(callback.m_hitPointWorld);
             result.mHitNormal = Misc::Convert::toOsg(callback.m_hitNormalWorld);
-            if (auto* ptrHolder = static_cast<PtrHolder*>(callback.m_hitCollisionObject->getUserPointer()))
+            if (auto* ptrHolder = static_cast<PtrHolder*>(mTaskScheduler->getUserPointer(callback.m_hitCollisionObject, callback.m_hitPointWorld, callback.m_hitNormalWorld)))
                 result.mHitObject = ptrHolder->getPtr();
         }
         return result;
@@ -433,7 +514,7 @@ namespace MWPhysics
         else
             return {};
 
-        ContactTestResultCallback resultCallback (me);
+        ContactTestResultCallback resultCallback (me, *mTaskScheduler);
         resultCallback.m_collisionFilterGroup = collisionGroup;
         resultCallback.m_collisionFilterMask = collisionMask;
         mTaskScheduler->contactTest(me, resultCallback);
@@ -453,7 +534,42 @@ namespace MWPhysics
         ActorMap::iterator found = mActors.find(ptr.mRef);
         if (found ==  mActors.end())
             return ptr.getRefData().getPosition().asVec3();
-        return MovementSolver::traceDown(ptr, position, found->second.get(), mCollisionWorld.get(), maxHeight);
+        Actor& actor = *found->second;
+
+        osg::Vec3f offset = actor.getCollisionObjectPosition() - ptr.getRefData().getPosition().asVec3();
+
+        ActorTracer tracer;
+        tracer.findGround(actor.getCollisionObject(), position + offset, position + offset - osg::Vec3f(0,0,maxHeight), mCollisionWorld.get());
+        if (tracer.mFraction >= 1.0f)
+        {
+            actor.setOnGround(false);
+            return position;
+        }
+
+        actor.setOnGround(true);
+
+        // Check if we actually found a valid spawn point (use an infinitely thin ray this time).
+        // Required for some broken door destinations in Morrowind.esm, where the spawn point
+        // intersects with other geometry if the actor's base is taken into account
+        btVector3 from = Misc::Convert::toBullet(position);
+        btVector3 to = from - btVector3(0,0,maxHeight);
+
+        btCollisionWorld::ClosestRayResultCallback resultCallback1(from, to);
+        resultCallback1.m_collisionFilterGroup = 0xff;
+        resultCallback1.m_collisionFilterMask = CollisionType_World|CollisionType_HeightMap;
+
+        mCollisionWorld->rayTest(from, to, resultCallback1);
+
+        if (resultCallback1.hasHit() && ((Misc::Convert::toOsg(resultCallback1.m_hitPointWorld) - tracer.mEndPos + offset).length2() > 35*35
+            || !isWalkableSlope(tracer.mPlaneNormal)))
+        {
+            actor.setOnSlope(!isWalkableSlope(resultCallback1.m_hitNormalWorld));
+            return Misc::Convert::toOsg(resultCallback1.m_hitPointWorld) + osg::Vec3f(0.f, 0.f, sGroundOffset);
+        }
+
+        actor.setOnSlope(!isWalkableSlope(tracer.mPlaneNormal));
+
+        return tracer.mEndPos-offset + osg::Vec3f(0.f, 0.f, sGroundOffset);
     }
 
     void PhysicsSystem::addHeightField(const float* heights, int x, int y, int size, int verts, float minH, float maxH, const osg::Object* holdObject)
@@ -465,7 +581,11 @@ namespace MWPhysics
     {
         HeightFieldMap::iterator heightfield = mHeightFields.find(std::make_pair(x,y));
         if(heightfield != mHeightFields.end())
+        {
+            const btCollisionObject* object = heightfield->second->getCollisionObject();
+            wakeActorsNear(object, object->getWorldTransform());
             mHeightFields.erase(heightfield);
+        }
     }
 
     const HeightField* PhysicsSystem::getHeightField(int x, int y) const
@@ -486,7 +606,17 @@ namespace MWPhysics
 
         assert(!getObject(ptr));
 
-        auto obj = std::make_shared<Object>(ptr, shapeInstance, rotation, collisionType, mTaskScheduler.get());
+        std::shared_ptr<CellStatics> cellStatics;
+        if (mMergeCellStatics && collisionType == CollisionType_World && ptr.getType() == ESM::Static::sRecordId
+            && !shapeInstance->isAnimated())
+        {
+            std::shared_ptr<CellStatics>& statics = mCellStatics[ptr.getCell()];
+            if (statics == nullptr)
+                statics = std::make_shared<CellStatics>(mTaskScheduler.get());
+            cellStatics = statics;
+        }
+
+        auto obj = std::make_shared<Object>(ptr, shapeInstance, rotation, collisionType, mTaskScheduler.get(), std::move(cellStatics));
         mObjects.emplace(ptr.mRef, obj);
 
         if (obj->isAnimated())
@@ -498,8 +628,11 @@ namespace MWPhysics
         if (auto foundObject = mObjects.find(ptr.mRef); foundObject != mObjects.end())
         {
             mAnimatedObjects.erase(foundObject->second.get());
+            wakeActorsNear(foundObject->second->getCollisionObject(), foundObject->second->getTransform());
+            const CellStatics* cellStatics = foundObject->second->getCellStatics().get();
 
             mObjects.erase(foundObject);
+            removeIfEmpty(cellStatics);
         }
         else if (auto foundActor = mActors.find(ptr.mRef); foundActor != mActors.end())
         {
@@ -572,8 +705,10 @@ namespace MWPhysics
         if (auto foundObject = mObjects.find(ptr.mRef); foundObject != mObjects.end())
         {
             float scale = ptr.getCellRef().getScale();
+            detachFromCellStatics(*foundObject->second);
             foundObject->second->setScale(scale);
             mTaskScheduler->updateSingleAabb(foundObject->second);
+            wakeActorsNear(foundObject->second->getCollisionObject(), foundObject->second->getTransform());
         }
         else if (auto foundActor = mActors.find(ptr.mRef); foundActor != mActors.end())
         {
@@ -586,8 +721,10 @@ namespace MWPhysics
     {
         if (auto foundObject = mObjects.find(ptr.mRef); foundObject != mObjects.end())
         {
+            detachFromCellStatics(*foundObject->second);
             foundObject->second->setRotation(rotate);
             mTaskScheduler->updateSingleAabb(foundObject->second);
+            wakeActorsNear(foundObject->second->getCollisionObject(), foundObject->second->getTransform());
         }
         else if (auto foundActor = mActors.find(ptr.mRef); foundActor != mActors.end())
         {
@@ -603,8 +740,12 @@ namespace MWPhysics
     {
         if (auto foundObject = mObjects.find(ptr.mRef); foundObject != mObjects.end())
         {
+            detachFromCellStatics(*foundObject->second);
+            const btTransform previousTransform = foundObject->second->getTransform();
             foundObject->second->updatePosition();
             mTaskScheduler->updateSingleAabb(foundObject->second);
+            wakeActorsNear(foundObject->second->getCollisionObject(), previousTransform);
+            wakeActorsNear(foundObject->second->getCollisionObject(), foundObject->second->getTransform());
         }
         else if (auto foundActor = mActors.find(ptr.mRef); foundActor != mActors.end())
         {
@@ -737,6 +878,38 @@ namespace MWPhysics
         return simulations;
     }
 
+    void PhysicsSystem::wakeActorsNear(const btCollisionObject* object, const btTransform& transform)
+    {
+        // Objects moving in one frame by less than this are still noticed by actors sleeping next to them
+        static constexpr float margin = 16.f;
+        btVector3 objectMin;
+        btVector3 objectMax;
+        object->getCollisionShape()->getAabb(transform, objectMin, objectMax);
+        // Actors sleeping on the object touch its bounds too
+        const btVector3 marginExtents(margin, margin, margin);
+        WakeUpActorsCallback callback;
+        mTaskScheduler->aabbTest(objectMin - marginExtents, objectMax + marginExtents, callback);
+    }
+
+    void PhysicsSystem::detachFromCellStatics(Object& object)
+    {
+        const std::shared_ptr<CellStatics> cellStatics = object.getCellStatics();
+        if (cellStatics == nullptr)
+            return;
+        object.detachFromCellStatics();
+        removeIfEmpty(cellStatics.get());
+    }
+
+    void PhysicsSystem::removeIfEmpty(const CellStatics* statics)
+    {
+        if (statics == nullptr || !statics->isEmpty())
+            return;
+        const auto found = std::find_if(mCellStatics.begin(), mCellStatics.end(),
+            [&] (const auto& v) { return v.second.get() == statics; });
+        if (found != mCellStatics.end())
+            mCellStatics.erase(found);
+    }
+
     void PhysicsSystem::stepSimulation(float dt, bool skipSimulation, osg::Timer_t frameStart, unsigned int frameNumber, osg::Stats& stats)
     {
         for (Object* animatedObject : mAnimatedObjects)
@@ -746,6 +919,7 @@ namespace MWPhysics
                 auto obj = mObjects.find(animatedObject->getPtr().mRef);
                 assert(obj != mObjects.end());
                 mTaskScheduler->updateSingleAabb(obj->second);
+                wakeActorsNear(animatedObject->getCollisionObject(), animatedObject->getTransform());
             }
         }
 
@@ -764,6 +938,12 @@ namespace MWPhysics
             // modifies mTimeAccum
             mTaskScheduler->applyQueuedMovements(mTimeAccum, std::move(simulations), frameStart, frameNumber, stats);
         }
+
+        if (!mRayQueries.empty())
+        {
+            mTaskScheduler->startRayQueries(std::exchange(mRayQueries, {}));
+            mRayQueriesStarted = true;
+        }
     }
 
     void PhysicsSystem::moveActors()
@@ -792,7 +972,10 @@ namespace MWPhysics
         ObjectMap::iterator found = mObjects.find(object.mRef);
         if (found != mObjects.end())
             if (found->second->animateCollisionShapes())
+            {
                 mTaskScheduler->updateSingleAabb(found->second);
+                wakeActorsNear(found->second->getCollisionObject(), found->second->getTransform());
+            }
     }
 
     void PhysicsSystem::debugDraw()
@@ -942,6 +1125,7 @@ namespace MWPhysics
         , mIsAquatic(actor.getPtr().getClass().isPureWaterCreature(actor.getPtr()))
         , mWaterCollision(waterCollision)
         , mSkipCollisionDetection(!actor.getCollisionMode())
+        , mSleeping(false)
     {
     }
 
@@ -957,6 +1141,7 @@ namespace MWPhysics
     WorldFrameData::WorldFrameData()
         : mIsInStorm(MWBase::Environment::get().getWorld()->isInStorm())
         , mStormDirection(MWBase::Environment::get().getWorld()->getStormDirection())
+        , mStormWalkMult(MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>().find("fStromWalkMult")->mValue.getFloat())
     {}
 
     LOSRequest::LOSRequest(const std::weak_ptr<Actor>& a1, const std::weak_ptr<Actor>& a2)
@@ -4,6 +4,7 @@
 #include <array>
 #include <memory>
 #include <map>
+#include <optional>
 #include <set>
 #include <unordered_map>
 #include <algorithm>
@@ -18,6 +19,7 @@
 
 #include "collisiontype.hpp"
 #include "raycasting.hpp"
+#include "rayqueryresults.hpp"
 
 namespace osg
 {
@@ -31,6 +33,15 @@ namespace MWRender
     class DebugDrawer;
 }
 
+namespace BulletHelpers
+{
+    namespace PhysicsRecording
+    {
+        struct ActorFrame;
+        struct WorldFrame;
+    }
+}
+
 namespace Resource
 {
     class BulletShapeManager;
@@ -43,15 +54,18 @@ class btDefaultCollisionConfiguration;
 class btCollisionDispatcher;
 class btCollisionObject;
 class btCollisionShape;
+class btTransform;
 class btVector3;
 
 namespace MWPhysics
 {
+    class CellStatics;
     class HeightField;
     class Object;
     class Actor;
     class PhysicsTaskScheduler;
     class Projectile;
+    class PtrHolder;
 
     using ActorMap = std::unordered_map<const MWWorld::LiveCellRefBase*, std::shared_ptr<Actor>>;
 
@@ -73,9 +87,31 @@ namespace MWPhysics
     };
     bool operator==(const LOSRequest& lhs, const LOSRequest& rhs) noexcept;
 
+    /// RayQuery prepared for the physics threads
+    struct RayQueryTask
+    {
+        std::size_t mTag;
+        osg::Vec3f mFrom;
+        osg::Vec3f mTo;
+        float mRadius;
+        /// Checked when the query is run, mIgnoreObject is not used after the holder expired
+        std::weak_ptr<const PtrHolder> mIgnore;
+        const btCollisionObject* mIgnoreObject;
+        int mMask;
+        int mGroup;
+        bool mHit = false;
+        osg::Vec3f mHitPos;
+        osg::Vec3f mHitNormal;
+        /// Resolved while the collision world is locked, expires when the object is removed before the result is taken
+        std::weak_ptr<PtrHolder> mHitObject;
+    };
+
     struct ActorFrameData
     {
         ActorFrameData(Actor& actor, bool inert, bool waterCollision, float slowFall, float waterlevel);
+        /// Restores the frame data of a recorded simulation step, see framedatarecording.hpp
+        ActorFrameData(const BulletHelpers::PhysicsRecording::ActorFrame& frame, btCollisionObject* collisionObject,
+            const btCollisionObject* standingOn);
         osg::Vec3f mPosition;
         osg::Vec3f mInertia;
         const btCollisionObject* mStandingOn;
@@ -98,6 +134,7 @@ namespace MWPhysics
         const bool mIsAquatic;
         const bool mWaterCollision;
         const bool mSkipCollisionDetection;
+        bool mSleeping;
     };
 
     struct ProjectileFrameData
@@ -113,8 +150,10 @@ namespace MWPhysics
     struct WorldFrameData
     {
         WorldFrameData();
+        explicit WorldFrameData(const BulletHelpers::PhysicsRecording::WorldFrame& frame);
         bool mIsInStorm;
         osg::Vec3f mStormDirection;
+        float mStormWalkMult;
     };
 
     using ActorSimulation = std::pair<std::shared_ptr<Actor>, ActorFrameData>;
@@ -198,6 +237,19 @@ namespace MWPhysics
             /// Return true if actor1 can see actor2.
             bool getLineOfSight(const MWWorld::ConstPtr& actor1, const MWWorld::ConstPtr& actor2) const override;
 
+            /// Queue a query to be run by the physics threads along with the next simulation, concurrently with the
+            /// rest of the frame. Its result is usually available on the next frame, without waiting.
+            /// @return tag to take the result with takeRayQueryResult()
+            std::size_t queueRayQuery(const RayQuery& query);
+
+            /// @return nothing while the query is not started yet, or when its result was already taken or dropped
+            /// because it was not taken for a few frames
+            std::optional<RayCastingResult> takeRayQueryResult(std::size_t tag);
+
+            /// Run the queued queries now and wait for them, for callers that need the results right away. Several
+            /// queries queued together are still run in parallel.
+            void flushRayQueries();
+
             bool isOnGround (const MWWorld::Ptr& actor);
 
             bool canMoveToWaterSurface (const MWWorld::ConstPtr &actor, const float waterlevel);
@@ -268,11 +320,25 @@ namespace MWPhysics
 
             std::vector<Simulation> prepareSimulation(bool willSimulate);
 
+            /// Wake up the sleeping actors standing on the object or touching its bounds at the given transform
+            void wakeActorsNear(const btCollisionObject* object, const btTransform& transform);
+
+            /// Give the object its own collision object again before it is moved
+            void detachFromCellStatics(Object& object);
+
+            void removeIfEmpty(const CellStatics* statics);
+
             std::unique_ptr<btBroadphaseInterface> mBroadphase;
             std::unique_ptr<btDefaultCollisionConfiguration> mCollisionConfiguration;
             std::unique_ptr<btCollisionDispatcher> mDispatcher;
             std::unique_ptr<btCollisionWorld> mCollisionWorld;
             std::unique_ptr<PhysicsTaskScheduler> mTaskScheduler;
+            std::vector<RayQueryResult> takeFinishedRayQueries();
+
+            std::vector<RayQueryTask> mRayQueries;
+            // Results not taken within a few frames are dropped
+            RayQueryResults mRayQueryResults {8};
+            bool mRayQueriesStarted = false;
 
             std::unique_ptr<Resource::BulletShapeManager> mShapeManager;
             Resource::ResourceSystem* mResourceSystem;
@@ -282,6 +348,11 @@ namespace MWPhysics
 
             std::set<Object*> mAnimatedObjects; // stores pointers to elements in mObjects
 
+            // Objects hold their cell statics, so these are destroyed with the last object
+            using CellStaticsMap = std::unordered_map<const MWWorld::CellStore*, std::shared_ptr<CellStatics>>;
+            CellStaticsMap mCellStatics;
+            bool mMergeCellStatics;
+
             ActorMap mActors;
 
             using ProjectileMap = std::map<int, std::shared_ptr<Projectile>>;
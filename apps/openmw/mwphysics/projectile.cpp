@@ -57,20 +57,10 @@ void Projectile::updateCollisionObjectPosition()
     mCollisionObject->setWorldTransform(trans);
 }
 
-void Projectile::hit(const btCollisionObject* target, btVector3 pos, btVector3 normal)
-{
-    bool active = true;
-    if (!mActive.compare_exchange_strong(active, false, std::memory_order_relaxed) || !active)
-        return;
-    mHitTarget = target;
-    mHitPosition = pos;
-    mHitNormal = normal;
-}
-
 MWWorld::Ptr Projectile::getTarget() const
 {
     assert(!mActive);
-    auto* target = static_cast<PtrHolder*>(mHitTarget->getUserPointer());
+    auto* target = static_cast<PtrHolder*>(mTaskScheduler->getUserPointer(mHitTarget, mHitPosition, mHitNormal));
     return target ? target->getPtr() : MWWorld::Ptr();
 }
 
@@ -106,18 +96,4 @@ void Projectile::setValidTargets(const std::vector<MWWorld::Ptr>& targets)
     }
 }
 
-bool Projectile::isValidTarget(const btCollisionObject* target) const
-{
-    assert(target);
-    std::scoped_lock lock(mMutex);
-    if (mCasterColObj == target)
-        return false;
-
-    if (mValidTargets.empty())
-        return true;
-
-    return std::any_of(mValidTargets.begin(), mValidTargets.end(),
-            [target](const btCollisionObject* actor) { return target == actor; });
-}
-
 }
@@ -1,9 +1,12 @@
 #ifndef OPENMW_MWPHYSICS_PROJECTILE_H
 #define OPENMW_MWPHYSICS_PROJECTILE_H
 
+#include <algorithm>
 #include <atomic>
+#include <cassert>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <LinearMath/btVector3.h>
 
@@ -62,10 +65,30 @@ namespace MWPhysics
             return mHitWater;
         }
 
-        void hit(const btCollisionObject* target, btVector3 pos, btVector3 normal);
+        void hit(const btCollisionObject* target, btVector3 pos, btVector3 normal)
+        {
+            bool active = true;
+            if (!mActive.compare_exchange_strong(active, false, std::memory_order_relaxed) || !active)
+                return;
+            mHitTarget = target;
+            mHitPosition = pos;
+            mHitNormal = normal;
+        }
 
         void setValidTargets(const std::vector<MWWorld::Ptr>& targets);
-        bool isValidTarget(const btCollisionObject* target) const;
+        bool isValidTarget(const btCollisionObject* target) const
+        {
+            assert(target);
+            std::scoped_lock lock(mMutex);
+            if (mCasterColObj == target)
+                return false;
+
+            if (mValidTargets.empty())
+                return true;
+
+            return std::any_of(mValidTargets.begin(), mValidTargets.end(),
+                    [target](const btCollisionObject* actor) { return target == actor; });
+        }
 
         btVector3 getHitPosition() const
         {
@@ -10,7 +10,8 @@
 
 namespace MWPhysics
 {
-    class PtrHolder
+    /// Always owned by a shared_ptr, so the physics threads can refer to it without keeping it alive
+    class PtrHolder : public std::enable_shared_from_this<PtrHolder>
     {
     public:
         virtual ~PtrHolder() = default;
@@ -1,6 +1,8 @@
 #ifndef OPENMW_MWPHYSICS_RAYCASTING_H
 #define OPENMW_MWPHYSICS_RAYCASTING_H
 
+#include <cstddef>
+
 #include <osg/Vec3f>
 
 #include "../mwworld/ptr.hpp"
@@ -17,6 +19,24 @@ namespace MWPhysics
         MWWorld::Ptr mHitObject;
     };
 
+    /// Ray cast or sphere sweep queued to run in the physics threads, a sphere is swept when mRadius is not 0.
+    struct RayQuery
+    {
+        osg::Vec3f mFrom;
+        osg::Vec3f mTo;
+        float mRadius = 0;
+        /// Not hit by ray casts, sphere sweeps hit everything
+        MWWorld::ConstPtr mIgnore;
+        int mMask = CollisionType_Default;
+        int mGroup = 0xff;
+    };
+
+    struct RayQueryResult
+    {
+        std::size_t mTag;
+        RayCastingResult mResult;
+    };
+
     class RayCastingInterface
     {
         public:
@@ -0,0 +1,33 @@
+#include "rayqueryresults.hpp"
+
+namespace MWPhysics
+{
+    void RayQueryResults::update(const std::vector<RayQueryResult>& results)
+    {
+        ++mUpdate;
+        for (auto it = mResults.begin(); it != mResults.end();)
+        {
+            if (mUpdate - it->second.mUpdate > mMaxAge)
+                it = mResults.erase(it);
+            else
+                ++it;
+        }
+        add(results);
+    }
+
+    void RayQueryResults::add(const std::vector<RayQueryResult>& results)
+    {
+        for (const RayQueryResult& result : results)
+            mResults.insert_or_assign(result.mTag, Entry {result.mResult, mUpdate});
+    }
+
+    std::optional<RayCastingResult> RayQueryResults::take(std::size_t tag)
+    {
+        const auto it = mResults.find(tag);
+        if (it == mResults.end())
+            return {};
+        RayCastingResult result = std::move(it->second.mResult);
+        mResults.erase(it);
+        return result;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef OPENMW_MWPHYSICS_RAYQUERYRESULTS_H
+#define OPENMW_MWPHYSICS_RAYQUERYRESULTS_H
+
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "raycasting.hpp"
+
+namespace MWPhysics
+{
+    /// Keeps the results of the queued ray queries until their callers take them. Callers skipping frames may come
+    /// back late, so results are only dropped when they were not taken within maxAge updates.
+    class RayQueryResults
+    {
+    public:
+        explicit RayQueryResults(unsigned maxAge) : mMaxAge(maxAge) {}
+
+        /// @return tag of a new query, never 0
+        std::size_t makeTag() { return ++mLastTag; }
+
+        /// Add the results of the queries run since the last update and drop the old ones
+        void update(const std::vector<RayQueryResult>& results);
+
+        /// Add the results of queries run out of turn, they are as old as those of the last update
+        void add(const std::vector<RayQueryResult>& results);
+
+        /// @return nothing while the query is running, or when its result was already taken or dropped
+        std::optional<RayCastingResult> take(std::size_t tag);
+
+    private:
+        struct Entry
+        {
+            RayCastingResult mResult;
+            unsigned mUpdate;
+        };
+
+        unsigned mMaxAge;
+        std::size_t mLastTag = 0;
+        unsigned mUpdate = 0;
+        std::unordered_map<std::size_t, Entry> mResults;
+    };
+}
+
+#endif
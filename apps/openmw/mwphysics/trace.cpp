@@ -6,7 +6,6 @@
 #include <BulletCollision/CollisionShapes/btConvexShape.h>
 
 #include "collisiontype.hpp"
-#include "actor.hpp"
 #include "actorconvexcallback.hpp"
 
 namespace MWPhysics
@@ -98,9 +97,9 @@ void ActorTracer::doTrace(const btCollisionObject *actor, const osg::Vec3f& star
     }
 }
 
-void ActorTracer::findGround(const Actor* actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world)
+void ActorTracer::findGround(const btCollisionObject* actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world)
 {
-    const auto traceCallback = sweepHelper(actor->getCollisionObject(), Misc::Convert::toBullet(start), Misc::Convert::toBullet(end), world, true);
+    const auto traceCallback = sweepHelper(actor, Misc::Convert::toBullet(start), Misc::Convert::toBullet(end), world, true);
     if(traceCallback.hasHit())
     {
         mFraction = traceCallback.m_closestHitFraction;
@@ -9,8 +9,6 @@ class btCollisionWorld;
 
 namespace MWPhysics
 {
-    class Actor;
-
     struct ActorTracer
     {
         osg::Vec3f mEndPos;
@@ -21,7 +19,7 @@ namespace MWPhysics
         float mFraction;
 
         void doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world, bool attempt_short_trace = false);
-        void findGround(const Actor* actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world);
+        void findGround(const btCollisionObject* actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world);
     };
 }
 
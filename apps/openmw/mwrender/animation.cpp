@@ -536,6 +536,15 @@ namespace MWRender
             mSkeleton->setActive(static_cast<SceneUtil::Skeleton::ActiveType>(active));
     }
 
+    void Animation::setLod(unsigned int updateInterval, float minPixelSize)
+    {
+        if (mSkeleton)
+        {
+            mSkeleton->setUpdateInterval(updateInterval);
+            mSkeleton->setMinPixelSize(minPixelSize);
+        }
+    }
+
     void Animation::updatePtr(const MWWorld::Ptr &ptr)
     {
         mPtr = ptr;
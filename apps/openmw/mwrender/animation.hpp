@@ -360,6 +360,12 @@ public:
     /// 0 = Inactive, 1 = Active in place, 2 = Active
     void setActive(int active);
 
+    /// Set animation level of detail on the object skeleton, if one exists.
+    /// Text keys are still processed every frame by runAnimation, only the pose update is throttled.
+    /// @see SceneUtil::Skeleton::setUpdateInterval
+    /// @see SceneUtil::Skeleton::setMinPixelSize
+    void setLod(unsigned int updateInterval, float minPixelSize);
+
     osg::Group* getOrCreateObjectRoot();
 
     osg::Group* getObjectRoot();
@@ -8,6 +8,22 @@
 
 #include <osgDB/WriteFile>
 
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+#include <extern/smhasher/MurmurHash3.h>
+
 #include <components/settings/settings.hpp>
 #include <components/files/memorystream.hpp>
 
@@ -62,6 +78,109 @@ namespace
     }
 
 
+    // RGB and alpha of the world map for every WNAM value, indexed by value - SCHAR_MIN
+    using ColourTable = std::array<std::array<unsigned char, 4>, 256>;
+
+    ColourTable makeColourTable()
+    {
+        ColourTable table;
+        for (int value = SCHAR_MIN; value <= SCHAR_MAX; ++value)
+        {
+            unsigned char r,g,b;
+
+            float y2 = value / 128.f;
+            if (y2 < 0)
+            {
+                r = static_cast<unsigned char>(14 * y2 + 38);
+                g = static_cast<unsigned char>(20 * y2 + 56);
+                b = static_cast<unsigned char>(18 * y2 + 51);
+            }
+            else if (y2 < 0.3f)
+            {
+                if (y2 < 0.1f)
+                    y2 *= 8.f;
+                else
+                {
+                    y2 -= 0.1f;
+                    y2 += 0.8f;
+                }
+                r = static_cast<unsigned char>(66 - 32 * y2);
+                g = static_cast<unsigned char>(48 - 23 * y2);
+                b = static_cast<unsigned char>(33 - 16 * y2);
+            }
+            else
+            {
+                y2 -= 0.3f;
+                y2 *= 1.428f;
+                r = static_cast<unsigned char>(34 - 29 * y2);
+                g = static_cast<unsigned char>(25 - 20 * y2);
+                b = static_cast<unsigned char>(17 - 12 * y2);
+            }
+
+            table[value - SCHAR_MIN] = {r, g, b, (y2 < 0) ? static_cast<unsigned char>(0) : static_cast<unsigned char>(255)};
+        }
+        return table;
+    }
+
+    constexpr std::uint32_t sCacheVersion = 1;
+
+    struct CacheHeader
+    {
+        std::array<std::uint64_t, 2> mKey;
+        std::uint32_t mVersion;
+        std::int32_t mWidth;
+        std::int32_t mHeight;
+        std::uint32_t mReserved;
+    };
+
+    /// Rows of cells rendered by the map work item together with helper items added to the same work queue.
+    /// Helpers started after all rows are taken return at once, so the map item never waits for a queued helper.
+    class RowJobs : public osg::Referenced
+    {
+    public:
+        RowJobs(std::size_t numRows, std::function<void(std::size_t)>&& render)
+            : mNumRows(numRows)
+            , mRender(std::move(render))
+        {
+        }
+
+        void run()
+        {
+            for (std::size_t row = mNextRow++; row < mNumRows; row = mNextRow++)
+            {
+                mRender(row);
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (++mDoneRows == mNumRows)
+                    mDone.notify_all();
+            }
+        }
+
+        void waitTillDone()
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mDone.wait(lock, [&] { return mDoneRows == mNumRows; });
+        }
+
+    private:
+        const std::size_t mNumRows;
+        const std::function<void(std::size_t)> mRender;
+        std::atomic<std::size_t> mNextRow {0};
+        std::mutex mMutex;
+        std::condition_variable mDone;
+        std::size_t mDoneRows = 0;
+    };
+
+    class RowJobsWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        RowJobsWorkItem(RowJobs* jobs) : mJobs(jobs) {}
+
+        void doWork() override { mJobs->run(); }
+
+    private:
+        osg::ref_ptr<RowJobs> mJobs;
+    };
+
     class CameraUpdateGlobalCallback : public SceneUtil::NodeCallback<CameraUpdateGlobalCallback, osg::Camera*>
     {
     public:
@@ -101,8 +220,10 @@ namespace MWRender
     class CreateMapWorkItem : public SceneUtil::WorkItem
     {
     public:
-        CreateMapWorkItem(int width, int height, int minX, int minY, int maxX, int maxY, int cellSize, const MWWorld::Store<ESM::Land>& landStore)
+        CreateMapWorkItem(int width, int height, int minX, int minY, int maxX, int maxY, int cellSize, const MWWorld::Store<ESM::Land>& landStore,
+                          const std::vector<std::string>& contentFiles, const std::string& cachePath, SceneUtil::WorkQueue* workQueue)
             : mWidth(width), mHeight(height), mMinX(minX), mMinY(minY), mMaxX(maxX), mMaxY(maxY), mCellSize(cellSize), mLandStore(landStore)
+            , mContentFiles(contentFiles), mCachePath(cachePath), mWorkQueue(workQueue)
         {
         }
 
@@ -110,70 +231,42 @@ namespace MWRender
         {
             osg::ref_ptr<osg::Image> image = new osg::Image;
             image->allocateImage(mWidth, mHeight, 1, GL_RGB, GL_UNSIGNED_BYTE);
-            unsigned char* data = image->data();
 
             osg::ref_ptr<osg::Image> alphaImage = new osg::Image;
             alphaImage->allocateImage(mWidth, mHeight, 1, GL_ALPHA, GL_UNSIGNED_BYTE);
-            unsigned char* alphaData = alphaImage->data();
 
-            for (int x = mMinX; x <= mMaxX; ++x)
+            const int numCellsX = mMaxX - mMinX + 1;
+            const int numCellsY = mMaxY - mMinY + 1;
+
+            // Look up the map data of every cell once, it's used for every texel of the cell and for the cache key
+            std::vector<const signed char*> wnam(static_cast<std::size_t>(numCellsX) * numCellsY, nullptr);
+            for (int y = 0; y < numCellsY; ++y)
             {
-                for (int y = mMinY; y <= mMaxY; ++y)
+                for (int x = 0; x < numCellsX; ++x)
                 {
-                    const ESM::Land* land = mLandStore.search (x,y);
+                    const ESM::Land* land = mLandStore.search(mMinX + x, mMinY + y);
+                    if (land && (land->mDataTypes & ESM::Land::DATA_WNAM))
+                        wnam[y * numCellsX + x] = land->mWnam;
+                }
+            }
 
-                    for (int cellY=0; cellY<mCellSize; ++cellY)
-                    {
-                        for (int cellX=0; cellX<mCellSize; ++cellX)
-                        {
-                            int vertexX = static_cast<int>(float(cellX) / float(mCellSize) * 9);
-                            int vertexY = static_cast<int>(float(cellY) / float(mCellSize) * 9);
-
-                            int texelX = (x-mMinX) * mCellSize + cellX;
-                            int texelY = (y-mMinY) * mCellSize + cellY;
-
-                            unsigned char r,g,b;
-
-                            float y2 = 0;
-                            if (land && (land->mDataTypes & ESM::Land::DATA_WNAM))
-                                y2 = land->mWnam[vertexY * 9 + vertexX] / 128.f;
-                            else
-                                y2 = SCHAR_MIN / 128.f;
-                            if (y2 < 0)
-                            {
-                                r = static_cast<unsigned char>(14 * y2 + 38);
-                                g = static_cast<unsigned char>(20 * y2 + 56);
-                                b = static_cast<unsigned char>(18 * y2 + 51);
-                            }
-                            else if (y2 < 0.3f)
-                            {
-                                if (y2 < 0.1f)
-                                    y2 *= 8.f;
-                                else
-                                {
-                                    y2 -= 0.1f;
-                                    y2 += 0.8f;
-                                }
-                                r = static_cast<unsigned char>(66 - 32 * y2);
-                                g = static_cast<unsigned char>(48 - 23 * y2);
-                                b = static_cast<unsigned char>(33 - 16 * y2);
-                            }
-                            else
-                            {
-                                y2 -= 0.3f;
-                                y2 *= 1.428f;
-                                r = static_cast<unsigned char>(34 - 29 * y2);
-                                g = static_cast<unsigned char>(25 - 20 * y2);
-                                b = static_cast<unsigned char>(17 - 12 * y2);
-                            }
-
-                            data[texelY * mWidth * 3 + texelX * 3] = r;
-                            data[texelY * mWidth * 3 + texelX * 3+1] = g;
-                            data[texelY * mWidth * 3 + texelX * 3+2] = b;
-
-                            alphaData[texelY * mWidth+ texelX] = (y2 < 0) ? static_cast<unsigned char>(0) : static_cast<unsigned char>(255);
-                        }
-                    }
+            boost::filesystem::path cacheFile;
+            std::array<std::uint64_t, 2> key {};
+            if (!mCachePath.empty())
+            {
+                key = makeCacheKey(wnam);
+                std::ostringstream name;
+                name << std::hex << std::setfill('0') << std::setw(16) << key[0] << std::setw(16) << key[1] << ".map";
+                cacheFile = boost::filesystem::path(mCachePath) / name.str();
+            }
+
+            if (cacheFile.empty() || !readCache(cacheFile, key, *image, *alphaImage))
+            {
+                rasterize(wnam, image->data(), alphaImage->data());
+                if (!cacheFile.empty())
+                {
+                    writeCache(cacheFile, key, *image, *alphaImage);
+                    removeStaleCacheFiles(cacheFile);
                 }
             }
 
@@ -213,15 +306,168 @@ namespace MWRender
         int mMinX, mMinY, mMaxX, mMaxY;
         int mCellSize;
         const MWWorld::Store<ESM::Land>& mLandStore;
+        std::vector<std::string> mContentFiles;
+        std::string mCachePath;
+        SceneUtil::WorkQueue* mWorkQueue;
 
         osg::ref_ptr<osg::Texture2D> mBaseTexture;
         osg::ref_ptr<osg::Texture2D> mAlphaTexture;
 
         osg::ref_ptr<osg::Image> mOverlayImage;
         osg::ref_ptr<osg::Texture2D> mOverlayTexture;
+
+    private:
+        void rasterize(const std::vector<const signed char*>& wnam, unsigned char* data, unsigned char* alphaData) const
+        {
+            static const ColourTable colourTable = makeColourTable();
+
+            std::vector<int> vertexIndices(mCellSize);
+            for (int i = 0; i < mCellSize; ++i)
+                vertexIndices[i] = static_cast<int>(float(i) / float(mCellSize) * 9);
+
+            // Every row of cells covers whole rows of texels, so the rows can be rendered concurrently
+            // by the other threads of the work queue running this item
+            const int numCellsX = mMaxX - mMinX + 1;
+            const int numCellsY = mMaxY - mMinY + 1;
+            osg::ref_ptr<RowJobs> jobs = new RowJobs(numCellsY, [&] (std::size_t y)
+            {
+                for (int x = 0; x < numCellsX; ++x)
+                {
+                    const signed char* cellWnam = wnam[y * numCellsX + x];
+
+                    for (int cellY=0; cellY<mCellSize; ++cellY)
+                    {
+                        const int texelX = x * mCellSize;
+                        const int texelY = static_cast<int>(y) * mCellSize + cellY;
+                        unsigned char* rgb = data + (texelY * mWidth + texelX) * 3;
+                        unsigned char* alpha = alphaData + texelY * mWidth + texelX;
+
+                        // Cells without map data are drawn like the deepest water
+                        if (cellWnam == nullptr)
+                        {
+                            const ColourTable::value_type& colour = colourTable.front();
+                            for (int cellX=0; cellX<mCellSize; ++cellX)
+                                std::copy(colour.begin(), colour.end() - 1, rgb + cellX * 3);
+                            std::fill(alpha, alpha + mCellSize, colour[3]);
+                            continue;
+                        }
+
+                        const signed char* row = cellWnam + vertexIndices[cellY] * 9;
+                        for (int cellX=0; cellX<mCellSize; ++cellX)
+                        {
+                            const ColourTable::value_type& colour = colourTable[row[vertexIndices[cellX]] - SCHAR_MIN];
+                            rgb[cellX * 3] = colour[0];
+                            rgb[cellX * 3 + 1] = colour[1];
+                            rgb[cellX * 3 + 2] = colour[2];
+                            alpha[cellX] = colour[3];
+                        }
+                    }
+                }
+            });
+
+            const std::size_t numHelpers = std::min<std::size_t>(mWorkQueue->getNumThreads(), numCellsY) - 1;
+            for (std::size_t i = 0; i < numHelpers; ++i)
+                mWorkQueue->addWorkItem(new RowJobsWorkItem(jobs), true);
+            jobs->run();
+            jobs->waitTillDone();
+        }
+
+        std::array<std::uint64_t, 2> makeCacheKey(const std::vector<const signed char*>& wnam) const
+        {
+            std::string data;
+            const auto append = [&] (const auto& value) { data.append(reinterpret_cast<const char*>(&value), sizeof(value)); };
+            append(sCacheVersion);
+            append(mWidth);
+            append(mHeight);
+            append(mMinX);
+            append(mMinY);
+            append(mMaxX);
+            append(mMaxY);
+            append(mCellSize);
+            for (const std::string& contentFile : mContentFiles)
+                data.append(contentFile).push_back('\0');
+            for (const signed char* cellWnam : wnam)
+            {
+                data.push_back(cellWnam != nullptr);
+                if (cellWnam != nullptr)
+                    data.append(reinterpret_cast<const char*>(cellWnam), ESM::Land::LAND_GLOBAL_MAP_LOD_SIZE);
+            }
+
+            std::array<std::uint64_t, 2> key {0, 0};
+            const std::uint64_t seed = 0;
+            MurmurHash3_x64_128(data.data(), static_cast<int>(data.size()), &seed, key.data());
+            return key;
+        }
+
+        bool readCache(const boost::filesystem::path& path, const std::array<std::uint64_t, 2>& key, osg::Image& image, osg::Image& alphaImage) const
+        {
+            boost::filesystem::ifstream stream(path, std::ios::binary);
+            if (!stream.is_open())
+                return false;
+
+            CacheHeader header;
+            stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+            if (!stream || header.mVersion != sCacheVersion || header.mKey != key || header.mWidth != mWidth || header.mHeight != mHeight)
+            {
+                Log(Debug::Warning) << "Ignoring invalid global map cache file " << path;
+                return false;
+            }
+
+            stream.read(reinterpret_cast<char*>(image.data()), image.getTotalSizeInBytes());
+            stream.read(reinterpret_cast<char*>(alphaImage.data()), alphaImage.getTotalSizeInBytes());
+            if (!stream)
+            {
+                Log(Debug::Warning) << "Failed to read global map cache file " << path;
+                return false;
+            }
+
+            Log(Debug::Verbose) << "Loaded global map from " << path;
+            return true;
+        }
+
+        /// Only the map of the current content is kept, files of other keys are never read again unless the content is switched back
+        void removeStaleCacheFiles(const boost::filesystem::path& current) const
+        {
+            boost::system::error_code ec;
+            for (boost::filesystem::directory_iterator it(current.parent_path(), ec), end; !ec && it != end; it.increment(ec))
+            {
+                const boost::filesystem::path& path = it->path();
+                if (path != current && (path.extension() == ".map" || path.extension() == ".tmp"))
+                {
+                    boost::system::error_code removeEc;
+                    if (boost::filesystem::remove(path, removeEc))
+                        Log(Debug::Verbose) << "Removed stale global map cache file " << path;
+                }
+            }
+        }
+
+        void writeCache(const boost::filesystem::path& path, const std::array<std::uint64_t, 2>& key, const osg::Image& image, const osg::Image& alphaImage) const
+        {
+            const boost::filesystem::path tmpPath = path.string() + ".tmp";
+            try
+            {
+                boost::filesystem::create_directories(path.parent_path());
+                {
+                    boost::filesystem::ofstream stream(tmpPath, std::ios::binary);
+                    const CacheHeader header {key, sCacheVersion, mWidth, mHeight, 0};
+                    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                    stream.write(reinterpret_cast<const char*>(image.data()), image.getTotalSizeInBytes());
+                    stream.write(reinterpret_cast<const char*>(alphaImage.data()), alphaImage.getTotalSizeInBytes());
+                    if (!stream)
+                        throw std::runtime_error("failed to write file");
+                }
+                boost::filesystem::rename(tmpPath, path);
+            }
+            catch (const std::exception& e)
+            {
+                Log(Debug::Warning) << "Failed to write global map cache file " << path << ": " << e.what();
+                boost::system::error_code ec;
+                boost::filesystem::remove(tmpPath, ec);
+            }
+        }
     };
 
-    GlobalMap::GlobalMap(osg::Group* root, SceneUtil::WorkQueue* workQueue)
+    GlobalMap::GlobalMap(osg::Group* root, SceneUtil::WorkQueue* workQueue, const std::string& cachePath)
         : mRoot(root)
         , mWorkQueue(workQueue)
         , mWidth(0)
@@ -231,6 +477,8 @@ namespace MWRender
 
     {
         mCellSize = Settings::Manager::getInt("global map cell size", "Map");
+        if (Settings::Manager::getBool("global map cache", "Map") && !cachePath.empty())
+            mCachePath = (boost::filesystem::path(cachePath) / "globalmap").string();
     }
 
     GlobalMap::~GlobalMap()
@@ -266,7 +514,8 @@ namespace MWRender
         mWidth = mCellSize*(mMaxX-mMinX+1);
         mHeight = mCellSize*(mMaxY-mMinY+1);
 
-        mWorkItem = new CreateMapWorkItem(mWidth, mHeight, mMinX, mMinY, mMaxX, mMaxY, mCellSize, esmStore.get<ESM::Land>());
+        mWorkItem = new CreateMapWorkItem(mWidth, mHeight, mMinX, mMinY, mMaxX, mMaxY, mCellSize, esmStore.get<ESM::Land>(),
+                                          MWBase::Environment::get().getWorld()->getContentFiles(), mCachePath, mWorkQueue);
         mWorkQueue->addWorkItem(mWorkItem);
     }
 
@@ -33,7 +33,8 @@ namespace MWRender
     class GlobalMap
     {
     public:
-        GlobalMap(osg::Group* root, SceneUtil::WorkQueue* workQueue);
+        /// @param cachePath directory to store the rendered base map in, used when "global map cache" is enabled
+        GlobalMap(osg::Group* root, SceneUtil::WorkQueue* workQueue, const std::string& cachePath);
         ~GlobalMap();
 
         void render();
@@ -83,6 +84,8 @@ namespace MWRender
 
         int mCellSize;
 
+        std::string mCachePath;
+
         osg::ref_ptr<osg::Group> mRoot;
 
         typedef std::vector<osg::ref_ptr<osg::Camera> > CameraVector;
@@ -7,7 +7,6 @@
 #include <osg/VertexAttribDivisor>
 #include <osg/Program>
 
-#include <components/esm/esmreader.hpp>
 #include <components/sceneutil/lightmanager.hpp>
 #include <components/sceneutil/nodecallback.hpp>
 #include <components/terrain/quadtreenode.hpp>
@@ -22,10 +21,10 @@ namespace MWRender
     class InstancingVisitor : public osg::NodeVisitor
     {
     public:
-        InstancingVisitor(std::vector<Groundcover::GroundcoverEntry>& instances, osg::Vec3f& chunkPosition)
+        InstancingVisitor(osg::Vec4Array* transforms, osg::Vec3Array* rotations)
         : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
-        , mInstances(instances)
-        , mChunkPosition(chunkPosition)
+        , mTransforms(transforms)
+        , mRotations(rotations)
         {
         }
 
@@ -33,42 +32,31 @@ namespace MWRender
         {
             for (unsigned int i = 0; i < geom.getNumPrimitiveSets(); ++i)
             {
-                geom.getPrimitiveSet(i)->setNumInstances(mInstances.size());
+                geom.getPrimitiveSet(i)->setNumInstances(mTransforms->size());
             }
 
-            osg::ref_ptr<osg::Vec4Array> transforms = new osg::Vec4Array(mInstances.size());
             osg::BoundingBox box;
             float radius = geom.getBoundingBox().radius();
-            for (unsigned int i = 0; i < transforms->getNumElements(); i++)
+            for (const osg::Vec4f& transform : *mTransforms)
             {
-                osg::Vec3f pos(mInstances[i].mPos.asVec3());
-                osg::Vec3f relativePos = pos - mChunkPosition;
-                (*transforms)[i] = osg::Vec4f(relativePos, mInstances[i].mScale);
-
                 // Use an additional margin due to groundcover animation
-                float instanceRadius = radius * mInstances[i].mScale * 1.1f;
-                osg::BoundingSphere instanceBounds(relativePos, instanceRadius);
+                float instanceRadius = radius * transform.w() * 1.1f;
+                osg::BoundingSphere instanceBounds(osg::Vec3f(transform.x(), transform.y(), transform.z()), instanceRadius);
                 box.expandBy(instanceBounds);
             }
 
             geom.setInitialBound(box);
 
-            osg::ref_ptr<osg::Vec3Array> rotations = new osg::Vec3Array(mInstances.size());
-            for (unsigned int i = 0; i < rotations->getNumElements(); i++)
-            {
-                (*rotations)[i] = mInstances[i].mPos.asRotationVec3();
-            }
-
             // Display lists do not support instancing in OSG 3.4
             geom.setUseDisplayList(false);
             geom.setUseVertexBufferObjects(true);
 
-            geom.setVertexAttribArray(6, transforms.get(), osg::Array::BIND_PER_VERTEX);
-            geom.setVertexAttribArray(7, rotations.get(), osg::Array::BIND_PER_VERTEX);
+            geom.setVertexAttribArray(6, mTransforms.get(), osg::Array::BIND_PER_VERTEX);
+            geom.setVertexAttribArray(7, mRotations.get(), osg::Array::BIND_PER_VERTEX);
         }
     private:
-        std::vector<Groundcover::GroundcoverEntry> mInstances;
-        osg::Vec3f mChunkPosition;
+        osg::ref_ptr<osg::Vec4Array> mTransforms;
+        osg::ref_ptr<osg::Vec3Array> mRotations;
     };
 
     class DensityCalculator
@@ -111,13 +99,12 @@ namespace MWRender
         osg::BoundingBox mBox;
     };
 
-    inline bool isInChunkBorders(ESM::CellRef& ref, osg::Vec2f& minBound, osg::Vec2f& maxBound)
+    inline bool isInChunkBorders(const osg::Vec3f& position, const osg::Vec2f& minBound, const osg::Vec2f& maxBound)
     {
         osg::Vec2f size = maxBound - minBound;
         if (size.x() >=1 && size.y() >=1) return true;
 
-        osg::Vec3f pos = ref.mPos.asVec3();
-        osg::Vec3f cellPos = pos / ESM::Land::REAL_SIZE;
+        osg::Vec3f cellPos = position / ESM::Land::REAL_SIZE;
         if ((minBound.x() > std::floor(minBound.x()) && cellPos.x() < minBound.x()) || (minBound.y() > std::floor(minBound.y()) && cellPos.y() < minBound.y())
             || (maxBound.x() < std::ceil(maxBound.x()) && cellPos.x() >= maxBound.x()) || (maxBound.y() < std::ceil(maxBound.y()) && cellPos.y() >= maxBound.y()))
             return false;
@@ -137,7 +124,7 @@ namespace MWRender
         {
             InstanceMap instances;
             collectInstances(instances, size, center);
-            osg::ref_ptr<osg::Node> node = createChunk(instances, center);
+            osg::ref_ptr<osg::Node> node = createChunk(instances);
             mCache->addEntryToObjectCache(id, node.get());
             return node;
         }
@@ -175,62 +162,41 @@ namespace MWRender
 
         osg::Vec2f minBound = (center - osg::Vec2f(size/2.f, size/2.f));
         osg::Vec2f maxBound = (center + osg::Vec2f(size/2.f, size/2.f));
+        osg::Vec3f worldCenter = osg::Vec3f(center.x(), center.y(), 0)*ESM::Land::REAL_SIZE;
         DensityCalculator calculator(mDensity);
-        std::vector<ESM::ESMReader> esm;
         osg::Vec2i startCell = osg::Vec2i(std::floor(center.x() - size/2.f), std::floor(center.y() - size/2.f));
         for (int cellX = startCell.x(); cellX < startCell.x() + size; ++cellX)
         {
             for (int cellY = startCell.y(); cellY < startCell.y() + size; ++cellY)
             {
-                ESM::Cell cell;
-                mGroundcoverStore.initCell(cell, cellX, cellY);
-                if (cell.mContextList.empty()) continue;
-
+                // The density is applied to the whole cell before clipping to the chunk,
+                // so that chunks of different sizes pick the same instances
                 calculator.reset();
-                std::map<ESM::RefNum, ESM::CellRef> refs;
-                for (size_t i=0; i<cell.mContextList.size(); ++i)
+                const MWWorld::GroundcoverCell& cell = mGroundcoverStore.getCellInstances(cellX, cellY);
+                for (std::size_t i = 0; i < cell.mModels.size(); ++i)
                 {
-                    unsigned int index = cell.mContextList[i].index;
-                    if (esm.size() <= index)
-                        esm.resize(index+1);
-                    cell.restore(esm[index], i);
-                    ESM::CellRef ref;
-                    ref.mRefNum.unset();
-                    bool deleted = false;
-                    while(cell.getNextRef(esm[index], ref, deleted))
-                    {
-                        if (!deleted && refs.find(ref.mRefNum) == refs.end() && !calculator.isInstanceEnabled()) deleted = true;
-                        if (!deleted && !isInChunkBorders(ref, minBound, maxBound)) deleted = true;
-
-                        if (deleted) { refs.erase(ref.mRefNum); continue; }
-                        refs[ref.mRefNum] = std::move(ref);
-                    }
-                }
-
-                for (auto& pair : refs)
-                {
-                    ESM::CellRef& ref = pair.second;
-                    const std::string& model = mGroundcoverStore.getGroundcoverModel(ref.mRefID);
-                    if (!model.empty())
-                        instances[model].emplace_back(std::move(ref));
+                    if (!calculator.isInstanceEnabled()) continue;
+                    if (!isInChunkBorders(cell.mPositions[i], minBound, maxBound)) continue;
+                    Instances& modelInstances = instances[cell.mModels[i]];
+                    modelInstances.mTransforms->push_back(osg::Vec4f(cell.mPositions[i] - worldCenter, cell.mScales[i]));
+                    modelInstances.mRotations->push_back(cell.mRotations[i]);
                 }
             }
         }
     }
 
-    osg::ref_ptr<osg::Node> Groundcover::createChunk(InstanceMap& instances, const osg::Vec2f& center)
+    osg::ref_ptr<osg::Node> Groundcover::createChunk(InstanceMap& instances)
     {
         osg::ref_ptr<osg::Group> group = new osg::Group;
-        osg::Vec3f worldCenter = osg::Vec3f(center.x(), center.y(), 0)*ESM::Land::REAL_SIZE;
         for (auto& pair : instances)
         {
-            const osg::Node* temp = mSceneManager->getTemplate(pair.first);
+            const osg::Node* temp = mSceneManager->getTemplate(mGroundcoverStore.getModel(pair.first));
             osg::ref_ptr<osg::Node> node = static_cast<osg::Node*>(temp->clone(osg::CopyOp::DEEP_COPY_NODES|osg::CopyOp::DEEP_COPY_DRAWABLES|osg::CopyOp::DEEP_COPY_USERDATA|osg::CopyOp::DEEP_COPY_ARRAYS|osg::CopyOp::DEEP_COPY_PRIMITIVES));
 
             // Keep link to original mesh to keep it in cache
             group->getOrCreateUserDataContainer()->addUserObject(new Resource::TemplateRef(temp));
 
-            InstancingVisitor visitor(pair.second, worldCenter);
+            InstancingVisitor visitor(pair.second.mTransforms, pair.second.mRotations);
             node->accept(visitor);
             group->addChild(node);
         }
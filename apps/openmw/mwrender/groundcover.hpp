@@ -1,6 +1,8 @@
 #ifndef OPENMW_MWRENDER_GROUNDCOVER_H
 #define OPENMW_MWRENDER_GROUNDCOVER_H
 
+#include <osg/Array>
+
 #include <components/terrain/quadtreeworld.hpp>
 #include <components/resource/scenemanager.hpp>
 #include <components/esm/loadcell.hpp>
@@ -30,15 +32,6 @@ namespace MWRender
 
         void reportStats(unsigned int frameNumber, osg::Stats* stats) const override;
 
-        struct GroundcoverEntry
-        {
-            ESM::Position mPos;
-            float mScale;
-
-            GroundcoverEntry(const ESM::CellRef& ref) : mPos(ref.mPos), mScale(ref.mScale)
-            {}
-        };
-
     private:
         Resource::SceneManager* mSceneManager;
         float mDensity;
@@ -46,8 +39,14 @@ namespace MWRender
         osg::ref_ptr<osg::Program> mProgramTemplate;
         const MWWorld::GroundcoverStore& mGroundcoverStore;
 
-        typedef std::map<std::string, std::vector<GroundcoverEntry>> InstanceMap;
-        osg::ref_ptr<osg::Node> createChunk(InstanceMap& instances, const osg::Vec2f& center);
+        /// Vertex attributes of the instances of a model, shared by all its geometries
+        struct Instances
+        {
+            osg::ref_ptr<osg::Vec4Array> mTransforms = new osg::Vec4Array; // Position relative to the chunk, scale
+            osg::ref_ptr<osg::Vec3Array> mRotations = new osg::Vec3Array;
+        };
+        typedef std::map<std::uint32_t, Instances> InstanceMap; // Model id, instances
+        osg::ref_ptr<osg::Node> createChunk(InstanceMap& instances);
         void collectInstances(InstanceMap& instances, float size, const osg::Vec2f& center);
     };
 }
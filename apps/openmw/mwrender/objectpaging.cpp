@@ -1,5 +1,6 @@
 #include "objectpaging.hpp"
 
+#include <algorithm>
 #include <unordered_map>
 
 #include <osg/Version>
@@ -9,6 +10,7 @@
 #include <osg/Material>
 #include <osgUtil/IncrementalCompileOperation>
 
+#include <components/debug/debuglog.hpp>
 #include <components/esm/esmreader.hpp>
 #include <components/misc/resourcehelpers.hpp>
 #include <components/resource/scenemanager.hpp>
@@ -31,6 +33,7 @@
 #include "apps/openmw/mwbase/environment.hpp"
 #include "apps/openmw/mwbase/world.hpp"
 
+#include "objectpagingcache.hpp"
 #include "vismask.hpp"
 
 namespace MWRender
@@ -379,7 +382,7 @@ namespace MWRender
         }
     };
 
-    ObjectPaging::ObjectPaging(Resource::SceneManager* sceneManager)
+    ObjectPaging::ObjectPaging(Resource::SceneManager* sceneManager, const std::string& cachePath)
             : GenericResourceManager<ChunkId>(nullptr)
          , mSceneManager(sceneManager)
          , mRefTrackerLocked(false)
@@ -390,8 +393,30 @@ namespace MWRender
         mMinSize = Settings::Manager::getFloat("object paging min size", "Terrain");
         mMinSizeMergeFactor = Settings::Manager::getFloat("object paging min size merge factor", "Terrain");
         mMinSizeCostMultiplier = Settings::Manager::getFloat("object paging min size cost multiplier", "Terrain");
+        mLodFactor = Settings::Manager::getFloat("lod factor", "Terrain");
+        // The thread building a chunk takes part in merging it
+        const int optimizerThreads = Settings::Manager::getInt("object paging optimizer threads", "Terrain");
+        if (optimizerThreads > 1)
+            mOptimizerJobPool = std::make_unique<Misc::JobPool>(static_cast<std::size_t>(optimizerThreads - 1));
+
+        if (Settings::Manager::getBool("object paging disk cache", "Terrain") && !cachePath.empty())
+        {
+            const boost::filesystem::path path = boost::filesystem::path(cachePath) / "objectpaging";
+            try
+            {
+                const int maxSize = Settings::Manager::getInt("object paging disk cache size", "Terrain");
+                mDiskCache = std::make_unique<ObjectPagingCache>(path, static_cast<std::uint64_t>(std::max(0, maxSize)) * 1024 * 1024);
+                Log(Debug::Info) << "Using object paging disk cache " << path;
+            }
+            catch (const std::exception& e)
+            {
+                Log(Debug::Warning) << "Failed to create object paging disk cache " << path << ": " << e.what();
+            }
+        }
     }
 
+    ObjectPaging::~ObjectPaging() = default;
+
     osg::ref_ptr<osg::Node> ObjectPaging::createChunk(float size, const osg::Vec2f& center, bool activeGrid, const osg::Vec3f& viewPoint, bool compile)
     {
         osg::Vec2i startCell = osg::Vec2i(std::floor(center.x() - size/2.f), std::floor(center.y() - size/2.f));
@@ -399,6 +424,17 @@ namespace MWRender
         osg::Vec3f worldCenter = osg::Vec3f(center.x(), center.y(), 0)*ESM::Land::REAL_SIZE;
         osg::Vec3f relativeViewPoint = viewPoint - worldCenter;
 
+        // The merged part of a chunk stored in the disk cache must not depend on where the chunk was first seen from.
+        // It is selected and built for the nearest distance the quadtree uses a chunk of this size at, which no
+        // reference of the chunk is closer to the camera than. The references that are not merged are filtered by the
+        // actual view point once the cache is looked up.
+        const bool viewIndependentMerge = mDiskCache != nullptr;
+        const float mergeDistance = activeGrid ? 0.f : size * ESM::Land::REAL_SIZE * mLodFactor;
+        auto getMergeSqrDistance = [&] (const osg::Vec3f& pos)
+        {
+            return viewIndependentMerge ? mergeDistance * mergeDistance : (viewPoint - pos).length2();
+        };
+
         std::map<ESM::RefNum, ESM::CellRef> refs;
         std::vector<ESM::ESMReader> esm;
         const MWWorld::ESMStore& store = MWBase::Environment::get().getWorld()->getStore();
@@ -464,8 +500,19 @@ namespace MWRender
             std::vector<const ESM::CellRef*> mInstances;
             AnalyzeVisitor::Result mAnalyzeResult;
             bool mNeedCompile = false;
+            bool mMerge = false;
+            float mMinSize = 0;
+            std::string mModel;
         };
         typedef std::map<osg::ref_ptr<const osg::Node>, InstanceList> NodeMap;
+        auto filterInstances = [] (const osg::Node* cnode, InstanceList& instanceList, const auto& getSqrDistance)
+        {
+            auto& instances = instanceList.mInstances;
+            instances.erase(std::remove_if(instances.begin(), instances.end(), [&] (const ESM::CellRef* cref)
+            {
+                return cnode->getBound().radius2() * cref->mScale*cref->mScale < getSqrDistance(cref->mPos.asVec3())*instanceList.mMinSize*instanceList.mMinSize;
+            }), instances.end());
+        };
         NodeMap nodes;
         osg::ref_ptr<RefnumSet> refnumSet = activeGrid ? new RefnumSet : nullptr;
 
@@ -476,7 +523,7 @@ namespace MWRender
         constexpr auto copyMask = ~Mask_UpdateVisitor;
 
         AnalyzeVisitor analyzeVisitor(copyMask);
-        analyzeVisitor.mCurrentDistance = (viewPoint - worldCenter).length2();
+        analyzeVisitor.mCurrentDistance = getMergeSqrDistance(worldCenter);
         float minSize = mMinSize;
         if (mMinSizeMergeFactor)
             minSize *= mMinSizeMergeFactor;
@@ -493,7 +540,7 @@ namespace MWRender
                     continue;
             }
 
-            float dSqr = (viewPoint - pos).length2();
+            float dSqr = getMergeSqrDistance(pos);
             if (!activeGrid)
             {
                 std::lock_guard<std::mutex> lock(mSizeCacheMutex);
@@ -552,27 +599,23 @@ namespace MWRender
                 const_cast<osg::Node*>(cnode.get())->accept(analyzeVisitor); // const-trickery required because there is no const version of NodeVisitor
                 emplaced.first->second.mAnalyzeResult = analyzeVisitor.retrieveResult();
                 emplaced.first->second.mNeedCompile = compile && cnode->referenceCount() <= 3;
+                emplaced.first->second.mModel = model;
             }
             else
                 analyzeVisitor.addInstance(emplaced.first->second.mAnalyzeResult);
             emplaced.first->second.mInstances.push_back(&ref);
         }
 
-        osg::ref_ptr<osg::Group> group = new osg::Group;
-        osg::ref_ptr<osg::Group> mergeGroup = new osg::Group;
-        osg::ref_ptr<Resource::TemplateMultiRef> templateRefs = new Resource::TemplateMultiRef;
-        osgUtil::StateToCompile stateToCompile(0, nullptr);
-        CopyOp copyop;
-        copyop.mCopyMask = copyMask;
-        for (const auto& pair : nodes)
+        for (auto& pair : nodes)
         {
             const osg::Node* cnode = pair.first;
+            InstanceList& instanceList = pair.second;
 
-            const AnalyzeVisitor::Result& analyzeResult = pair.second.mAnalyzeResult;
+            const AnalyzeVisitor::Result& analyzeResult = instanceList.mAnalyzeResult;
 
             float mergeCost = analyzeResult.mNumVerts * size;
             float mergeBenefit = analyzeVisitor.getMergeBenefit(analyzeResult) * mMergeFactor;
-            bool merge = mergeBenefit > mergeCost;
+            instanceList.mMerge = mergeBenefit > mergeCost;
 
             float minSizeMerged = mMinSize;
             float factor2 = mergeBenefit > 0 ? std::min(1.f, mergeCost * mMinSizeCostMultiplier / mergeBenefit) : 1;
@@ -580,15 +623,90 @@ namespace MWRender
             if (minSizeMergeFactor2 > 0)
                 minSizeMerged *= minSizeMergeFactor2;
 
+            instanceList.mMinSize = minSizeMerged;
+            if (!activeGrid && minSizeMerged != minSize && (instanceList.mMerge || !viewIndependentMerge))
+                filterInstances(cnode, instanceList, getMergeSqrDistance);
+        }
+
+        // The merged part of the chunk is looked up in the disk cache before anything is copied. The key covers every reference of the chunk before
+        // the size filters and the settings the merged part depends on. The entry records the merged models, it is rebuilt when they differ.
+        // NodeMap is ordered by pointer, sort by model to get the same order in every session.
+        std::vector<const NodeMap::value_type*> mergedTemplates;
+        for (const auto& pair : nodes)
+            if (pair.second.mMerge && !pair.second.mInstances.empty())
+                mergedTemplates.push_back(&pair);
+        std::sort(mergedTemplates.begin(), mergedTemplates.end(), [] (const NodeMap::value_type* lhs, const NodeMap::value_type* rhs) { return lhs->second.mModel < rhs->second.mModel; });
+
+        std::vector<ObjectPagingCache::Template> cacheTemplates;
+        ObjectPagingCache::Key cacheKey {};
+        osg::ref_ptr<osg::Group> cachedMergeGroup;
+        if (mDiskCache && !mergedTemplates.empty())
+        {
+            for (const NodeMap::value_type* pair : mergedTemplates)
+            {
+                const std::string& model = pair->second.mModel;
+                cacheTemplates.push_back({model, mDiskCache->getContentHash(*mSceneManager->getVFS(), model), pair->first});
+            }
+            std::string keyData;
+            auto append = [&] (const auto& value) { keyData.append(reinterpret_cast<const char*>(&value), sizeof(value)); };
+            append(size);
+            append(center.x());
+            append(center.y());
+            append(activeGrid);
+            append(mMergeFactor);
+            append(mMinSize);
+            append(mMinSizeMergeFactor);
+            append(mMinSizeCostMultiplier);
+            append(mLodFactor);
+            for (const std::string& contentFile : MWBase::Environment::get().getWorld()->getContentFiles())
+                keyData.append(contentFile).push_back('\0');
+            {
+                std::lock_guard<std::mutex> lock(mRefTrackerMutex);
+                for (const auto& pair : refs)
+                {
+                    const ESM::CellRef& ref = pair.second;
+                    append(ref.mRefNum.mIndex);
+                    append(ref.mRefNum.mContentFile);
+                    keyData.append(ref.mRefID).push_back('\0');
+                    append(ref.mPos);
+                    append(ref.mScale);
+                    append(getRefTracker().mDisabled.count(pair.first) > 0);
+                }
+            }
+            cacheKey = ObjectPagingCache::makeKey(keyData);
+            cachedMergeGroup = mDiskCache->read(cacheKey, cacheTemplates);
+        }
+
+        if (viewIndependentMerge && !activeGrid)
+        {
+            for (auto& pair : nodes)
+                if (!pair.second.mMerge)
+                    filterInstances(pair.first, pair.second, [&] (const osg::Vec3f& pos) { return (viewPoint - pos).length2(); });
+        }
+
+        osg::ref_ptr<osg::Group> group = new osg::Group;
+        osg::ref_ptr<osg::Group> mergeGroup = cachedMergeGroup ? cachedMergeGroup : new osg::Group;
+        osg::ref_ptr<Resource::TemplateMultiRef> templateRefs = new Resource::TemplateMultiRef;
+        osgUtil::StateToCompile stateToCompile(0, nullptr);
+        CopyOp copyop;
+        copyop.mCopyMask = copyMask;
+        for (const auto& pair : nodes)
+        {
+            const osg::Node* cnode = pair.first;
+            const bool merge = pair.second.mMerge;
+
             unsigned int numinstances = 0;
             for (auto cref : pair.second.mInstances)
             {
+                if (merge && cachedMergeGroup)
+                {
+                    ++numinstances;
+                    continue;
+                }
+
                 const ESM::CellRef& ref = *cref;
                 osg::Vec3f pos = ref.mPos.asVec3();
 
-                if (!activeGrid && minSizeMerged != minSize && cnode->getBound().radius2() * cref->mScale*cref->mScale < (viewPoint-pos).length2()*minSizeMerged*minSizeMerged)
-                    continue;
-
                 osg::Vec3f nodePos = pos - worldCenter;
                 osg::Quat nodeAttitude = osg::Quat(ref.mPos.rot[2], osg::Vec3f(0,0,-1)) *
                                         osg::Quat(ref.mPos.rot[1], osg::Vec3f(0,-1,0)) *
@@ -620,9 +738,10 @@ namespace MWRender
                 // - When Arrays are removed or replaced in the cloned geometry, the original Arrays in their place must outlive the cloned geometry regardless. (ensured by TemplateMultiRef)
                 // - Arrays that we add or replace in the cloned geometry must be explicitely forbidden from reusing BufferObjects of the original geometry. (ensured by needvbo() in optimizer.cpp)
                 copyop.setCopyFlags(merge ? osg::CopyOp::DEEP_COPY_NODES|osg::CopyOp::DEEP_COPY_DRAWABLES : osg::CopyOp::DEEP_COPY_NODES);
-                copyop.mOptimizeBillboards = (size > 1/4.f);
+                // Billboards baked for a view point would make a cached chunk depend on it, a chunk keeping them is not cached
+                copyop.mOptimizeBillboards = (size > 1/4.f) && !(merge && viewIndependentMerge);
                 copyop.mNodePath.push_back(trans);
-                copyop.mSqrDistance = (viewPoint - pos).length2();
+                copyop.mSqrDistance = merge ? getMergeSqrDistance(pos) : (viewPoint - pos).length2();
                 copyop.mViewVector = (viewPoint - worldCenter);
                 copyop.copy(cnode, trans);
                 copyop.mNodePath.pop_back();
@@ -664,16 +783,24 @@ namespace MWRender
 
         if (mergeGroup->getNumChildren())
         {
-            SceneUtil::Optimizer optimizer;
-            if (size > 1/8.f)
+            if (!cachedMergeGroup)
             {
-                optimizer.setViewPoint(relativeViewPoint);
-                optimizer.setMergeAlphaBlending(true);
-            }
-            optimizer.setIsOperationPermissibleForObjectCallback(new CanOptimizeCallback);
-            unsigned int options = SceneUtil::Optimizer::FLATTEN_STATIC_TRANSFORMS|SceneUtil::Optimizer::REMOVE_REDUNDANT_NODES|SceneUtil::Optimizer::MERGE_GEOMETRY;
+                SceneUtil::Optimizer optimizer;
+                if (size > 1/8.f)
+                {
+                    optimizer.setViewPoint(viewIndependentMerge ? osg::Vec3f(0, 0, mergeDistance) : relativeViewPoint);
+                    optimizer.setMergeAlphaBlending(true);
+                }
+                optimizer.setIsOperationPermissibleForObjectCallback(new CanOptimizeCallback);
+                optimizer.setJobPool(mOptimizerJobPool.get());
+                unsigned int options = SceneUtil::Optimizer::FLATTEN_STATIC_TRANSFORMS|SceneUtil::Optimizer::REMOVE_REDUNDANT_NODES|SceneUtil::Optimizer::MERGE_GEOMETRY;
 
-            optimizer.optimize(mergeGroup, options);
+                optimizer.optimize(mergeGroup, options);
+                *mLastOptimizerTimings.lock() = optimizer.getTimings();
+
+                if (mDiskCache && !cacheTemplates.empty())
+                    mDiskCache->write(cacheKey, *mergeGroup, cacheTemplates);
+            }
 
             group->addChild(mergeGroup);
 
@@ -842,6 +969,11 @@ namespace MWRender
     void ObjectPaging::reportStats(unsigned int frameNumber, osg::Stats *stats) const
     {
         stats->setAttribute(frameNumber, "Object Chunk", mCache->getCacheSize());
+
+        // Reported in microseconds to be readable in the statistics overlay
+        const SceneUtil::Optimizer::Timings timings = mLastOptimizerTimings.lockConst().get();
+        stats->setAttribute(frameNumber, "Object Flatten", timings._flattenStaticTransforms * 1e6);
+        stats->setAttribute(frameNumber, "Object Merge", timings._mergeGeometry * 1e6);
     }
 
 }
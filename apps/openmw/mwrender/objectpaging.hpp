@@ -4,7 +4,11 @@
 #include <components/terrain/quadtreeworld.hpp>
 #include <components/resource/resourcemanager.hpp>
 #include <components/esm/loadcell.hpp>
+#include <components/misc/guarded.hpp>
+#include <components/misc/jobpool.hpp>
+#include <components/sceneutil/optimizer.hpp>
 
+#include <memory>
 #include <mutex>
 
 namespace Resource
@@ -18,14 +22,16 @@ namespace MWWorld
 
 namespace MWRender
 {
+    class ObjectPagingCache;
 
     typedef std::tuple<osg::Vec2f, float, bool> ChunkId; // Center, Size, ActiveGrid
 
     class ObjectPaging : public Resource::GenericResourceManager<ChunkId>, public Terrain::QuadTreeWorld::ChunkManager
     {
     public:
-        ObjectPaging(Resource::SceneManager* sceneManager);
-        ~ObjectPaging() = default;
+        /// @param cachePath directory for the persistent cache of merged chunks, used when "object paging disk cache" is enabled
+        ObjectPaging(Resource::SceneManager* sceneManager, const std::string& cachePath);
+        ~ObjectPaging();
 
         osg::ref_ptr<osg::Node> getChunk(float size, const osg::Vec2f& center, unsigned char lod, unsigned int lodFlags, bool activeGrid, const osg::Vec3f& viewPoint, bool compile) override;
 
@@ -57,6 +63,13 @@ namespace MWRender
         float mMinSize;
         float mMinSizeMergeFactor;
         float mMinSizeCostMultiplier;
+        float mLodFactor;
+        /// Helps the threads building chunks to merge their geometry, nullptr to merge in those threads only
+        std::unique_ptr<Misc::JobPool> mOptimizerJobPool;
+
+        Misc::ScopeGuarded<SceneUtil::Optimizer::Timings> mLastOptimizerTimings;
+
+        std::unique_ptr<ObjectPagingCache> mDiskCache;
 
         std::mutex mRefTrackerMutex;
         struct RefTracker
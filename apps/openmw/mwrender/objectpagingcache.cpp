@@ -0,0 +1,982 @@
+#include "objectpagingcache.hpp"
+
+#include <osg/AlphaFunc>
+#include <osg/BlendFunc>
+#include <osg/CullFace>
+#include <osg/Geometry>
+#include <osg/Material>
+#include <osg/MatrixTransform>
+#include <osg/Program>
+#include <osg/TexEnv>
+#include <osg/Texture>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <components/debug/debuglog.hpp>
+#include <components/sceneutil/depth.hpp>
+#include <components/sceneutil/morphgeometry.hpp>
+#include <components/sceneutil/riggeometry.hpp>
+#include <components/vfs/manager.hpp>
+
+#include <extern/smhasher/MurmurHash3.h>
+
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+
+#include "objectpaging.hpp"
+
+namespace MWRender
+{
+    namespace
+    {
+        constexpr char sMagic[] = {'O', 'M', 'W', 'P'};
+        constexpr std::uint32_t sFormatVersion = 2;
+        // Limits to fail fast on a corrupt entry instead of allocating memory or recursing according to garbage,
+        // far beyond anything a chunk contains
+        constexpr std::uint32_t sMaxCount = 1 << 24;
+        constexpr std::uint32_t sMaxNodeDepth = 64;
+
+        enum NodeType : std::uint8_t
+        {
+            NodeType_Group = 0,
+            NodeType_MatrixTransform = 1,
+            NodeType_Geometry = 2,
+        };
+
+        enum StateSetType : std::uint8_t
+        {
+            StateSetType_None = 0,
+            StateSetType_Template = 1,
+            // A state set that is not part of the templates and only disables depth writes,
+            // created by the optimizer for merged alpha blended geometry
+            StateSetType_NoDepthWrite = 2,
+        };
+
+        struct UnsupportedNode : std::runtime_error
+        {
+            using std::runtime_error::runtime_error;
+        };
+
+        /// Collects the bytes describing the content of a state set, so equal state sets of different sessions get
+        /// the same hash
+        class StateSetHasher
+        {
+        public:
+            ObjectPagingCache::Key hash(const osg::StateSet& stateSet)
+            {
+                mData.clear();
+                add(stateSet.getRenderingHint());
+                add(static_cast<std::int32_t>(stateSet.getRenderBinMode()));
+                add(stateSet.getBinNumber());
+                add(stateSet.getBinName());
+                add(stateSet.getNestRenderBins());
+                addModes(stateSet.getModeList());
+                addAttributes(stateSet.getAttributeList());
+                add(stateSet.getTextureModeList().size());
+                for (const osg::StateSet::ModeList& modes : stateSet.getTextureModeList())
+                    addModes(modes);
+                add(stateSet.getTextureAttributeList().size());
+                for (const osg::StateSet::AttributeList& attributes : stateSet.getTextureAttributeList())
+                    addAttributes(attributes);
+                add(stateSet.getUniformList().size());
+                for (const auto& [name, uniform] : stateSet.getUniformList())
+                {
+                    add(name);
+                    add(uniform.second);
+                    addUniform(*uniform.first);
+                }
+                add(stateSet.getDefineList().size());
+                for (const auto& [name, define] : stateSet.getDefineList())
+                {
+                    add(name);
+                    add(define.first);
+                    add(define.second);
+                }
+                return ObjectPagingCache::makeKey(mData);
+            }
+
+        private:
+            std::string mData;
+
+            template <class T>
+            void add(const T& value)
+            {
+                static_assert(std::is_arithmetic_v<T>);
+                mData.append(reinterpret_cast<const char*>(&value), sizeof(value));
+            }
+
+            void add(const std::string& value)
+            {
+                add(value.size());
+                mData.append(value);
+            }
+
+            void add(const osg::Vec4f& value)
+            {
+                for (int i = 0; i < 4; ++i)
+                    add(value[i]);
+            }
+
+            void addData(const osg::Array* array)
+            {
+                add(static_cast<std::uint8_t>(array != nullptr));
+                if (array != nullptr)
+                    mData.append(static_cast<const char*>(array->getDataPointer()), array->getTotalDataSize());
+            }
+
+            void addModes(const osg::StateSet::ModeList& modes)
+            {
+                add(modes.size());
+                for (const auto& [mode, value] : modes)
+                {
+                    add(mode);
+                    add(value);
+                }
+            }
+
+            void addAttributes(const osg::StateSet::AttributeList& attributes)
+            {
+                add(attributes.size());
+                for (const auto& [typeMember, attribute] : attributes)
+                {
+                    add(static_cast<std::int32_t>(typeMember.first));
+                    add(typeMember.second);
+                    add(attribute.second);
+                    addAttribute(*attribute.first);
+                }
+            }
+
+            void addImage(const osg::Image* image)
+            {
+                add(static_cast<std::uint8_t>(image != nullptr));
+                if (image == nullptr)
+                    return;
+                add(image->getFileName());
+                if (!image->getFileName().empty())
+                    return;
+                add(image->s());
+                add(image->t());
+                add(image->r());
+                add(image->getPixelFormat());
+                add(image->getDataType());
+                if (image->data() != nullptr)
+                    mData.append(reinterpret_cast<const char*>(image->data()), image->getTotalSizeInBytes());
+            }
+
+            void addAttribute(const osg::StateAttribute& attribute)
+            {
+                add(std::string(attribute.libraryName()));
+                add(std::string(attribute.className()));
+
+                if (const auto texture = dynamic_cast<const osg::Texture*>(&attribute))
+                {
+                    add(texture->getNumImages());
+                    for (unsigned int i = 0; i < texture->getNumImages(); ++i)
+                        addImage(texture->getImage(i));
+                    add(static_cast<std::int32_t>(texture->getFilter(osg::Texture::MIN_FILTER)));
+                    add(static_cast<std::int32_t>(texture->getFilter(osg::Texture::MAG_FILTER)));
+                    add(static_cast<std::int32_t>(texture->getWrap(osg::Texture::WRAP_S)));
+                    add(static_cast<std::int32_t>(texture->getWrap(osg::Texture::WRAP_T)));
+                    add(static_cast<std::int32_t>(texture->getWrap(osg::Texture::WRAP_R)));
+                }
+                else if (const auto material = dynamic_cast<const osg::Material*>(&attribute))
+                {
+                    for (const osg::Material::Face face : {osg::Material::FRONT, osg::Material::BACK})
+                    {
+                        add(material->getAmbient(face));
+                        add(material->getDiffuse(face));
+                        add(material->getSpecular(face));
+                        add(material->getEmission(face));
+                        add(material->getShininess(face));
+                    }
+                    add(static_cast<std::int32_t>(material->getColorMode()));
+                }
+                else if (const auto blendFunc = dynamic_cast<const osg::BlendFunc*>(&attribute))
+                {
+                    add(blendFunc->getSource());
+                    add(blendFunc->getDestination());
+                    add(blendFunc->getSourceAlpha());
+                    add(blendFunc->getDestinationAlpha());
+                }
+                else if (const auto alphaFunc = dynamic_cast<const osg::AlphaFunc*>(&attribute))
+                {
+                    add(static_cast<std::int32_t>(alphaFunc->getFunction()));
+                    add(alphaFunc->getReferenceValue());
+                }
+                else if (const auto depth = dynamic_cast<const osg::Depth*>(&attribute))
+                {
+                    add(static_cast<std::int32_t>(depth->getFunction()));
+                    add(depth->getWriteMask());
+                    add(depth->getZNear());
+                    add(depth->getZFar());
+                }
+                else if (const auto cullFace = dynamic_cast<const osg::CullFace*>(&attribute))
+                    add(static_cast<std::int32_t>(cullFace->getMode()));
+                else if (const auto texEnv = dynamic_cast<const osg::TexEnv*>(&attribute))
+                    add(static_cast<std::int32_t>(texEnv->getMode()));
+                else if (const auto program = dynamic_cast<const osg::Program*>(&attribute))
+                {
+                    add(program->getNumShaders());
+                    for (unsigned int i = 0; i < program->getNumShaders(); ++i)
+                    {
+                        add(static_cast<std::int32_t>(program->getShader(i)->getType()));
+                        add(program->getShader(i)->getShaderSource());
+                    }
+                }
+            }
+
+            void addUniform(const osg::Uniform& uniform)
+            {
+                add(static_cast<std::int32_t>(uniform.getType()));
+                add(uniform.getNumElements());
+                addData(uniform.getFloatArray());
+                addData(uniform.getDoubleArray());
+                addData(uniform.getIntArray());
+                addData(uniform.getUIntArray());
+            }
+        };
+
+        class CollectStateSetsVisitor : public osg::NodeVisitor
+        {
+        public:
+            CollectStateSetsVisitor()
+                : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            {
+                setNodeMaskOverride(~0u);
+            }
+
+            void apply(osg::Node& node) override
+            {
+                add(node.getStateSet());
+                traverse(node);
+            }
+
+            void apply(osg::Drawable& drawable) override
+            {
+                add(drawable.getStateSet());
+                if (const auto rig = dynamic_cast<const SceneUtil::RigGeometry*>(&drawable))
+                    add(rig->getSourceGeometry()->getStateSet());
+                else if (const auto morph = dynamic_cast<const SceneUtil::MorphGeometry*>(&drawable))
+                    add(morph->getSourceGeometry()->getStateSet());
+            }
+
+            std::unordered_map<const osg::StateSet*, ObjectPagingCache::Key> mKeys;
+            std::map<ObjectPagingCache::Key, osg::StateSet*> mStateSets;
+            /// Hashes of different state sets which can not be told apart
+            std::set<ObjectPagingCache::Key> mAmbiguous;
+
+        private:
+            StateSetHasher mHasher;
+
+            void add(osg::StateSet* stateSet)
+            {
+                if (stateSet == nullptr || mKeys.count(stateSet) > 0)
+                    return;
+                const ObjectPagingCache::Key key = mHasher.hash(*stateSet);
+                mKeys.emplace(stateSet, key);
+                if (!mStateSets.emplace(key, stateSet).second)
+                    mAmbiguous.insert(key);
+            }
+        };
+
+        void collectStateSets(const std::vector<ObjectPagingCache::Template>& templates, CollectStateSetsVisitor& visitor)
+        {
+            for (const ObjectPagingCache::Template& value : templates)
+                const_cast<osg::Node*>(value.mNode)->accept(visitor); // const-trickery required because there is no const version of NodeVisitor
+        }
+
+        bool isDepthWriteOnlyStateSet(const osg::StateSet& stateSet)
+        {
+            if (!stateSet.getModeList().empty() || !stateSet.getTextureModeList().empty() || !stateSet.getTextureAttributeList().empty()
+                || !stateSet.getUniformList().empty() || !stateSet.getDefineList().empty() || stateSet.getAttributeList().size() != 1)
+                return false;
+            const osg::Depth* depth = dynamic_cast<const SceneUtil::AutoDepth*>(stateSet.getAttribute(osg::StateAttribute::DEPTH));
+            return depth != nullptr && !depth->getWriteMask();
+        }
+
+        class Writer
+        {
+        public:
+            Writer(std::ostream& stream, const CollectStateSetsVisitor& stateSets)
+                : mStream(stream)
+                , mStateSets(stateSets)
+            {}
+
+            template <class T>
+            void write(const T& value)
+            {
+                mStream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+            }
+
+            void writeString(const std::string& value)
+            {
+                write(static_cast<std::uint32_t>(value.size()));
+                mStream.write(value.data(), value.size());
+            }
+
+            void writeNode(const osg::Node& node)
+            {
+                if (node.getUpdateCallback() || node.getCullCallback() || node.getEventCallback())
+                    throw UnsupportedNode("node with callbacks");
+                if (const osg::Drawable* drawable = node.asDrawable())
+                    if (drawable->getDrawCallback() || drawable->getComputeBoundingBoxCallback())
+                        throw UnsupportedNode("drawable with callbacks");
+
+                const std::type_info& type = typeid(node);
+                if (type == typeid(osg::Geometry))
+                    write(NodeType_Geometry);
+                else if (type == typeid(osg::MatrixTransform))
+                    write(NodeType_MatrixTransform);
+                else if (type == typeid(osg::Group))
+                    write(NodeType_Group);
+                else
+                    throw UnsupportedNode(node.className());
+
+                write(static_cast<std::uint32_t>(node.getNodeMask()));
+                writeStateSet(node.getStateSet());
+
+                if (type == typeid(osg::Geometry))
+                    return writeGeometry(static_cast<const osg::Geometry&>(node));
+
+                if (node.getUserDataContainer() && node.getUserDataContainer()->getNumUserObjects() > 0)
+                    throw UnsupportedNode("group with user data");
+
+                if (type == typeid(osg::MatrixTransform))
+                {
+                    const osg::MatrixTransform& transform = static_cast<const osg::MatrixTransform&>(node);
+                    write(static_cast<std::uint8_t>(transform.getReferenceFrame()));
+                    const osg::Matrix::value_type* matrix = transform.getMatrix().ptr();
+                    for (int i = 0; i < 16; ++i)
+                        write(matrix[i]);
+                }
+
+                const osg::Group& group = *node.asGroup();
+                write(static_cast<std::uint32_t>(group.getNumChildren()));
+                for (unsigned int i = 0; i < group.getNumChildren(); ++i)
+                    writeNode(*group.getChild(i));
+            }
+
+        private:
+            std::ostream& mStream;
+            const CollectStateSetsVisitor& mStateSets;
+
+            void writeStateSet(const osg::StateSet* stateSet)
+            {
+                if (stateSet == nullptr)
+                    return write(StateSetType_None);
+                const auto it = mStateSets.mKeys.find(stateSet);
+                if (it != mStateSets.mKeys.end())
+                {
+                    if (mStateSets.mAmbiguous.count(it->second) > 0)
+                        throw UnsupportedNode("state set equal to another one");
+                    write(StateSetType_Template);
+                    write(it->second[0]);
+                    write(it->second[1]);
+                    return;
+                }
+                if (isDepthWriteOnlyStateSet(*stateSet))
+                    return write(StateSetType_NoDepthWrite);
+                throw UnsupportedNode("state set not found in templates");
+            }
+
+            void writeArray(const osg::Array* array)
+            {
+                write(static_cast<std::uint8_t>(array != nullptr));
+                if (array == nullptr)
+                    return;
+                switch (array->getType())
+                {
+                    case osg::Array::FloatArrayType:
+                    case osg::Array::Vec2ArrayType:
+                    case osg::Array::Vec3ArrayType:
+                    case osg::Array::Vec4ArrayType:
+                    case osg::Array::Vec4ubArrayType:
+                        break;
+                    default:
+                        throw UnsupportedNode(array->className());
+                }
+                write(static_cast<std::uint32_t>(array->getType()));
+                write(static_cast<std::int32_t>(array->getBinding()));
+                write(static_cast<std::uint8_t>(array->getNormalize()));
+                write(static_cast<std::uint32_t>(array->getNumElements()));
+                mStream.write(static_cast<const char*>(array->getDataPointer()), array->getTotalDataSize());
+            }
+
+            template <class T>
+            void writeIndices(const T& indices)
+            {
+                write(static_cast<std::uint32_t>(indices.size()));
+                if (!indices.empty())
+                    mStream.write(reinterpret_cast<const char*>(&indices.front()), indices.size() * sizeof(indices.front()));
+            }
+
+            void writePrimitiveSet(const osg::PrimitiveSet& primitiveSet)
+            {
+                write(static_cast<std::uint32_t>(primitiveSet.getType()));
+                write(static_cast<std::uint32_t>(primitiveSet.getMode()));
+                switch (primitiveSet.getType())
+                {
+                    case osg::PrimitiveSet::DrawArraysPrimitiveType:
+                    {
+                        const auto& drawArrays = static_cast<const osg::DrawArrays&>(primitiveSet);
+                        write(static_cast<std::int32_t>(drawArrays.getFirst()));
+                        write(static_cast<std::int32_t>(drawArrays.getCount()));
+                        break;
+                    }
+                    case osg::PrimitiveSet::DrawArrayLengthsPrimitiveType:
+                    {
+                        const auto& drawArrayLengths = static_cast<const osg::DrawArrayLengths&>(primitiveSet);
+                        write(static_cast<std::int32_t>(drawArrayLengths.getFirst()));
+                        writeIndices(drawArrayLengths);
+                        break;
+                    }
+                    case osg::PrimitiveSet::DrawElementsUBytePrimitiveType:
+                        writeIndices(static_cast<const osg::DrawElementsUByte&>(primitiveSet));
+                        break;
+                    case osg::PrimitiveSet::DrawElementsUShortPrimitiveType:
+                        writeIndices(static_cast<const osg::DrawElementsUShort&>(primitiveSet));
+                        break;
+                    case osg::PrimitiveSet::DrawElementsUIntPrimitiveType:
+                        writeIndices(static_cast<const osg::DrawElementsUInt&>(primitiveSet));
+                        break;
+                    default:
+                        throw UnsupportedNode(primitiveSet.className());
+                }
+            }
+
+            void writeGeometry(const osg::Geometry& geometry)
+            {
+                write(static_cast<std::uint8_t>(geometry.getUseVertexBufferObjects()));
+                write(static_cast<std::uint8_t>(geometry.getUseDisplayList()));
+
+                writeArray(geometry.getVertexArray());
+                writeArray(geometry.getNormalArray());
+                writeArray(geometry.getColorArray());
+                writeArray(geometry.getSecondaryColorArray());
+                writeArray(geometry.getFogCoordArray());
+
+                write(static_cast<std::uint32_t>(geometry.getNumTexCoordArrays()));
+                for (unsigned int i = 0; i < geometry.getNumTexCoordArrays(); ++i)
+                    writeArray(geometry.getTexCoordArray(i));
+
+                write(static_cast<std::uint32_t>(geometry.getNumVertexAttribArrays()));
+                for (unsigned int i = 0; i < geometry.getNumVertexAttribArrays(); ++i)
+                    writeArray(geometry.getVertexAttribArray(i));
+
+                write(static_cast<std::uint32_t>(geometry.getNumPrimitiveSets()));
+                for (unsigned int i = 0; i < geometry.getNumPrimitiveSets(); ++i)
+                    writePrimitiveSet(*geometry.getPrimitiveSet(i));
+
+                std::vector<const RefnumMarker*> markers;
+                if (const osg::UserDataContainer* udc = geometry.getUserDataContainer())
+                {
+                    if (udc->getUserData() != nullptr)
+                        throw UnsupportedNode("geometry with user data");
+                    for (unsigned int i = 0; i < udc->getNumUserObjects(); ++i)
+                    {
+                        const auto marker = dynamic_cast<const RefnumMarker*>(udc->getUserObject(i));
+                        if (marker == nullptr)
+                            throw UnsupportedNode("geometry with user objects");
+                        markers.push_back(marker);
+                    }
+                }
+                write(static_cast<std::uint32_t>(markers.size()));
+                for (const RefnumMarker* marker : markers)
+                {
+                    write(static_cast<std::uint32_t>(marker->mRefnum.mIndex));
+                    write(static_cast<std::int32_t>(marker->mRefnum.mContentFile));
+                    write(static_cast<std::uint32_t>(marker->mNumVertices));
+                }
+            }
+        };
+
+        class Reader
+        {
+        public:
+            Reader(std::istream& stream, const CollectStateSetsVisitor& stateSets)
+                : mStream(stream)
+                , mStateSets(stateSets)
+            {}
+
+            template <class T>
+            T read()
+            {
+                T value;
+                mStream.read(reinterpret_cast<char*>(&value), sizeof(value));
+                if (!mStream)
+                    throw std::runtime_error("unexpected end of file");
+                return value;
+            }
+
+            std::uint32_t readCount()
+            {
+                const auto value = read<std::uint32_t>();
+                if (value > sMaxCount)
+                    throw std::runtime_error("count is too large");
+                return value;
+            }
+
+            std::string readString()
+            {
+                std::string value(readCount(), '\0');
+                mStream.read(&value[0], value.size());
+                if (!mStream)
+                    throw std::runtime_error("unexpected end of file");
+                return value;
+            }
+
+            osg::ref_ptr<osg::Node> readNode(std::uint32_t depth = 0)
+            {
+                if (depth > sMaxNodeDepth)
+                    throw std::runtime_error("node depth is too large");
+                const auto type = read<std::uint8_t>();
+                const auto nodeMask = read<std::uint32_t>();
+                const osg::ref_ptr<osg::StateSet> stateSet = readStateSet();
+
+                osg::ref_ptr<osg::Node> node;
+                switch (type)
+                {
+                    case NodeType_Geometry:
+                        node = readGeometry();
+                        break;
+                    case NodeType_MatrixTransform:
+                        node = readMatrixTransform();
+                        break;
+                    case NodeType_Group:
+                        node = new osg::Group;
+                        break;
+                    default:
+                        throw std::runtime_error("invalid node type");
+                }
+
+                node->setNodeMask(nodeMask);
+                node->setDataVariance(osg::Object::STATIC);
+                if (stateSet != nullptr)
+                    node->setStateSet(stateSet);
+
+                if (osg::Group* group = node->asGroup())
+                {
+                    const auto numChildren = readCount();
+                    for (std::uint32_t i = 0; i < numChildren; ++i)
+                        group->addChild(readNode(depth + 1));
+                }
+
+                return node;
+            }
+
+        private:
+            std::istream& mStream;
+            const CollectStateSetsVisitor& mStateSets;
+
+            osg::ref_ptr<osg::StateSet> readStateSet()
+            {
+                switch (read<std::uint8_t>())
+                {
+                    case StateSetType_None:
+                        return nullptr;
+                    case StateSetType_NoDepthWrite:
+                    {
+                        osg::ref_ptr<osg::StateSet> stateSet = new osg::StateSet;
+                        osg::ref_ptr<osg::Depth> depth = new SceneUtil::AutoDepth;
+                        depth->setWriteMask(false);
+                        stateSet->setAttribute(depth);
+                        return stateSet;
+                    }
+                    case StateSetType_Template:
+                    {
+                        ObjectPagingCache::Key key;
+                        key[0] = read<std::uint64_t>();
+                        key[1] = read<std::uint64_t>();
+                        const auto it = mStateSets.mStateSets.find(key);
+                        if (it == mStateSets.mStateSets.end() || mStateSets.mAmbiguous.count(key) > 0)
+                            throw std::runtime_error("state set not found in templates");
+                        return it->second;
+                    }
+                    default:
+                        throw std::runtime_error("invalid state set type");
+                }
+            }
+
+            osg::ref_ptr<osg::MatrixTransform> readMatrixTransform()
+            {
+                osg::ref_ptr<osg::MatrixTransform> transform = new osg::MatrixTransform;
+                transform->setReferenceFrame(static_cast<osg::Transform::ReferenceFrame>(read<std::uint8_t>()));
+                osg::Matrix matrix;
+                osg::Matrix::value_type* data = matrix.ptr();
+                for (int i = 0; i < 16; ++i)
+                    data[i] = read<osg::Matrix::value_type>();
+                transform->setMatrix(matrix);
+                return transform;
+            }
+
+            template <class ArrayType>
+            osg::ref_ptr<osg::Array> readArrayData(std::uint32_t numElements)
+            {
+                osg::ref_ptr<ArrayType> array = new ArrayType(numElements);
+                if (numElements > 0)
+                    mStream.read(reinterpret_cast<char*>(&array->front()), array->getTotalDataSize());
+                if (!mStream)
+                    throw std::runtime_error("unexpected end of file");
+                return array;
+            }
+
+            osg::ref_ptr<osg::Array> readArray()
+            {
+                if (read<std::uint8_t>() == 0)
+                    return nullptr;
+                const auto type = static_cast<osg::Array::Type>(read<std::uint32_t>());
+                const auto binding = static_cast<osg::Array::Binding>(read<std::int32_t>());
+                const bool normalize = read<std::uint8_t>() != 0;
+                const auto numElements = readCount();
+
+                osg::ref_ptr<osg::Array> array;
+                switch (type)
+                {
+                    case osg::Array::FloatArrayType: array = readArrayData<osg::FloatArray>(numElements); break;
+                    case osg::Array::Vec2ArrayType: array = readArrayData<osg::Vec2Array>(numElements); break;
+                    case osg::Array::Vec3ArrayType: array = readArrayData<osg::Vec3Array>(numElements); break;
+                    case osg::Array::Vec4ArrayType: array = readArrayData<osg::Vec4Array>(numElements); break;
+                    case osg::Array::Vec4ubArrayType: array = readArrayData<osg::Vec4ubArray>(numElements); break;
+                    default:
+                        throw std::runtime_error("invalid array type");
+                }
+                array->setBinding(binding);
+                array->setNormalize(normalize);
+                return array;
+            }
+
+            template <class T>
+            void readIndices(T& indices)
+            {
+                indices.resize(readCount());
+                if (!indices.empty())
+                    mStream.read(reinterpret_cast<char*>(&indices.front()), indices.size() * sizeof(indices.front()));
+                if (!mStream)
+                    throw std::runtime_error("unexpected end of file");
+            }
+
+            osg::ref_ptr<osg::PrimitiveSet> readPrimitiveSet()
+            {
+                const auto type = static_cast<osg::PrimitiveSet::Type>(read<std::uint32_t>());
+                const auto mode = static_cast<GLenum>(read<std::uint32_t>());
+                switch (type)
+                {
+                    case osg::PrimitiveSet::DrawArraysPrimitiveType:
+                    {
+                        const auto first = read<std::int32_t>();
+                        const auto count = read<std::int32_t>();
+                        return new osg::DrawArrays(mode, first, count);
+                    }
+                    case osg::PrimitiveSet::DrawArrayLengthsPrimitiveType:
+                    {
+                        osg::ref_ptr<osg::DrawArrayLengths> result = new osg::DrawArrayLengths(mode, read<std::int32_t>());
+                        readIndices(*result);
+                        return result;
+                    }
+                    case osg::PrimitiveSet::DrawElementsUBytePrimitiveType:
+                    {
+                        osg::ref_ptr<osg::DrawElementsUByte> result = new osg::DrawElementsUByte(mode);
+                        readIndices(*result);
+                        return result;
+                    }
+                    case osg::PrimitiveSet::DrawElementsUShortPrimitiveType:
+                    {
+                        osg::ref_ptr<osg::DrawElementsUShort> result = new osg::DrawElementsUShort(mode);
+                        readIndices(*result);
+                        return result;
+                    }
+                    case osg::PrimitiveSet::DrawElementsUIntPrimitiveType:
+                    {
+                        osg::ref_ptr<osg::DrawElementsUInt> result = new osg::DrawElementsUInt(mode);
+                        readIndices(*result);
+                        return result;
+                    }
+                    default:
+                        throw std::runtime_error("invalid primitive set type");
+                }
+            }
+
+            osg::ref_ptr<osg::Geometry> readGeometry()
+            {
+                osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+                geometry->setUseVertexBufferObjects(read<std::uint8_t>() != 0);
+                geometry->setUseDisplayList(read<std::uint8_t>() != 0);
+
+                geometry->setVertexArray(readArray());
+                geometry->setNormalArray(readArray());
+                geometry->setColorArray(readArray());
+                geometry->setSecondaryColorArray(readArray());
+                geometry->setFogCoordArray(readArray());
+
+                const auto numTexCoordArrays = readCount();
+                for (std::uint32_t i = 0; i < numTexCoordArrays; ++i)
+                    geometry->setTexCoordArray(i, readArray());
+
+                const auto numVertexAttribArrays = readCount();
+                for (std::uint32_t i = 0; i < numVertexAttribArrays; ++i)
+                    geometry->setVertexAttribArray(i, readArray());
+
+                const auto numPrimitiveSets = readCount();
+                for (std::uint32_t i = 0; i < numPrimitiveSets; ++i)
+                    geometry->addPrimitiveSet(readPrimitiveSet());
+
+                const auto numMarkers = readCount();
+                for (std::uint32_t i = 0; i < numMarkers; ++i)
+                {
+                    osg::ref_ptr<RefnumMarker> marker = new RefnumMarker;
+                    marker->mRefnum.mIndex = read<std::uint32_t>();
+                    marker->mRefnum.mContentFile = read<std::int32_t>();
+                    marker->mNumVertices = read<std::uint32_t>();
+                    geometry->getOrCreateUserDataContainer()->addUserObject(marker);
+                }
+
+                return geometry;
+            }
+        };
+    }
+
+    ObjectPagingCache::ObjectPagingCache(const boost::filesystem::path& path, std::uint64_t maxSize)
+        : mPath(path)
+        , mMaxSize(maxSize)
+    {
+        boost::filesystem::create_directories(mPath);
+        std::lock_guard<std::mutex> lock(mMutex);
+        prune(true);
+    }
+
+    ObjectPagingCache::Key ObjectPagingCache::makeKey(const std::string& data)
+    {
+        const Key seed {0, sFormatVersion};
+        Key key {0, 0};
+        MurmurHash3_x64_128(data.data(), static_cast<int>(data.size()), seed.data(), key.data());
+        return key;
+    }
+
+    ObjectPagingCache::Key ObjectPagingCache::getContentHash(const VFS::Manager& vfs, const std::string& path)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            const auto it = mContentHashes.find(path);
+            if (it != mContentHashes.end())
+                return it->second;
+        }
+
+        Key hash {0, 0};
+        try
+        {
+            const Files::IStreamPtr stream = vfs.get(path);
+            const std::string content {std::istreambuf_iterator<char>(*stream), std::istreambuf_iterator<char>()};
+            hash = makeKey(content);
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Failed to hash " << path << " for object paging cache: " << e.what();
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mContentHashes.emplace(path, hash);
+        return hash;
+    }
+
+    boost::filesystem::path ObjectPagingCache::getFilePath(const Key& key) const
+    {
+        std::ostringstream name;
+        name << std::hex << std::setfill('0') << std::setw(16) << key[0] << std::setw(16) << key[1] << ".chunk";
+        return mPath / name.str();
+    }
+
+    osg::ref_ptr<osg::Group> ObjectPagingCache::read(const Key& key, const std::vector<Template>& templates)
+    {
+        const boost::filesystem::path path = getFilePath(key);
+        boost::filesystem::ifstream stream(path, std::ios::binary);
+        if (!stream.is_open())
+            return nullptr;
+
+        try
+        {
+            char magic[sizeof(sMagic)];
+            stream.read(magic, sizeof(magic));
+            if (!stream || !std::equal(std::begin(magic), std::end(magic), std::begin(sMagic)))
+                throw std::runtime_error("invalid header");
+
+            CollectStateSetsVisitor stateSets;
+            collectStateSets(templates, stateSets);
+            Reader reader(stream, stateSets);
+            if (reader.read<std::uint32_t>() != sFormatVersion)
+                throw std::runtime_error("unsupported format version");
+            if (reader.read<std::uint64_t>() != key[0] || reader.read<std::uint64_t>() != key[1])
+                throw std::runtime_error("key mismatch");
+
+            // The entry is outdated when the chunk is now built from other models or a model file has changed
+            if (reader.read<std::uint32_t>() != templates.size())
+                return nullptr;
+            for (const Template& v : templates)
+            {
+                if (reader.readString() != v.mModel)
+                    return nullptr;
+                if (reader.read<std::uint64_t>() != v.mContentHash[0] || reader.read<std::uint64_t>() != v.mContentHash[1])
+                    return nullptr;
+            }
+
+            osg::ref_ptr<osg::Node> node = reader.readNode();
+            osg::ref_ptr<osg::Group> group = node->asGroup();
+            if (group == nullptr)
+                throw std::runtime_error("root is not a group");
+
+            stream.close();
+            boost::system::error_code ec;
+            boost::filesystem::last_write_time(path, std::time(nullptr), ec);
+
+            return group;
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Failed to read object paging cache entry " << path << ": " << e.what();
+            return nullptr;
+        }
+    }
+
+    void ObjectPagingCache::write(const Key& key, const osg::Group& node, const std::vector<Template>& templates)
+    {
+        CollectStateSetsVisitor stateSets;
+        collectStateSets(templates, stateSets);
+
+        std::ostringstream data(std::ios::binary);
+        data.write(sMagic, sizeof(sMagic));
+        Writer writer(data, stateSets);
+        writer.write(sFormatVersion);
+        writer.write(key[0]);
+        writer.write(key[1]);
+        writer.write(static_cast<std::uint32_t>(templates.size()));
+        for (const Template& v : templates)
+        {
+            writer.writeString(v.mModel);
+            writer.write(v.mContentHash[0]);
+            writer.write(v.mContentHash[1]);
+        }
+        try
+        {
+            writer.writeNode(node);
+        }
+        catch (const UnsupportedNode& e)
+        {
+            Log(Debug::Verbose) << "Object paging chunk is not cached: " << e.what();
+            return;
+        }
+
+        const boost::filesystem::path path = getFilePath(key);
+        std::ostringstream tmpName;
+        tmpName << path.filename().string() << '.' << std::this_thread::get_id() << ".tmp";
+        const boost::filesystem::path tmpPath = mPath / tmpName.str();
+        const std::string content = data.str();
+        std::uint64_t replacedSize = 0;
+
+        try
+        {
+            {
+                boost::filesystem::ofstream stream(tmpPath, std::ios::binary);
+                stream.write(content.data(), content.size());
+                if (!stream)
+                    throw std::runtime_error("failed to write file");
+            }
+            // An existing entry for the key is replaced and must not be counted twice
+            boost::system::error_code ec;
+            replacedSize = boost::filesystem::file_size(path, ec);
+            if (ec)
+                replacedSize = 0;
+            // Replace the entry atomically so that concurrent readers never see a partially written file
+            boost::filesystem::rename(tmpPath, path);
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Failed to write object paging cache entry " << path << ": " << e.what();
+            boost::system::error_code ec;
+            boost::filesystem::remove(tmpPath, ec);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mSize = mSize - std::min(mSize, replacedSize) + content.size();
+        if (mMaxSize != 0 && mSize > mMaxSize)
+            prune(false);
+    }
+
+    void ObjectPagingCache::prune()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        prune(false);
+    }
+
+    std::uint64_t ObjectPagingCache::getSize()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mSize;
+    }
+
+    void ObjectPagingCache::prune(bool removeTemporary)
+    {
+        struct Entry
+        {
+            boost::filesystem::path mPath;
+            std::uint64_t mSize;
+            std::time_t mLastWriteTime;
+        };
+
+        std::vector<Entry> entries;
+        std::uint64_t size = 0;
+        boost::system::error_code ec;
+        for (boost::filesystem::directory_iterator it(mPath, ec), end; !ec && it != end; it.increment(ec))
+        {
+            const boost::filesystem::path& path = it->path();
+            if (path.extension() == ".tmp")
+            {
+                // Left behind by a crash, only removed on startup when no entry is being written
+                if (removeTemporary)
+                    boost::filesystem::remove(path, ec);
+                continue;
+            }
+            if (path.extension() != ".chunk")
+                continue;
+            boost::system::error_code fileEc;
+            const std::uint64_t fileSize = boost::filesystem::file_size(path, fileEc);
+            const std::time_t lastWriteTime = boost::filesystem::last_write_time(path, fileEc);
+            if (fileEc)
+                continue;
+            entries.push_back(Entry {path, fileSize, lastWriteTime});
+            size += fileSize;
+        }
+
+        if (mMaxSize != 0 && size > mMaxSize)
+        {
+            std::sort(entries.begin(), entries.end(),
+                [] (const Entry& lhs, const Entry& rhs) { return lhs.mLastWriteTime < rhs.mLastWriteTime; });
+            // Leave some room so the directory is not listed again after every write
+            const std::uint64_t targetSize = mMaxSize / 4 * 3;
+            std::size_t removed = 0;
+            for (const Entry& entry : entries)
+            {
+                if (size <= targetSize)
+                    break;
+                if (boost::filesystem::remove(entry.mPath, ec))
+                {
+                    size -= entry.mSize;
+                    ++removed;
+                }
+            }
+            Log(Debug::Verbose) << "Removed " << removed << " object paging cache entries";
+        }
+
+        mSize = size;
+    }
+}
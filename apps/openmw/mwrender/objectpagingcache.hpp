@@ -0,0 +1,79 @@
+#ifndef OPENMW_MWRENDER_OBJECTPAGINGCACHE_H
+#define OPENMW_MWRENDER_OBJECTPAGINGCACHE_H
+
+#include <osg/ref_ptr>
+
+#include <boost/filesystem/path.hpp>
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace osg
+{
+    class Group;
+    class Node;
+}
+
+namespace VFS
+{
+    class Manager;
+}
+
+namespace MWRender
+{
+    /// @brief Persistent disk cache of merged object paging chunks.
+    /// @par Only the merged part of a chunk is stored. Geometry is written as raw arrays, state sets are not written:
+    /// they are referenced by a hash of their content and are taken from the templates the chunk is built from when it
+    /// is read back. Chunks containing anything else than plain groups, matrix transforms and geometries are not stored.
+    /// @par Each entry records the models it was built from along with a hash of their files, so an entry is not used
+    /// once a model is replaced. The least recently used entries are removed when the cache grows beyond its size limit.
+    class ObjectPagingCache
+    {
+    public:
+        using Key = std::array<std::uint64_t, 2>;
+
+        struct Template
+        {
+            std::string mModel;
+            Key mContentHash;
+            const osg::Node* mNode;
+        };
+
+        /// @param maxSize in bytes, 0 for no limit
+        ObjectPagingCache(const boost::filesystem::path& path, std::uint64_t maxSize);
+
+        static Key makeKey(const std::string& data);
+
+        /// Hash of the content of the file, computed once per path
+        Key getContentHash(const VFS::Manager& vfs, const std::string& path);
+
+        /// @param templates in the same order as passed to write()
+        /// @return nullptr if there is no valid entry for the key built from the same templates
+        osg::ref_ptr<osg::Group> read(const Key& key, const std::vector<Template>& templates);
+
+        void write(const Key& key, const osg::Group& node, const std::vector<Template>& templates);
+
+        /// Remove the least recently used entries until the cache is well below its size limit
+        void prune();
+
+        /// Total size of the entries in bytes
+        std::uint64_t getSize();
+
+    private:
+        boost::filesystem::path mPath;
+        std::uint64_t mMaxSize;
+        std::mutex mMutex;
+        std::uint64_t mSize = 0;
+        std::unordered_map<std::string, Key> mContentHashes;
+
+        boost::filesystem::path getFilePath(const Key& key) const;
+
+        void prune(bool removeTemporary);
+    };
+}
+
+#endif
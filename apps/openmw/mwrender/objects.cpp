@@ -3,6 +3,7 @@
 #include <osg/Group>
 #include <osg/UserDataContainer>
 
+#include <components/sceneutil/occlusionculling.hpp>
 #include <components/sceneutil/positionattitudetransform.hpp>
 
 #include "../mwworld/ptr.hpp"
@@ -32,6 +33,11 @@ Objects::~Objects()
     mCellSceneNodes.clear();
 }
 
+void Objects::setOcclusionCuller(osg::ref_ptr<SceneUtil::OcclusionCuller> culler)
+{
+    mOcclusionCuller = std::move(culler);
+}
+
 void Objects::insertBegin(const MWWorld::Ptr& ptr)
 {
     assert(mObjects.find(ptr) == mObjects.end());
@@ -54,6 +60,9 @@ void Objects::insertBegin(const MWWorld::Ptr& ptr)
 
     insert->getOrCreateUserDataContainer()->addUserObject(new PtrHolder(ptr));
 
+    if (mOcclusionCuller)
+        insert->addCullCallback(new SceneUtil::OcclusionTestCallback(mOcclusionCuller));
+
     const float *f = ptr.getRefData().getPosition().pos;
 
     insert->setPosition(osg::Vec3(f[0], f[1], f[2]));
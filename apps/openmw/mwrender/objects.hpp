@@ -24,6 +24,11 @@ namespace MWWorld
     class CellStore;
 }
 
+namespace SceneUtil
+{
+    class OcclusionCuller;
+}
+
 namespace MWRender{
 
 class Animation;
@@ -61,12 +66,17 @@ class Objects{
 
     Resource::ResourceSystem* mResourceSystem;
 
+    osg::ref_ptr<SceneUtil::OcclusionCuller> mOcclusionCuller;
+
     void insertBegin(const MWWorld::Ptr& ptr);
 
 public:
     Objects(Resource::ResourceSystem* resourceSystem, osg::ref_ptr<osg::Group> rootNode);
     ~Objects();
 
+    /// Objects inserted afterwards are skipped by the cull traversal when hidden behind occluders.
+    void setOcclusionCuller(osg::ref_ptr<SceneUtil::OcclusionCuller> culler);
+
     /// @param animated Attempt to load separate keyframes from a .kf file matching the model file?
     /// @param allowLight If false, no lights will be created, and particles systems will be removed.
     void insertModel(const MWWorld::Ptr& ptr, const std::string &model, bool animated=false, bool allowLight=true);
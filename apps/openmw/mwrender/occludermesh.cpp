@@ -0,0 +1,106 @@
+#include "occludermesh.hpp"
+
+#include <components/bullethelpers/processtrianglecallback.hpp>
+#include <components/misc/convert.hpp>
+#include <components/sceneutil/occlusionculling.hpp>
+
+#include <BulletCollision/CollisionShapes/btBoxShape.h>
+#include <BulletCollision/CollisionShapes/btCompoundShape.h>
+#include <BulletCollision/CollisionShapes/btConcaveShape.h>
+#include <LinearMath/btTransform.h>
+
+#include <array>
+
+namespace MWRender
+{
+    namespace
+    {
+        bool addShape(const btCollisionShape& shape, const btTransform& transform, std::size_t maxTriangles,
+                      std::vector<osg::Vec3f>& vertices);
+
+        bool addCompound(const btCompoundShape& shape, const btTransform& transform, std::size_t maxTriangles,
+                         std::vector<osg::Vec3f>& vertices)
+        {
+            for (int i = 0, num = shape.getNumChildShapes(); i < num; ++i)
+                if (!addShape(*shape.getChildShape(i), transform * shape.getChildTransform(i), maxTriangles, vertices))
+                    return false;
+            return true;
+        }
+
+        bool addConcave(const btConcaveShape& shape, const btTransform& transform, std::size_t maxTriangles,
+                        std::vector<osg::Vec3f>& vertices)
+        {
+            bool overflow = false;
+            auto callback = BulletHelpers::makeProcessTriangleCallback([&] (btVector3* triangle, int, int)
+            {
+                if (overflow || vertices.size() / 3 >= maxTriangles)
+                {
+                    overflow = true;
+                    return;
+                }
+                for (std::size_t i = 0; i < 3; ++i)
+                    vertices.push_back(Misc::Convert::toOsg(transform(triangle[i])));
+            });
+            btVector3 aabbMin;
+            btVector3 aabbMax;
+            shape.getAabb(btTransform::getIdentity(), aabbMin, aabbMax);
+            shape.processAllTriangles(&callback, aabbMin, aabbMax);
+            return !overflow;
+        }
+
+        bool addBox(const btBoxShape& shape, const btTransform& transform, std::size_t maxTriangles,
+                    std::vector<osg::Vec3f>& vertices)
+        {
+            constexpr std::array<int, 36> indices {{
+                0, 2, 3,
+                3, 1, 0,
+                0, 4, 6,
+                6, 2, 0,
+                0, 1, 5,
+                5, 4, 0,
+                7, 5, 1,
+                1, 3, 7,
+                7, 3, 2,
+                2, 6, 7,
+                7, 6, 4,
+                4, 5, 7,
+            }};
+
+            if (vertices.size() / 3 + indices.size() / 3 > maxTriangles)
+                return false;
+
+            for (const int index : indices)
+            {
+                btVector3 position;
+                shape.getVertex(index, position);
+                vertices.push_back(Misc::Convert::toOsg(transform(position)));
+            }
+            return true;
+        }
+
+        bool addShape(const btCollisionShape& shape, const btTransform& transform, std::size_t maxTriangles,
+                      std::vector<osg::Vec3f>& vertices)
+        {
+            if (shape.isCompound())
+                return addCompound(static_cast<const btCompoundShape&>(shape), transform, maxTriangles, vertices);
+            else if (shape.getShapeType() == TERRAIN_SHAPE_PROXYTYPE)
+                return false;
+            else if (shape.isConcave())
+                return addConcave(static_cast<const btConcaveShape&>(shape), transform, maxTriangles, vertices);
+            else if (shape.getShapeType() == BOX_SHAPE_PROXYTYPE)
+                return addBox(static_cast<const btBoxShape&>(shape), transform, maxTriangles, vertices);
+            return false;
+        }
+    }
+
+    osg::ref_ptr<SceneUtil::OccluderMesh> makeOccluderMesh(const btCollisionShape& shape, const btTransform& transform,
+                                                           std::size_t maxTriangles)
+    {
+        osg::ref_ptr<SceneUtil::OccluderMesh> mesh = new SceneUtil::OccluderMesh;
+        if (!addShape(shape, transform, maxTriangles, mesh->mVertices) || mesh->mVertices.empty())
+            return nullptr;
+        for (const osg::Vec3f& vertex : mesh->mVertices)
+            mesh->mBounds.expandBy(vertex);
+        return mesh;
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef OPENMW_MWRENDER_OCCLUDERMESH_H
+#define OPENMW_MWRENDER_OCCLUDERMESH_H
+
+#include <osg/ref_ptr>
+
+#include <cstddef>
+
+class btCollisionShape;
+class btTransform;
+
+namespace SceneUtil
+{
+    struct OccluderMesh;
+}
+
+namespace MWRender
+{
+    /// Collect the triangles of a collision shape in world space, to be drawn as an occluder.
+    /// @return nullptr if the shape has more than maxTriangles triangles or contains shapes without triangles
+    osg::ref_ptr<SceneUtil::OccluderMesh> makeOccluderMesh(const btCollisionShape& shape, const btTransform& transform,
+                                                           std::size_t maxTriangles);
+}
+
+#endif
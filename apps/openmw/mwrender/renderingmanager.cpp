@@ -39,11 +39,13 @@
 #include <components/sceneutil/workqueue.hpp>
 #include <components/sceneutil/writescene.hpp>
 #include <components/sceneutil/shadow.hpp>
+#include <components/sceneutil/occlusionculling.hpp>
 
 #include <components/terrain/terraingrid.hpp>
 #include <components/terrain/quadtreeworld.hpp>
 
 #include <components/esm/loadcell.hpp>
+#include <components/misc/convert.hpp>
 
 #include <components/detournavigator/navigator.hpp>
 
@@ -70,6 +72,7 @@
 #include "screenshotmanager.hpp"
 #include "groundcover.hpp"
 #include "postprocessor.hpp"
+#include "occludermesh.hpp"
 
 namespace MWRender
 {
@@ -294,12 +297,15 @@ namespace MWRender
 
     RenderingManager::RenderingManager(osgViewer::Viewer* viewer, osg::ref_ptr<osg::Group> rootNode,
                                        Resource::ResourceSystem* resourceSystem, SceneUtil::WorkQueue* workQueue,
-                                       const std::string& resourcePath, DetourNavigator::Navigator& navigator, const MWWorld::GroundcoverStore& groundcoverStore)
+                                       const std::string& resourcePath, const std::string& cachePath, DetourNavigator::Navigator& navigator,
+                                       const MWWorld::GroundcoverStore& groundcoverStore)
         : mViewer(viewer)
         , mRootNode(rootNode)
         , mResourceSystem(resourceSystem)
         , mWorkQueue(workQueue)
         , mNavigator(navigator)
+        , mMinOccluderSize(Settings::Manager::getFloat("occluder min size", "Camera"))
+        , mMaxOccluderTriangles(static_cast<std::size_t>(std::max(0, Settings::Manager::getInt("occluder max triangles", "Camera"))))
         , mMinimumAmbientLuminance(0.f)
         , mNightEyeFactor(0.f)
         // TODO: Near clip should not need to be bounded like this, but too small values break OSG shadow calculations CPU-side.
@@ -393,6 +399,18 @@ namespace MWRender
 
         mObjects.reset(new Objects(mResourceSystem, sceneRoot));
 
+        if (Settings::Manager::getBool("occlusion culling", "Camera"))
+        {
+            mOcclusionCuller = new SceneUtil::OcclusionCuller(
+                std::max(1, Settings::Manager::getInt("occlusion buffer width", "Camera")),
+                std::max(1, Settings::Manager::getInt("occlusion buffer height", "Camera")),
+                Settings::Manager::getFloat("occluder distance", "Camera"),
+                static_cast<std::size_t>(std::max(0, Settings::Manager::getInt("occluder triangle budget", "Camera"))));
+            mOcclusionCuller->setCamera(mViewer->getCamera());
+            mObjects->setOcclusionCuller(mOcclusionCuller);
+            sceneRoot->addCullCallback(new SceneUtil::OcclusionBuildCallback(mOcclusionCuller));
+        }
+
         if (getenv("OPENMW_DONT_PRECOMPILE") == nullptr)
         {
             mViewer->setIncrementalCompileOperation(new osgUtil::IncrementalCompileOperation);
@@ -410,6 +428,7 @@ namespace MWRender
         const bool useTerrainSpecularMaps = Settings::Manager::getBool("auto use terrain specular maps", "Shaders");
 
         mTerrainStorage.reset(new TerrainStorage(mResourceSystem, normalMapPattern, heightMapPattern, useTerrainNormalMaps, specularMapPattern, useTerrainSpecularMaps));
+        mTerrainStorage->setMaxVertexThreads(static_cast<unsigned int>(std::max(1, Settings::Manager::getInt("vertex generation threads", "Terrain"))));
         const float lodFactor = Settings::Manager::getFloat("lod factor", "Terrain");
 
         bool groundcover = Settings::Manager::getBool("enabled", "Groundcover");
@@ -429,7 +448,7 @@ namespace MWRender
                 compMapResolution, compMapLevel, lodFactor, vertexLodMod, maxCompGeometrySize, debugChunks));
             if (Settings::Manager::getBool("object paging", "Terrain"))
             {
-                mObjectPaging.reset(new ObjectPaging(mResourceSystem->getSceneManager()));
+                mObjectPaging.reset(new ObjectPaging(mResourceSystem->getSceneManager(), cachePath));
                 static_cast<Terrain::QuadTreeWorld*>(mTerrain.get())->addChunkManager(mObjectPaging.get());
                 mResourceSystem->addResourceManager(mObjectPaging.get());
             }
@@ -867,11 +886,44 @@ namespace MWRender
 
     void RenderingManager::removeObject(const MWWorld::Ptr &ptr)
     {
+        removeOccluder(ptr);
         mActorsPaths->remove(ptr);
         mObjects->removeObject(ptr);
         mWater->removeEmitter(ptr);
     }
 
+    void RenderingManager::addOccluder(const MWWorld::ConstPtr& ptr, const std::string& model, const btCollisionShape& shape, const btTransform& transform)
+    {
+        if (!mOcclusionCuller)
+            return;
+
+        osg::ref_ptr<SceneUtil::OccluderMesh> mesh = makeOccluderMesh(shape, transform, mMaxOccluderTriangles);
+        if (!mesh || mesh->mBounds.radius() < mMinOccluderSize)
+            return;
+
+        osg::BoundingSphere bound = mResourceSystem->getSceneManager()->getTemplate(model)->getBound();
+        if (!bound.valid())
+            return;
+        const float scale = ptr.getCellRef().getScale();
+        bound.center() = Misc::Convert::toOsg(transform(Misc::Convert::toBullet(bound.center() * scale)));
+        bound.radius() *= scale;
+
+        // Allow for the rounding of collision shapes built from the model
+        constexpr float tolerance = 1.f;
+        const osg::Vec3f extents(bound.radius() + tolerance, bound.radius() + tolerance, bound.radius() + tolerance);
+        osg::BoundingBox visible(bound.center() - extents, bound.center() + extents);
+        if (!visible.contains(mesh->mBounds._min) || !visible.contains(mesh->mBounds._max))
+            return;
+
+        mOcclusionCuller->addOccluder(ptr.getBase(), std::move(mesh));
+    }
+
+    void RenderingManager::removeOccluder(const MWWorld::ConstPtr& ptr)
+    {
+        if (mOcclusionCuller)
+            mOcclusionCuller->removeOccluder(ptr.getBase());
+    }
+
     void RenderingManager::setWaterEnabled(bool enabled)
     {
         mWater->setEnabled(enabled);
@@ -1035,6 +1087,7 @@ namespace MWRender
 
     void RenderingManager::updatePtr(const MWWorld::Ptr &old, const MWWorld::Ptr &updated)
     {
+        removeOccluder(old);
         mObjects->updatePtr(old, updated);
         mActorsPaths->updatePtr(old, updated);
     }
@@ -1204,6 +1257,8 @@ namespace MWRender
         if (stats->collectStats("resource"))
         {
             mTerrain->reportStats(frameNumber, stats);
+            if (mOcclusionCuller)
+                mOcclusionCuller->reportStats(frameNumber, stats);
         }
     }
 
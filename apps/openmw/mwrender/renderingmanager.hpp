@@ -14,9 +14,13 @@
 #include "renderinginterface.hpp"
 #include "rendermode.hpp"
 
+#include <cstddef>
 #include <deque>
 #include <memory>
 
+class btCollisionShape;
+class btTransform;
+
 namespace osg
 {
     class Group;
@@ -59,6 +63,7 @@ namespace SceneUtil
 {
     class ShadowManager;
     class WorkQueue;
+    class OcclusionCuller;
 }
 
 namespace DetourNavigator
@@ -99,7 +104,8 @@ namespace MWRender
     public:
         RenderingManager(osgViewer::Viewer* viewer, osg::ref_ptr<osg::Group> rootNode,
                          Resource::ResourceSystem* resourceSystem, SceneUtil::WorkQueue* workQueue,
-                         const std::string& resourcePath, DetourNavigator::Navigator& navigator, const MWWorld::GroundcoverStore& groundcoverStore);
+                         const std::string& resourcePath, const std::string& cachePath, DetourNavigator::Navigator& navigator,
+                         const MWWorld::GroundcoverStore& groundcoverStore);
         ~RenderingManager();
 
         osgUtil::IncrementalCompileOperation* getIncrementalCompileOperation();
@@ -146,6 +152,11 @@ namespace MWRender
 
         void removeObject(const MWWorld::Ptr& ptr);
 
+        /// Hide objects behind a static object using its collision shape, if occlusion culling is enabled.
+        /// Objects with a collision shape reaching beyond their model, like invisible walls, are ignored.
+        void addOccluder(const MWWorld::ConstPtr& ptr, const std::string& model, const btCollisionShape& shape, const btTransform& transform);
+        void removeOccluder(const MWWorld::ConstPtr& ptr);
+
         void setWaterEnabled(bool enabled);
         void setWaterHeight(float level);
 
@@ -283,6 +294,9 @@ namespace MWRender
         std::unique_ptr<ScreenshotManager> mScreenshotManager;
         std::unique_ptr<EffectManager> mEffectManager;
         std::unique_ptr<SceneUtil::ShadowManager> mShadowManager;
+        osg::ref_ptr<SceneUtil::OcclusionCuller> mOcclusionCuller;
+        float mMinOccluderSize;
+        std::size_t mMaxOccluderTriangles;
         osg::ref_ptr<PostProcessor> mPostProcessor;
         osg::ref_ptr<NpcAnimation> mPlayerAnimation;
         osg::ref_ptr<SceneUtil::PositionAttitudeTransform> mPlayerNode;
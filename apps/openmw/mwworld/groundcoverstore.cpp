@@ -1,6 +1,10 @@
 #include "groundcoverstore.hpp"
 
+#include <algorithm>
+
+#include <components/debug/debuglog.hpp>
 #include <components/esmloader/load.hpp>
+#include <components/misc/parallelfor.hpp>
 #include <components/misc/stringops.hpp>
 
 namespace MWWorld
@@ -14,41 +18,100 @@ namespace MWWorld
         std::vector<ESM::ESMReader> readers(groundcoverFiles.size());
         const EsmLoader::EsmData content = EsmLoader::loadEsmData(query, groundcoverFiles, fileCollections, readers, encoder);
 
+        std::map<std::string, std::uint32_t> modelIndices;
+
         for (const ESM::Static& stat : statics)
-        {
-            std::string id = Misc::StringUtils::lowerCase(stat.mId);
-            mMeshCache[id] = "meshes\\" + Misc::StringUtils::lowerCase(stat.mModel);
-        }
+            addModel(stat.mId, stat.mModel, modelIndices);
 
         for (const ESM::Static& stat : content.mStatics)
-        {
-            std::string id = Misc::StringUtils::lowerCase(stat.mId);
-            mMeshCache[id] = "meshes\\" + Misc::StringUtils::lowerCase(stat.mModel);
-        }
+            addModel(stat.mId, stat.mModel, modelIndices);
 
+        std::map<std::pair<int, int>, const ESM::Cell*> cells;
         for (const ESM::Cell& cell : content.mCells)
         {
             if (!cell.isExterior()) continue;
-            auto cellIndex = std::make_pair(cell.getCellId().mIndex.mX, cell.getCellId().mIndex.mY);
-            mCellContexts[cellIndex] = std::move(cell.mContextList);
+            cells[std::make_pair(cell.getCellId().mIndex.mX, cell.getCellId().mIndex.mY)] = &cell;
+        }
+
+        // Read all references once, so that groundcover chunks only need to pick instances from the cell tables.
+        // Cells are read in parallel, every thread reads a contiguous range of cells with its own set of readers.
+        std::vector<std::pair<std::pair<int, int>, const ESM::Cell*>> cellList(cells.begin(), cells.end());
+        std::vector<GroundcoverCell> cellInstances(cellList.size());
+        Misc::JobPool& pool = Misc::getSharedJobPool();
+        const std::size_t numRanges = std::min(pool.getThreadCount() + 1, cellList.size());
+        Misc::parallelFor(pool, numRanges, [&] (std::size_t range)
+        {
+            std::vector<ESM::ESMReader> esm;
+            const std::size_t begin = cellList.size() * range / numRanges;
+            const std::size_t end = cellList.size() * (range + 1) / numRanges;
+            for (std::size_t i = begin; i < end; ++i)
+                cellInstances[i] = readCellInstances(*cellList[i].second, esm);
+        });
+
+        std::size_t numInstances = 0;
+        for (std::size_t i = 0; i < cellList.size(); ++i)
+        {
+            if (cellInstances[i].mModels.empty()) continue;
+            numInstances += cellInstances[i].mModels.size();
+            mCellInstances.emplace(cellList[i].first, std::move(cellInstances[i]));
         }
+
+        Log(Debug::Info) << "Loaded " << numInstances << " groundcover instances of " << mModels.size() << " models in " << mCellInstances.size() << " cells";
     }
 
-    std::string GroundcoverStore::getGroundcoverModel(const std::string& id) const
+    void GroundcoverStore::addModel(const std::string& id, const std::string& model, std::map<std::string, std::uint32_t>& modelIndices)
     {
-        std::string idLower = Misc::StringUtils::lowerCase(id);
-        auto search = mMeshCache.find(idLower);
-        if (search == mMeshCache.end()) return std::string();
+        const std::string path = "meshes\\" + Misc::StringUtils::lowerCase(model);
+        const auto inserted = modelIndices.emplace(path, static_cast<std::uint32_t>(mModels.size()));
+        if (inserted.second)
+            mModels.push_back(path);
+        mModelIds[Misc::StringUtils::lowerCase(id)] = inserted.first->second;
+    }
 
-        return search->second;
+    GroundcoverCell GroundcoverStore::readCellInstances(const ESM::Cell& cell, std::vector<ESM::ESMReader>& esm) const
+    {
+        std::map<ESM::RefNum, ESM::CellRef> refs;
+        for (size_t i=0; i<cell.mContextList.size(); ++i)
+        {
+            unsigned int index = cell.mContextList[i].index;
+            if (esm.size() <= index)
+                esm.resize(index+1);
+            cell.restore(esm[index], i);
+            ESM::CellRef ref;
+            ref.mRefNum.unset();
+            bool deleted = false;
+            while (ESM::Cell::getNextRef(esm[index], ref, deleted))
+            {
+                if (deleted) { refs.erase(ref.mRefNum); continue; }
+                refs[ref.mRefNum] = std::move(ref);
+            }
+        }
+
+        GroundcoverCell instances;
+        instances.mPositions.reserve(refs.size());
+        instances.mRotations.reserve(refs.size());
+        instances.mScales.reserve(refs.size());
+        instances.mModels.reserve(refs.size());
+        for (const auto& pair : refs)
+        {
+            const ESM::CellRef& ref = pair.second;
+            const auto model = mModelIds.find(Misc::StringUtils::lowerCase(ref.mRefID));
+            if (model == mModelIds.end())
+                continue;
+            instances.mPositions.push_back(ref.mPos.asVec3());
+            instances.mRotations.push_back(ref.mPos.asRotationVec3());
+            instances.mScales.push_back(ref.mScale);
+            instances.mModels.push_back(model->second);
+        }
+        return instances;
     }
 
-    void GroundcoverStore::initCell(ESM::Cell& cell, int cellX, int cellY) const
+    const GroundcoverCell& GroundcoverStore::getCellInstances(int cellX, int cellY) const
     {
-        cell.blank();
+        static const GroundcoverCell empty;
+        auto search = mCellInstances.find(std::make_pair(cellX, cellY));
+        if (search == mCellInstances.end()) return empty;
 
-        auto searchCell = mCellContexts.find(std::make_pair(cellX, cellY));
-        if (searchCell != mCellContexts.end())
-            cell.mContextList = searchCell->second;
+        return search->second;
     }
 }
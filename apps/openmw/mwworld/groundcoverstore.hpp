@@ -1,10 +1,13 @@
 #ifndef GAME_MWWORLD_GROUNDCOVER_STORE_H
 #define GAME_MWWORLD_GROUNDCOVER_STORE_H
 
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <map>
 
+#include <osg/Vec3f>
+
 #include <components/esm/esmreader.hpp>
 #include <components/esmloader/esmdata.hpp>
 #include <components/files/collections.hpp>
@@ -13,16 +16,32 @@
 
 namespace MWWorld
 {
+    /// Groundcover instances of a cell as parallel arrays, one element per instance
+    struct GroundcoverCell
+    {
+        std::vector<osg::Vec3f> mPositions;
+        std::vector<osg::Vec3f> mRotations;
+        std::vector<float> mScales;
+        std::vector<std::uint32_t> mModels;
+    };
+
     class GroundcoverStore
     {
         private:
-            std::map<std::string, std::string> mMeshCache;
-            std::map<std::pair<int, int>, std::vector<ESM::ESM_Context>> mCellContexts;
+            std::map<std::string, std::uint32_t> mModelIds;
+            std::vector<std::string> mModels;
+            std::map<std::pair<int, int>, GroundcoverCell> mCellInstances;
+
+            void addModel(const std::string& id, const std::string& model, std::map<std::string, std::uint32_t>& modelIndices);
+            GroundcoverCell readCellInstances(const ESM::Cell& cell, std::vector<ESM::ESMReader>& readers) const;
 
         public:
             void init(const Store<ESM::Static>& statics, const Files::Collections& fileCollections, const std::vector<std::string>& groundcoverFiles, ToUTF8::Utf8Encoder* encoder);
-            std::string getGroundcoverModel(const std::string& id) const;
-            void initCell(ESM::Cell& cell, int cellX, int cellY) const;
+
+            const std::string& getModel(std::uint32_t model) const { return mModels[model]; }
+
+            /// @return instances of the cell ordered by reference number, already resolved against deleted and overridden references
+            const GroundcoverCell& getCellInstances(int cellX, int cellY) const;
     };
 }
 
@@ -20,6 +20,7 @@
 #include <components/detournavigator/debug.hpp>
 #include <components/misc/convert.hpp>
 #include <components/detournavigator/heightfieldshape.hpp>
+#include <components/esm/loadstat.hpp>
 
 #include "../mwbase/environment.hpp"
 #include "../mwbase/world.hpp"
@@ -121,10 +122,17 @@ namespace
 
         ptr.getClass().insertObject (ptr, model, rotation, physics);
 
+        if (ptr.getType() == ESM::Static::sRecordId)
+        {
+            const auto object = physics.getObject(ptr);
+            if (object != nullptr && !object->getShapeInstance()->isAnimated())
+                rendering.addOccluder(ptr, model, *object->getShapeInstance()->mCollisionShape, object->getTransform());
+        }
+
         MWBase::Environment::get().getLuaManager()->objectAddedToScene(ptr);
     }
 
-    void addObject(const MWWorld::Ptr& ptr, const MWPhysics::PhysicsSystem& physics, DetourNavigator::Navigator& navigator)
+    void addObject(const MWWorld::Ptr& ptr, MWPhysics::PhysicsSystem& physics, DetourNavigator::Navigator& navigator)
     {
         if (const auto object = physics.getObject(ptr))
         {
@@ -147,15 +155,28 @@ namespace
                     transform.getOrigin()
                 );
 
+                const auto findGround = [&] (const osg::Vec3f& point)
+                {
+                    MWPhysics::RayQuery query;
+                    query.mFrom = point;
+                    query.mTo = point - osg::Vec3f(0, 0, 1000);
+                    query.mIgnore = ptr;
+                    query.mMask = MWPhysics::CollisionType_World | MWPhysics::CollisionType_HeightMap | MWPhysics::CollisionType_Water;
+                    return physics.queueRayQuery(query);
+                };
+
+                // Both rays are cast at once by the physics threads
                 const auto start = Misc::Convert::toOsg(closedDoorTransform(center + toPoint));
-                const auto startPoint = physics.castRay(start, start - osg::Vec3f(0, 0, 1000), ptr, {},
-                    MWPhysics::CollisionType_World | MWPhysics::CollisionType_HeightMap | MWPhysics::CollisionType_Water);
-                const auto connectionStart = startPoint.mHit ? startPoint.mHitPos : start;
-
+                const std::size_t startQuery = findGround(start);
                 const auto end = Misc::Convert::toOsg(closedDoorTransform(center - toPoint));
-                const auto endPoint = physics.castRay(end, end - osg::Vec3f(0, 0, 1000), ptr, {},
-                    MWPhysics::CollisionType_World | MWPhysics::CollisionType_HeightMap | MWPhysics::CollisionType_Water);
-                const auto connectionEnd = endPoint.mHit ? endPoint.mHitPos : end;
+                const std::size_t endQuery = findGround(end);
+                physics.flushRayQueries();
+
+                const auto startPoint = physics.takeRayQueryResult(startQuery);
+                const auto connectionStart = startPoint.has_value() && startPoint->mHit ? startPoint->mHitPos : start;
+
+                const auto endPoint = physics.takeRayQueryResult(endQuery);
+                const auto connectionEnd = endPoint.has_value() && endPoint->mHit ? endPoint->mHitPos : end;
 
                 navigator.addObject(
                     DetourNavigator::ObjectId(object),
@@ -263,6 +284,7 @@ namespace MWWorld
 
     void Scene::updateObjectPosition(const Ptr &ptr, const osg::Vec3f &pos, bool movePhysics)
     {
+        mRendering.removeOccluder(ptr);
         mRendering.moveObject(ptr, pos);
         if (movePhysics)
         {
@@ -273,6 +295,7 @@ namespace MWWorld
     void Scene::updateObjectRotation(const Ptr &ptr, RotationOrder order)
     {
         const auto rot = makeNodeRotation(ptr, order);
+        mRendering.removeOccluder(ptr);
         setNodeRotation(ptr, mRendering, rot);
         mPhysics->updateRotation(ptr, rot);
     }
@@ -307,6 +330,7 @@ namespace MWWorld
         const auto world = MWBase::Environment::get().getWorld();
         for (const auto& ptr : visitor.mObjects)
         {
+            mRendering.removeOccluder(ptr);
             if (const auto object = mPhysics->getObject(ptr))
             {
                 mNavigator.removeObject(DetourNavigator::ObjectId(object));
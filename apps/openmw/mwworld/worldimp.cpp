@@ -30,6 +30,7 @@
 #include <components/sceneutil/positionattitudetransform.hpp>
 
 #include <components/detournavigator/navigator.hpp>
+#include <components/detournavigator/pathqueryservice.hpp>
 #include <components/detournavigator/settings.hpp>
 
 #include <components/loadinglistener/loadinglistener.hpp>
@@ -141,7 +142,7 @@ namespace MWWorld
         const std::vector<std::string>& groundcoverFiles,
         ToUTF8::Utf8Encoder* encoder, int activationDistanceOverride,
         const std::string& startCell, const std::string& startupScript,
-        const std::string& resourcePath, const std::string& userDataPath)
+        const std::string& resourcePath, const std::string& userDataPath, const std::string& cachePath)
     : mResourceSystem(resourceSystem), mLocalScripts (mStore),
       mCells (mStore, mEsm), mSky (true),
       mGodMode(false), mScriptsEnabled(true), mDiscardMovements(true), mContentFiles (contentFiles),
@@ -188,13 +189,16 @@ namespace MWWorld
             auto navigatorSettings = DetourNavigator::makeSettingsFromSettingsManager();
             navigatorSettings.mSwimHeightScale = mSwimHeightScale;
             mNavigator = DetourNavigator::makeNavigator(navigatorSettings);
+            if (navigatorSettings.mAsyncPathQueryThreads > 0)
+                mPathQueryService = std::make_unique<DetourNavigator::PathQueryService>(*mNavigator,
+                    navigatorSettings.mAsyncPathQueryThreads);
         }
         else
         {
             mNavigator = DetourNavigator::makeNavigatorStub();
         }
 
-        mRendering.reset(new MWRender::RenderingManager(viewer, rootNode, resourceSystem, workQueue, resourcePath, *mNavigator, mGroundcoverStore));
+        mRendering.reset(new MWRender::RenderingManager(viewer, rootNode, resourceSystem, workQueue, resourcePath, cachePath, *mNavigator, mGroundcoverStore));
         mProjectileManager.reset(new ProjectileManager(mRendering->getLightRoot(), resourceSystem, mRendering.get(), mPhysics.get()));
         mRendering->preloadCommonAssets();
 
@@ -1226,6 +1230,11 @@ namespace MWWorld
             MWBase::Environment::get().getWindowManager()->updateConsoleObjectPtr(ptr, newPtr);
             MWBase::Environment::get().getScriptManager()->getGlobalScripts().updatePtrs(ptr, newPtr);
         }
+        if (haveToMove && newPtr.getClass().isActor())
+        {
+            // Keep the proximity queries right for actors teleported by scripts
+            MWBase::Environment::get().getMechanicsManager()->updatePosition(newPtr);
+        }
         if (haveToMove && newPtr.getRefData().getBaseNode())
         {
             mWorldScene->updateObjectPosition(newPtr, position, movePhysics);
@@ -1281,6 +1290,7 @@ namespace MWWorld
         if (scale != ptr.getCellRef().getScale())
         {
             ptr.getCellRef().setScale(scale);
+            mRendering->removeOccluder(ptr);
             mRendering->pagingBlacklistObject(mStore.find(ptr.getCellRef().getRefId()), ptr);
             mWorldScene->removeFromPagedRefs(ptr);
         }
@@ -1564,6 +1574,16 @@ namespace MWWorld
         return mPhysics->castRay(from, to, ignore, std::vector<MWWorld::Ptr>(), mask).mHit;
     }
 
+    std::size_t World::queueRayQuery(const MWPhysics::RayQuery& query)
+    {
+        return mPhysics->queueRayQuery(query);
+    }
+
+    std::optional<MWPhysics::RayCastingResult> World::takeRayQueryResult(std::size_t tag)
+    {
+        return mPhysics->takeRayQueryResult(tag);
+    }
+
     bool World::rotateDoor(const Ptr door, MWWorld::DoorState state, float duration)
     {
         const ESM::Position& objPos = door.getRefData().getPosition();
@@ -3912,6 +3932,11 @@ namespace MWWorld
         return mNavigator.get();
     }
 
+    DetourNavigator::PathQueryService* World::getPathQueryService() const
+    {
+        return mPathQueryService.get();
+    }
+
     void World::updateActorPath(const MWWorld::ConstPtr& actor, const std::deque<osg::Vec3f>& path,
             const osg::Vec3f& halfExtents, const osg::Vec3f& start, const osg::Vec3f& end) const
     {
@@ -92,6 +92,7 @@ namespace MWWorld
             std::unique_ptr<MWWorld::Player> mPlayer;
             std::unique_ptr<MWPhysics::PhysicsSystem> mPhysics;
             std::unique_ptr<DetourNavigator::Navigator> mNavigator;
+            std::unique_ptr<DetourNavigator::PathQueryService> mPathQueryService;
             std::unique_ptr<MWRender::RenderingManager> mRendering;
             std::unique_ptr<MWWorld::Scene> mWorldScene;
             std::unique_ptr<MWWorld::WeatherManager> mWeatherManager;
@@ -189,7 +190,7 @@ namespace MWWorld
                 const std::vector<std::string>& groundcoverFiles,
                 ToUTF8::Utf8Encoder* encoder, int activationDistanceOverride,
                 const std::string& startCell, const std::string& startupScript,
-                const std::string& resourcePath, const std::string& userDataPath);
+                const std::string& resourcePath, const std::string& userDataPath, const std::string& cachePath);
 
             virtual ~World();
 
@@ -416,6 +417,10 @@ namespace MWWorld
 
             bool castRay(const osg::Vec3f& from, const osg::Vec3f& to, int mask, const MWWorld::ConstPtr& ignore) override;
 
+            std::size_t queueRayQuery(const MWPhysics::RayQuery& query) override;
+
+            std::optional<MWPhysics::RayCastingResult> takeRayQueryResult(std::size_t tag) override;
+
             void setActorCollisionMode(const Ptr& ptr, bool internal, bool external) override;
             bool isActorCollisionEnabled(const Ptr& ptr) override;
 
@@ -718,6 +723,8 @@ namespace MWWorld
 
             DetourNavigator::Navigator* getNavigator() const override;
 
+            DetourNavigator::PathQueryService* getPathQueryService() const override;
+
             void updateActorPath(const MWWorld::ConstPtr& actor, const std::deque<osg::Vec3f>& path,
                     const osg::Vec3f& halfExtents, const osg::Vec3f& start, const osg::Vec3f& end) const override;
 
@@ -0,0 +1,178 @@
+#include <components/bullethelpers/physicsrecording.hpp>
+
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcher.h>
+#include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
+#include <BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
+#include <BulletCollision/CollisionShapes/btBoxShape.h>
+#include <BulletCollision/CollisionShapes/btCompoundShape.h>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    using namespace testing;
+    using namespace BulletHelpers;
+    using namespace BulletHelpers::PhysicsRecording;
+
+    struct BulletHelpersPhysicsRecordingTest : Test
+    {
+        btDefaultCollisionConfiguration mConfiguration;
+        btCollisionDispatcher mDispatcher {&mConfiguration};
+        btDbvtBroadphase mBroadphase;
+        btCollisionWorld mWorld {&mDispatcher, &mBroadphase, &mConfiguration};
+        btBoxShape mBox {btVector3(1, 2, 3)};
+        btCollisionObject mObject;
+        std::stringstream* mStream = nullptr;
+        std::optional<PhysicsRecorder> mRecorder;
+
+        BulletHelpersPhysicsRecordingTest()
+        {
+            mObject.setCollisionShape(&mBox);
+            mObject.setWorldTransform(btTransform(btQuaternion::getIdentity(), btVector3(10, 20, 30)));
+            auto stream = std::make_unique<std::stringstream>();
+            mStream = stream.get();
+            mRecorder.emplace(std::move(stream));
+        }
+
+        ~BulletHelpersPhysicsRecordingTest()
+        {
+            if (mObject.getBroadphaseHandle() != nullptr)
+                mWorld.removeCollisionObject(&mObject);
+        }
+
+        std::vector<Record> readRecords()
+        {
+            PhysicsRecordingReader reader(std::make_unique<std::stringstream>(mStream->str()));
+            std::vector<Record> result;
+            while (std::optional<Record> record = reader.next())
+                result.push_back(std::move(*record));
+            return result;
+        }
+    };
+
+    TEST_F(BulletHelpersPhysicsRecordingTest, reader_should_throw_on_missing_header)
+    {
+        EXPECT_THROW(PhysicsRecordingReader(std::make_unique<std::stringstream>("OMW")), std::runtime_error);
+    }
+
+    TEST_F(BulletHelpersPhysicsRecordingTest, should_read_added_box_and_actor)
+    {
+        mWorld.addCollisionObject(&mObject, 2, 4);
+        mRecorder->beginStep(mWorld, 0.5f, 3);
+        mRecorder->recordWorld(WorldFrame {true, btVector3(1, 0, 0), 0.25f});
+        ActorFrame actor {};
+        actor.mPosition = btVector3(1, 2, 3);
+        actor.mMovement = btVector3(4, 5, 6);
+        actor.mRotationZ = 0.5f;
+        actor.mHalfExtentsZ = 64;
+        actor.mStuckFrames = 2;
+        actor.mIsOnGround = true;
+        actor.mSleeping = true;
+        mRecorder->recordActor(mObject, &mObject, actor);
+        mRecorder->recordActorResult(mObject, btVector3(7, 8, 9), true);
+        mRecorder->endStep(0.125);
+
+        const std::vector<Record> records = readRecords();
+        ASSERT_EQ(records.size(), 6u);
+        ASSERT_TRUE(std::holds_alternative<BeginStep>(records[0]));
+        EXPECT_EQ(std::get<BeginStep>(records[0]).mDuration, 0.5f);
+        EXPECT_EQ(std::get<BeginStep>(records[0]).mThreads, 3u);
+        ASSERT_TRUE(std::holds_alternative<AddObject>(records[1]));
+        const AddObject& add = std::get<AddObject>(records[1]);
+        EXPECT_EQ(add.mGroup, 2);
+        EXPECT_EQ(add.mMask, 4);
+        EXPECT_EQ(add.mTransform.getOrigin(), btVector3(10, 20, 30));
+        ASSERT_NE(add.mShape.mShape, nullptr);
+        ASSERT_EQ(add.mShape.mShape->getShapeType(), BOX_SHAPE_PROXYTYPE);
+        EXPECT_EQ(static_cast<const btBoxShape&>(*add.mShape.mShape).getHalfExtentsWithMargin(),
+                  mBox.getHalfExtentsWithMargin());
+        ASSERT_TRUE(std::holds_alternative<WorldFrame>(records[2]));
+        const WorldFrame& world = std::get<WorldFrame>(records[2]);
+        EXPECT_TRUE(world.mIsInStorm);
+        EXPECT_EQ(world.mStormDirection, btVector3(1, 0, 0));
+        EXPECT_EQ(world.mStormWalkMult, 0.25f);
+        ASSERT_TRUE(std::holds_alternative<ActorFrame>(records[3]));
+        const ActorFrame& frame = std::get<ActorFrame>(records[3]);
+        EXPECT_EQ(frame.mObject, add.mId);
+        EXPECT_EQ(frame.mStandingOn, add.mId);
+        EXPECT_EQ(frame.mPosition, btVector3(1, 2, 3));
+        EXPECT_EQ(frame.mMovement, btVector3(4, 5, 6));
+        EXPECT_EQ(frame.mRotationZ, 0.5f);
+        EXPECT_EQ(frame.mHalfExtentsZ, 64);
+        EXPECT_EQ(frame.mStuckFrames, 2u);
+        EXPECT_TRUE(frame.mIsOnGround);
+        EXPECT_FALSE(frame.mIsOnSlope);
+        EXPECT_TRUE(frame.mSleeping);
+        ASSERT_TRUE(std::holds_alternative<ActorResult>(records[4]));
+        const ActorResult& result = std::get<ActorResult>(records[4]);
+        EXPECT_EQ(result.mObject, add.mId);
+        EXPECT_EQ(result.mPosition, btVector3(7, 8, 9));
+        EXPECT_TRUE(result.mIsOnGround);
+        ASSERT_TRUE(std::holds_alternative<EndStep>(records[5]));
+        EXPECT_EQ(std::get<EndStep>(records[5]).mSeconds, 0.125);
+    }
+
+    TEST_F(BulletHelpersPhysicsRecordingTest, should_not_record_actor_without_object_in_world)
+    {
+        mRecorder->beginStep(mWorld, 0.5f, 1);
+        mRecorder->recordActor(mObject, nullptr, ActorFrame {});
+        mRecorder->recordActorResult(mObject, btVector3(7, 8, 9), true);
+        mRecorder->endStep(0);
+
+        const std::vector<Record> records = readRecords();
+        ASSERT_EQ(records.size(), 2u);
+        EXPECT_TRUE(std::holds_alternative<BeginStep>(records[0]));
+        EXPECT_TRUE(std::holds_alternative<EndStep>(records[1]));
+    }
+
+    TEST_F(BulletHelpersPhysicsRecordingTest, should_record_only_changes_since_previous_step)
+    {
+        mWorld.addCollisionObject(&mObject);
+        mRecorder->beginStep(mWorld, 0.5f, 1);
+        mRecorder->endStep(0);
+        mRecorder->beginStep(mWorld, 0.5f, 1);
+        mRecorder->endStep(0);
+        mObject.setWorldTransform(btTransform(btQuaternion::getIdentity(), btVector3(1, 1, 1)));
+        mRecorder->beginStep(mWorld, 0.5f, 1);
+        mRecorder->endStep(0);
+        mWorld.removeCollisionObject(&mObject);
+        mRecorder->beginStep(mWorld, 0.5f, 1);
+        mRecorder->endStep(0);
+
+        const std::vector<Record> records = readRecords();
+        ASSERT_EQ(records.size(), 11u);
+        EXPECT_TRUE(std::holds_alternative<AddObject>(records[1]));
+        EXPECT_TRUE(std::holds_alternative<BeginStep>(records[3]));
+        EXPECT_TRUE(std::holds_alternative<EndStep>(records[4]));
+        ASSERT_TRUE(std::holds_alternative<SetTransform>(records[6]));
+        EXPECT_EQ(std::get<SetTransform>(records[6]).mTransform.getOrigin(), btVector3(1, 1, 1));
+        ASSERT_TRUE(std::holds_alternative<RemoveObject>(records[9]));
+        EXPECT_EQ(std::get<RemoveObject>(records[9]).mId, std::get<AddObject>(records[1]).mId);
+    }
+
+    TEST_F(BulletHelpersPhysicsRecordingTest, should_read_compound_with_child_transform)
+    {
+        btCompoundShape compound;
+        compound.addChildShape(btTransform(btQuaternion::getIdentity(), btVector3(0, 0, 5)), &mBox);
+        mObject.setCollisionShape(&compound);
+        mWorld.addCollisionObject(&mObject);
+        mRecorder->beginStep(mWorld, 0.5f, 1);
+        mRecorder->endStep(0);
+        mWorld.removeCollisionObject(&mObject);
+
+        const std::vector<Record> records = readRecords();
+        ASSERT_EQ(records.size(), 3u);
+        ASSERT_TRUE(std::holds_alternative<AddObject>(records[1]));
+        const Shape& shape = std::get<AddObject>(records[1]).mShape;
+        ASSERT_NE(shape.mShape, nullptr);
+        ASSERT_EQ(shape.mShape->getShapeType(), COMPOUND_SHAPE_PROXYTYPE);
+        const btCompoundShape& result = static_cast<const btCompoundShape&>(*shape.mShape);
+        ASSERT_EQ(result.getNumChildShapes(), 1);
+        EXPECT_EQ(result.getChildTransform(0).getOrigin(), btVector3(0, 0, 5));
+        EXPECT_EQ(result.getChildShape(0)->getShapeType(), BOX_SHAPE_PROXYTYPE);
+    }
+}
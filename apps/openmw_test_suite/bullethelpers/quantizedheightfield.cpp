@@ -0,0 +1,39 @@
+#include <components/bullethelpers/quantizedheightfield.hpp>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace BulletHelpers;
+
+    TEST(BulletHelpersQuantizeHeightfieldTest, should_restore_heights_within_half_scale)
+    {
+        const std::vector<float> heights {-2048.5f, -1000, 0, 13.25f, 4096};
+        const QuantizedHeightfield result = quantizeHeightfield(heights.data(), heights.size(), -2048.5f, 4096);
+        ASSERT_EQ(result.mSamples.size(), heights.size());
+        for (std::size_t i = 0; i < heights.size(); ++i)
+            EXPECT_NEAR(result.getHeight(i), heights[i], result.mScale * 0.5f) << i;
+    }
+
+    TEST(BulletHelpersQuantizeHeightfieldTest, should_center_height_range_on_offset)
+    {
+        const std::vector<float> heights {100, 300};
+        const QuantizedHeightfield result = quantizeHeightfield(heights.data(), heights.size(), 100, 300);
+        EXPECT_EQ(result.mOffset, 200);
+        EXPECT_EQ(result.mMinHeight, -100);
+        EXPECT_EQ(result.mMaxHeight, 100);
+        EXPECT_EQ(result.mSamples, std::vector<std::int16_t>({-32767, 32767}));
+    }
+
+    TEST(BulletHelpersQuantizeHeightfieldTest, should_support_flat_heightfield)
+    {
+        const std::vector<float> heights(4, -2048);
+        const QuantizedHeightfield result = quantizeHeightfield(heights.data(), heights.size(), -2048, -2048);
+        EXPECT_EQ(result.mSamples, std::vector<std::int16_t>(4, 0));
+        for (std::size_t i = 0; i < heights.size(); ++i)
+            EXPECT_EQ(result.getHeight(i), -2048);
+    }
+}
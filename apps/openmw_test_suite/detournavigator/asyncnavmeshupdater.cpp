@@ -0,0 +1,139 @@
+#include <components/detournavigator/asyncnavmeshupdater.hpp>
+
+#include <gtest/gtest.h>
+
+#include <list>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace DetourNavigator;
+
+    struct DetourNavigatorAsyncNavMeshUpdaterJobsTest : Test
+    {
+        const osg::Vec3f mAgentHalfExtents {29, 29, 66};
+        const std::chrono::steady_clock::time_point mNow = std::chrono::steady_clock::now();
+        std::list<Job> mJobs;
+        std::vector<JobIt> mQueue;
+
+        JobIt addJob(ChangeType changeType, int distanceToPlayer,
+            std::chrono::steady_clock::time_point processTime = std::chrono::steady_clock::time_point())
+        {
+            return mJobs.emplace(mJobs.end(), mAgentHalfExtents, std::weak_ptr<GuardedNavMeshCacheItem>(),
+                TilePosition {distanceToPlayer, 0}, changeType, distanceToPlayer, processTime);
+        }
+
+        std::vector<JobIt> popAll()
+        {
+            std::vector<JobIt> result;
+            while (!mQueue.empty())
+                result.push_back(popPrioritizedJob(mQueue));
+            return result;
+        }
+
+        void expectValidIndices() const
+        {
+            for (std::size_t i = 0; i < mQueue.size(); ++i)
+                EXPECT_EQ(mQueue[i]->mWaitingIndex, i) << i;
+        }
+    };
+
+    TEST(DetourNavigatorMergeChangeTypeTest, should_keep_same_change_type)
+    {
+        EXPECT_EQ(mergeChangeType(ChangeType::add, ChangeType::add), ChangeType::add);
+        EXPECT_EQ(mergeChangeType(ChangeType::update, ChangeType::update), ChangeType::update);
+    }
+
+    TEST(DetourNavigatorMergeChangeTypeTest, should_keep_remove_when_tile_is_added)
+    {
+        EXPECT_EQ(mergeChangeType(ChangeType::remove, ChangeType::add), ChangeType::remove);
+    }
+
+    TEST(DetourNavigatorMergeChangeTypeTest, should_become_remove_when_tile_is_removed)
+    {
+        EXPECT_EQ(mergeChangeType(ChangeType::add, ChangeType::remove), ChangeType::remove);
+        EXPECT_EQ(mergeChangeType(ChangeType::mixed, ChangeType::remove), ChangeType::remove);
+    }
+
+    TEST(DetourNavigatorMergeChangeTypeTest, should_not_be_temporary_update_when_merged_with_persistent_change)
+    {
+        EXPECT_EQ(mergeChangeType(ChangeType::update, ChangeType::add), ChangeType::add);
+        EXPECT_EQ(mergeChangeType(ChangeType::add, ChangeType::update), ChangeType::add);
+        EXPECT_EQ(mergeChangeType(ChangeType::mixed, ChangeType::update), ChangeType::mixed);
+    }
+
+    TEST_F(DetourNavigatorAsyncNavMeshUpdaterJobsTest, pop_should_return_jobs_ordered_by_priority)
+    {
+        const JobIt update = addJob(ChangeType::update, 1);
+        const JobIt farAdd = addJob(ChangeType::add, 3);
+        const JobIt remove = addJob(ChangeType::remove, 4);
+        const JobIt nearAdd = addJob(ChangeType::add, 2);
+        const JobIt mixed = addJob(ChangeType::mixed, 5);
+        for (const JobIt job : {update, farAdd, remove, nearAdd, mixed})
+            insertPrioritizedJob(job, mQueue);
+        expectValidIndices();
+        EXPECT_EQ(popAll(), std::vector<JobIt>({remove, mixed, nearAdd, farAdd, update}));
+    }
+
+    TEST_F(DetourNavigatorAsyncNavMeshUpdaterJobsTest, pop_should_return_job_with_earlier_process_time_first)
+    {
+        const JobIt later = addJob(ChangeType::remove, 1, mNow + std::chrono::seconds(1));
+        const JobIt earlier = addJob(ChangeType::update, 2, mNow);
+        insertPrioritizedJob(later, mQueue);
+        insertPrioritizedJob(earlier, mQueue);
+        EXPECT_EQ(popAll(), std::vector<JobIt>({earlier, later}));
+    }
+
+    TEST_F(DetourNavigatorAsyncNavMeshUpdaterJobsTest, pop_should_keep_valid_indices_of_remaining_jobs)
+    {
+        for (int i = 0; i < 10; ++i)
+            insertPrioritizedJob(addJob(ChangeType::add, (i * 7) % 10), mQueue);
+        popPrioritizedJob(mQueue);
+        popPrioritizedJob(mQueue);
+        expectValidIndices();
+    }
+
+    TEST_F(DetourNavigatorAsyncNavMeshUpdaterJobsTest, update_should_move_job_with_increased_priority_to_front)
+    {
+        std::vector<JobIt> jobs;
+        for (int i = 0; i < 10; ++i)
+        {
+            jobs.push_back(addJob(ChangeType::add, i));
+            insertPrioritizedJob(jobs.back(), mQueue);
+        }
+        jobs[7]->mChangeType = mergeChangeType(jobs[7]->mChangeType, ChangeType::remove);
+        updatePrioritizedJob(jobs[7], mQueue);
+        expectValidIndices();
+        EXPECT_EQ(popPrioritizedJob(mQueue), jobs[7]);
+    }
+
+    TEST_F(DetourNavigatorAsyncNavMeshUpdaterJobsTest, update_should_move_job_with_decreased_priority_back)
+    {
+        std::vector<JobIt> jobs;
+        for (int i = 0; i < 10; ++i)
+        {
+            jobs.push_back(addJob(ChangeType::add, i));
+            insertPrioritizedJob(jobs.back(), mQueue);
+        }
+        jobs[0]->mDistanceToPlayer = 100;
+        updatePrioritizedJob(jobs[0], mQueue);
+        expectValidIndices();
+        EXPECT_EQ(popAll().back(), jobs[0]);
+    }
+
+    TEST_F(DetourNavigatorAsyncNavMeshUpdaterJobsTest, prioritize_should_restore_order_after_all_priorities_changed)
+    {
+        std::vector<JobIt> jobs;
+        for (int i = 0; i < 10; ++i)
+        {
+            jobs.push_back(addJob(ChangeType::add, i));
+            insertPrioritizedJob(jobs.back(), mQueue);
+        }
+        for (int i = 0; i < 10; ++i)
+            jobs[i]->mDistanceToPlayer = 10 - i;
+        prioritizeJobs(mQueue);
+        expectValidIndices();
+        EXPECT_EQ(popAll(), std::vector<JobIt>(jobs.rbegin(), jobs.rend()));
+    }
+}
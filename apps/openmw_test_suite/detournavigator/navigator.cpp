@@ -3,6 +3,7 @@
 #include <components/detournavigator/navigatorimpl.hpp>
 #include <components/detournavigator/exceptions.hpp>
 #include <components/detournavigator/navigatorutils.hpp>
+#include <components/detournavigator/settingsutils.hpp>
 #include <components/misc/rng.hpp>
 #include <components/loadinglistener/loadinglistener.hpp>
 #include <components/esm/loadland.hpp>
@@ -1140,4 +1141,49 @@ namespace
             Vec3fEq(56.66666412353515625, -204, -2.6667373180389404296875)
         )) << mPath;
     }
+
+    TEST_F(DetourNavigatorNavigatorTest, find_coarse_path_should_return_waypoints_across_tiles_ending_at_end)
+    {
+        const HeightfieldPlane plane {100};
+
+        mNavigator->addAgent(mAgentHalfExtents);
+        mNavigator->addHeightfield(mCellPosition, ESM::Land::REAL_SIZE, mShift, plane);
+        mNavigator->update(mPlayerPosition);
+        mNavigator->wait(mListener, WaitConditionType::allJobsDone);
+
+        const osg::Vec3f start(-3000, 0, 102);
+        const osg::Vec3f end(3000, 0, 102);
+        const auto result = findCoarsePath(*mNavigator, mAgentHalfExtents, start, end, Flag_walk);
+
+        ASSERT_TRUE(result.has_value());
+        ASSERT_GT(result->size(), 2u);
+        EXPECT_NEAR(result->back().x(), end.x(), 1e-2);
+        EXPECT_NEAR(result->back().y(), end.y(), 1e-2);
+        const float maxStep = 2 * getRealTileSize(mSettings);
+        osg::Vec3f previous = start;
+        for (const osg::Vec3f& waypoint : *result)
+        {
+            EXPECT_LT((waypoint - previous).length(), maxStep) << waypoint;
+            previous = waypoint;
+        }
+    }
+
+    TEST_F(DetourNavigatorNavigatorTest, find_coarse_path_to_end_out_of_navmesh_should_lead_towards_end)
+    {
+        const HeightfieldPlane plane {100};
+
+        mNavigator->addAgent(mAgentHalfExtents);
+        mNavigator->addHeightfield(mCellPosition, ESM::Land::REAL_SIZE, mShift, plane);
+        mNavigator->update(mPlayerPosition);
+        mNavigator->wait(mListener, WaitConditionType::allJobsDone);
+
+        const osg::Vec3f start(-3000, 0, 102);
+        const osg::Vec3f end(100000, 0, 102);
+        const auto result = findCoarsePath(*mNavigator, mAgentHalfExtents, start, end, Flag_walk);
+
+        ASSERT_TRUE(result.has_value());
+        ASSERT_FALSE(result->empty());
+        EXPECT_GT(result->back().x(), 3000);
+        EXPECT_LT(result->back().x(), ESM::Land::REAL_SIZE / 2);
+    }
 }
@@ -210,6 +210,19 @@ namespace
         EXPECT_EQ(result.get(), *copy);
     }
 
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, get_for_equal_recast_mesh_of_other_revision_should_return_cached_value)
+    {
+        const std::size_t maxSize = mRecastMeshSize + mPreparedNavMeshDataSize;
+        NavMeshTilesCache cache(maxSize);
+        const auto copy = clone(*mPreparedNavMeshData);
+        const RecastMesh sameRecastMesh {mGeneration + 1, mRevision + 1, mMesh, mWater, mHeightfields, mFlatHeightfields};
+
+        cache.set(mAgentHalfExtents, mTilePosition, mRecastMesh, std::move(mPreparedNavMeshData));
+        const auto result = cache.get(mAgentHalfExtents, mTilePosition, sameRecastMesh);
+        ASSERT_TRUE(result);
+        EXPECT_EQ(result.get(), *copy);
+    }
+
     TEST_F(DetourNavigatorNavMeshTilesCacheTest, get_for_cache_miss_by_agent_half_extents_should_return_empty_value)
     {
         const std::size_t maxSize = 1;
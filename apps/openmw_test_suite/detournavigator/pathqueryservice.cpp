@@ -0,0 +1,166 @@
+#include <components/detournavigator/navigatorimpl.hpp>
+#include <components/detournavigator/pathqueryservice.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+namespace
+{
+    using namespace testing;
+    using namespace DetourNavigator;
+
+    struct DetourNavigatorPathQueryServiceTest : Test
+    {
+        Settings mSettings;
+        std::unique_ptr<Navigator> mNavigator;
+        std::unique_ptr<PathQueryService> mService;
+        PathQuery mQuery;
+
+        DetourNavigatorPathQueryServiceTest()
+        {
+            mSettings.mBorderSize = 16;
+            mSettings.mCellHeight = 0.2f;
+            mSettings.mCellSize = 0.2f;
+            mSettings.mDetailSampleDist = 6;
+            mSettings.mDetailSampleMaxError = 1;
+            mSettings.mMaxClimb = 34;
+            mSettings.mMaxSimplificationError = 1.3f;
+            mSettings.mMaxSlope = 49;
+            mSettings.mRecastScaleFactor = 0.017647058823529415f;
+            mSettings.mSwimHeightScale = 0.89999997615814208984375f;
+            mSettings.mMaxEdgeLen = 12;
+            mSettings.mMaxNavMeshQueryNodes = 2048;
+            mSettings.mMaxVertsPerPoly = 6;
+            mSettings.mRegionMergeSize = 20;
+            mSettings.mRegionMinSize = 8;
+            mSettings.mTileSize = 64;
+            mSettings.mWaitUntilMinDistanceToPlayer = std::numeric_limits<int>::max();
+            mSettings.mAsyncNavMeshUpdaterThreads = 1;
+            mSettings.mMaxNavMeshTilesCacheSize = 1024 * 1024;
+            mSettings.mMaxPolygonPathSize = 1024;
+            mSettings.mMaxSmoothPathSize = 1024;
+            mSettings.mMaxPolys = 4096;
+            mSettings.mMaxTilesNumber = 512;
+            mSettings.mMinUpdateInterval = std::chrono::milliseconds(50);
+            mNavigator.reset(new NavigatorImpl(mSettings));
+            // Without threads the queries run only in wait()
+            mService = std::make_unique<PathQueryService>(*mNavigator, 0);
+
+            mQuery.mAgentHalfExtents = osg::Vec3f(29, 29, 66);
+            mQuery.mStepSize = 28.333332061767578125f;
+            mQuery.mStart = osg::Vec3f(-204, 204, 1);
+            mQuery.mEnd = osg::Vec3f(204, -204, 1);
+            mQuery.mIncludeFlags = Flag_walk;
+            mNavigator->addAgent(mQuery.mAgentHalfExtents);
+        }
+    };
+
+    TEST_F(DetourNavigatorPathQueryServiceTest, request_without_navmesh_should_be_ready_with_navmesh_not_found)
+    {
+        mQuery.mAgentHalfExtents = osg::Vec3f(1, 1, 1);
+        const std::shared_ptr<const PendingPath> pending = mService->request(mQuery);
+        ASSERT_TRUE(pending->isReady());
+        EXPECT_EQ(pending->getResult().mStatus, Status::NavMeshNotFound);
+    }
+
+    TEST_F(DetourNavigatorPathQueryServiceTest, request_should_be_pending_until_processed)
+    {
+        const std::shared_ptr<const PendingPath> pending = mService->request(mQuery);
+        EXPECT_FALSE(pending->isReady());
+    }
+
+    TEST_F(DetourNavigatorPathQueryServiceTest, requests_of_equal_queries_should_share_pending_path)
+    {
+        const std::shared_ptr<const PendingPath> first = mService->request(mQuery);
+        const std::shared_ptr<const PendingPath> second = mService->request(mQuery);
+        EXPECT_EQ(first, second);
+    }
+
+    TEST_F(DetourNavigatorPathQueryServiceTest, requests_of_queries_with_close_positions_should_share_pending_path)
+    {
+        const std::shared_ptr<const PendingPath> first = mService->request(mQuery);
+        mQuery.mStart += osg::Vec3f(10, 0, 0);
+        mQuery.mEnd -= osg::Vec3f(0, 10, 0);
+        const std::shared_ptr<const PendingPath> second = mService->request(mQuery);
+        EXPECT_EQ(first, second);
+    }
+
+    TEST_F(DetourNavigatorPathQueryServiceTest, requests_of_queries_with_distant_positions_should_not_share_pending_path)
+    {
+        const std::shared_ptr<const PendingPath> first = mService->request(mQuery);
+        mQuery.mStart += osg::Vec3f(30, 0, 0);
+        const std::shared_ptr<const PendingPath> second = mService->request(mQuery);
+        EXPECT_NE(first, second);
+    }
+
+    TEST_F(DetourNavigatorPathQueryServiceTest, requests_of_queries_with_other_parameters_should_not_share_pending_path)
+    {
+        const std::shared_ptr<const PendingPath> first = mService->request(mQuery);
+        mQuery.mAcceptPartialPath = true;
+        const std::shared_ptr<const PendingPath> second = mService->request(mQuery);
+        EXPECT_NE(first, second);
+    }
+
+    TEST_F(DetourNavigatorPathQueryServiceTest, wait_should_make_result_ready)
+    {
+        mQuery.mRetryWithPathgrid = true;
+        const std::shared_ptr<const PendingPath> pending = mService->request(mQuery);
+        mService->wait(*pending);
+        ASSERT_TRUE(pending->isReady());
+        // The navmesh of the agent has no tiles
+        EXPECT_NE(pending->getResult().mStatus, Status::Success);
+        EXPECT_TRUE(pending->getResult().mPath.empty());
+        EXPECT_EQ(pending->getResult().mIncludeFlags, Flag_walk | Flag_usePathgrid);
+    }
+
+    TEST_F(DetourNavigatorPathQueryServiceTest, requests_of_queries_with_other_max_distance_should_not_share_pending_path)
+    {
+        const std::shared_ptr<const PendingPath> first = mService->request(mQuery);
+        mQuery.mMaxDistance = 100;
+        const std::shared_ptr<const PendingPath> second = mService->request(mQuery);
+        EXPECT_NE(first, second);
+    }
+
+    TEST_F(DetourNavigatorPathQueryServiceTest, wait_should_make_result_with_end_closer_than_max_distance)
+    {
+        mQuery.mMaxDistance = 1000;
+        const std::shared_ptr<const PendingPath> pending = mService->request(mQuery);
+        mService->wait(*pending);
+        ASSERT_TRUE(pending->isReady());
+        EXPECT_EQ(pending->getResult().mEnd, mQuery.mEnd);
+    }
+
+    TEST_F(DetourNavigatorPathQueryServiceTest, wait_should_make_result_with_end_limited_by_max_distance)
+    {
+        mQuery.mMaxDistance = 100;
+        const std::shared_ptr<const PendingPath> pending = mService->request(mQuery);
+        mService->wait(*pending);
+        ASSERT_TRUE(pending->isReady());
+        // There is no route over the navmesh tiles, so the end is on the straight line
+        const osg::Vec3f end = pending->getResult().mEnd;
+        EXPECT_NEAR((end - mQuery.mStart).length(), 100, 1e-3);
+        EXPECT_NEAR((end - mQuery.mStart).length() + (mQuery.mEnd - end).length(),
+                    (mQuery.mEnd - mQuery.mStart).length(), 1e-3);
+    }
+
+    TEST_F(DetourNavigatorPathQueryServiceTest, request_without_navmesh_should_limit_end_by_max_distance)
+    {
+        mQuery.mAgentHalfExtents = osg::Vec3f(1, 1, 1);
+        mQuery.mMaxDistance = 100;
+        const std::shared_ptr<const PendingPath> pending = mService->request(mQuery);
+        ASSERT_TRUE(pending->isReady());
+        EXPECT_NEAR((pending->getResult().mEnd - mQuery.mStart).length(), 100, 1e-3);
+    }
+
+    TEST_F(DetourNavigatorPathQueryServiceTest, request_after_result_is_ready_should_replace_finished_pending_path)
+    {
+        const std::shared_ptr<const PendingPath> first = mService->request(mQuery);
+        mService->wait(*first);
+        const std::shared_ptr<const PendingPath> second = mService->request(mQuery);
+        EXPECT_NE(first, second);
+        EXPECT_FALSE(second->isReady());
+        mService->wait(*second);
+        EXPECT_TRUE(second->isReady());
+    }
+}
@@ -3,12 +3,14 @@
 #include <components/detournavigator/recastmeshbuilder.hpp>
 #include <components/detournavigator/recastmesh.hpp>
 #include <components/detournavigator/exceptions.hpp>
+#include <components/detournavigator/triangulatedshape.hpp>
 #include <components/esm/loadland.hpp>
 #include <components/misc/convert.hpp>
 #include <components/debug/debuglog.hpp>
 
 #include <BulletCollision/CollisionShapes/btBoxShape.h>
 #include <BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
+#include <BulletCollision/CollisionShapes/btScaledBvhTriangleMeshShape.h>
 #include <BulletCollision/CollisionShapes/btTriangleMesh.h>
 #include <BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
 #include <BulletCollision/CollisionShapes/btCompoundShape.h>
@@ -23,21 +25,6 @@
 
 namespace DetourNavigator
 {
-    static inline bool operator ==(const Cell& lhs, const Cell& rhs)
-    {
-        return lhs.mSize == rhs.mSize && lhs.mShift == rhs.mShift;
-    }
-
-    static inline bool operator==(const Heightfield& lhs, const Heightfield& rhs)
-    {
-        return makeTuple(lhs) == makeTuple(rhs);
-    }
-
-    static inline bool operator==(const FlatHeightfield& lhs, const FlatHeightfield& rhs)
-    {
-        return std::tie(lhs.mBounds, lhs.mHeight) == std::tie(rhs.mBounds, rhs.mHeight);
-    }
-
     static inline std::ostream& operator<<(std::ostream& s, const FlatHeightfield& v)
     {
         return s << "FlatHeightfield {" << v.mBounds << ", " << v.mHeight << "}";
@@ -325,6 +312,61 @@ namespace
         EXPECT_EQ(recastMesh->getMesh().getAreaTypes(), std::vector<AreaType>({AreaType_ground}));
     }
 
+    TEST_F(DetourNavigatorRecastMeshBuilderTest, add_triangulated_shape_should_produce_same_mesh_as_concave_shape)
+    {
+        btTriangleMesh mesh;
+        mesh.addTriangle(btVector3(-1, -1, 0), btVector3(-1, 1, 0), btVector3(1, -1, 0));
+        mesh.addTriangle(btVector3(-3, -3, 0), btVector3(-3, -2, 0), btVector3(-2, -3, 0));
+        btBvhTriangleMeshShape shape(&mesh, true);
+        btScaledBvhTriangleMeshShape scaled(&shape, btVector3(2, 3, 4));
+        const btTransform transform(btQuaternion(btVector3(0, 0, 1), static_cast<btScalar>(osg::PI_4)), btVector3(1, 2, 3));
+
+        RecastMeshBuilder expectedBuilder(mBounds);
+        expectedBuilder.addObject(static_cast<const btCollisionShape&>(scaled), transform, AreaType_ground);
+        const auto expected = std::move(expectedBuilder).create(mGeneration, mRevision);
+
+        RecastMeshBuilder builder(mBounds);
+        builder.addObject(*getTriangulatedShape(scaled), transform, AreaType_ground);
+        const auto recastMesh = std::move(builder).create(mGeneration, mRevision);
+
+        EXPECT_EQ(recastMesh->getMesh().getVertices(), expected->getMesh().getVertices());
+        EXPECT_EQ(recastMesh->getMesh().getIndices(), expected->getMesh().getIndices());
+        EXPECT_EQ(recastMesh->getMesh().getAreaTypes(), expected->getMesh().getAreaTypes());
+    }
+
+    TEST_F(DetourNavigatorRecastMeshBuilderTest, with_bounds_add_triangulated_shape_should_filter_by_bounds)
+    {
+        mBounds.mMin = osg::Vec2f(-3, -3);
+        mBounds.mMax = osg::Vec2f(-2, -2);
+        btTriangleMesh mesh;
+        mesh.addTriangle(btVector3(-1, -1, 0), btVector3(-1, 1, 0), btVector3(1, -1, 0));
+        mesh.addTriangle(btVector3(-3, -3, 0), btVector3(-3, -2, 0), btVector3(-2, -3, 0));
+        btBvhTriangleMeshShape shape(&mesh, true);
+        RecastMeshBuilder builder(mBounds);
+        builder.addObject(*getTriangulatedShape(shape), btTransform::getIdentity(), AreaType_ground);
+        const auto recastMesh = std::move(builder).create(mGeneration, mRevision);
+        EXPECT_EQ(recastMesh->getMesh().getVertices(), std::vector<float>({
+            -3, -3, 0,
+            -3, -2, 0,
+            -2, -3, 0,
+        })) << recastMesh->getMesh().getVertices();
+        EXPECT_EQ(recastMesh->getMesh().getIndices(), std::vector<int>({2, 1, 0}));
+        EXPECT_EQ(recastMesh->getMesh().getAreaTypes(), std::vector<AreaType>({AreaType_ground}));
+    }
+
+    TEST_F(DetourNavigatorRecastMeshBuilderTest, get_triangulated_shape_should_share_triangles_of_same_mesh_and_scale)
+    {
+        btTriangleMesh mesh;
+        mesh.addTriangle(btVector3(-1, -1, 0), btVector3(-1, 1, 0), btVector3(1, -1, 0));
+        btBvhTriangleMeshShape shape(&mesh, true);
+        btScaledBvhTriangleMeshShape first(&shape, btVector3(2, 2, 2));
+        btScaledBvhTriangleMeshShape second(&shape, btVector3(2, 2, 2));
+        btScaledBvhTriangleMeshShape other(&shape, btVector3(3, 3, 3));
+        const auto firstTriangulated = getTriangulatedShape(first);
+        EXPECT_EQ(getTriangulatedShape(second), firstTriangulated);
+        EXPECT_NE(getTriangulatedShape(other), firstTriangulated);
+    }
+
     TEST_F(DetourNavigatorRecastMeshBuilderTest, with_bounds_add_rotated_by_x_bhv_triangle_shape_should_filter_by_bounds)
     {
         mBounds.mMin = osg::Vec2f(-5, -5);
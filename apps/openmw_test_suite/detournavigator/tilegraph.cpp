@@ -0,0 +1,173 @@
+#include <components/detournavigator/tilegraph.hpp>
+
+#include <DetourNavMesh.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace DetourNavigator;
+
+    // Quad edges in the order of the vertices
+    constexpr std::size_t edgeNegativeX = 0;
+    constexpr std::size_t edgePositiveX = 2;
+
+    constexpr unsigned short linkPositiveX = DT_EXT_LINK | 0;
+    constexpr unsigned short linkNegativeX = DT_EXT_LINK | 4;
+
+    /// Tile of flat quads, each one is given by bounds along x and z axes of navmesh coordinates
+    struct TestTile
+    {
+        dtMeshHeader mHeader {};
+        std::vector<float> mVertices;
+        std::vector<dtPoly> mPolygons;
+        dtMeshTile mTile {};
+
+        TestTile(int x, int y)
+        {
+            mHeader.x = x;
+            mHeader.y = y;
+            mHeader.walkableClimb = 1;
+        }
+
+        /// @return index of the quad, its vertices go from (minX, minZ) through (minX, maxZ)
+        int addQuad(float minX, float maxX, float minZ, float maxZ)
+        {
+            const auto firstVertex = static_cast<unsigned short>(mVertices.size() / 3);
+            mVertices.insert(mVertices.end(), {minX, 0, minZ, minX, 0, maxZ, maxX, 0, maxZ, maxX, 0, minZ});
+            dtPoly& polygon = mPolygons.emplace_back(dtPoly {});
+            polygon.setType(DT_POLYTYPE_GROUND);
+            polygon.flags = Flag_walk;
+            polygon.vertCount = 4;
+            for (unsigned short i = 0; i < 4; ++i)
+                polygon.verts[i] = firstVertex + i;
+            return static_cast<int>(mPolygons.size() - 1);
+        }
+
+        void link(int polygon, std::size_t edge, unsigned short neighbour)
+        {
+            mPolygons[static_cast<std::size_t>(polygon)].neis[edge] = neighbour;
+        }
+
+        const dtMeshTile& get()
+        {
+            mHeader.polyCount = static_cast<int>(mPolygons.size());
+            mTile.header = &mHeader;
+            mTile.polys = mPolygons.data();
+            mTile.verts = mVertices.data();
+            return mTile;
+        }
+    };
+
+    struct DetourNavigatorTileGraphTest : Test
+    {
+        TestTile mLeft {0, 0};
+        TestTile mRight {1, 0};
+        TileGraph mGraph;
+
+        // Two quads of the left tile connected inside of it through the -x edges, both have border edges on +x side
+        // separated by a gap
+        DetourNavigatorTileGraphTest()
+        {
+            const int bottom = mLeft.addQuad(0, 1, 0, 1);
+            const int top = mLeft.addQuad(0, 1, 3, 4);
+            mLeft.link(bottom, edgeNegativeX, static_cast<unsigned short>(top + 1));
+            mLeft.link(top, edgeNegativeX, static_cast<unsigned short>(bottom + 1));
+            mLeft.link(bottom, edgePositiveX, linkPositiveX);
+            mLeft.link(top, edgePositiveX, linkPositiveX);
+        }
+
+        void addRightQuad(float minZ, float maxZ)
+        {
+            const int polygon = mRight.addQuad(1, 2, minZ, maxZ);
+            mRight.link(polygon, edgeNegativeX, linkNegativeX);
+        }
+    };
+
+    TEST_F(DetourNavigatorTileGraphTest, make_tile_clusters_should_join_polygons_connected_inside_tile)
+    {
+        const TileClusters result = makeTileClusters(mLeft.get());
+        ASSERT_EQ(result.mClusters.size(), 1u);
+        EXPECT_EQ(result.mPolygonClusters, std::vector<std::uint16_t>({0, 0}));
+        EXPECT_EQ(result.mClusters[0].mFlags, Flag_walk);
+        EXPECT_FLOAT_EQ(result.mMaxClimb, 1);
+    }
+
+    TEST_F(DetourNavigatorTileGraphTest, make_tile_clusters_should_keep_separate_portal_spans)
+    {
+        const TileClusters result = makeTileClusters(mLeft.get());
+        ASSERT_EQ(result.mClusters.size(), 1u);
+        const auto& portals = result.mClusters[0].mPortals[0];
+        ASSERT_EQ(portals.size(), 2u);
+        EXPECT_FLOAT_EQ(portals[0].mMin, 0);
+        EXPECT_FLOAT_EQ(portals[0].mMax, 1);
+        EXPECT_FLOAT_EQ(portals[1].mMin, 3);
+        EXPECT_FLOAT_EQ(portals[1].mMax, 4);
+        EXPECT_TRUE(result.mClusters[0].mPortals[1].empty());
+        EXPECT_TRUE(result.mClusters[0].mPortals[2].empty());
+        EXPECT_TRUE(result.mClusters[0].mPortals[3].empty());
+    }
+
+    TEST_F(DetourNavigatorTileGraphTest, make_tile_clusters_should_merge_touching_portal_edges)
+    {
+        TestTile tile(0, 0);
+        const int bottom = tile.addQuad(0, 1, 0, 1);
+        const int top = tile.addQuad(0, 1, 1, 2);
+        tile.link(bottom, edgeNegativeX, static_cast<unsigned short>(top + 1));
+        tile.link(top, edgeNegativeX, static_cast<unsigned short>(bottom + 1));
+        tile.link(top, edgePositiveX, linkPositiveX);
+        tile.link(bottom, edgePositiveX, linkPositiveX);
+        const TileClusters result = makeTileClusters(tile.get());
+        ASSERT_EQ(result.mClusters.size(), 1u);
+        const auto& portals = result.mClusters[0].mPortals[0];
+        ASSERT_EQ(portals.size(), 1u);
+        EXPECT_FLOAT_EQ(portals[0].mMin, 0);
+        EXPECT_FLOAT_EQ(portals[0].mMax, 2);
+    }
+
+    TEST_F(DetourNavigatorTileGraphTest, find_route_should_lead_through_overlapping_portal_span)
+    {
+        addRightQuad(0.5f, 1.5f);
+        mGraph.updateTile(TilePosition(0, 0), mLeft.get());
+        mGraph.updateTile(TilePosition(1, 0), mRight.get());
+        const osg::Vec3f end(2, 0, 1);
+        const auto result = mGraph.findRoute(TilePosition(0, 0), 0, end, std::pair(TilePosition(1, 0), 0), Flag_walk);
+        ASSERT_TRUE(result.has_value());
+        EXPECT_EQ(*result, std::vector<osg::Vec3f>({osg::Vec3f(1.5f, 0, 1)}));
+    }
+
+    TEST_F(DetourNavigatorTileGraphTest, find_route_should_not_lead_through_gap_between_portal_spans)
+    {
+        addRightQuad(1.5f, 2.5f);
+        mGraph.updateTile(TilePosition(0, 0), mLeft.get());
+        mGraph.updateTile(TilePosition(1, 0), mRight.get());
+        const osg::Vec3f end(2, 0, 2);
+        const auto result = mGraph.findRoute(TilePosition(0, 0), 0, end, std::pair(TilePosition(1, 0), 0), Flag_walk);
+        EXPECT_FALSE(result.has_value());
+    }
+
+    TEST_F(DetourNavigatorTileGraphTest, find_route_without_end_polygon_should_lead_to_closest_reachable_cluster)
+    {
+        addRightQuad(0.5f, 1.5f);
+        mGraph.updateTile(TilePosition(0, 0), mLeft.get());
+        mGraph.updateTile(TilePosition(1, 0), mRight.get());
+        const osg::Vec3f end(100, 0, 1);
+        const auto result = mGraph.findRoute(TilePosition(0, 0), 0, end, std::nullopt, Flag_walk);
+        ASSERT_TRUE(result.has_value());
+        EXPECT_EQ(*result, std::vector<osg::Vec3f>({osg::Vec3f(1.5f, 0, 1)}));
+    }
+
+    TEST_F(DetourNavigatorTileGraphTest, find_route_should_not_lead_through_removed_tile)
+    {
+        addRightQuad(0.5f, 1.5f);
+        mGraph.updateTile(TilePosition(0, 0), mLeft.get());
+        mGraph.updateTile(TilePosition(1, 0), mRight.get());
+        mGraph.removeTile(TilePosition(1, 0));
+        const osg::Vec3f end(2, 0, 1);
+        const auto result = mGraph.findRoute(TilePosition(0, 0), 0, end, std::pair(TilePosition(1, 0), 0), Flag_walk);
+        EXPECT_FALSE(result.has_value());
+    }
+}
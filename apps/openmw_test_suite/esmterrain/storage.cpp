@@ -0,0 +1,114 @@
+#include <components/esmterrain/storage.hpp>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <utility>
+
+namespace
+{
+    using namespace testing;
+    using namespace ESMTerrain;
+
+    constexpr int landFlags = ESM::Land::DATA_VHGT | ESM::Land::DATA_VNML | ESM::Land::DATA_VCLR;
+
+    /// Cells in [0, 3) on both axes have land with values depending on the cell and the vertex, cell (1, 2) has none
+    class TestStorage final : public Storage
+    {
+    public:
+        TestStorage()
+            : Storage(nullptr)
+        {
+            for (int cellX = 0; cellX < 3; ++cellX)
+            {
+                for (int cellY = 0; cellY < 3; ++cellY)
+                {
+                    if (cellX == 1 && cellY == 2)
+                        continue;
+                    auto land = std::make_unique<ESM::Land>();
+                    land->mX = cellX;
+                    land->mY = cellY;
+                    land->add(landFlags);
+                    ESM::Land::LandData& data = *land->getLandData();
+                    for (int i = 0; i < ESM::Land::LAND_NUM_VERTS; ++i)
+                    {
+                        const int value = (cellX * 7 + cellY * 13 + i) % 101;
+                        data.mHeights[i] = static_cast<float>(value * 3);
+                        data.mNormals[i * 3] = static_cast<signed char>(value - 50);
+                        data.mNormals[i * 3 + 1] = static_cast<signed char>(50 - value);
+                        data.mNormals[i * 3 + 2] = 100;
+                        data.mColours[i * 3] = static_cast<unsigned char>(value);
+                        data.mColours[i * 3 + 1] = static_cast<unsigned char>(value * 2);
+                        data.mColours[i * 3 + 2] = static_cast<unsigned char>(255 - value);
+                    }
+                    mLands.emplace(std::make_pair(cellX, cellY), std::move(land));
+                }
+            }
+        }
+
+        osg::ref_ptr<const LandObject> getLand(int cellX, int cellY) override
+        {
+            const auto it = mLands.find(std::make_pair(cellX, cellY));
+            if (it == mLands.end())
+                return nullptr;
+            return new LandObject(it->second.get(), landFlags);
+        }
+
+        const ESM::LandTexture* getLandTexture(int /*index*/, short /*plugin*/) override
+        {
+            return nullptr;
+        }
+
+        void getBounds(float& minX, float& maxX, float& minY, float& maxY) override
+        {
+            minX = 0;
+            maxX = 3;
+            minY = 0;
+            maxY = 3;
+        }
+
+    private:
+        std::map<std::pair<int, int>, std::unique_ptr<ESM::Land>> mLands;
+    };
+
+    struct Vertices
+    {
+        osg::ref_ptr<osg::Vec3Array> mPositions = new osg::Vec3Array;
+        osg::ref_ptr<osg::Vec3Array> mNormals = new osg::Vec3Array;
+        osg::ref_ptr<osg::Vec4ubArray> mColours = new osg::Vec4ubArray;
+    };
+
+    struct ESMTerrainStorageTest : TestWithParam<std::pair<int, float>>
+    {
+        TestStorage mStorage;
+
+        Vertices fillVertexBuffers(unsigned threads, int lodLevel, float size)
+        {
+            Vertices result;
+            mStorage.setMaxVertexThreads(threads);
+            const osg::Vec2f center(size / 2, size / 2);
+            mStorage.fillVertexBuffers(lodLevel, size, center, result.mPositions, result.mNormals, result.mColours);
+            return result;
+        }
+    };
+
+    TEST_P(ESMTerrainStorageTest, fill_vertex_buffers_in_several_threads_should_match_single_thread)
+    {
+        const auto [lodLevel, size] = GetParam();
+        const Vertices expected = fillVertexBuffers(1, lodLevel, size);
+        const Vertices result = fillVertexBuffers(4, lodLevel, size);
+        ASSERT_FALSE(expected.mPositions->empty());
+        EXPECT_EQ(result.mPositions->asVector(), expected.mPositions->asVector());
+        EXPECT_EQ(result.mNormals->asVector(), expected.mNormals->asVector());
+        EXPECT_EQ(result.mColours->asVector(), expected.mColours->asVector());
+    }
+
+    INSTANTIATE_TEST_SUITE_P(ChunksSpanningSeveralCells, ESMTerrainStorageTest, Values(
+        std::make_pair(0, 1.0f),
+        std::make_pair(0, 2.0f),
+        std::make_pair(0, 3.0f),
+        std::make_pair(1, 3.0f),
+        std::make_pair(3, 2.0f)
+    ));
+}
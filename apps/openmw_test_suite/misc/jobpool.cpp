@@ -0,0 +1,114 @@
+#include <components/misc/jobpool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace Misc;
+
+    TEST(MiscJobPoolTest, emptyGraphShouldBeDone)
+    {
+        JobPool pool(2);
+        JobGraph graph;
+        graph.start(pool);
+        EXPECT_TRUE(graph.isDone());
+        graph.wait();
+    }
+
+    TEST(MiscJobPoolTest, shouldRunEveryJobOnce)
+    {
+        JobPool pool(4);
+        std::vector<std::atomic<int>> calls(1000);
+        JobGraph graph;
+        for (std::size_t i = 0; i < calls.size(); ++i)
+            graph.add([&, i] { ++calls[i]; });
+        graph.start(pool);
+        graph.wait();
+        for (const auto& v : calls)
+            EXPECT_EQ(v, 1);
+    }
+
+    TEST(MiscJobPoolTest, poolWithoutThreadsShouldRunJobsInWaitingThread)
+    {
+        JobPool pool(0);
+        int calls = 0;
+        JobGraph graph;
+        graph.add([&] { ++calls; });
+        graph.start(pool);
+        EXPECT_EQ(calls, 0);
+        graph.wait();
+        EXPECT_EQ(calls, 1);
+    }
+
+    TEST(MiscJobPoolTest, jobShouldRunAfterItsDependencies)
+    {
+        JobPool pool(4);
+        std::mutex mutex;
+        std::vector<int> order;
+        const auto record = [&] (int value) { const std::lock_guard lock(mutex); order.push_back(value); };
+        JobGraph graph;
+        const JobGraph::Id last = graph.add([&] { record(3); });
+        const JobGraph::Id first = graph.add([&] { record(1); });
+        for (int i = 0; i < 100; ++i)
+        {
+            const JobGraph::Id middle = graph.add([&] { record(2); });
+            graph.addDependency(middle, first);
+            graph.addDependency(last, middle);
+        }
+        graph.start(pool);
+        graph.wait();
+        ASSERT_EQ(order.size(), 102u);
+        EXPECT_EQ(order.front(), 1);
+        EXPECT_EQ(order.back(), 3);
+    }
+
+    TEST(MiscJobPoolTest, graphShouldBeReusable)
+    {
+        JobPool pool(2);
+        std::atomic<int> calls {0};
+        JobGraph graph;
+        const JobGraph::Id first = graph.add([&] { ++calls; });
+        graph.addDependency(graph.add([&] { ++calls; }), first);
+        for (int i = 0; i < 3; ++i)
+        {
+            graph.start(pool);
+            graph.wait();
+        }
+        EXPECT_EQ(calls, 6);
+    }
+
+    TEST(MiscJobPoolTest, jobsPushedByJobsShouldRun)
+    {
+        JobPool pool(3);
+        std::atomic<int> calls {0};
+        JobGraph graph;
+        graph.add([&]
+        {
+            for (int i = 0; i < 100; ++i)
+                pool.push([&] { if (++calls == 100) pool.notify(); });
+        });
+        graph.start(pool);
+        graph.wait();
+        pool.runUntil([&] { return calls == 100; });
+        EXPECT_EQ(calls, 100);
+    }
+
+    TEST(MiscJobPoolTest, waitShouldRethrowExceptionAfterAllJobsAreDone)
+    {
+        JobPool pool(2);
+        std::atomic<int> calls {0};
+        JobGraph graph;
+        const JobGraph::Id failing = graph.add([] { throw std::runtime_error("error"); });
+        graph.addDependency(graph.add([&] { ++calls; }), failing);
+        graph.start(pool);
+        EXPECT_THROW(graph.wait(), std::runtime_error);
+        EXPECT_TRUE(graph.isDone());
+        EXPECT_EQ(calls, 1);
+    }
+}
@@ -0,0 +1,103 @@
+#include <components/misc/parallelfor.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace Misc;
+
+    TEST(MiscParallelForTest, shouldNotCallFunctionForZeroCount)
+    {
+        JobPool pool(3);
+        std::atomic<int> calls {0};
+        parallelFor(pool, 0, [&] (std::size_t) { ++calls; });
+        EXPECT_EQ(calls, 0);
+    }
+
+    TEST(MiscParallelForTest, shouldCallFunctionOnceForEachIndexInCallingThreadForOneMaxThread)
+    {
+        JobPool pool(3);
+        const std::thread::id callingThread = std::this_thread::get_id();
+        std::vector<int> calls(13, 0);
+        parallelFor(pool, calls.size(), 1, [&] (std::size_t i)
+        {
+            EXPECT_EQ(std::this_thread::get_id(), callingThread);
+            ++calls[i];
+        });
+        EXPECT_EQ(calls, std::vector<int>(13, 1));
+    }
+
+    TEST(MiscParallelForTest, shouldTreatZeroMaxThreadsAsOne)
+    {
+        JobPool pool(3);
+        std::vector<int> calls(3, 0);
+        parallelFor(pool, calls.size(), 0, [&] (std::size_t i) { ++calls[i]; });
+        EXPECT_EQ(calls, std::vector<int>(3, 1));
+    }
+
+    TEST(MiscParallelForTest, shouldUseNoMoreThanMaxThreads)
+    {
+        JobPool pool(4);
+        std::mutex mutex;
+        std::set<std::thread::id> threads;
+        std::vector<std::atomic<int>> calls(1000);
+        parallelFor(pool, calls.size(), 2, [&] (std::size_t i)
+        {
+            ++calls[i];
+            const std::lock_guard lock(mutex);
+            threads.insert(std::this_thread::get_id());
+        });
+        for (const auto& v : calls)
+            EXPECT_EQ(v, 1);
+        EXPECT_LE(threads.size(), 2u);
+    }
+
+    TEST(MiscParallelForTest, shouldCallFunctionOnceForEachIndexInSharedPool)
+    {
+        std::vector<std::atomic<int>> calls(1000);
+        parallelFor(getSharedJobPool(), calls.size(), [&] (std::size_t i) { ++calls[i]; });
+        for (const auto& v : calls)
+            EXPECT_EQ(v, 1);
+    }
+
+    TEST(MiscParallelForTest, shouldCallFunctionOnceForEachIndexInPool)
+    {
+        JobPool pool(3);
+        std::vector<std::atomic<int>> calls(1000);
+        parallelFor(pool, calls.size(), [&] (std::size_t i) { ++calls[i]; });
+        for (const auto& v : calls)
+            EXPECT_EQ(v, 1);
+    }
+
+    TEST(MiscParallelForTest, shouldRunInCallingThreadForPoolWithoutThreads)
+    {
+        JobPool pool(0);
+        std::vector<int> calls(3, 0);
+        parallelFor(pool, calls.size(), [&] (std::size_t i) { ++calls[i]; });
+        EXPECT_EQ(calls, std::vector<int>(3, 1));
+    }
+
+    TEST(MiscParallelForTest, shouldReusePoolForSeveralLoops)
+    {
+        JobPool pool(2);
+        std::atomic<int> calls {0};
+        for (int i = 0; i < 100; ++i)
+            parallelFor(pool, 10, [&] (std::size_t) { ++calls; });
+        EXPECT_EQ(calls, 1000);
+    }
+
+    TEST(MiscParallelForTest, shouldRethrowExceptionFromPool)
+    {
+        JobPool pool(3);
+        EXPECT_THROW(parallelFor(pool, 100, [] (std::size_t i) { if (i == 42) throw std::runtime_error("error"); }),
+                     std::runtime_error);
+    }
+}
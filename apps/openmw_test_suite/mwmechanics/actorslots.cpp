@@ -0,0 +1,280 @@
+#include <apps/openmw/mwmechanics/actorslots.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWMechanics;
+
+    struct MWMechanicsActorSlotsTest : Test
+    {
+        // Addresses are used as actor references
+        std::array<int, 8> mRefs {};
+        // Index of each erase the same way a registry swaps its per actor data
+        std::vector<std::size_t> mErased;
+        std::vector<const void*> mData;
+        ActorSlots mSlots {[this] (std::size_t index)
+        {
+            mErased.push_back(index);
+            mData[index] = mData.back();
+            mData.pop_back();
+        }};
+
+        ActorHandle add(std::size_t ref, const osg::Vec3f& position = osg::Vec3f())
+        {
+            mData.push_back(&mRefs[ref]);
+            return mSlots.add(&mRefs[ref], position);
+        }
+
+        std::vector<std::size_t> findNear(const osg::Vec3f& position, float radius) const
+        {
+            std::vector<std::size_t> result;
+            mSlots.findNear(position, radius, result);
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+
+        // Enough actors far away to make a small query look up the grid
+        void addDistant()
+        {
+            for (std::size_t i = 4; i < mRefs.size(); ++i)
+                add(i, osg::Vec3f(100000, 100000 + 10000 * i, 0));
+        }
+    };
+
+    TEST_F(MWMechanicsActorSlotsTest, add_should_append_actor)
+    {
+        add(0);
+        add(1);
+        EXPECT_EQ(mSlots.size(), 2u);
+        EXPECT_EQ(mSlots.count(), 2u);
+        EXPECT_EQ(mSlots.find(&mRefs[0]), 0u);
+        EXPECT_EQ(mSlots.find(&mRefs[1]), 1u);
+        EXPECT_FALSE(mSlots.isRemoved(1));
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, find_should_return_npos_for_not_added_actor)
+    {
+        add(0);
+        EXPECT_EQ(mSlots.find(&mRefs[1]), ActorSlots::npos);
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, remove_should_move_last_actor_into_index)
+    {
+        add(0);
+        add(1);
+        add(2);
+        mSlots.remove(0);
+        EXPECT_EQ(mErased, std::vector<std::size_t>({0}));
+        EXPECT_EQ(mSlots.size(), 2u);
+        EXPECT_EQ(mSlots.find(&mRefs[0]), ActorSlots::npos);
+        EXPECT_EQ(mSlots.find(&mRefs[2]), 0u);
+        EXPECT_EQ(mSlots.find(&mRefs[1]), 1u);
+        EXPECT_EQ(mData, std::vector<const void*>({&mRefs[2], &mRefs[1]}));
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, handle_should_follow_actor_moved_by_removal)
+    {
+        add(0);
+        const ActorHandle handle = add(1);
+        EXPECT_EQ(mSlots.getIndex(handle), 1u);
+        mSlots.remove(0);
+        EXPECT_EQ(mSlots.getIndex(handle), 0u);
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, handle_of_removed_actor_should_be_invalid)
+    {
+        const ActorHandle handle = add(0);
+        add(1);
+        mSlots.remove(0);
+        EXPECT_EQ(mSlots.getIndex(handle), ActorSlots::npos);
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, handle_of_removed_actor_should_be_invalid_after_its_slot_is_reused)
+    {
+        const ActorHandle removed = add(0);
+        mSlots.remove(0);
+        const ActorHandle added = add(1);
+        EXPECT_EQ(added.mSlot, removed.mSlot);
+        EXPECT_EQ(mSlots.getIndex(removed), ActorSlots::npos);
+        EXPECT_EQ(mSlots.getIndex(added), 0u);
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, default_handle_should_be_invalid)
+    {
+        add(0);
+        EXPECT_EQ(mSlots.getIndex(ActorHandle {}), ActorSlots::npos);
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, remove_inside_iteration_scope_should_be_deferred_until_scope_ends)
+    {
+        add(0);
+        add(1);
+        {
+            ActorSlots::IterationScope scope(mSlots);
+            mSlots.remove(0);
+            EXPECT_TRUE(mErased.empty());
+            EXPECT_EQ(mSlots.size(), 2u);
+            EXPECT_EQ(mSlots.count(), 1u);
+            EXPECT_TRUE(mSlots.isRemoved(0));
+            EXPECT_EQ(mSlots.find(&mRefs[0]), ActorSlots::npos);
+            EXPECT_EQ(mSlots.find(&mRefs[1]), 1u);
+        }
+        EXPECT_EQ(mErased, std::vector<std::size_t>({0}));
+        EXPECT_EQ(mSlots.size(), 1u);
+        EXPECT_EQ(mSlots.find(&mRefs[1]), 0u);
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, remove_inside_nested_iteration_scope_should_be_deferred_until_outermost_ends)
+    {
+        add(0);
+        {
+            ActorSlots::IterationScope outer(mSlots);
+            {
+                ActorSlots::IterationScope inner(mSlots);
+                mSlots.remove(0);
+            }
+            EXPECT_TRUE(mErased.empty());
+        }
+        EXPECT_EQ(mErased, std::vector<std::size_t>({0}));
+        EXPECT_EQ(mSlots.size(), 0u);
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, actor_removed_and_added_again_inside_iteration_scope_should_get_new_index)
+    {
+        add(0);
+        add(1);
+        const ActorHandle removed = mSlots.getHandle(0);
+        ActorHandle added;
+        {
+            ActorSlots::IterationScope scope(mSlots);
+            mSlots.remove(0);
+            added = add(0);
+            EXPECT_EQ(mSlots.size(), 3u);
+            EXPECT_TRUE(mSlots.isRemoved(0));
+            EXPECT_EQ(mSlots.find(&mRefs[0]), 2u);
+            EXPECT_EQ(mSlots.getIndex(added), 2u);
+            EXPECT_EQ(mSlots.getIndex(removed), ActorSlots::npos);
+        }
+        EXPECT_EQ(mSlots.size(), 2u);
+        EXPECT_EQ(mSlots.find(&mRefs[0]), 0u);
+        EXPECT_EQ(mSlots.find(&mRefs[1]), 1u);
+        EXPECT_EQ(mSlots.getIndex(added), 0u);
+        EXPECT_EQ(mData, std::vector<const void*>({&mRefs[0], &mRefs[1]}));
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, compact_should_erase_from_back)
+    {
+        for (std::size_t i = 0; i < 4; ++i)
+            add(i);
+        {
+            ActorSlots::IterationScope scope(mSlots);
+            mSlots.remove(0);
+            mSlots.remove(2);
+        }
+        EXPECT_EQ(mErased, std::vector<std::size_t>({2, 0}));
+        EXPECT_EQ(mSlots.find(&mRefs[3]), 0u);
+        EXPECT_EQ(mSlots.find(&mRefs[1]), 1u);
+        EXPECT_EQ(mData, std::vector<const void*>({&mRefs[3], &mRefs[1]}));
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, update_ref_should_keep_index_and_handle)
+    {
+        add(0);
+        const ActorHandle handle = add(1);
+        EXPECT_TRUE(mSlots.updateRef(&mRefs[1], &mRefs[2]));
+        EXPECT_EQ(mSlots.find(&mRefs[1]), ActorSlots::npos);
+        EXPECT_EQ(mSlots.find(&mRefs[2]), 1u);
+        EXPECT_EQ(mSlots.getIndex(handle), 1u);
+        EXPECT_EQ(mSlots.count(), 2u);
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, update_ref_should_return_false_for_not_added_actor)
+    {
+        add(0);
+        EXPECT_FALSE(mSlots.updateRef(&mRefs[1], &mRefs[2]));
+        EXPECT_EQ(mSlots.find(&mRefs[2]), ActorSlots::npos);
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, removal_after_update_ref_should_use_new_ref)
+    {
+        add(0);
+        mSlots.updateRef(&mRefs[0], &mRefs[1]);
+        mSlots.remove(0);
+        EXPECT_EQ(mSlots.count(), 0u);
+        EXPECT_EQ(mSlots.find(&mRefs[1]), ActorSlots::npos);
+        add(0);
+        EXPECT_EQ(mSlots.find(&mRefs[0]), 0u);
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, clear_should_remove_all_actors)
+    {
+        const ActorHandle handle = add(0);
+        add(1);
+        mSlots.clear();
+        EXPECT_EQ(mSlots.size(), 0u);
+        EXPECT_EQ(mSlots.count(), 0u);
+        EXPECT_EQ(mSlots.find(&mRefs[0]), ActorSlots::npos);
+        EXPECT_EQ(mSlots.getIndex(handle), ActorSlots::npos);
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, find_near_should_return_actors_from_cells_covered_by_radius_and_max_movement)
+    {
+        add(0, osg::Vec3f(100, 100, 0));
+        add(1, osg::Vec3f(1100, 100, 0));
+        add(2, osg::Vec3f(1500, 100, 0));
+        addDistant();
+        EXPECT_EQ(findNear(osg::Vec3f(100, 100, 0), 0), std::vector<std::size_t>({0}));
+        EXPECT_EQ(findNear(osg::Vec3f(900, 100, 0), 0), std::vector<std::size_t>({0, 1, 2}));
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, find_near_should_support_negative_coordinates)
+    {
+        add(0, osg::Vec3f(-1500, -500, 0));
+        add(1, osg::Vec3f(-500, -500, 0));
+        add(2, osg::Vec3f(500, 500, 0));
+        add(3, osg::Vec3f(-1500, 500, 0));
+        addDistant();
+        EXPECT_EQ(findNear(osg::Vec3f(-1536, -512, 0), 0), std::vector<std::size_t>({0}));
+        EXPECT_EQ(findNear(osg::Vec3f(-512, -512, 0), 0), std::vector<std::size_t>({1}));
+        EXPECT_EQ(findNear(osg::Vec3f(-1024, -10, 0), 0), std::vector<std::size_t>({0, 1, 3}));
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, find_near_should_follow_actor_moved_to_other_cell)
+    {
+        add(0, osg::Vec3f(100, 100, 0));
+        add(1, osg::Vec3f(-5000, -5000, 0));
+        addDistant();
+        mSlots.setPosition(0, osg::Vec3f(5000, 5000, 0));
+        EXPECT_EQ(mSlots.getPosition(0), osg::Vec3f(5000, 5000, 0));
+        EXPECT_EQ(findNear(osg::Vec3f(100, 100, 0), 0), std::vector<std::size_t>());
+        EXPECT_EQ(findNear(osg::Vec3f(5000, 5000, 0), 0), std::vector<std::size_t>({0}));
+        mSlots.setPosition(0, osg::Vec3f(5100, 5000, 0));
+        EXPECT_EQ(findNear(osg::Vec3f(5000, 5000, 0), 0), std::vector<std::size_t>({0}));
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, find_near_should_not_return_removed_actors)
+    {
+        add(0, osg::Vec3f(100, 100, 0));
+        add(1, osg::Vec3f(200, 100, 0));
+        addDistant();
+        ActorSlots::IterationScope scope(mSlots);
+        mSlots.remove(0);
+        EXPECT_EQ(findNear(osg::Vec3f(100, 100, 0), 0), std::vector<std::size_t>({1}));
+        EXPECT_EQ(findNear(osg::Vec3f(100, 100, 0), 1000000), std::vector<std::size_t>({1, 2, 3, 4, 5}));
+    }
+
+    TEST_F(MWMechanicsActorSlotsTest, find_near_covering_more_cells_than_actors_should_check_every_actor_position)
+    {
+        add(0, osg::Vec3f(-100, -100, 0));
+        add(1, osg::Vec3f(3000, -3000, 0));
+        add(2, osg::Vec3f(10000, 0, 0));
+        EXPECT_EQ(findNear(osg::Vec3f(0, 0, 0), 3000), std::vector<std::size_t>({0, 1}));
+        EXPECT_EQ(findNear(osg::Vec3f(0, 0, 0), 2700), std::vector<std::size_t>({0}));
+    }
+}
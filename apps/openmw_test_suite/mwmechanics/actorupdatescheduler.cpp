@@ -0,0 +1,139 @@
+#include <apps/openmw/mwmechanics/actorupdatescheduler.hpp>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWMechanics;
+
+    struct MWMechanicsActorUpdateSchedulerTest : Test
+    {
+        ActorUpdateScheduler mScheduler {1000, 4, 0.001f};
+    };
+
+    TEST_F(MWMechanicsActorUpdateSchedulerTest, should_update_every_frame_closer_than_lod_distance)
+    {
+        EXPECT_EQ(mScheduler.getUpdateInterval(999, true), 1);
+        EXPECT_EQ(mScheduler.getUpdateInterval(999, false), 1);
+    }
+
+    TEST_F(MWMechanicsActorUpdateSchedulerTest, should_skip_one_more_frame_for_each_further_band)
+    {
+        EXPECT_EQ(mScheduler.getUpdateInterval(1000, true), 2);
+        EXPECT_EQ(mScheduler.getUpdateInterval(2500, true), 3);
+    }
+
+    TEST_F(MWMechanicsActorUpdateSchedulerTest, should_treat_actor_not_in_view_as_one_band_further)
+    {
+        EXPECT_EQ(mScheduler.getUpdateInterval(1000, false), 3);
+    }
+
+    TEST_F(MWMechanicsActorUpdateSchedulerTest, should_limit_interval_by_max_interval)
+    {
+        EXPECT_EQ(mScheduler.getUpdateInterval(100000, true), 4);
+    }
+
+    TEST_F(MWMechanicsActorUpdateSchedulerTest, should_update_every_frame_when_disabled)
+    {
+        const ActorUpdateScheduler scheduler(0, 4, 0);
+        EXPECT_EQ(scheduler.getUpdateInterval(100000, false), 1);
+    }
+
+    TEST(MWMechanicsGetLodUpdateIntervalTest, should_add_extra_bands_only_beyond_lod_distance)
+    {
+        EXPECT_EQ(getLodUpdateInterval(999, 1000, 4, 1), 1u);
+        EXPECT_EQ(getLodUpdateInterval(1000, 1000, 4, 1), 3u);
+    }
+
+    TEST(MWMechanicsGetLodUpdateIntervalTest, should_treat_zero_max_interval_as_one)
+    {
+        EXPECT_EQ(getLodUpdateInterval(100000, 1000, 0), 1u);
+    }
+
+    TEST_F(MWMechanicsActorUpdateSchedulerTest, should_be_due_once_per_interval_depending_on_phase)
+    {
+        std::vector<unsigned> dueFrames;
+        for (unsigned frame = 0; frame < 6; ++frame)
+        {
+            mScheduler.beginFrame();
+            if (mScheduler.isDue(1, 0, 3))
+                dueFrames.push_back(frame);
+        }
+        EXPECT_EQ(dueFrames, std::vector<unsigned>({1, 4}));
+    }
+
+    TEST_F(MWMechanicsActorUpdateSchedulerTest, should_be_due_when_skipped_for_interval)
+    {
+        mScheduler.beginFrame();
+        EXPECT_FALSE(mScheduler.isDue(0, 2, 3));
+        EXPECT_TRUE(mScheduler.isDue(0, 3, 3));
+    }
+
+    TEST_F(MWMechanicsActorUpdateSchedulerTest, should_select_all_deferred_before_cost_is_known)
+    {
+        mScheduler.beginFrame();
+        mScheduler.addDeferred(0, 1, 2);
+        mScheduler.addDeferred(1, 1, 2);
+        EXPECT_EQ(mScheduler.selectDeferred(), std::vector<std::size_t>({0, 1}));
+    }
+
+    TEST_F(MWMechanicsActorUpdateSchedulerTest, should_select_most_overdue_first)
+    {
+        mScheduler.beginFrame();
+        mScheduler.addDeferred(0, 1, 2);
+        mScheduler.addDeferred(1, 5, 2);
+        mScheduler.addDeferred(2, 3, 2);
+        EXPECT_EQ(mScheduler.selectDeferred(), std::vector<std::size_t>({1, 2, 0}));
+    }
+
+    TEST_F(MWMechanicsActorUpdateSchedulerTest, should_select_as_many_as_fit_into_budget_by_previous_cost)
+    {
+        mScheduler.beginFrame();
+        mScheduler.reportUpdate(true, 0.0004f);
+        mScheduler.endFrame();
+
+        mScheduler.beginFrame();
+        for (std::size_t i = 0; i < 4; ++i)
+            mScheduler.addDeferred(i, 1, 2);
+        EXPECT_EQ(mScheduler.selectDeferred(), std::vector<std::size_t>({0, 1}));
+    }
+
+    TEST_F(MWMechanicsActorUpdateSchedulerTest, should_select_at_least_one_when_cost_exceeds_budget)
+    {
+        mScheduler.beginFrame();
+        mScheduler.reportUpdate(true, 0.01f);
+        mScheduler.endFrame();
+
+        mScheduler.beginFrame();
+        mScheduler.addDeferred(0, 1, 2);
+        mScheduler.addDeferred(1, 1, 2);
+        EXPECT_EQ(mScheduler.selectDeferred(), std::vector<std::size_t>({0}));
+    }
+
+    TEST_F(MWMechanicsActorUpdateSchedulerTest, should_run_out_of_budget_after_deferred_updates_exceed_it)
+    {
+        mScheduler.beginFrame();
+        EXPECT_TRUE(mScheduler.hasBudget());
+        mScheduler.reportUpdate(false, 0.01f);
+        EXPECT_TRUE(mScheduler.hasBudget());
+        mScheduler.reportUpdate(true, 0.01f);
+        EXPECT_FALSE(mScheduler.hasBudget());
+    }
+
+    TEST_F(MWMechanicsActorUpdateSchedulerTest, should_report_updated_and_starved_actors)
+    {
+        mScheduler.beginFrame();
+        mScheduler.addDeferred(0, 1, 2);
+        mScheduler.addDeferred(1, 1, 2);
+        mScheduler.addDeferred(2, 1, 2);
+        mScheduler.selectDeferred();
+        mScheduler.reportUpdate(false, 0);
+        mScheduler.reportUpdate(true, 0);
+        mScheduler.endFrame();
+        EXPECT_EQ(mScheduler.getUpdatedCount(), 2);
+        EXPECT_EQ(mScheduler.getStarvedCount(), 2);
+    }
+}
@@ -0,0 +1,122 @@
+#include <apps/openmw/mwmechanics/collisionprediction.hpp>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWMechanics;
+
+    CollisionPredictionActor makeActor(const osg::Vec3f& position, const osg::Vec3f& velocity = osg::Vec3f())
+    {
+        CollisionPredictionActor result;
+        result.mPosition = position;
+        result.mHalfExtents = osg::Vec3f(30, 30, 60);
+        result.mVelocity = velocity;
+        result.mMaxSpeed = 100;
+        return result;
+    }
+
+    CollisionPredictionQuery makeQuery(std::size_t actor)
+    {
+        CollisionPredictionQuery result;
+        result.mActor = actor;
+        result.mIsMoving = true;
+        result.mMaxTime = 2;
+        return result;
+    }
+
+    struct MWMechanicsCollisionPredictionTest : Test
+    {
+        std::vector<CollisionPredictionActor> mActors {
+            makeActor(osg::Vec3f(0, 0, 0), osg::Vec3f(0, 100, 0)),
+            makeActor(osg::Vec3f(0, 150, 0)),
+        };
+        std::vector<PredictedCollision> mCollisions;
+    };
+
+    TEST_F(MWMechanicsCollisionPredictionTest, should_predict_collision_with_standing_actor_ahead)
+    {
+        predictCollisions(mActors, makeQuery(0), {0, 1}, mCollisions);
+        ASSERT_EQ(mCollisions.size(), 1);
+        EXPECT_EQ(mCollisions[0].mOther, 1);
+        EXPECT_FLOAT_EQ(mCollisions[0].mTime, 0.8f);
+        EXPECT_FLOAT_EQ(mCollisions[0].mAngle, 0);
+        EXPECT_FLOAT_EQ(mCollisions[0].mMovementCorrection.x(), 0);
+        EXPECT_FLOAT_EQ(mCollisions[0].mMovementCorrection.y(), -0.5f);
+    }
+
+    TEST_F(MWMechanicsCollisionPredictionTest, should_halve_forward_correction_for_dead_actor)
+    {
+        mActors[1].mDead = true;
+        predictCollisions(mActors, makeQuery(0), {1}, mCollisions);
+        ASSERT_EQ(mCollisions.size(), 1);
+        EXPECT_FLOAT_EQ(mCollisions[0].mMovementCorrection.y(), -0.25f);
+    }
+
+    TEST_F(MWMechanicsCollisionPredictionTest, should_ignore_actor_behind)
+    {
+        mActors[1].mPosition = osg::Vec3f(0, -150, 0);
+        predictCollisions(mActors, makeQuery(0), {1}, mCollisions);
+        EXPECT_TRUE(mCollisions.empty());
+    }
+
+    TEST_F(MWMechanicsCollisionPredictionTest, should_ignore_actor_further_than_check_distance)
+    {
+        mActors[1].mPosition = osg::Vec3f(0, getCollisionCheckDistance(true) + 1, 0);
+        predictCollisions(mActors, makeQuery(0), {1}, mCollisions);
+        EXPECT_TRUE(mCollisions.empty());
+    }
+
+    TEST_F(MWMechanicsCollisionPredictionTest, should_ignore_actor_on_different_height)
+    {
+        mActors[1].mPosition.z() = 200;
+        predictCollisions(mActors, makeQuery(0), {1}, mCollisions);
+        EXPECT_TRUE(mCollisions.empty());
+    }
+
+    TEST_F(MWMechanicsCollisionPredictionTest, should_ignore_query_ignored_actor)
+    {
+        CollisionPredictionQuery query = makeQuery(0);
+        query.mIgnored = 1;
+        predictCollisions(mActors, query, {1}, mCollisions);
+        EXPECT_TRUE(mCollisions.empty());
+    }
+
+    TEST_F(MWMechanicsCollisionPredictionTest, should_ignore_collision_after_max_time)
+    {
+        CollisionPredictionQuery query = makeQuery(0);
+        query.mMaxTime = 0.8f;
+        predictCollisions(mActors, query, {1}, mCollisions);
+        EXPECT_TRUE(mCollisions.empty());
+    }
+
+    TEST_F(MWMechanicsCollisionPredictionTest, should_ignore_actor_moving_the_same_way)
+    {
+        mActors[1].mVelocity = mActors[0].mVelocity;
+        predictCollisions(mActors, makeQuery(0), {1}, mCollisions);
+        EXPECT_TRUE(mCollisions.empty());
+    }
+
+    TEST_F(MWMechanicsCollisionPredictionTest, should_sort_collisions_by_time)
+    {
+        mActors.push_back(makeActor(osg::Vec3f(0, 120, 0)));
+        predictCollisions(mActors, makeQuery(0), {1, 2}, mCollisions);
+        ASSERT_EQ(mCollisions.size(), 2);
+        EXPECT_EQ(mCollisions[0].mOther, 2);
+        EXPECT_FLOAT_EQ(mCollisions[0].mTime, 0.5f);
+        EXPECT_EQ(mCollisions[1].mOther, 1);
+        EXPECT_FLOAT_EQ(mCollisions[1].mTime, 0.8f);
+    }
+
+    TEST_F(MWMechanicsCollisionPredictionTest, should_keep_collisions_already_in_output)
+    {
+        mCollisions.push_back(PredictedCollision {42, 1.5f, 0, osg::Vec2f()});
+        predictCollisions(mActors, makeQuery(0), {1}, mCollisions);
+        ASSERT_EQ(mCollisions.size(), 2);
+        EXPECT_EQ(mCollisions[0].mOther, 42);
+        EXPECT_EQ(mCollisions[1].mOther, 1);
+    }
+}
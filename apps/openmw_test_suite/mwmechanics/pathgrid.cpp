@@ -0,0 +1,210 @@
+#include <apps/openmw/mwmechanics/pathgrid.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <list>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWMechanics;
+
+    float getCost(const ESM::Pathgrid::Point& a, const ESM::Pathgrid::Point& b)
+    {
+        return 300.0f * (std::abs(a.mX - b.mX) + std::abs(a.mY - b.mY) + std::abs(a.mZ - b.mZ));
+    }
+
+    // A* search the graph used before the next point tables, as the reference for the paths it finds
+    std::vector<int> findPathByAStar(const ESM::Pathgrid& pathgrid, int start, int goal)
+    {
+        const std::size_t size = pathgrid.mPoints.size();
+        std::vector<float> gScore(size, -1);
+        std::vector<float> fScore(size, -1);
+        std::vector<int> parent(size, -1);
+
+        gScore[start] = 0;
+        fScore[start] = getCost(pathgrid.mPoints[start], pathgrid.mPoints[goal]);
+
+        std::list<int> openset {start};
+        std::vector<int> closedset;
+        int current = -1;
+
+        while (!openset.empty())
+        {
+            current = openset.front();
+            openset.pop_front();
+            if (current == goal)
+                break;
+            closedset.push_back(current);
+
+            for (const ESM::Pathgrid::Edge& edge : pathgrid.mEdges)
+            {
+                if (edge.mV0 != current)
+                    continue;
+                const int dest = edge.mV1;
+                if (std::find(closedset.begin(), closedset.end(), dest) != closedset.end())
+                    continue;
+                const float tentative = gScore[current] + getCost(pathgrid.mPoints[current], pathgrid.mPoints[dest]);
+                const bool isInOpenSet = std::find(openset.begin(), openset.end(), dest) != openset.end();
+                if (isInOpenSet && tentative >= gScore[dest])
+                    continue;
+                parent[dest] = current;
+                gScore[dest] = tentative;
+                fScore[dest] = tentative + getCost(pathgrid.mPoints[dest], pathgrid.mPoints[goal]);
+                if (isInOpenSet)
+                    openset.remove(dest);
+                const auto it = std::find_if(openset.begin(), openset.end(),
+                                             [&] (int point) { return fScore[point] > fScore[dest]; });
+                openset.insert(it, dest);
+            }
+        }
+
+        std::vector<int> path;
+        if (current != goal)
+            return path;
+        for (int point = goal; point != -1; point = parent[point])
+            path.push_back(point);
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    struct MWMechanicsPathgridGraphTest : Test
+    {
+        ESM::Pathgrid mPathgrid;
+
+        // Paths of equal cost may go through different points, so paths are compared by cost
+        float getPathCost(const std::vector<int>& path) const
+        {
+            float cost = 0;
+            for (std::size_t i = 1; i < path.size(); ++i)
+            {
+                const auto edge = std::find_if(mPathgrid.mEdges.begin(), mPathgrid.mEdges.end(),
+                    [&] (const ESM::Pathgrid::Edge& v) { return v.mV0 == path[i - 1] && v.mV1 == path[i]; });
+                EXPECT_NE(edge, mPathgrid.mEdges.end()) << path[i - 1] << " " << path[i];
+                cost += getCost(mPathgrid.mPoints[path[i - 1]], mPathgrid.mPoints[path[i]]);
+            }
+            return cost;
+        }
+
+        void expectSameAsAStar(const std::vector<int>& path, int start, int end) const
+        {
+            const std::vector<int> expected = findPathByAStar(mPathgrid, start, end);
+            ASSERT_FALSE(path.empty()) << start << " " << end;
+            EXPECT_EQ(path.front(), start);
+            EXPECT_EQ(path.back(), end);
+            EXPECT_FLOAT_EQ(getPathCost(path), getPathCost(expected)) << start << " " << end;
+        }
+
+        // Uneven 3x3 grid of points 0 to 8 connected both ways to the horizontal and vertical neighbours, except
+        // 4 -> 5 which is one way. Point 9 is connected only one way from 8 and point 10 not at all.
+        MWMechanicsPathgridGraphTest()
+        {
+            const int xs[] = {0, 500, 1300};
+            const int ys[] = {0, 700, 1100};
+            for (int y : ys)
+                for (int x : xs)
+                    mPathgrid.mPoints.emplace_back(x + y / 10, y, 0);
+            mPathgrid.mPoints.emplace_back(2000, 2000, 0);
+            mPathgrid.mPoints.emplace_back(5000, 5000, 0);
+            for (int row = 0; row < 3; ++row)
+            {
+                for (int col = 0; col < 3; ++col)
+                {
+                    const int point = row * 3 + col;
+                    if (col < 2)
+                    {
+                        connect(point, point + 1);
+                        if (point != 4)
+                            connect(point + 1, point);
+                    }
+                    if (row < 2)
+                    {
+                        connect(point, point + 3);
+                        connect(point + 3, point);
+                    }
+                }
+            }
+            connect(8, 9);
+        }
+
+        void connect(int from, int to)
+        {
+            mPathgrid.mEdges.push_back(ESM::Pathgrid::Edge {from, to});
+        }
+    };
+
+    TEST_F(MWMechanicsPathgridGraphTest, find_path_should_match_a_star_for_every_pair_of_connected_points)
+    {
+        const PathgridGraph graph(&mPathgrid);
+        std::vector<int> path;
+        for (int start = 0; start < 9; ++start)
+        {
+            for (int end = 0; end < 9; ++end)
+            {
+                if (start == end)
+                    continue;
+                ASSERT_TRUE(graph.isPointConnected(start, end)) << start << " " << end;
+                graph.findPath(start, end, path);
+                expectSameAsAStar(path, start, end);
+            }
+        }
+    }
+
+    TEST_F(MWMechanicsPathgridGraphTest, find_path_should_follow_one_way_edge_only_in_its_direction)
+    {
+        const PathgridGraph graph(&mPathgrid);
+        std::vector<int> path;
+        graph.findPath(4, 5, path);
+        EXPECT_EQ(path, std::vector<int>({4, 5}));
+        graph.findPath(5, 4, path);
+        // Around through a neighbour of both
+        EXPECT_EQ(path.size(), 4u);
+        expectSameAsAStar(path, 5, 4);
+    }
+
+    TEST_F(MWMechanicsPathgridGraphTest, find_path_should_reuse_next_points_for_other_start)
+    {
+        const PathgridGraph graph(&mPathgrid);
+        std::vector<int> path;
+        graph.findPath(0, 8, path);
+        expectSameAsAStar(path, 0, 8);
+        graph.findPath(6, 8, path);
+        expectSameAsAStar(path, 6, 8);
+    }
+
+    TEST_F(MWMechanicsPathgridGraphTest, find_path_to_unreachable_point_should_return_empty_path)
+    {
+        const PathgridGraph graph(&mPathgrid);
+        std::vector<int> path {1, 2, 3};
+        EXPECT_FALSE(graph.isPointConnected(0, 10));
+        graph.findPath(0, 10, path);
+        EXPECT_EQ(path, std::vector<int>());
+        EXPECT_EQ(findPathByAStar(mPathgrid, 0, 10), std::vector<int>());
+    }
+
+    TEST_F(MWMechanicsPathgridGraphTest, find_path_to_point_reachable_only_one_way_should_return_empty_path)
+    {
+        const PathgridGraph graph(&mPathgrid);
+        std::vector<int> path;
+        EXPECT_FALSE(graph.isPointConnected(0, 9));
+        graph.findPath(0, 9, path);
+        EXPECT_EQ(path, std::vector<int>());
+    }
+
+    TEST_F(MWMechanicsPathgridGraphTest, find_path_to_start_should_return_empty_path)
+    {
+        const PathgridGraph graph(&mPathgrid);
+        std::vector<int> path {1};
+        graph.findPath(3, 3, path);
+        EXPECT_EQ(path, std::vector<int>());
+    }
+
+    TEST_F(MWMechanicsPathgridGraphTest, graph_without_pathgrid_should_have_no_pathgrid)
+    {
+        const PathgridGraph graph(nullptr);
+        EXPECT_EQ(graph.getPathgrid(), nullptr);
+    }
+}
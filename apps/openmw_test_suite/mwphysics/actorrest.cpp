@@ -0,0 +1,81 @@
+#include <apps/openmw/mwphysics/actorrest.hpp>
+
+#include <BulletCollision/CollisionDispatch/btCollisionObject.h>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWPhysics;
+
+    struct MWPhysicsActorRestTest : Test
+    {
+        ActorRest mRest;
+        const btCollisionObject mGroundObject;
+        const btCollisionObject mOtherGroundObject;
+        const btCollisionObject* const mGround = &mGroundObject;
+        const btCollisionObject* const mOtherGround = &mOtherGroundObject;
+    };
+
+    TEST_F(MWPhysicsActorRestTest, should_not_sleep_initially)
+    {
+        EXPECT_FALSE(mRest.isSleeping());
+        EXPECT_EQ(mRest.getSleepingOn(), nullptr);
+    }
+
+    TEST_F(MWPhysicsActorRestTest, should_sleep_after_resting_on_same_object_for_a_few_steps)
+    {
+        mRest.update(mGround);
+        for (unsigned i = 1; i < ActorRest::stepsBeforeSleeping; ++i)
+        {
+            mRest.update(mGround);
+            EXPECT_FALSE(mRest.isSleeping());
+        }
+        mRest.update(mGround);
+        EXPECT_TRUE(mRest.isSleeping());
+        EXPECT_EQ(mRest.getSleepingOn(), mGround);
+    }
+
+    TEST_F(MWPhysicsActorRestTest, should_start_counting_again_when_resting_on_other_object)
+    {
+        for (unsigned i = 0; i < ActorRest::stepsBeforeSleeping; ++i)
+            mRest.update(mGround);
+        mRest.update(mOtherGround);
+        EXPECT_FALSE(mRest.isSleeping());
+        for (unsigned i = 0; i < ActorRest::stepsBeforeSleeping; ++i)
+            mRest.update(mOtherGround);
+        EXPECT_TRUE(mRest.isSleeping());
+        EXPECT_EQ(mRest.getSleepingOn(), mOtherGround);
+    }
+
+    TEST_F(MWPhysicsActorRestTest, should_wake_up_when_not_at_rest)
+    {
+        for (unsigned i = 0; i <= ActorRest::stepsBeforeSleeping; ++i)
+            mRest.update(mGround);
+        ASSERT_TRUE(mRest.isSleeping());
+        mRest.update(nullptr);
+        EXPECT_FALSE(mRest.isSleeping());
+        EXPECT_EQ(mRest.getSleepingOn(), nullptr);
+    }
+
+    TEST_F(MWPhysicsActorRestTest, should_never_sleep_when_not_at_rest)
+    {
+        for (unsigned i = 0; i <= ActorRest::stepsBeforeSleeping; ++i)
+            mRest.update(nullptr);
+        EXPECT_FALSE(mRest.isSleeping());
+    }
+
+    TEST_F(MWPhysicsActorRestTest, wake_up_should_restart_counting)
+    {
+        for (unsigned i = 0; i <= ActorRest::stepsBeforeSleeping; ++i)
+            mRest.update(mGround);
+        mRest.wakeUp();
+        EXPECT_FALSE(mRest.isSleeping());
+        for (unsigned i = 0; i < ActorRest::stepsBeforeSleeping; ++i)
+            mRest.update(mGround);
+        EXPECT_FALSE(mRest.isSleeping());
+        mRest.update(mGround);
+        EXPECT_TRUE(mRest.isSleeping());
+    }
+}
@@ -0,0 +1,138 @@
+#include <apps/openmw/mwphysics/compoundchild.hpp>
+
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcher.h>
+#include <BulletCollision/CollisionDispatch/btCollisionObject.h>
+#include <BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h>
+#include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
+#include <BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
+#include <BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
+#include <BulletCollision/CollisionShapes/btCompoundShape.h>
+#include <BulletCollision/CollisionShapes/btSphereShape.h>
+#include <BulletCollision/CollisionShapes/btTriangleMesh.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWPhysics;
+
+    struct CollectChildIndices : btCollisionWorld::ContactResultCallback
+    {
+        const btCollisionObject* mCompound;
+        std::vector<int> mChildIndices;
+
+        explicit CollectChildIndices(const btCollisionObject* compound) : mCompound(compound) {}
+
+        btScalar addSingleResult(btManifoldPoint& /*cp*/,
+                                 const btCollisionObjectWrapper* col0Wrap, int /*partId0*/, int /*index0*/,
+                                 const btCollisionObjectWrapper* col1Wrap, int /*partId1*/, int /*index1*/) override
+        {
+            mChildIndices.push_back(getCompoundChildIndex(col0Wrap->m_collisionObject == mCompound ? *col0Wrap : *col1Wrap));
+            return 0;
+        }
+    };
+
+    /// Child 0 is a ramp z = x over [0, 100] on x and y, child 1 a sphere below it, inside the bounds of the ramp.
+    /// A part of the ramp surface is inside the bounds of the sphere, so bounds alone can't tell them apart.
+    struct MWPhysicsCompoundChildTest : Test
+    {
+        btTriangleMesh mRampMesh;
+        std::unique_ptr<btBvhTriangleMeshShape> mRamp;
+        btSphereShape mSphere {9};
+        btCompoundShape mShape;
+        const btVector3 mRampNormal = btVector3(-1, 0, 1).normalized();
+        const btVector3 mPointOnRampInSphereBounds {52, 50, 52};
+        const btVector3 mTopOfSphere {60, 50, 54};
+
+        MWPhysicsCompoundChildTest()
+        {
+            mRampMesh.addTriangle(btVector3(0, 0, 0), btVector3(100, 0, 100), btVector3(100, 100, 100));
+            mRampMesh.addTriangle(btVector3(0, 0, 0), btVector3(100, 100, 100), btVector3(0, 100, 0));
+            mRamp = std::make_unique<btBvhTriangleMeshShape>(&mRampMesh, true);
+            mShape.addChildShape(btTransform::getIdentity(), mRamp.get());
+            mShape.addChildShape(btTransform(btQuaternion::getIdentity(), btVector3(60, 50, 45)), &mSphere);
+        }
+
+        std::vector<int> getContactChildIndices(const btVector3& position, btScalar radius)
+        {
+            btDefaultCollisionConfiguration configuration;
+            btCollisionDispatcher dispatcher(&configuration);
+            btDbvtBroadphase broadphase;
+            btCollisionWorld world(&dispatcher, &broadphase, &configuration);
+            btCollisionObject compound;
+            compound.setCollisionShape(&mShape);
+            world.addCollisionObject(&compound);
+            btSphereShape sphere(radius);
+            btCollisionObject object;
+            object.setCollisionShape(&sphere);
+            object.setWorldTransform(btTransform(btQuaternion::getIdentity(), position));
+            CollectChildIndices callback(&compound);
+            world.contactTest(&object, callback);
+            world.removeCollisionObject(&compound);
+            return callback.mChildIndices;
+        }
+    };
+
+    TEST_F(MWPhysicsCompoundChildTest, find_should_return_child_hit_by_segment_when_bounds_overlap)
+    {
+        const btVector3& point = mPointOnRampInSphereBounds;
+        EXPECT_EQ(findCompoundChildIndex(mShape, point + mRampNormal, point - mRampNormal), 0);
+    }
+
+    TEST_F(MWPhysicsCompoundChildTest, find_should_return_smaller_child_when_it_is_hit_inside_bounds_of_other)
+    {
+        const btVector3 up(0, 0, 1);
+        EXPECT_EQ(findCompoundChildIndex(mShape, mTopOfSphere + up, mTopOfSphere - up), 1);
+    }
+
+    TEST_F(MWPhysicsCompoundChildTest, find_should_return_only_child_with_bounds_touched_by_segment)
+    {
+        const btVector3 up(0, 0, 1);
+        const btVector3 point(10, 90, 10);
+        EXPECT_EQ(findCompoundChildIndex(mShape, point + up, point - up), 0);
+    }
+
+    TEST_F(MWPhysicsCompoundChildTest, find_should_return_minus_one_when_there_are_no_children_nearby)
+    {
+        const btVector3 up(0, 0, 1);
+        const btVector3 point(500, 500, 500);
+        EXPECT_EQ(findCompoundChildIndex(mShape, point + up, point - up), -1);
+    }
+
+    TEST_F(MWPhysicsCompoundChildTest, get_index_should_return_child_of_mesh_triangle_contact)
+    {
+        const std::vector<int> indices = getContactChildIndices(mPointOnRampInSphereBounds + mRampNormal * 0.5f, 1);
+        ASSERT_FALSE(indices.empty());
+        EXPECT_EQ(indices, std::vector<int>(indices.size(), 0));
+    }
+
+    TEST_F(MWPhysicsCompoundChildTest, get_index_should_return_child_of_convex_contact)
+    {
+        const std::vector<int> indices = getContactChildIndices(mTopOfSphere + btVector3(0, 0, 0.5f), 1);
+        ASSERT_FALSE(indices.empty());
+        EXPECT_EQ(indices, std::vector<int>(indices.size(), 1));
+    }
+
+    TEST_F(MWPhysicsCompoundChildTest, get_index_should_return_child_for_nested_wrappers)
+    {
+        const btCollisionObject object;
+        const btTransform transform = btTransform::getIdentity();
+        const btCollisionObjectWrapper root(nullptr, &mShape, &object, transform, -1, -1);
+        const btCollisionObjectWrapper child(&root, mRamp.get(), &object, transform, -1, 0);
+        const btCollisionObjectWrapper triangle(&child, mRamp.get(), &object, transform, 0, 1);
+        EXPECT_EQ(getCompoundChildIndex(triangle), 0);
+        EXPECT_EQ(getCompoundChildIndex(child), 0);
+    }
+
+    TEST_F(MWPhysicsCompoundChildTest, get_index_should_return_minus_one_for_collision_object_itself)
+    {
+        const btCollisionObject object;
+        const btCollisionObjectWrapper root(nullptr, &mShape, &object, btTransform::getIdentity(), -1, -1);
+        EXPECT_EQ(getCompoundChildIndex(root), -1);
+    }
+}
@@ -0,0 +1,101 @@
+#include <apps/openmw/mwphysics/rayqueryresults.hpp>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWPhysics;
+
+    RayQueryResult makeResult(std::size_t tag, const osg::Vec3f& hitPos)
+    {
+        return RayQueryResult {tag, RayCastingResult {true, hitPos, osg::Vec3f(0, 0, 1), {}}};
+    }
+
+    struct MWPhysicsRayQueryResultsTest : Test
+    {
+        RayQueryResults mResults {2};
+    };
+
+    TEST_F(MWPhysicsRayQueryResultsTest, make_tag_should_return_unique_non_zero_tags)
+    {
+        const std::size_t first = mResults.makeTag();
+        const std::size_t second = mResults.makeTag();
+        EXPECT_NE(first, 0u);
+        EXPECT_NE(second, 0u);
+        EXPECT_NE(first, second);
+    }
+
+    TEST_F(MWPhysicsRayQueryResultsTest, take_should_return_nothing_before_update)
+    {
+        const std::size_t tag = mResults.makeTag();
+        EXPECT_FALSE(mResults.take(tag).has_value());
+    }
+
+    TEST_F(MWPhysicsRayQueryResultsTest, take_should_return_result_for_tag)
+    {
+        const std::size_t first = mResults.makeTag();
+        const std::size_t second = mResults.makeTag();
+        mResults.update({makeResult(first, osg::Vec3f(1, 2, 3)), makeResult(second, osg::Vec3f(4, 5, 6))});
+        const std::optional<RayCastingResult> result = mResults.take(second);
+        ASSERT_TRUE(result.has_value());
+        EXPECT_TRUE(result->mHit);
+        EXPECT_EQ(result->mHitPos, osg::Vec3f(4, 5, 6));
+    }
+
+    TEST_F(MWPhysicsRayQueryResultsTest, take_should_return_result_only_once)
+    {
+        const std::size_t tag = mResults.makeTag();
+        mResults.update({makeResult(tag, osg::Vec3f(1, 2, 3))});
+        EXPECT_TRUE(mResults.take(tag).has_value());
+        EXPECT_FALSE(mResults.take(tag).has_value());
+    }
+
+    TEST_F(MWPhysicsRayQueryResultsTest, update_should_keep_results_not_taken_for_max_age)
+    {
+        const std::size_t tag = mResults.makeTag();
+        mResults.update({makeResult(tag, osg::Vec3f(1, 2, 3))});
+        mResults.update({});
+        mResults.update({});
+        EXPECT_TRUE(mResults.take(tag).has_value());
+    }
+
+    TEST_F(MWPhysicsRayQueryResultsTest, update_should_drop_results_older_than_max_age)
+    {
+        const std::size_t tag = mResults.makeTag();
+        mResults.update({makeResult(tag, osg::Vec3f(1, 2, 3))});
+        mResults.update({});
+        mResults.update({});
+        mResults.update({});
+        EXPECT_FALSE(mResults.take(tag).has_value());
+    }
+
+    TEST_F(MWPhysicsRayQueryResultsTest, add_should_make_result_available_without_update)
+    {
+        const std::size_t tag = mResults.makeTag();
+        mResults.add({makeResult(tag, osg::Vec3f(1, 2, 3))});
+        const std::optional<RayCastingResult> result = mResults.take(tag);
+        ASSERT_TRUE(result.has_value());
+        EXPECT_EQ(result->mHitPos, osg::Vec3f(1, 2, 3));
+    }
+
+    TEST_F(MWPhysicsRayQueryResultsTest, add_should_not_drop_results_of_previous_update)
+    {
+        const std::size_t first = mResults.makeTag();
+        mResults.update({makeResult(first, osg::Vec3f(1, 2, 3))});
+        for (int i = 0; i < 4; ++i)
+            mResults.add({makeResult(mResults.makeTag(), osg::Vec3f(4, 5, 6))});
+        EXPECT_TRUE(mResults.take(first).has_value());
+    }
+
+    TEST_F(MWPhysicsRayQueryResultsTest, update_should_age_added_results_as_results_of_previous_update)
+    {
+        const std::size_t tag = mResults.makeTag();
+        mResults.update({});
+        mResults.add({makeResult(tag, osg::Vec3f(1, 2, 3))});
+        mResults.update({});
+        mResults.update({});
+        mResults.update({});
+        EXPECT_FALSE(mResults.take(tag).has_value());
+    }
+}
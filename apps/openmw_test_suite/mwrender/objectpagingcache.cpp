@@ -0,0 +1,199 @@
+#include <apps/openmw/mwrender/objectpagingcache.hpp>
+#include <apps/openmw/mwrender/objectpaging.hpp>
+
+#include <osg/Geometry>
+#include <osg/Material>
+#include <osg/MatrixTransform>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+
+namespace
+{
+    using namespace testing;
+    using namespace MWRender;
+
+    struct MWRenderObjectPagingCacheTest : Test
+    {
+        const boost::filesystem::path mPath = std::string(UnitTest::GetInstance()->current_test_info()->name()) + "_objectpaging";
+        const ObjectPagingCache::Key mKey = ObjectPagingCache::makeKey("chunk");
+        osg::ref_ptr<osg::Group> mTemplate = new osg::Group;
+        osg::ref_ptr<osg::StateSet> mStateSet = new osg::StateSet;
+
+        MWRenderObjectPagingCacheTest()
+        {
+            boost::filesystem::remove_all(mPath);
+            osg::ref_ptr<osg::Material> material = new osg::Material;
+            material->setDiffuse(osg::Material::FRONT_AND_BACK, osg::Vec4f(1, 0, 0, 1));
+            mStateSet->setAttributeAndModes(material);
+            osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+            geometry->setStateSet(mStateSet);
+            mTemplate->addChild(geometry);
+        }
+
+        ~MWRenderObjectPagingCacheTest()
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove_all(mPath, ec);
+        }
+
+        std::vector<ObjectPagingCache::Template> makeTemplates(const ObjectPagingCache::Key& contentHash) const
+        {
+            return {ObjectPagingCache::Template {"meshes/a.nif", contentHash, mTemplate.get()}};
+        }
+
+        osg::ref_ptr<osg::Group> makeChunk() const
+        {
+            osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+            osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
+            vertices->push_back(osg::Vec3f(0, 0, 0));
+            vertices->push_back(osg::Vec3f(1, 0, 0));
+            vertices->push_back(osg::Vec3f(0, 1, 0));
+            geometry->setVertexArray(vertices);
+            geometry->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::TRIANGLES, 0, 3));
+            // The copy of a template shares its state set
+            geometry->setStateSet(mStateSet);
+            osg::ref_ptr<RefnumMarker> marker = new RefnumMarker;
+            marker->mRefnum.mIndex = 42;
+            marker->mRefnum.mContentFile = 1;
+            marker->mNumVertices = 3;
+            geometry->getOrCreateUserDataContainer()->addUserObject(marker);
+
+            osg::ref_ptr<osg::MatrixTransform> transform = new osg::MatrixTransform(osg::Matrix::translate(1, 2, 3));
+            transform->addChild(geometry);
+            osg::ref_ptr<osg::Group> chunk = new osg::Group;
+            chunk->addChild(transform);
+            return chunk;
+        }
+    };
+
+    TEST_F(MWRenderObjectPagingCacheTest, read_should_return_nullptr_for_missing_entry)
+    {
+        ObjectPagingCache cache(mPath, 0);
+        EXPECT_EQ(cache.read(mKey, makeTemplates({1, 2})), nullptr);
+    }
+
+    TEST_F(MWRenderObjectPagingCacheTest, read_should_return_written_chunk)
+    {
+        ObjectPagingCache cache(mPath, 0);
+        cache.write(mKey, *makeChunk(), makeTemplates({1, 2}));
+
+        const osg::ref_ptr<osg::Group> result = cache.read(mKey, makeTemplates({1, 2}));
+        ASSERT_NE(result, nullptr);
+        ASSERT_EQ(result->getNumChildren(), 1u);
+        const auto transform = dynamic_cast<const osg::MatrixTransform*>(result->getChild(0));
+        ASSERT_NE(transform, nullptr);
+        EXPECT_EQ(transform->getMatrix(), osg::Matrix::translate(1, 2, 3));
+        ASSERT_EQ(transform->getNumChildren(), 1u);
+        const auto geometry = dynamic_cast<const osg::Geometry*>(transform->getChild(0));
+        ASSERT_NE(geometry, nullptr);
+        EXPECT_EQ(geometry->getStateSet(), mStateSet.get());
+        const auto vertices = dynamic_cast<const osg::Vec3Array*>(geometry->getVertexArray());
+        ASSERT_NE(vertices, nullptr);
+        ASSERT_EQ(vertices->size(), 3u);
+        EXPECT_EQ((*vertices)[1], osg::Vec3f(1, 0, 0));
+        ASSERT_EQ(geometry->getNumPrimitiveSets(), 1u);
+        EXPECT_EQ(geometry->getPrimitiveSet(0)->getNumIndices(), 3u);
+        ASSERT_NE(geometry->getUserDataContainer(), nullptr);
+        ASSERT_EQ(geometry->getUserDataContainer()->getNumUserObjects(), 1u);
+        const auto marker = dynamic_cast<const RefnumMarker*>(geometry->getUserDataContainer()->getUserObject(0));
+        ASSERT_NE(marker, nullptr);
+        EXPECT_EQ(marker->mRefnum.mIndex, 42u);
+        EXPECT_EQ(marker->mRefnum.mContentFile, 1);
+        EXPECT_EQ(marker->mNumVertices, 3u);
+    }
+
+    TEST_F(MWRenderObjectPagingCacheTest, read_should_use_equal_state_set_of_other_template)
+    {
+        ObjectPagingCache cache(mPath, 0);
+        cache.write(mKey, *makeChunk(), makeTemplates({1, 2}));
+
+        osg::ref_ptr<osg::StateSet> stateSet = new osg::StateSet(*mStateSet, osg::CopyOp::DEEP_COPY_ALL);
+        mTemplate->getChild(0)->setStateSet(stateSet);
+        const osg::ref_ptr<osg::Group> result = cache.read(mKey, makeTemplates({1, 2}));
+        ASSERT_NE(result, nullptr);
+        EXPECT_EQ(result->getChild(0)->asGroup()->getChild(0)->getStateSet(), stateSet.get());
+    }
+
+    TEST_F(MWRenderObjectPagingCacheTest, read_should_return_nullptr_when_model_has_changed)
+    {
+        ObjectPagingCache cache(mPath, 0);
+        cache.write(mKey, *makeChunk(), makeTemplates({1, 2}));
+        EXPECT_EQ(cache.read(mKey, makeTemplates({1, 3})), nullptr);
+    }
+
+    TEST_F(MWRenderObjectPagingCacheTest, read_should_return_nullptr_when_state_set_has_changed)
+    {
+        ObjectPagingCache cache(mPath, 0);
+        cache.write(mKey, *makeChunk(), makeTemplates({1, 2}));
+        static_cast<osg::Material*>(mStateSet->getAttribute(osg::StateAttribute::MATERIAL))
+            ->setDiffuse(osg::Material::FRONT_AND_BACK, osg::Vec4f(0, 1, 0, 1));
+        EXPECT_EQ(cache.read(mKey, makeTemplates({1, 2})), nullptr);
+    }
+
+    TEST_F(MWRenderObjectPagingCacheTest, read_should_return_nullptr_for_too_deeply_nested_chunk)
+    {
+        ObjectPagingCache cache(mPath, 0);
+        osg::ref_ptr<osg::Group> chunk = makeChunk();
+        for (int i = 0; i < 100; ++i)
+        {
+            osg::ref_ptr<osg::Group> parent = new osg::Group;
+            parent->addChild(chunk);
+            chunk = parent;
+        }
+        cache.write(mKey, *chunk, makeTemplates({1, 2}));
+        EXPECT_EQ(cache.read(mKey, makeTemplates({1, 2})), nullptr);
+    }
+
+    TEST_F(MWRenderObjectPagingCacheTest, read_should_return_nullptr_for_corrupt_array_size)
+    {
+        ObjectPagingCache cache(mPath, 0);
+        cache.write(mKey, *makeChunk(), makeTemplates({1, 2}));
+        ASSERT_NE(cache.read(mKey, makeTemplates({1, 2})), nullptr);
+
+        const boost::filesystem::directory_iterator entry(mPath);
+        ASSERT_NE(entry, boost::filesystem::directory_iterator());
+        const boost::filesystem::path path = entry->path();
+        std::string content;
+        {
+            boost::filesystem::ifstream stream(path, std::ios::binary);
+            content.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+        }
+        // The number of vertices precedes the data of the vertex array
+        const osg::Vec3f vertices[] = {osg::Vec3f(0, 0, 0), osg::Vec3f(1, 0, 0), osg::Vec3f(0, 1, 0)};
+        const char* const data = reinterpret_cast<const char*>(vertices);
+        const auto it = std::search(content.begin(), content.end(), data, data + sizeof(vertices));
+        ASSERT_NE(it, content.end());
+        ASSERT_GE(it - content.begin(), 4);
+        std::fill(it - 4, it, '\xff');
+        {
+            boost::filesystem::ofstream stream(path, std::ios::binary);
+            stream.write(content.data(), content.size());
+        }
+
+        EXPECT_EQ(cache.read(mKey, makeTemplates({1, 2})), nullptr);
+    }
+
+    TEST_F(MWRenderObjectPagingCacheTest, write_should_not_count_replaced_entry)
+    {
+        ObjectPagingCache cache(mPath, 0);
+        cache.write(mKey, *makeChunk(), makeTemplates({1, 2}));
+        const std::uint64_t size = cache.getSize();
+        ASSERT_GT(size, 0u);
+        cache.write(mKey, *makeChunk(), makeTemplates({1, 2}));
+        EXPECT_EQ(cache.getSize(), size);
+    }
+
+    TEST_F(MWRenderObjectPagingCacheTest, write_should_remove_least_recently_used_entries_beyond_max_size)
+    {
+        ObjectPagingCache cache(mPath, 1);
+        cache.write(mKey, *makeChunk(), makeTemplates({1, 2}));
+        EXPECT_EQ(cache.read(mKey, makeTemplates({1, 2})), nullptr);
+    }
+}
@@ -0,0 +1,158 @@
+#include <components/sceneutil/occlusionbuffer.hpp>
+#include <components/sceneutil/depth.hpp>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace SceneUtil;
+
+    // Looks along +Y from the origin with Z up
+    osg::Matrixf makeViewMatrix()
+    {
+        return osg::Matrixf::lookAt(osg::Vec3f(0, 0, 0), osg::Vec3f(0, 1, 0), osg::Vec3f(0, 0, 1));
+    }
+
+    std::vector<osg::Vec3f> makeQuad(const osg::Vec3f& a, const osg::Vec3f& b, const osg::Vec3f& c, const osg::Vec3f& d)
+    {
+        return {a, b, c, a, c, d};
+    }
+
+    // Wall facing the camera at distance y covering [minX, maxX] x [minZ, maxZ]
+    std::vector<osg::Vec3f> makeWall(float y, float minX, float maxX, float minZ, float maxZ)
+    {
+        return makeQuad(osg::Vec3f(minX, y, minZ), osg::Vec3f(maxX, y, minZ), osg::Vec3f(maxX, y, maxZ), osg::Vec3f(minX, y, maxZ));
+    }
+
+    osg::BoundingBox makeBox(const osg::Vec3f& center, float halfSize)
+    {
+        const osg::Vec3f half(halfSize, halfSize, halfSize);
+        return osg::BoundingBox(center - half, center + half);
+    }
+
+    struct SceneUtilOcclusionBufferTest : Test
+    {
+        OcclusionBuffer mBuffer {128, 64};
+        osg::Matrixf mViewProjection = makeViewMatrix() * osg::Matrixf::perspective(90, 2, 1, 10000);
+
+        void draw(const std::vector<osg::Vec3f>& triangles)
+        {
+            mBuffer.clear(mViewProjection);
+            mBuffer.drawTriangles(triangles.data(), triangles.size());
+        }
+    };
+
+    TEST_F(SceneUtilOcclusionBufferTest, sizeShouldBeRoundedUpToTileSize)
+    {
+        const OcclusionBuffer buffer(100, 1);
+        EXPECT_EQ(buffer.getWidth(), 104);
+        EXPECT_EQ(buffer.getHeight(), OcclusionBuffer::sTileSize);
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, emptyBufferShouldNotOccludeAnything)
+    {
+        draw({});
+        EXPECT_FALSE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, 500, 0), 10), mViewProjection));
+        EXPECT_EQ(mBuffer.getNumDrawnTriangles(), 0u);
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, boxBehindWallShouldBeOccluded)
+    {
+        draw(makeWall(100, -500, 500, -500, 500));
+        EXPECT_TRUE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, 200, 0), 10), mViewProjection));
+        EXPECT_EQ(mBuffer.getNumDrawnTriangles(), 2u);
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, wallShouldOccludeWithBothFaces)
+    {
+        draw(makeWall(100, 500, -500, -500, 500));
+        EXPECT_TRUE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, 200, 0), 10), mViewProjection));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, boxInFrontOfWallShouldNotBeOccluded)
+    {
+        draw(makeWall(100, -500, 500, -500, 500));
+        EXPECT_FALSE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, 50, 0), 10), mViewProjection));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, boxIntersectingWallShouldNotBeOccluded)
+    {
+        draw(makeWall(100, -500, 500, -500, 500));
+        EXPECT_FALSE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, 100, 0), 10), mViewProjection));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, partiallyCoveredBoxShouldNotBeOccluded)
+    {
+        draw(makeWall(100, -500, 0, -500, 500));
+        EXPECT_FALSE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, 200, 0), 10), mViewProjection));
+        EXPECT_TRUE(mBuffer.isOccluded(makeBox(osg::Vec3f(-100, 200, 0), 10), mViewProjection));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, boxVisibleThroughGapShouldNotBeOccluded)
+    {
+        std::vector<osg::Vec3f> triangles = makeWall(100, -500, -10, -500, 500);
+        const std::vector<osg::Vec3f> right = makeWall(100, 10, 500, -500, 500);
+        triangles.insert(triangles.end(), right.begin(), right.end());
+        draw(triangles);
+        EXPECT_FALSE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, 1000, 0), 10), mViewProjection));
+        EXPECT_TRUE(mBuffer.isOccluded(makeBox(osg::Vec3f(-200, 1000, 0), 10), mViewProjection));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, closestOccluderShouldBeKept)
+    {
+        std::vector<osg::Vec3f> triangles = makeWall(100, -500, 0, -500, 500);
+        const std::vector<osg::Vec3f> far = makeWall(300, -1500, 1500, -1500, 1500);
+        triangles.insert(triangles.end(), far.begin(), far.end());
+        draw(triangles);
+        EXPECT_TRUE(mBuffer.isOccluded(makeBox(osg::Vec3f(-100, 200, 0), 10), mViewProjection));
+        EXPECT_FALSE(mBuffer.isOccluded(makeBox(osg::Vec3f(100, 200, 0), 10), mViewProjection));
+        EXPECT_TRUE(mBuffer.isOccluded(makeBox(osg::Vec3f(100, 400, 0), 10), mViewProjection));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, boxCrossingNearPlaneShouldNotBeOccluded)
+    {
+        draw(makeWall(100, -500, 500, -500, 500));
+        EXPECT_FALSE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, 0, 0), 10), mViewProjection));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, boxOutsideOfViewShouldNotBeOccluded)
+    {
+        draw(makeWall(100, -500, 500, -500, 500));
+        EXPECT_FALSE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, -200, 0), 10), mViewProjection));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, boxNextToOccluderSilhouetteShouldNotBeOccluded)
+    {
+        // Width of a pixel at the distance of 1 unit
+        const float pixelSize = 2.f * 2 / 128;
+        // The edge of the wall and the box are in the same pixel, the wall covers its center but not the box
+        draw(makeWall(100, -500, 0.75f * pixelSize * 100, -500, 500));
+        EXPECT_FALSE(mBuffer.isOccluded(osg::BoundingBox(osg::Vec3f(0.8f * pixelSize * 200, 200, -10),
+            osg::Vec3f(0.9f * pixelSize * 200, 200, 10)), mViewProjection));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, occluderCrossingNearPlaneShouldBeClipped)
+    {
+        draw(makeQuad(osg::Vec3f(-1000, -100, -10), osg::Vec3f(1000, -100, -10), osg::Vec3f(1000, 1000, -10), osg::Vec3f(-1000, 1000, -10)));
+        EXPECT_GT(mBuffer.getNumDrawnTriangles(), 0u);
+        EXPECT_TRUE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, 300, -40), 5), mViewProjection));
+        EXPECT_FALSE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, 500, 30), 5), mViewProjection));
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, occluderBehindCameraShouldBeIgnored)
+    {
+        draw(makeWall(-100, -500, 500, -500, 500));
+        EXPECT_EQ(mBuffer.getNumDrawnTriangles(), 0u);
+    }
+
+    TEST_F(SceneUtilOcclusionBufferTest, shouldSupportReversedDepthProjection)
+    {
+        mViewProjection = makeViewMatrix() * osg::Matrixf(getReversedZProjectionMatrixAsPerspectiveInf(90, 2, 1));
+        draw(makeWall(100, -500, 500, -500, 500));
+        EXPECT_TRUE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, 200, 0), 10), mViewProjection));
+        EXPECT_FALSE(mBuffer.isOccluded(makeBox(osg::Vec3f(0, 50, 0), 10), mViewProjection));
+    }
+}
@@ -0,0 +1,109 @@
+#include <components/sceneutil/occlusionculling.hpp>
+
+#include <osg/Camera>
+#include <osg/MatrixTransform>
+#include <osg/Viewport>
+#include <osgUtil/CullVisitor>
+#include <osgUtil/RenderStage>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+    using namespace testing;
+    using namespace SceneUtil;
+
+    class RecordTraversalCallback : public SceneUtil::NodeCallback<RecordTraversalCallback>
+    {
+    public:
+        explicit RecordTraversalCallback(bool& traversed) : mTraversed(traversed) {}
+
+        void operator()(osg::Node* node, osg::NodeVisitor* nv)
+        {
+            mTraversed = true;
+            traverse(node, nv);
+        }
+
+    private:
+        bool& mTraversed;
+    };
+
+    // Wall facing the camera at distance y covering [-500, 500] in x and z
+    osg::ref_ptr<OccluderMesh> makeWall(float y)
+    {
+        osg::ref_ptr<OccluderMesh> mesh = new OccluderMesh;
+        const osg::Vec3f a(-500, y, -500);
+        const osg::Vec3f b(500, y, -500);
+        const osg::Vec3f c(500, y, 500);
+        const osg::Vec3f d(-500, y, 500);
+        mesh->mVertices = {a, b, c, a, c, d};
+        for (const osg::Vec3f& vertex : mesh->mVertices)
+            mesh->mBounds.expandBy(vertex);
+        return mesh;
+    }
+
+    struct SceneUtilOcclusionCullingTest : Test
+    {
+        osg::ref_ptr<osg::Camera> mCamera = new osg::Camera;
+        osg::ref_ptr<OcclusionCuller> mCuller = new OcclusionCuller(128, 64, 10000, 1000);
+        osg::ref_ptr<osgUtil::CullVisitor> mCullVisitor = new osgUtil::CullVisitor;
+        osg::ref_ptr<osgUtil::RenderStage> mRenderStage = new osgUtil::RenderStage;
+        osg::ref_ptr<osg::Group> mRoot = new osg::Group;
+
+        SceneUtilOcclusionCullingTest()
+        {
+            mCuller->setCamera(mCamera);
+            mRoot->addCullCallback(new OcclusionBuildCallback(mCuller));
+
+            mRenderStage->setCamera(mCamera);
+            mCullVisitor->setCurrentRenderBin(mRenderStage);
+            mCullVisitor->pushViewport(new osg::Viewport(0, 0, 128, 64));
+            mCullVisitor->pushProjectionMatrix(new osg::RefMatrix(osg::Matrix::perspective(90, 2, 1, 10000)));
+            // Looks along +Y from the origin with Z up
+            mCullVisitor->pushModelViewMatrix(new osg::RefMatrix(osg::Matrix::lookAt(osg::Vec3f(0, 0, 0), osg::Vec3f(0, 1, 0), osg::Vec3f(0, 0, 1))),
+                osg::Transform::ABSOLUTE_RF);
+        }
+
+        // Adds a transform with an occlusion test placing a child with the given local bounds at the position
+        void addObject(const osg::Vec3f& position, float radius, bool& traversed)
+        {
+            osg::ref_ptr<osg::Group> child = new osg::Group;
+            child->setInitialBound(osg::BoundingSphere(osg::Vec3f(), radius));
+            child->addCullCallback(new RecordTraversalCallback(traversed));
+
+            osg::ref_ptr<osg::MatrixTransform> transform = new osg::MatrixTransform(osg::Matrix::translate(position));
+            transform->addCullCallback(new OcclusionTestCallback(mCuller));
+            transform->addChild(child);
+            mRoot->addChild(transform);
+        }
+    };
+
+    TEST_F(SceneUtilOcclusionCullingTest, objectBehindOccluderShouldNotBeTraversed)
+    {
+        mCuller->addOccluder(this, makeWall(200));
+        bool traversed = false;
+        addObject(osg::Vec3f(0, 300, 0), 10, traversed);
+        mRoot->accept(*mCullVisitor);
+        EXPECT_FALSE(traversed);
+    }
+
+    TEST_F(SceneUtilOcclusionCullingTest, transformShouldBeAppliedOnceToChildBounds)
+    {
+        mCuller->addOccluder(this, makeWall(200));
+        bool traversed = false;
+        // Moved behind the wall if the translation was applied twice
+        addObject(osg::Vec3f(0, 150, 0), 10, traversed);
+        mRoot->accept(*mCullVisitor);
+        EXPECT_TRUE(traversed);
+    }
+
+    TEST_F(SceneUtilOcclusionCullingTest, objectShouldBeTraversedByOtherCamera)
+    {
+        mCuller->addOccluder(this, makeWall(200));
+        mRenderStage->setCamera(new osg::Camera);
+        bool traversed = false;
+        addObject(osg::Vec3f(0, 300, 0), 10, traversed);
+        mRoot->accept(*mCullVisitor);
+        EXPECT_TRUE(traversed);
+    }
+}
@@ -0,0 +1,504 @@
+#include "physicsrecording.hpp"
+
+#include <BulletCollision/BroadphaseCollision/btBroadphaseProxy.h>
+#include <BulletCollision/CollisionDispatch/btCollisionObject.h>
+#include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
+#include <BulletCollision/CollisionShapes/btBoxShape.h>
+#include <BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
+#include <BulletCollision/CollisionShapes/btCompoundShape.h>
+#include <BulletCollision/CollisionShapes/btConcaveShape.h>
+#include <BulletCollision/CollisionShapes/btSphereShape.h>
+#include <BulletCollision/CollisionShapes/btTriangleCallback.h>
+#include <BulletCollision/CollisionShapes/btTriangleMesh.h>
+
+#include <array>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace BulletHelpers
+{
+    namespace
+    {
+        constexpr std::array<char, 8> header {'O', 'M', 'W', 'P', 'H', 'Y', 'S', '2'};
+
+        enum class RecordType : std::uint8_t
+        {
+            BeginStep,
+            EndStep,
+            AddObject,
+            RemoveObject,
+            SetTransform,
+            WorldFrame,
+            ActorFrame,
+            ActorResult,
+        };
+
+        enum class ShapeType : std::uint8_t
+        {
+            None,
+            Box,
+            Sphere,
+            Compound,
+            Triangles,
+        };
+
+        class Writer
+        {
+        public:
+            explicit Writer(std::vector<char>& buffer) : mBuffer(buffer) {}
+
+            template <class T>
+            void write(const T& value)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                const char* const data = reinterpret_cast<const char*>(&value);
+                mBuffer.insert(mBuffer.end(), data, data + sizeof(T));
+            }
+
+            void write(RecordType value) { write(static_cast<std::uint8_t>(value)); }
+
+            void write(ShapeType value) { write(static_cast<std::uint8_t>(value)); }
+
+            void write(bool value) { write(static_cast<std::uint8_t>(value)); }
+
+            void write(const btVector3& value)
+            {
+                for (int i = 0; i < 3; ++i)
+                    write(static_cast<float>(value[i]));
+            }
+
+            void write(const btTransform& value)
+            {
+                write(value.getOrigin());
+                const btQuaternion rotation = value.getRotation();
+                for (int i = 0; i < 4; ++i)
+                    write(static_cast<float>(rotation[i]));
+            }
+
+        private:
+            std::vector<char>& mBuffer;
+        };
+
+        class Reader
+        {
+        public:
+            explicit Reader(std::istream& stream) : mStream(stream) {}
+
+            template <class T>
+            T read()
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                T value;
+                mStream.read(reinterpret_cast<char*>(&value), sizeof(T));
+                if (!mStream)
+                    throw std::runtime_error("Unexpected end of physics recording");
+                return value;
+            }
+
+            bool readBool()
+            {
+                return read<std::uint8_t>() != 0;
+            }
+
+            btVector3 readVector()
+            {
+                const float x = read<float>();
+                const float y = read<float>();
+                const float z = read<float>();
+                return btVector3(x, y, z);
+            }
+
+            btTransform readTransform()
+            {
+                const btVector3 origin = readVector();
+                std::array<float, 4> rotation;
+                for (float& v : rotation)
+                    v = read<float>();
+                return btTransform(btQuaternion(rotation[0], rotation[1], rotation[2], rotation[3]), origin);
+            }
+
+        private:
+            std::istream& mStream;
+        };
+
+        struct CollectTriangles : btTriangleCallback
+        {
+            std::vector<btVector3> mVertices;
+
+            void processTriangle(btVector3* triangle, int /*partId*/, int /*triangleIndex*/) override
+            {
+                mVertices.insert(mVertices.end(), triangle, triangle + 3);
+            }
+        };
+
+        void writeShape(Writer& writer, const btCollisionShape& shape)
+        {
+            switch (shape.getShapeType())
+            {
+                case BOX_SHAPE_PROXYTYPE:
+                    writer.write(ShapeType::Box);
+                    writer.write(static_cast<float>(shape.getMargin()));
+                    writer.write(static_cast<const btBoxShape&>(shape).getHalfExtentsWithMargin());
+                    return;
+                case SPHERE_SHAPE_PROXYTYPE:
+                    writer.write(ShapeType::Sphere);
+                    writer.write(static_cast<float>(shape.getMargin()));
+                    writer.write(static_cast<float>(static_cast<const btSphereShape&>(shape).getRadius()));
+                    return;
+                case COMPOUND_SHAPE_PROXYTYPE:
+                {
+                    const btCompoundShape& compound = static_cast<const btCompoundShape&>(shape);
+                    writer.write(ShapeType::Compound);
+                    writer.write(static_cast<float>(shape.getMargin()));
+                    writer.write(static_cast<std::uint32_t>(compound.getNumChildShapes()));
+                    for (int i = 0; i < compound.getNumChildShapes(); ++i)
+                    {
+                        writer.write(compound.getChildTransform(i));
+                        writeShape(writer, *compound.getChildShape(i));
+                    }
+                    return;
+                }
+                default:
+                    break;
+            }
+            if (!shape.isConcave())
+            {
+                writer.write(ShapeType::None);
+                writer.write(static_cast<float>(shape.getMargin()));
+                return;
+            }
+            // Meshes and heightfields are written as the triangles they are made of, scaling included
+            CollectTriangles triangles;
+            const btVector3 extent(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+            static_cast<const btConcaveShape&>(shape).processAllTriangles(&triangles, -extent, extent);
+            writer.write(ShapeType::Triangles);
+            writer.write(static_cast<float>(shape.getMargin()));
+            writer.write(static_cast<std::uint32_t>(triangles.mVertices.size() / 3));
+            for (const btVector3& vertex : triangles.mVertices)
+                writer.write(vertex);
+        }
+
+        PhysicsRecording::Shape readShape(Reader& reader)
+        {
+            PhysicsRecording::Shape result;
+            const ShapeType type = static_cast<ShapeType>(reader.read<std::uint8_t>());
+            const float margin = reader.read<float>();
+            switch (type)
+            {
+                case ShapeType::None:
+                    return result;
+                case ShapeType::Box:
+                    result.mShape = std::make_unique<btBoxShape>(reader.readVector());
+                    break;
+                case ShapeType::Sphere:
+                    result.mShape = std::make_unique<btSphereShape>(reader.read<float>());
+                    break;
+                case ShapeType::Compound:
+                {
+                    auto compound = std::make_unique<btCompoundShape>();
+                    const std::uint32_t count = reader.read<std::uint32_t>();
+                    result.mChildren.reserve(count);
+                    for (std::uint32_t i = 0; i < count; ++i)
+                    {
+                        const btTransform transform = reader.readTransform();
+                        PhysicsRecording::Shape& child = result.mChildren.emplace_back(readShape(reader));
+                        if (child.mShape != nullptr)
+                            compound->addChildShape(transform, child.mShape.get());
+                    }
+                    result.mShape = std::move(compound);
+                    break;
+                }
+                case ShapeType::Triangles:
+                {
+                    auto mesh = std::make_unique<btTriangleMesh>();
+                    const std::uint32_t count = reader.read<std::uint32_t>();
+                    for (std::uint32_t i = 0; i < count; ++i)
+                    {
+                        const btVector3 a = reader.readVector();
+                        const btVector3 b = reader.readVector();
+                        const btVector3 c = reader.readVector();
+                        mesh->addTriangle(a, b, c);
+                    }
+                    if (count == 0)
+                        return result;
+                    result.mShape = std::make_unique<btBvhTriangleMeshShape>(mesh.get(), true);
+                    result.mMesh = std::move(mesh);
+                    break;
+                }
+                default:
+                    throw std::runtime_error("Unknown shape type in physics recording: " + std::to_string(static_cast<int>(type)));
+            }
+            result.mShape->setMargin(margin);
+            return result;
+        }
+
+        int getShapeRevision(const btCollisionShape& shape)
+        {
+            if (shape.isCompound())
+                return static_cast<const btCompoundShape&>(shape).getUpdateRevision();
+            return 0;
+        }
+    }
+
+    PhysicsRecorder::PhysicsRecorder(std::unique_ptr<std::ostream> stream)
+        : mStream(std::move(stream))
+    {
+        mStream->write(header.data(), header.size());
+    }
+
+    PhysicsRecorder::~PhysicsRecorder()
+    {
+        if (mInStep)
+            endStep(0);
+        mStream->flush();
+    }
+
+    void PhysicsRecorder::beginStep(const btCollisionWorld& world, float duration, std::uint32_t threads)
+    {
+        if (mInStep)
+            endStep(0);
+        Writer writer(mBuffer);
+        writer.write(RecordType::BeginStep);
+        writer.write(duration);
+        writer.write(threads);
+
+        for (auto& [object, recorded] : mObjects)
+            recorded.mSeen = false;
+
+        const btCollisionObjectArray& objects = world.getCollisionObjectArray();
+        for (int i = 0; i < objects.size(); ++i)
+        {
+            const btCollisionObject& object = *objects[i];
+            const btCollisionShape& shape = *object.getCollisionShape();
+            auto it = mObjects.find(&object);
+            // A changed shape may also be a new object at the address of a removed one
+            if (it != mObjects.end() && (it->second.mShape != &shape || it->second.mShapeRevision != getShapeRevision(shape)
+                || it->second.mScaling != shape.getLocalScaling()))
+            {
+                writer.write(RecordType::RemoveObject);
+                writer.write(it->second.mId);
+                mObjects.erase(it);
+                it = mObjects.end();
+            }
+            if (it == mObjects.end())
+            {
+                const RecordedObject recorded {mNextId++, &shape, getShapeRevision(shape), shape.getLocalScaling(),
+                    object.getWorldTransform(), true};
+                writer.write(RecordType::AddObject);
+                writer.write(recorded.mId);
+                writer.write(static_cast<std::int32_t>(object.getBroadphaseHandle()->m_collisionFilterGroup));
+                writer.write(static_cast<std::int32_t>(object.getBroadphaseHandle()->m_collisionFilterMask));
+                writer.write(recorded.mTransform);
+                writeShape(writer, shape);
+                mObjects.emplace(&object, recorded);
+                continue;
+            }
+            it->second.mSeen = true;
+            if (!(it->second.mTransform == object.getWorldTransform()))
+            {
+                it->second.mTransform = object.getWorldTransform();
+                writer.write(RecordType::SetTransform);
+                writer.write(it->second.mId);
+                writer.write(it->second.mTransform);
+            }
+        }
+
+        for (auto it = mObjects.begin(); it != mObjects.end();)
+        {
+            if (it->second.mSeen)
+            {
+                ++it;
+                continue;
+            }
+            writer.write(RecordType::RemoveObject);
+            writer.write(it->second.mId);
+            it = mObjects.erase(it);
+        }
+
+        mInStep = true;
+    }
+
+    void PhysicsRecorder::recordWorld(const PhysicsRecording::WorldFrame& world)
+    {
+        if (!mInStep)
+            return;
+        Writer writer(mBuffer);
+        writer.write(RecordType::WorldFrame);
+        writer.write(world.mIsInStorm);
+        writer.write(world.mStormDirection);
+        writer.write(world.mStormWalkMult);
+    }
+
+    void PhysicsRecorder::recordActor(const btCollisionObject& object, const btCollisionObject* standingOn,
+        PhysicsRecording::ActorFrame actor)
+    {
+        const std::optional<std::uint32_t> id = getId(&object);
+        if (!mInStep || !id.has_value())
+            return;
+        actor.mObject = *id;
+        actor.mStandingOn = getId(standingOn);
+        Writer writer(mBuffer);
+        writer.write(RecordType::ActorFrame);
+        writer.write(actor.mObject);
+        writer.write(actor.mStandingOn.has_value());
+        writer.write(actor.mStandingOn.value_or(0));
+        writer.write(actor.mPosition);
+        writer.write(actor.mInertia);
+        writer.write(actor.mMovement);
+        writer.write(actor.mLastStuckPosition);
+        writer.write(actor.mRotationX);
+        writer.write(actor.mRotationZ);
+        writer.write(actor.mSwimLevel);
+        writer.write(actor.mSlowFall);
+        writer.write(actor.mWaterlevel);
+        writer.write(actor.mHalfExtentsZ);
+        writer.write(actor.mOldHeight);
+        writer.write(actor.mStuckFrames);
+        writer.write(actor.mIsOnGround);
+        writer.write(actor.mIsOnSlope);
+        writer.write(actor.mWalkingOnWater);
+        writer.write(actor.mInert);
+        writer.write(actor.mFlying);
+        writer.write(actor.mWasOnGround);
+        writer.write(actor.mIsAquatic);
+        writer.write(actor.mWaterCollision);
+        writer.write(actor.mSkipCollisionDetection);
+        writer.write(actor.mSleeping);
+    }
+
+    void PhysicsRecorder::recordActorResult(const btCollisionObject& object, const btVector3& position, bool isOnGround)
+    {
+        const std::optional<std::uint32_t> id = getId(&object);
+        if (!mInStep || !id.has_value())
+            return;
+        Writer writer(mBuffer);
+        writer.write(RecordType::ActorResult);
+        writer.write(*id);
+        writer.write(position);
+        writer.write(isOnGround);
+    }
+
+    void PhysicsRecorder::endStep(double seconds)
+    {
+        if (!mInStep)
+            return;
+        Writer writer(mBuffer);
+        writer.write(RecordType::EndStep);
+        writer.write(seconds);
+        mStream->write(mBuffer.data(), static_cast<std::streamsize>(mBuffer.size()));
+        mBuffer.clear();
+        mInStep = false;
+    }
+
+    std::optional<std::uint32_t> PhysicsRecorder::getId(const btCollisionObject* object) const
+    {
+        const auto it = mObjects.find(object);
+        if (it == mObjects.end())
+            return std::nullopt;
+        return it->second.mId;
+    }
+
+    PhysicsRecordingReader::PhysicsRecordingReader(std::unique_ptr<std::istream> stream)
+        : mStream(std::move(stream))
+    {
+        std::array<char, header.size()> value;
+        mStream->read(value.data(), value.size());
+        if (!*mStream || value != header)
+            throw std::runtime_error("Not a physics recording");
+    }
+
+    PhysicsRecordingReader::~PhysicsRecordingReader() = default;
+
+    std::optional<PhysicsRecording::Record> PhysicsRecordingReader::next()
+    {
+        using namespace PhysicsRecording;
+        const int type = mStream->get();
+        if (type == std::char_traits<char>::eof())
+            return std::nullopt;
+        Reader reader(*mStream);
+        switch (static_cast<RecordType>(type))
+        {
+            case RecordType::BeginStep:
+            {
+                BeginStep result;
+                result.mDuration = reader.read<float>();
+                result.mThreads = reader.read<std::uint32_t>();
+                return result;
+            }
+            case RecordType::EndStep:
+                return EndStep {reader.read<double>()};
+            case RecordType::AddObject:
+            {
+                AddObject result;
+                result.mId = reader.read<std::uint32_t>();
+                result.mGroup = reader.read<std::int32_t>();
+                result.mMask = reader.read<std::int32_t>();
+                result.mTransform = reader.readTransform();
+                result.mShape = readShape(reader);
+                return Record(std::move(result));
+            }
+            case RecordType::RemoveObject:
+                return RemoveObject {reader.read<std::uint32_t>()};
+            case RecordType::SetTransform:
+            {
+                SetTransform result;
+                result.mId = reader.read<std::uint32_t>();
+                result.mTransform = reader.readTransform();
+                return result;
+            }
+            case RecordType::WorldFrame:
+            {
+                WorldFrame result;
+                result.mIsInStorm = reader.readBool();
+                result.mStormDirection = reader.readVector();
+                result.mStormWalkMult = reader.read<float>();
+                return result;
+            }
+            case RecordType::ActorFrame:
+            {
+                ActorFrame result;
+                result.mObject = reader.read<std::uint32_t>();
+                const bool standing = reader.readBool();
+                const std::uint32_t standingOn = reader.read<std::uint32_t>();
+                if (standing)
+                    result.mStandingOn = standingOn;
+                result.mPosition = reader.readVector();
+                result.mInertia = reader.readVector();
+                result.mMovement = reader.readVector();
+                result.mLastStuckPosition = reader.readVector();
+                result.mRotationX = reader.read<float>();
+                result.mRotationZ = reader.read<float>();
+                result.mSwimLevel = reader.read<float>();
+                result.mSlowFall = reader.read<float>();
+                result.mWaterlevel = reader.read<float>();
+                result.mHalfExtentsZ = reader.read<float>();
+                result.mOldHeight = reader.read<float>();
+                result.mStuckFrames = reader.read<std::uint32_t>();
+                result.mIsOnGround = reader.readBool();
+                result.mIsOnSlope = reader.readBool();
+                result.mWalkingOnWater = reader.readBool();
+                result.mInert = reader.readBool();
+                result.mFlying = reader.readBool();
+                result.mWasOnGround = reader.readBool();
+                result.mIsAquatic = reader.readBool();
+                result.mWaterCollision = reader.readBool();
+                result.mSkipCollisionDetection = reader.readBool();
+                result.mSleeping = reader.readBool();
+                return result;
+            }
+            case RecordType::ActorResult:
+            {
+                ActorResult result;
+                result.mObject = reader.read<std::uint32_t>();
+                result.mPosition = reader.readVector();
+                result.mIsOnGround = reader.readBool();
+                return result;
+            }
+        }
+        throw std::runtime_error("Unknown record type in physics recording: " + std::to_string(type));
+    }
+}
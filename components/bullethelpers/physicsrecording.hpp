@@ -0,0 +1,175 @@
+#ifndef OPENMW_COMPONENTS_BULLETHELPERS_PHYSICSRECORDING_H
+#define OPENMW_COMPONENTS_BULLETHELPERS_PHYSICSRECORDING_H
+
+#include <LinearMath/btTransform.h>
+#include <LinearMath/btVector3.h>
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+class btCollisionObject;
+class btCollisionShape;
+class btCollisionWorld;
+class btStridingMeshInterface;
+
+namespace BulletHelpers
+{
+    namespace PhysicsRecording
+    {
+        /// Shape read back from a recording with everything it references
+        struct Shape
+        {
+            std::unique_ptr<btStridingMeshInterface> mMesh;
+            std::vector<Shape> mChildren;
+            std::unique_ptr<btCollisionShape> mShape;
+        };
+
+        struct BeginStep
+        {
+            float mDuration;
+            /// Number of threads the recorded step was simulated with
+            std::uint32_t mThreads;
+        };
+
+        struct EndStep
+        {
+            /// Time the recorded step took to unstick and move the actors, recording excluded
+            double mSeconds;
+        };
+
+        struct AddObject
+        {
+            std::uint32_t mId;
+            int mGroup;
+            int mMask;
+            btTransform mTransform;
+            Shape mShape;
+        };
+
+        struct RemoveObject
+        {
+            std::uint32_t mId;
+        };
+
+        struct SetTransform
+        {
+            std::uint32_t mId;
+            btTransform mTransform;
+        };
+
+        /// Game state the movement of every actor depends on
+        struct WorldFrame
+        {
+            bool mIsInStorm;
+            btVector3 mStormDirection;
+            float mStormWalkMult;
+        };
+
+        /// State of an actor given to the movement solver at the start of a step
+        struct ActorFrame
+        {
+            std::uint32_t mObject;
+            std::optional<std::uint32_t> mStandingOn;
+            btVector3 mPosition;
+            btVector3 mInertia;
+            btVector3 mMovement;
+            btVector3 mLastStuckPosition;
+            float mRotationX;
+            float mRotationZ;
+            float mSwimLevel;
+            float mSlowFall;
+            float mWaterlevel;
+            float mHalfExtentsZ;
+            float mOldHeight;
+            std::uint32_t mStuckFrames;
+            bool mIsOnGround;
+            bool mIsOnSlope;
+            bool mWalkingOnWater;
+            bool mInert;
+            bool mFlying;
+            bool mWasOnGround;
+            bool mIsAquatic;
+            bool mWaterCollision;
+            bool mSkipCollisionDetection;
+            bool mSleeping;
+        };
+
+        /// State of an actor moved by a step
+        struct ActorResult
+        {
+            std::uint32_t mObject;
+            btVector3 mPosition;
+            bool mIsOnGround;
+        };
+
+        using Record = std::variant<BeginStep, EndStep, AddObject, RemoveObject, SetTransform, WorldFrame, ActorFrame,
+            ActorResult>;
+    }
+
+    /// @brief Writes the changes of a collision world and the input and output of the movement of actors for each
+    /// simulation step.
+    /// @par The collision world is compared to its state at the previous step, so its users do not have to report
+    /// their changes. Shapes are written as boxes, spheres, compounds or triangle soups, other convex shapes are
+    /// skipped. Actors refer to the collision objects by their id in the recording.
+    class PhysicsRecorder
+    {
+    public:
+        explicit PhysicsRecorder(std::unique_ptr<std::ostream> stream);
+        ~PhysicsRecorder();
+
+        /// Record the objects added, removed or moved since the previous step. The world must not change meanwhile.
+        void beginStep(const btCollisionWorld& world, float duration, std::uint32_t threads);
+
+        void recordWorld(const PhysicsRecording::WorldFrame& world);
+
+        /// @param actor its object ids are set from object and standingOn, which must be in the world given to
+        /// beginStep(). An actor without an object there is not recorded.
+        void recordActor(const btCollisionObject& object, const btCollisionObject* standingOn,
+            PhysicsRecording::ActorFrame actor);
+
+        void recordActorResult(const btCollisionObject& object, const btVector3& position, bool isOnGround);
+
+        void endStep(double seconds);
+
+    private:
+        struct RecordedObject
+        {
+            std::uint32_t mId;
+            const btCollisionShape* mShape;
+            int mShapeRevision;
+            btVector3 mScaling;
+            btTransform mTransform;
+            bool mSeen;
+        };
+
+        std::unique_ptr<std::ostream> mStream;
+        std::unordered_map<const btCollisionObject*, RecordedObject> mObjects;
+        std::uint32_t mNextId = 0;
+        bool mInStep = false;
+        std::vector<char> mBuffer;
+
+        std::optional<std::uint32_t> getId(const btCollisionObject* object) const;
+    };
+
+    class PhysicsRecordingReader
+    {
+    public:
+        /// @throw std::runtime_error if the stream does not start with a recording header
+        explicit PhysicsRecordingReader(std::unique_ptr<std::istream> stream);
+        ~PhysicsRecordingReader();
+
+        /// @return the next record, std::nullopt at the end of the recording
+        /// @throw std::runtime_error on malformed input
+        std::optional<PhysicsRecording::Record> next();
+
+    private:
+        std::unique_ptr<std::istream> mStream;
+    };
+}
+
+#endif
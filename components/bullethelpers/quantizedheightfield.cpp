@@ -0,0 +1,27 @@
+#include "quantizedheightfield.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+namespace BulletHelpers
+{
+    QuantizedHeightfield quantizeHeightfield(const float* heights, std::size_t count, float minHeight, float maxHeight)
+    {
+        constexpr float maxSample = std::numeric_limits<std::int16_t>::max();
+        QuantizedHeightfield result;
+        result.mOffset = (minHeight + maxHeight) * 0.5f;
+        const float halfRange = (maxHeight - minHeight) * 0.5f;
+        result.mScale = halfRange > 0 ? halfRange / maxSample : 1.0f;
+        result.mMinHeight = minHeight - result.mOffset;
+        result.mMaxHeight = maxHeight - result.mOffset;
+        result.mSamples.reserve(count);
+        std::transform(heights, heights + count, std::back_inserter(result.mSamples), [&] (float height)
+        {
+            const float sample = std::round((height - result.mOffset) / result.mScale);
+            return static_cast<std::int16_t>(std::clamp(sample, -maxSample, maxSample));
+        });
+        return result;
+    }
+}
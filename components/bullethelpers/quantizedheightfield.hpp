@@ -0,0 +1,31 @@
+#ifndef OPENMW_COMPONENTS_BULLETHELPERS_QUANTIZEDHEIGHTFIELD_H
+#define OPENMW_COMPONENTS_BULLETHELPERS_QUANTIZEDHEIGHTFIELD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace BulletHelpers
+{
+    /// @brief Heightfield samples stored as int16 relative to the middle of the height range.
+    /// @par A height is restored as mOffset + sample * mScale. Used with PHY_SHORT heightfield shapes with mScale as
+    /// height scale and [mMinHeight, mMaxHeight] as height range, positioned by getHeightfieldShift() for the original
+    /// range, since both are centered on mOffset.
+    struct QuantizedHeightfield
+    {
+        std::vector<std::int16_t> mSamples;
+        float mScale = 1;
+        float mOffset = 0;
+        float mMinHeight = 0;
+        float mMaxHeight = 0;
+
+        float getHeight(std::size_t index) const
+        {
+            return mOffset + mSamples[index] * mScale;
+        }
+    };
+
+    QuantizedHeightfield quantizeHeightfield(const float* heights, std::size_t count, float minHeight, float maxHeight);
+}
+
+#endif
@@ -31,13 +31,13 @@ namespace
     }
 
     int getMinDistanceTo(const TilePosition& position, int maxDistance,
-                         const std::set<std::tuple<osg::Vec3f, TilePosition>>& pushedTiles,
+                         const std::map<std::tuple<osg::Vec3f, TilePosition>, JobIt>& pushedTiles,
                          const std::set<std::tuple<osg::Vec3f, TilePosition>>& presentTiles)
     {
         int result = maxDistance;
-        for (const auto& [halfExtents, tile] : pushedTiles)
-            if (presentTiles.find(std::tie(halfExtents, tile)) == presentTiles.end())
-                result = std::min(result, getManhattanDistance(position, tile));
+        for (const auto& [agentAndTile, job] : pushedTiles)
+            if (presentTiles.find(agentAndTile) == presentTiles.end())
+                result = std::min(result, getManhattanDistance(position, std::get<TilePosition>(agentAndTile)));
         return result;
     }
 
@@ -61,10 +61,36 @@ namespace
         }
     };
 
-    void insertPrioritizedJob(JobIt job, std::deque<JobIt>& queue)
+    void siftUp(std::vector<JobIt>& queue, std::size_t index)
     {
-        const auto it = std::upper_bound(queue.begin(), queue.end(), job, LessByJobPriority {});
-        queue.insert(it, job);
+        while (index > 0)
+        {
+            const std::size_t parent = (index - 1) / 2;
+            if (!LessByJobPriority {}(queue[index], queue[parent]))
+                break;
+            std::swap(queue[index], queue[parent]);
+            queue[index]->mWaitingIndex = index;
+            index = parent;
+        }
+        queue[index]->mWaitingIndex = index;
+    }
+
+    void siftDown(std::vector<JobIt>& queue, std::size_t index)
+    {
+        while (true)
+        {
+            std::size_t first = 2 * index + 1;
+            if (first >= queue.size())
+                break;
+            if (first + 1 < queue.size() && LessByJobPriority {}(queue[first + 1], queue[first]))
+                ++first;
+            if (!LessByJobPriority {}(queue[first], queue[index]))
+                break;
+            std::swap(queue[index], queue[first]);
+            queue[index]->mWaitingIndex = index;
+            index = first;
+        }
+        queue[index]->mWaitingIndex = index;
     }
 
     auto getAgentAndTile(const Job& job) noexcept
@@ -75,6 +101,42 @@ namespace
 
 namespace DetourNavigator
 {
+    void insertPrioritizedJob(JobIt job, std::vector<JobIt>& queue)
+    {
+        queue.push_back(job);
+        siftUp(queue, queue.size() - 1);
+    }
+
+    JobIt popPrioritizedJob(std::vector<JobIt>& queue)
+    {
+        const JobIt result = queue.front();
+        queue.front() = queue.back();
+        queue.pop_back();
+        if (!queue.empty())
+            siftDown(queue, 0);
+        return result;
+    }
+
+    void updatePrioritizedJob(JobIt job, std::vector<JobIt>& queue)
+    {
+        siftUp(queue, job->mWaitingIndex);
+        siftDown(queue, job->mWaitingIndex);
+    }
+
+    void prioritizeJobs(std::vector<JobIt>& queue)
+    {
+        for (std::size_t i = queue.size() / 2; i > 0; --i)
+            siftDown(queue, i - 1);
+        for (std::size_t i = 0; i < queue.size(); ++i)
+            queue[i]->mWaitingIndex = i;
+    }
+
+    ChangeType mergeChangeType(ChangeType current, ChangeType added) noexcept
+    {
+        // Lower values are more urgent, an update is only temporary if all merged changes are updates
+        return std::min(current, added);
+    }
+
     Job::Job(const osg::Vec3f& agentHalfExtents, std::weak_ptr<GuardedNavMeshCacheItem> navMeshCacheItem,
         const TilePosition& changedTile, ChangeType changeType, int distanceToPlayer,
         std::chrono::steady_clock::time_point processTime)
@@ -141,24 +203,39 @@ namespace DetourNavigator
 
         for (const auto& [changedTile, changeType] : changedTiles)
         {
-            if (mPushed.emplace(agentHalfExtents, changedTile).second)
+            const auto processTime = changeType == ChangeType::update
+                ? getUpdateProcessTime(agentHalfExtents, changedTile)
+                : std::chrono::steady_clock::time_point();
+
+            const auto pushed = mPushed.find(std::tie(agentHalfExtents, changedTile));
+
+            if (pushed != mPushed.end())
             {
-                const auto processTime = changeType == ChangeType::update
-                    ? mLastUpdates[std::tie(agentHalfExtents, changedTile)] + mSettings.get().mMinUpdateInterval
-                    : std::chrono::steady_clock::time_point();
+                // A tile is rebuilt from its current state, one job covers all changes made before it starts
+                const JobIt job = pushed->second;
+                job->mChangeType = mergeChangeType(job->mChangeType, changeType);
+                job->mProcessTime = std::min(job->mProcessTime, processTime);
+                if (!playerTileChanged)
+                    updatePrioritizedJob(job, mWaiting);
+                continue;
+            }
 
-                const JobIt it = mJobs.emplace(mJobs.end(), agentHalfExtents, navMeshCacheItem, changedTile,
-                    changeType, getManhattanDistance(changedTile, playerTile), processTime);
+            const JobIt it = mJobs.emplace(mJobs.end(), agentHalfExtents, navMeshCacheItem, changedTile,
+                changeType, getManhattanDistance(changedTile, playerTile), processTime);
 
-                if (playerTileChanged)
-                    mWaiting.push_back(it);
-                else
-                    insertPrioritizedJob(it, mWaiting);
+            mPushed.emplace(std::tie(agentHalfExtents, changedTile), it);
+
+            if (playerTileChanged)
+            {
+                it->mWaitingIndex = mWaiting.size();
+                mWaiting.push_back(it);
             }
+            else
+                insertPrioritizedJob(it, mWaiting);
         }
 
         if (playerTileChanged)
-            std::sort(mWaiting.begin(), mWaiting.end(), LessByJobPriority {});
+            prioritizeJobs(mWaiting);
 
         Log(Debug::Debug) << "Posted " << mJobs.size() << " navigator jobs";
 
@@ -369,9 +446,7 @@ namespace DetourNavigator
         if (shouldStop)
             return mJobs.end();
 
-        const JobIt job = mWaiting.front();
-
-        mWaiting.pop_front();
+        const JobIt job = popPrioritizedJob(mWaiting);
 
         if (!lockTile(job->mAgentHalfExtents, job->mChangedTile))
         {
@@ -387,6 +462,16 @@ namespace DetourNavigator
         return job;
     }
 
+    std::chrono::steady_clock::time_point AsyncNavMeshUpdater::getUpdateProcessTime(const osg::Vec3f& agentHalfExtents,
+        const TilePosition& changedTile) const
+    {
+        // Only looked up, the time of the last update is recorded when an update job starts
+        const auto it = mLastUpdates.find(std::tie(agentHalfExtents, changedTile));
+        if (it == mLastUpdates.end())
+            return std::chrono::steady_clock::time_point();
+        return it->second + mSettings.get().mMinUpdateInterval;
+    }
+
     void AsyncNavMeshUpdater::writeDebugFiles(const Job& job, const RecastMesh* recastMesh) const
     {
         std::string revision;
@@ -417,7 +502,7 @@ namespace DetourNavigator
 
         const std::lock_guard<std::mutex> lock(mMutex);
 
-        if (mPushed.emplace(job->mAgentHalfExtents, job->mChangedTile).second)
+        if (mPushed.emplace(std::make_tuple(job->mAgentHalfExtents, job->mChangedTile), job).second)
         {
             ++job->mTryNumber;
             insertPrioritizedJob(job, mWaiting);
@@ -15,11 +15,12 @@
 #include <condition_variable>
 #include <memory>
 #include <mutex>
-#include <deque>
+#include <map>
 #include <set>
 #include <thread>
 #include <tuple>
 #include <list>
+#include <vector>
 
 class dtNavMesh;
 
@@ -58,11 +59,12 @@ namespace DetourNavigator
         const osg::Vec3f mAgentHalfExtents;
         const std::weak_ptr<GuardedNavMeshCacheItem> mNavMeshCacheItem;
         const TilePosition mChangedTile;
-        const std::chrono::steady_clock::time_point mProcessTime;
+        std::chrono::steady_clock::time_point mProcessTime;
         unsigned mTryNumber = 0;
         ChangeType mChangeType;
         int mDistanceToPlayer;
         const int mDistanceToOrigin;
+        std::size_t mWaitingIndex = 0;
 
         Job(const osg::Vec3f& agentHalfExtents, std::weak_ptr<GuardedNavMeshCacheItem> navMeshCacheItem,
             const TilePosition& changedTile, ChangeType changeType, int distanceToPlayer,
@@ -71,6 +73,21 @@ namespace DetourNavigator
 
     using JobIt = std::list<Job>::iterator;
 
+    /// A waiting job covers all changes of its tile posted before it starts, it gets the more urgent change type
+    ChangeType mergeChangeType(ChangeType current, ChangeType added) noexcept;
+
+    /// Waiting jobs form a binary heap, the first job has the highest priority. Each job stores its index in the
+    /// queue, so its priority can be changed without a search.
+    void insertPrioritizedJob(JobIt job, std::vector<JobIt>& queue);
+
+    JobIt popPrioritizedJob(std::vector<JobIt>& queue);
+
+    /// Restore the queue order after the priority of the job has changed
+    void updatePrioritizedJob(JobIt job, std::vector<JobIt>& queue);
+
+    /// Restore the queue order after the priorities of any jobs have changed, in linear time
+    void prioritizeJobs(std::vector<JobIt>& queue);
+
     class AsyncNavMeshUpdater
     {
     public:
@@ -95,8 +112,10 @@ namespace DetourNavigator
         std::condition_variable mDone;
         std::condition_variable mProcessed;
         std::list<Job> mJobs;
-        std::deque<JobIt> mWaiting;
-        std::set<std::tuple<osg::Vec3f, TilePosition>> mPushed;
+        // Binary heap ordered by job priority, each job stores its position in mWaitingIndex
+        std::vector<JobIt> mWaiting;
+        // Waiting jobs by agent and tile, new changes of the same tile are merged into them
+        std::map<std::tuple<osg::Vec3f, TilePosition>, JobIt> mPushed;
         Misc::ScopeGuarded<TilePosition> mPlayerTile;
         NavMeshTilesCache mNavMeshTilesCache;
         Misc::ScopeGuarded<std::set<std::tuple<osg::Vec3f, TilePosition>>> mProcessingTiles;
@@ -110,9 +129,8 @@ namespace DetourNavigator
 
         JobIt getNextJob();
 
-        JobIt getJob(std::deque<JobIt>& jobs, bool changeLastUpdate);
-
-        void postThreadJob(JobIt job, std::deque<JobIt>& queue);
+        std::chrono::steady_clock::time_point getUpdateProcessTime(const osg::Vec3f& agentHalfExtents,
+            const TilePosition& changedTile) const;
 
         void writeDebugFiles(const Job& job, const RecastMesh* recastMesh) const;
 
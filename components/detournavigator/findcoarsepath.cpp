@@ -0,0 +1,67 @@
+#include "findcoarsepath.hpp"
+#include "findsmoothpath.hpp"
+#include "settings.hpp"
+#include "tilegraph.hpp"
+
+#include <DetourNavMesh.h>
+#include <DetourNavMeshQuery.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace DetourNavigator
+{
+    namespace
+    {
+        std::optional<std::pair<TilePosition, int>> getTilePolygon(const dtNavMesh& navMesh, dtPolyRef ref)
+        {
+            const dtMeshTile* tile = nullptr;
+            const dtPoly* polygon = nullptr;
+            if (ref == 0 || !dtStatusSucceed(navMesh.getTileAndPolyByRef(ref, &tile, &polygon)))
+                return std::nullopt;
+            return std::pair(TilePosition(tile->header->x, tile->header->y), static_cast<int>(polygon - tile->polys));
+        }
+    }
+
+    std::optional<std::vector<osg::Vec3f>> findCoarsePath(dtNavMeshQuery& navMeshQuery, const dtNavMesh& navMesh,
+        const TileGraph& tileGraph, const osg::Vec3f& halfExtents, const osg::Vec3f& start, const osg::Vec3f& end,
+        const Flags includeFlags, const Settings& settings)
+    {
+        if (!initNavMeshQuery(navMeshQuery, navMesh, settings.mMaxNavMeshQueryNodes))
+            return std::nullopt;
+
+        dtQueryFilter queryFilter;
+        queryFilter.setIncludeFlags(includeFlags);
+
+        constexpr float polyDistanceFactor = 4;
+        const osg::Vec3f polyHalfExtents = halfExtents * polyDistanceFactor;
+
+        const auto startPolygon = getTilePolygon(navMesh,
+            findNearestPoly(navMeshQuery, queryFilter, start, polyHalfExtents));
+        if (!startPolygon.has_value())
+            return std::nullopt;
+
+        // End may be out of the loaded tiles, then the route leads as close to it as possible
+        const auto endPolygon = getTilePolygon(navMesh,
+            findNearestPoly(navMeshQuery, queryFilter, end, polyHalfExtents));
+
+        auto result = tileGraph.findRoute(startPolygon->first, startPolygon->second, end, endPolygon, includeFlags);
+        if (result.has_value() && endPolygon.has_value())
+            result->push_back(end);
+        return result;
+    }
+
+    osg::Vec3f getLimitedPathEnd(const osg::Vec3f& start, const osg::Vec3f& end, float maxDistance,
+        const std::vector<osg::Vec3f>& route)
+    {
+        const osg::Vec3f startToEnd = end - start;
+        const float distance = startToEnd.length();
+        if (distance <= maxDistance)
+            return end;
+        const auto outOfReach = std::find_if(route.begin(), route.end(),
+            [&] (const osg::Vec3f& v) { return (v - start).length() > maxDistance; });
+        if (outOfReach != route.begin())
+            return *std::prev(outOfReach);
+        return start + startToEnd * (maxDistance / distance);
+    }
+}
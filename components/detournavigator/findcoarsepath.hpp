@@ -0,0 +1,29 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_FINDCOARSEPATH_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_FINDCOARSEPATH_H
+
+#include "flags.hpp"
+
+#include <optional>
+#include <vector>
+
+#include <osg/Vec3f>
+
+class dtNavMesh;
+class dtNavMeshQuery;
+
+namespace DetourNavigator
+{
+    struct Settings;
+    class TileGraph;
+
+    std::optional<std::vector<osg::Vec3f>> findCoarsePath(dtNavMeshQuery& navMeshQuery, const dtNavMesh& navMesh,
+        const TileGraph& tileGraph, const osg::Vec3f& halfExtents, const osg::Vec3f& start, const osg::Vec3f& end,
+        const Flags includeFlags, const Settings& settings);
+
+    /// @return end when it is not further than maxDistance from start, otherwise the last route waypoint within
+    /// maxDistance or the point at maxDistance on the straight line to end when there is no such waypoint
+    osg::Vec3f getLimitedPathEnd(const osg::Vec3f& start, const osg::Vec3f& end, float maxDistance,
+        const std::vector<osg::Vec3f>& route);
+}
+
+#endif
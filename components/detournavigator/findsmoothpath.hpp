@@ -255,12 +255,12 @@ namespace DetourNavigator
         return Status::Success;
     }
 
+    /// Uses given navMeshQuery to avoid allocation of its node pool for each call
     template <class OutputIterator>
-    Status findSmoothPath(const dtNavMesh& navMesh, const osg::Vec3f& halfExtents, const float stepSize,
-            const osg::Vec3f& start, const osg::Vec3f& end, const Flags includeFlags, const AreaCosts& areaCosts,
-            const Settings& settings, float endTolerance, OutputIterator& out)
+    Status findSmoothPath(dtNavMeshQuery& navMeshQuery, const dtNavMesh& navMesh, const osg::Vec3f& halfExtents,
+            const float stepSize, const osg::Vec3f& start, const osg::Vec3f& end, const Flags includeFlags,
+            const AreaCosts& areaCosts, const Settings& settings, float endTolerance, OutputIterator& out)
     {
-        dtNavMeshQuery navMeshQuery;
         if (!initNavMeshQuery(navMeshQuery, navMesh, settings.mMaxNavMeshQueryNodes))
             return Status::InitNavMeshQueryFailed;
 
@@ -303,6 +303,16 @@ namespace DetourNavigator
 
         return partialPath ? Status::PartialPath : Status::Success;
     }
+
+    template <class OutputIterator>
+    Status findSmoothPath(const dtNavMesh& navMesh, const osg::Vec3f& halfExtents, const float stepSize,
+            const osg::Vec3f& start, const osg::Vec3f& end, const Flags includeFlags, const AreaCosts& areaCosts,
+            const Settings& settings, float endTolerance, OutputIterator& out)
+    {
+        dtNavMeshQuery navMeshQuery;
+        return findSmoothPath(navMeshQuery, navMesh, halfExtents, stepSize, start, end, includeFlags, areaCosts,
+            settings, endTolerance, out);
+    }
 }
 
 #endif
@@ -1,8 +1,11 @@
 #include "navigatorutils.hpp"
+#include "findcoarsepath.hpp"
 #include "findrandompointaroundcircle.hpp"
 #include "navigator.hpp"
 #include "raycast.hpp"
 
+#include <DetourNavMeshQuery.h>
+
 namespace DetourNavigator
 {
     std::optional<osg::Vec3f> findRandomPointAroundCircle(const Navigator& navigator, const osg::Vec3f& agentHalfExtents,
@@ -34,4 +37,23 @@ namespace DetourNavigator
             return std::nullopt;
         return fromNavMeshCoordinates(settings, *result);
     }
+
+    std::optional<std::vector<osg::Vec3f>> findCoarsePath(const Navigator& navigator, const osg::Vec3f& agentHalfExtents,
+        const osg::Vec3f& start, const osg::Vec3f& end, const Flags includeFlags)
+    {
+        const auto navMesh = navigator.getNavMesh(agentHalfExtents);
+        if (navMesh == nullptr)
+            return std::nullopt;
+        const auto settings = navigator.getSettings();
+        thread_local dtNavMeshQuery navMeshQuery;
+        const auto locked = navMesh->lockConst();
+        auto result = DetourNavigator::findCoarsePath(navMeshQuery, locked->getImpl(), locked->getTileGraph(),
+            toNavMeshCoordinates(settings, agentHalfExtents), toNavMeshCoordinates(settings, start),
+            toNavMeshCoordinates(settings, end), includeFlags, settings);
+        if (!result)
+            return std::nullopt;
+        for (osg::Vec3f& waypoint : *result)
+            waypoint = fromNavMeshCoordinates(settings, waypoint);
+        return result;
+    }
 }
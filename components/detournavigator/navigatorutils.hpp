@@ -7,6 +7,7 @@
 #include "navigator.hpp"
 
 #include <optional>
+#include <vector>
 
 namespace DetourNavigator
 {
@@ -63,6 +64,18 @@ namespace DetourNavigator
      */
     std::optional<osg::Vec3f> raycast(const Navigator& navigator, const osg::Vec3f& agentHalfExtents, const osg::Vec3f& start,
         const osg::Vec3f& end, const Flags includeFlags);
+
+    /**
+     * @brief findCoarsePath finds a route over navmesh tiles without the limits of a single navmesh query.
+     * @param agentHalfExtents allows to find navmesh for given actor.
+     * @param start of the route.
+     * @param end of the route, when it is not on the navmesh the route leads as close to it as possible.
+     * @param includeFlags setup allowed surfaces for actor to walk.
+     * @return not empty optional with waypoints to refine by findPath leg by leg, the last one is end when it is
+     * reachable. Empty optional if there is no route.
+     */
+    std::optional<std::vector<osg::Vec3f>> findCoarsePath(const Navigator& navigator, const osg::Vec3f& agentHalfExtents,
+        const osg::Vec3f& start, const osg::Vec3f& end, const Flags includeFlags);
 }
 
 #endif
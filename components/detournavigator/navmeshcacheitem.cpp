@@ -66,6 +66,8 @@ namespace DetourNavigator
                 tile->second.mCached = std::move(cached);
                 tile->second.mData = std::move(navMeshData);
             }
+            if (const dtMeshTile* meshTile = getTile(*mImpl, position))
+                mTileGraph.updateTile(position, *meshTile);
             ++mVersion.mRevision;
             return UpdateNavMeshStatusBuilder().added(true).removed(removed).getResult();
         }
@@ -74,6 +76,7 @@ namespace DetourNavigator
             if (removed)
             {
                 mUsedTiles.erase(position);
+                mTileGraph.removeTile(position);
                 ++mVersion.mRevision;
             }
             return UpdateNavMeshStatusBuilder().removed(removed).failed((addStatus & DT_OUT_OF_MEMORY) != 0).getResult();
@@ -86,6 +89,7 @@ namespace DetourNavigator
         if (removed)
         {
             mUsedTiles.erase(position);
+            mTileGraph.removeTile(position);
             ++mVersion.mRevision;
         }
         return UpdateNavMeshStatusBuilder().removed(removed).getResult();
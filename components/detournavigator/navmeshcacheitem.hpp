@@ -6,6 +6,7 @@
 #include "navmeshtilescache.hpp"
 #include "dtstatus.hpp"
 #include "navmeshdata.hpp"
+#include "tilegraph.hpp"
 #include "version.hpp"
 
 #include <components/misc/guarded.hpp>
@@ -142,6 +143,8 @@ namespace DetourNavigator
 
         const Version& getVersion() const { return mVersion; }
 
+        const TileGraph& getTileGraph() const { return mTileGraph; }
+
         UpdateNavMeshStatus updateTile(const TilePosition& position, NavMeshTilesCache::Value&& cached,
                                        NavMeshData&& navMeshData);
 
@@ -166,6 +169,7 @@ namespace DetourNavigator
         NavMeshPtr mImpl;
         Version mVersion;
         std::map<TilePosition, Tile> mUsedTiles;
+        TileGraph mTileGraph;
     };
 
     using GuardedNavMeshCacheItem = Misc::ScopeGuarded<NavMeshCacheItem>;
@@ -1,11 +1,30 @@
 #include "navmeshtilescache.hpp"
 
+#include <components/misc/hash.hpp>
+
 #include <osg/Stats>
 
+#include <algorithm>
 #include <cstring>
+#include <iterator>
 
 namespace DetourNavigator
 {
+    namespace
+    {
+        std::size_t getHash(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
+            const RecastMesh& recastMesh)
+        {
+            std::size_t result = recastMesh.getHash();
+            Misc::hashCombine(result, agentHalfExtents.x());
+            Misc::hashCombine(result, agentHalfExtents.y());
+            Misc::hashCombine(result, agentHalfExtents.z());
+            Misc::hashCombine(result, changedTile.x());
+            Misc::hashCombine(result, changedTile.y());
+            return result;
+        }
+    }
+
     NavMeshTilesCache::NavMeshTilesCache(const std::size_t maxNavMeshDataSize)
         : mMaxNavMeshDataSize(maxNavMeshDataSize), mUsedNavMeshDataSize(0), mFreeNavMeshDataSize(0),
           mHitCount(0), mGetCount(0) {}
@@ -17,15 +36,16 @@ namespace DetourNavigator
 
         ++mGetCount;
 
-        const auto tile = mValues.find(std::make_tuple(agentHalfExtents, changedTile, recastMesh));
-        if (tile == mValues.end())
+        const auto tile = findUnsafe(getHash(agentHalfExtents, changedTile, recastMesh), agentHalfExtents,
+                                     changedTile, recastMesh);
+        if (!tile.has_value())
             return Value();
 
-        acquireItemUnsafe(tile->second);
+        acquireItemUnsafe(*tile);
 
         ++mHitCount;
 
-        return Value(*this, tile->second);
+        return Value(*this, *tile);
     }
 
     NavMeshTilesCache::Value NavMeshTilesCache::set(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
@@ -34,28 +54,30 @@ namespace DetourNavigator
         const auto itemSize = sizeof(RecastMesh) + getSize(recastMesh)
             + (value == nullptr ? 0 : sizeof(PreparedNavMeshData) + getSize(*value));
 
+        const std::size_t hash = getHash(agentHalfExtents, changedTile, recastMesh);
+
         const std::lock_guard<std::mutex> lock(mMutex);
 
         if (itemSize > mFreeNavMeshDataSize + (mMaxNavMeshDataSize - mUsedNavMeshDataSize))
             return Value();
 
+        if (const auto existing = findUnsafe(hash, agentHalfExtents, changedTile, recastMesh))
+        {
+            acquireItemUnsafe(*existing);
+            ++mGetCount;
+            ++mHitCount;
+            return Value(*this, *existing);
+        }
+
         while (!mFreeItems.empty() && mUsedNavMeshDataSize + itemSize > mMaxNavMeshDataSize)
             removeLeastRecentlyUsed();
 
         RecastMeshData key {recastMesh.getMesh(), recastMesh.getWater(),
                     recastMesh.getHeightfields(), recastMesh.getFlatHeightfields()};
 
-        const auto iterator = mFreeItems.emplace(mFreeItems.end(), agentHalfExtents, changedTile, std::move(key), itemSize);
-        const auto emplaced = mValues.emplace(std::make_tuple(agentHalfExtents, changedTile, std::cref(iterator->mRecastMeshData)), iterator);
-
-        if (!emplaced.second)
-        {
-            mFreeItems.erase(iterator);
-            acquireItemUnsafe(emplaced.first->second);
-            ++mGetCount;
-            ++mHitCount;
-            return Value(*this, emplaced.first->second);
-        }
+        const auto iterator = mFreeItems.emplace(mFreeItems.end(), agentHalfExtents, changedTile, std::move(key),
+                                                 itemSize, hash);
+        mValues.emplace(hash, iterator);
 
         iterator->mPreparedNavMeshData = std::move(value);
         ++iterator->mUseCount;
@@ -89,16 +111,31 @@ namespace DetourNavigator
             out.setAttribute(frameNumber, "NavMesh CacheHitRate", static_cast<double>(stats.mHitCount) / stats.mGetCount * 100.0);
     }
 
+    std::optional<NavMeshTilesCache::ItemIterator> NavMeshTilesCache::findUnsafe(std::size_t hash,
+        const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile, const RecastMesh& recastMesh) const
+    {
+        const auto [begin, end] = mValues.equal_range(hash);
+        for (auto it = begin; it != end; ++it)
+        {
+            const Item& item = *it->second;
+            if (item.mAgentHalfExtents == agentHalfExtents && item.mChangedTile == changedTile
+                    && item.mRecastMeshData == recastMesh)
+                return it->second;
+        }
+        return std::nullopt;
+    }
+
     void NavMeshTilesCache::removeLeastRecentlyUsed()
     {
-        const auto& item = mFreeItems.back();
+        const auto item = std::prev(mFreeItems.end());
 
-        const auto value = mValues.find(std::make_tuple(item.mAgentHalfExtents, item.mChangedTile, std::cref(item.mRecastMeshData)));
-        if (value == mValues.end())
+        const auto [begin, end] = mValues.equal_range(item->mHash);
+        const auto value = std::find_if(begin, end, [&] (const auto& v) { return v.second == item; });
+        if (value == end)
             return;
 
-        mUsedNavMeshDataSize -= item.mSize;
-        mFreeNavMeshDataSize -= item.mSize;
+        mUsedNavMeshDataSize -= item->mSize;
+        mFreeNavMeshDataSize -= item->mSize;
 
         mValues.erase(value);
         mFreeItems.pop_back();
@@ -6,11 +6,12 @@
 #include "tileposition.hpp"
 
 #include <atomic>
-#include <map>
 #include <list>
 #include <mutex>
 #include <cassert>
 #include <cstring>
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
 namespace osg
@@ -28,22 +29,10 @@ namespace DetourNavigator
         std::vector<FlatHeightfield> mFlatHeightfields;
     };
 
-    inline bool operator <(const RecastMeshData& lhs, const RecastMeshData& rhs)
+    inline bool operator ==(const RecastMeshData& lhs, const RecastMesh& rhs)
     {
         return std::tie(lhs.mMesh, lhs.mWater, lhs.mHeightfields, lhs.mFlatHeightfields)
-                < std::tie(rhs.mMesh, rhs.mWater, rhs.mHeightfields, rhs.mFlatHeightfields);
-    }
-
-    inline bool operator <(const RecastMeshData& lhs, const RecastMesh& rhs)
-    {
-        return std::tie(lhs.mMesh, lhs.mWater, lhs.mHeightfields, lhs.mFlatHeightfields)
-                < std::tie(rhs.getMesh(), rhs.getWater(), rhs.getHeightfields(), rhs.getFlatHeightfields());
-    }
-
-    inline bool operator <(const RecastMesh& lhs, const RecastMeshData& rhs)
-    {
-        return std::tie(lhs.getMesh(), lhs.getWater(), lhs.getHeightfields(), lhs.getFlatHeightfields())
-                < std::tie(rhs.mMesh, rhs.mWater, rhs.mHeightfields, rhs.mFlatHeightfields);
+                == std::tie(rhs.getMesh(), rhs.getWater(), rhs.getHeightfields(), rhs.getFlatHeightfields());
     }
 
     class NavMeshTilesCache
@@ -57,14 +46,16 @@ namespace DetourNavigator
             RecastMeshData mRecastMeshData;
             std::unique_ptr<PreparedNavMeshData> mPreparedNavMeshData;
             std::size_t mSize;
+            std::size_t mHash;
 
             Item(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
-                 RecastMeshData&& recastMeshData, std::size_t size)
+                 RecastMeshData&& recastMeshData, std::size_t size, std::size_t hash)
                 : mUseCount(0)
                 , mAgentHalfExtents(agentHalfExtents)
                 , mChangedTile(changedTile)
                 , mRecastMeshData(std::move(recastMeshData))
                 , mSize(size)
+                , mHash(hash)
             {}
         };
 
@@ -155,7 +146,12 @@ namespace DetourNavigator
         std::size_t mGetCount;
         std::list<Item> mBusyItems;
         std::list<Item> mFreeItems;
-        std::map<std::tuple<osg::Vec3f, TilePosition, std::reference_wrapper<const RecastMeshData>>, ItemIterator, std::less<>> mValues;
+        // Keyed by the hash of the agent half extents, tile position and recast mesh, content is compared only on
+        // hash match
+        std::unordered_multimap<std::size_t, ItemIterator> mValues;
+
+        std::optional<ItemIterator> findUnsafe(std::size_t hash, const osg::Vec3f& agentHalfExtents,
+            const TilePosition& changedTile, const RecastMesh& recastMesh) const;
 
         void removeLeastRecentlyUsed();
 
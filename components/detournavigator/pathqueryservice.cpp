@@ -0,0 +1,145 @@
+#include "pathqueryservice.hpp"
+#include "findcoarsepath.hpp"
+#include "findsmoothpath.hpp"
+#include "navigator.hpp"
+#include "settings.hpp"
+#include "settingsutils.hpp"
+
+#include <DetourNavMeshQuery.h>
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+
+namespace DetourNavigator
+{
+    namespace
+    {
+        dtNavMeshQuery& getNavMeshQuery()
+        {
+            thread_local dtNavMeshQuery navMeshQuery;
+            return navMeshQuery;
+        }
+
+        osg::Vec3f findPathEnd(const GuardedNavMeshCacheItem& navMeshCacheItem, const Settings& settings,
+            const PathQuery& query)
+        {
+            if (query.mMaxDistance <= 0 || (query.mEnd - query.mStart).length() <= query.mMaxDistance)
+                return query.mEnd;
+            std::optional<std::vector<osg::Vec3f>> route;
+            {
+                const auto locked = navMeshCacheItem.lockConst();
+                route = findCoarsePath(getNavMeshQuery(), locked->getImpl(), locked->getTileGraph(),
+                    toNavMeshCoordinates(settings, query.mAgentHalfExtents), toNavMeshCoordinates(settings, query.mStart),
+                    toNavMeshCoordinates(settings, query.mEnd), query.mIncludeFlags, settings);
+            }
+            if (!route.has_value())
+                route.emplace();
+            for (osg::Vec3f& waypoint : *route)
+                waypoint = fromNavMeshCoordinates(settings, waypoint);
+            return getLimitedPathEnd(query.mStart, query.mEnd, query.mMaxDistance, *route);
+        }
+
+        Status findPath(const GuardedNavMeshCacheItem& navMeshCacheItem, const Settings& settings,
+            const PathQuery& query, const osg::Vec3f& end, Flags includeFlags, std::vector<osg::Vec3f>& path)
+        {
+            auto out = std::back_inserter(path);
+            const Status status = findSmoothPath(getNavMeshQuery(), navMeshCacheItem.lockConst()->getImpl(),
+                toNavMeshCoordinates(settings, query.mAgentHalfExtents), toNavMeshCoordinates(settings, query.mStepSize),
+                toNavMeshCoordinates(settings, query.mStart), toNavMeshCoordinates(settings, end), includeFlags,
+                query.mAreaCosts, settings, query.mEndTolerance, out);
+            if (query.mAcceptPartialPath && status == Status::PartialPath)
+                return Status::Success;
+            return status;
+        }
+
+        auto makeTupleWithoutPositions(const PathQuery& v) noexcept
+        {
+            return std::tie(v.mAgentHalfExtents, v.mStepSize, v.mMaxDistance, v.mIncludeFlags, v.mAreaCosts.mWater,
+                            v.mAreaCosts.mDoor, v.mAreaCosts.mPathgrid, v.mAreaCosts.mGround, v.mEndTolerance,
+                            v.mAcceptPartialPath, v.mRetryWithPathgrid);
+        }
+
+        bool isEquivalent(const PathQuery& lhs, const PathQuery& rhs) noexcept
+        {
+            // Paths between positions closer than the agent's radius hardly differ
+            const float radius = std::min(lhs.mAgentHalfExtents.x(), lhs.mAgentHalfExtents.y());
+            return makeTupleWithoutPositions(lhs) == makeTupleWithoutPositions(rhs)
+                && (lhs.mStart - rhs.mStart).length2() <= radius * radius
+                && (lhs.mEnd - rhs.mEnd).length2() <= radius * radius;
+        }
+    }
+
+    PathQueryService::PathQueryService(const Navigator& navigator, std::size_t threads)
+        : mNavigator(navigator)
+        , mPool(threads)
+    {
+    }
+
+    std::shared_ptr<const PendingPath> PathQueryService::request(const PathQuery& query)
+    {
+        auto pending = std::make_shared<PendingPath>(query);
+        // Navmeshes of the navigator are added and removed by the calling thread
+        SharedNavMeshCacheItem navMeshCacheItem = mNavigator.getNavMesh(query.mAgentHalfExtents);
+        if (navMeshCacheItem == nullptr)
+        {
+            pending->mResult.mIncludeFlags = query.mIncludeFlags;
+            pending->mResult.mEnd = query.mMaxDistance > 0
+                ? getLimitedPathEnd(query.mStart, query.mEnd, query.mMaxDistance, {})
+                : query.mEnd;
+            pending->mReady = true;
+            return pending;
+        }
+        {
+            const std::lock_guard lock(mMutex);
+            // Finished queries are removed, so there are only as many as queued and running jobs
+            for (const std::weak_ptr<PendingPath>& v : mPending)
+                if (std::shared_ptr<PendingPath> existing = v.lock(); existing != nullptr && isEquivalent(existing->mQuery, query))
+                    return existing;
+            mPending.push_back(pending);
+        }
+        mPool.push([this, pending, navMeshCacheItem = std::move(navMeshCacheItem)]
+        {
+            process(*pending, *navMeshCacheItem);
+        });
+        return pending;
+    }
+
+    void PathQueryService::process(PendingPath& pending, const GuardedNavMeshCacheItem& navMeshCacheItem)
+    {
+        const PathQuery& query = pending.mQuery;
+        const Settings& settings = mNavigator.getSettings();
+        PathQueryResult& result = pending.mResult;
+
+        result.mIncludeFlags = query.mIncludeFlags;
+        result.mEnd = findPathEnd(navMeshCacheItem, settings, query);
+        result.mStatus = findPath(navMeshCacheItem, settings, query, result.mEnd, result.mIncludeFlags, result.mPath);
+        if (result.mStatus != Status::Success)
+            result.mPath.clear();
+
+        if (query.mRetryWithPathgrid && result.mPath.empty() && (query.mIncludeFlags & Flag_usePathgrid) == 0)
+        {
+            result.mIncludeFlags = query.mIncludeFlags | Flag_usePathgrid;
+            result.mStatus = findPath(navMeshCacheItem, settings, query, result.mEnd, result.mIncludeFlags,
+                                      result.mPath);
+            if (result.mStatus != Status::Success)
+                result.mPath.clear();
+        }
+
+        {
+            const std::lock_guard lock(mMutex);
+            const auto it = std::find_if(mPending.begin(), mPending.end(),
+                [&] (const std::weak_ptr<PendingPath>& v) { return v.lock().get() == &pending; });
+            if (it != mPending.end())
+                mPending.erase(it);
+        }
+
+        pending.mReady.store(true, std::memory_order_release);
+        mPool.notify();
+    }
+
+    void PathQueryService::wait(const PendingPath& pending)
+    {
+        mPool.runUntil([&] { return pending.isReady(); });
+    }
+}
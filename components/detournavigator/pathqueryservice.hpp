@@ -0,0 +1,99 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_PATHQUERYSERVICE_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_PATHQUERYSERVICE_H
+
+#include "areatype.hpp"
+#include "flags.hpp"
+#include "navmeshcacheitem.hpp"
+#include "status.hpp"
+
+#include <components/misc/jobpool.hpp>
+
+#include <osg/Vec3f>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace DetourNavigator
+{
+    struct Navigator;
+
+    struct PathQuery
+    {
+        osg::Vec3f mAgentHalfExtents;
+        float mStepSize = 0;
+        osg::Vec3f mStart;
+        osg::Vec3f mEnd;
+        /// When positive and mEnd is further from mStart, the path leads to the last waypoint of the route over navmesh
+        /// tiles within this distance on the way to mEnd
+        float mMaxDistance = 0;
+        Flags mIncludeFlags = Flag_none;
+        AreaCosts mAreaCosts;
+        float mEndTolerance = 0;
+        /// Partial path is reported as success
+        bool mAcceptPartialPath = false;
+        /// When no path is found with mIncludeFlags, try again with Flag_usePathgrid
+        bool mRetryWithPathgrid = false;
+    };
+
+    struct PathQueryResult
+    {
+        Status mStatus = Status::NavMeshNotFound;
+        /// Include flags of the last attempt
+        Flags mIncludeFlags = Flag_none;
+        /// End the path is found to, differs from the query end when it is limited by the query max distance
+        osg::Vec3f mEnd;
+        /// Empty when mStatus is not Status::Success
+        std::vector<osg::Vec3f> mPath;
+    };
+
+    /// Shared by all requests of equivalent queries made before its result was ready
+    class PendingPath
+    {
+    public:
+        explicit PendingPath(const PathQuery& query) : mQuery(query) {}
+
+        const PathQuery& getQuery() const { return mQuery; }
+
+        bool isReady() const { return mReady.load(std::memory_order_acquire); }
+
+        /// May be called only when isReady() returns true
+        const PathQueryResult& getResult() const { return mResult; }
+
+    private:
+        const PathQuery mQuery;
+        std::atomic_bool mReady {false};
+        PathQueryResult mResult;
+
+        friend class PathQueryService;
+    };
+
+    /// @brief Finds paths over navmesh on background threads.
+    /// @par Each thread reuses its own dtNavMeshQuery for both the route over navmesh tiles limiting the path end and
+    /// the path itself. Requests of a query equivalent to one not finished yet share its
+    /// result: all parameters are equal and the start and end are closer than the agent's horizontal half extent to
+    /// the ones of the first query. The navigator must outlive the service.
+    class PathQueryService
+    {
+    public:
+        PathQueryService(const Navigator& navigator, std::size_t threads);
+
+        std::shared_ptr<const PendingPath> request(const PathQuery& query);
+
+        /// Run queued queries in the calling thread until the path is ready, a service without threads runs them only
+        /// this way
+        void wait(const PendingPath& pending);
+
+    private:
+        const Navigator& mNavigator;
+        std::mutex mMutex;
+        std::vector<std::weak_ptr<PendingPath>> mPending;
+        // Destroyed first to stop the threads before the other members
+        Misc::JobPool mPool;
+
+        void process(PendingPath& pending, const GuardedNavMeshCacheItem& navMeshCacheItem);
+    };
+}
+
+#endif
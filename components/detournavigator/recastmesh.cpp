@@ -1,10 +1,80 @@
 #include "recastmesh.hpp"
 #include "exceptions.hpp"
 
+#include <components/misc/hash.hpp>
+
 #include <Recast.h>
 
+#include <string_view>
+#include <type_traits>
+
 namespace DetourNavigator
 {
+    namespace
+    {
+        template <class T>
+        void hashValues(std::size_t& seed, const std::vector<T>& values)
+        {
+            static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+            // Negative and positive zeros compare equal but have different bytes, they can only produce cache misses
+            Misc::hashCombine(seed, values.size());
+            Misc::hashCombine(seed, std::string_view(reinterpret_cast<const char*>(values.data()),
+                                                     values.size() * sizeof(T)));
+        }
+
+        void hashValue(std::size_t& seed, const osg::Vec2f& value)
+        {
+            Misc::hashCombine(seed, value.x());
+            Misc::hashCombine(seed, value.y());
+        }
+
+        void hashValue(std::size_t& seed, const osg::Vec3f& value)
+        {
+            Misc::hashCombine(seed, value.x());
+            Misc::hashCombine(seed, value.y());
+            Misc::hashCombine(seed, value.z());
+        }
+
+        void hashValue(std::size_t& seed, const TileBounds& value)
+        {
+            hashValue(seed, value.mMin);
+            hashValue(seed, value.mMax);
+        }
+    }
+
+    std::size_t getRecastMeshHash(const Mesh& mesh, const std::vector<Cell>& water,
+        const std::vector<Heightfield>& heightfields, const std::vector<FlatHeightfield>& flatHeightfields)
+    {
+        std::size_t result = 0;
+        hashValues(result, mesh.getIndices());
+        hashValues(result, mesh.getVertices());
+        hashValues(result, mesh.getAreaTypes());
+        Misc::hashCombine(result, water.size());
+        for (const Cell& v : water)
+        {
+            Misc::hashCombine(result, v.mSize);
+            hashValue(result, v.mShift);
+        }
+        Misc::hashCombine(result, heightfields.size());
+        for (const Heightfield& v : heightfields)
+        {
+            hashValue(result, v.mBounds);
+            Misc::hashCombine(result, v.mLength);
+            Misc::hashCombine(result, v.mMinHeight);
+            Misc::hashCombine(result, v.mMaxHeight);
+            hashValue(result, v.mShift);
+            Misc::hashCombine(result, v.mScale);
+            hashValues(result, v.mHeights);
+        }
+        Misc::hashCombine(result, flatHeightfields.size());
+        for (const FlatHeightfield& v : flatHeightfields)
+        {
+            hashValue(result, v.mBounds);
+            Misc::hashCombine(result, v.mHeight);
+        }
+        return result;
+    }
+
     Mesh::Mesh(std::vector<int>&& indices, std::vector<float>&& vertices, std::vector<AreaType>&& areaTypes)
     {
         if (indices.size() / 3 != areaTypes.size())
@@ -53,5 +123,6 @@ namespace DetourNavigator
             mBounds.mMax.y() = std::max(mBounds.mMax.y(), v.mBounds.mMax.y());
             mBounds.mMax.z() = std::max(mBounds.mMax.z(), v.mHeight);
         }
+        mHash = getRecastMeshHash(mMesh, mWater, mHeightfields, mFlatHeightfields);
     }
 }
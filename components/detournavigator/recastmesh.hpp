@@ -39,6 +39,12 @@ namespace DetourNavigator
                     < std::tie(rhs.mIndices, rhs.mVertices, rhs.mAreaTypes);
         }
 
+        friend inline bool operator==(const Mesh& lhs, const Mesh& rhs) noexcept
+        {
+            return std::tie(lhs.mIndices, lhs.mVertices, lhs.mAreaTypes)
+                    == std::tie(rhs.mIndices, rhs.mVertices, rhs.mAreaTypes);
+        }
+
         friend inline std::size_t getSize(const Mesh& value) noexcept
         {
             return value.mIndices.size() * sizeof(int)
@@ -74,6 +80,11 @@ namespace DetourNavigator
         return makeTuple(lhs) < makeTuple(rhs);
     }
 
+    inline bool operator==(const Heightfield& lhs, const Heightfield& rhs) noexcept
+    {
+        return makeTuple(lhs) == makeTuple(rhs);
+    }
+
     struct FlatHeightfield
     {
         TileBounds mBounds;
@@ -85,6 +96,11 @@ namespace DetourNavigator
         return std::tie(lhs.mBounds, lhs.mHeight) < std::tie(rhs.mBounds, rhs.mHeight);
     }
 
+    inline bool operator==(const FlatHeightfield& lhs, const FlatHeightfield& rhs) noexcept
+    {
+        return std::tie(lhs.mBounds, lhs.mHeight) == std::tie(rhs.mBounds, rhs.mHeight);
+    }
+
     class RecastMesh
     {
     public:
@@ -123,6 +139,9 @@ namespace DetourNavigator
             return mBounds;
         }
 
+        /// Precomputed getRecastMeshHash() of the content
+        std::size_t getHash() const noexcept { return mHash; }
+
     private:
         std::size_t mGeneration;
         std::size_t mRevision;
@@ -131,6 +150,7 @@ namespace DetourNavigator
         std::vector<Heightfield> mHeightfields;
         std::vector<FlatHeightfield> mFlatHeightfields;
         Bounds mBounds;
+        std::size_t mHash;
 
         friend inline std::size_t getSize(const RecastMesh& value) noexcept
         {
@@ -146,6 +166,15 @@ namespace DetourNavigator
     {
         return std::tie(lhs.mSize, lhs.mShift) < std::tie(rhs.mSize, rhs.mShift);
     }
+
+    inline bool operator==(const Cell& lhs, const Cell& rhs) noexcept
+    {
+        return std::tie(lhs.mSize, lhs.mShift) == std::tie(rhs.mSize, rhs.mShift);
+    }
+
+    /// @return hash of the content, equal for meshes comparing equal
+    std::size_t getRecastMeshHash(const Mesh& mesh, const std::vector<Cell>& water,
+        const std::vector<Heightfield>& heightfields, const std::vector<FlatHeightfield>& flatHeightfields);
 }
 
 #endif
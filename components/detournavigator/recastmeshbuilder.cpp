@@ -1,6 +1,7 @@
 #include "recastmeshbuilder.hpp"
 #include "debug.hpp"
 #include "exceptions.hpp"
+#include "triangulatedshape.hpp"
 
 #include <components/bullethelpers/transformboundingbox.hpp>
 #include <components/bullethelpers/processtrianglecallback.hpp>
@@ -200,6 +201,39 @@ namespace DetourNavigator
         }
     }
 
+    void RecastMeshBuilder::addObject(const TriangulatedShape& shape, const btTransform& transform,
+                                      const AreaType areaType)
+    {
+        using BulletHelpers::transformBoundingBox;
+
+        const btVector3 boundsMin(mBounds.mMin.x(), mBounds.mMin.y(),
+            -std::numeric_limits<btScalar>::max() * std::numeric_limits<btScalar>::epsilon());
+        const btVector3 boundsMax(mBounds.mMax.x(), mBounds.mMax.y(),
+            std::numeric_limits<btScalar>::max() * std::numeric_limits<btScalar>::epsilon());
+
+        const std::vector<btVector3>& vertices = shape.getVertices();
+        if (vertices.empty())
+            return;
+
+        btVector3 aabbMin = shape.getAabbMin();
+        btVector3 aabbMax = shape.getAabbMax();
+        transformBoundingBox(transform, aabbMin, aabbMax);
+        if (!TestAabbAgainstAabb2(aabbMin, aabbMax, boundsMin, boundsMax))
+            return;
+
+        std::array<btVector3, 3> transformed;
+        for (std::size_t i = 0; i + 2 < vertices.size(); i += 3)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+                transformed[j] = transform(vertices[i + j]);
+            if (!TestTriangleAgainstAabb2(transformed.data(), boundsMin, boundsMax))
+                continue;
+            RecastMeshTriangle triangle = makeRecastMeshTriangle(transformed.data(), areaType);
+            std::reverse(triangle.mVertices.begin(), triangle.mVertices.end());
+            mTriangles.emplace_back(triangle);
+        }
+    }
+
     void RecastMeshBuilder::addWater(const int cellSize, const osg::Vec3f& shift)
     {
         mWater.push_back(Cell {cellSize, shift});
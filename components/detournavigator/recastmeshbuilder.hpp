@@ -22,6 +22,8 @@ class btTriangleCallback;
 
 namespace DetourNavigator
 {
+    class TriangulatedShape;
+
     struct RecastMeshTriangle
     {
         AreaType mAreaType;
@@ -48,6 +50,9 @@ namespace DetourNavigator
 
         void addObject(const btBoxShape& shape, const btTransform& transform, const AreaType areaType);
 
+        /// Produces the same triangles as for the concave shape it is made of
+        void addObject(const TriangulatedShape& shape, const btTransform& transform, const AreaType areaType);
+
         void addWater(const int mCellSize, const osg::Vec3f& shift);
 
         void addHeightfield(int cellSize, const osg::Vec3f& shift, float height);
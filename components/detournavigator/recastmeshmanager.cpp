@@ -5,10 +5,39 @@
 
 #include <components/debug/debuglog.hpp>
 
+#include <BulletCollision/CollisionShapes/btCollisionShape.h>
+
+#include <functional>
+#include <memory>
 #include <utility>
+#include <vector>
 
 namespace
 {
+    using DetourNavigator::AreaType;
+    using DetourNavigator::ChildRecastMeshObject;
+    using DetourNavigator::TriangulatedShape;
+
+    struct Object
+    {
+        std::reference_wrapper<const btCollisionShape> mShape;
+        btTransform mTransform;
+        AreaType mAreaType;
+        std::shared_ptr<const TriangulatedShape> mTriangulatedShape;
+    };
+
+    // Compound children are added one by one to use triangles cached by each child
+    void addObjects(const ChildRecastMeshObject& object, const btTransform& transform, std::vector<Object>& objects)
+    {
+        if (object.getShape().isCompound())
+        {
+            for (const ChildRecastMeshObject& child : object.getChildren())
+                addObjects(child, transform * child.getTransform(), objects);
+            return;
+        }
+        objects.push_back(Object {object.getShape(), transform, object.getAreaType(), object.getTriangulatedShape()});
+    }
+
     struct AddHeightfield
     {
         const DetourNavigator::Cell& mCell;
@@ -119,12 +148,7 @@ namespace DetourNavigator
     std::shared_ptr<RecastMesh> RecastMeshManager::getMesh() const
     {
         RecastMeshBuilder builder(mTileBounds);
-        using Object = std::tuple<
-            osg::ref_ptr<const osg::Referenced>,
-            std::reference_wrapper<const btCollisionShape>,
-            btTransform,
-            AreaType
-        >;
+        std::vector<osg::ref_ptr<const osg::Referenced>> holders;
         std::vector<Object> objects;
         std::size_t revision;
         {
@@ -133,16 +157,23 @@ namespace DetourNavigator
                 builder.addWater(v.mSize, v.mShift);
             for (const auto& [cellPosition, v] : mHeightfields)
                 std::visit(AddHeightfield {v.mCell, builder}, v.mShape);
+            holders.reserve(mObjects.size());
             objects.reserve(mObjects.size());
             for (const auto& [k, object] : mObjects)
             {
                 const RecastMeshObject& impl = object.getImpl();
-                objects.emplace_back(impl.getHolder(), impl.getShape(), impl.getTransform(), impl.getAreaType());
+                holders.push_back(impl.getHolder());
+                addObjects(impl.getImpl(), impl.getTransform(), objects);
             }
             revision = mRevision;
         }
-        for (const auto& [holder, shape, transform, areaType] : objects)
-            builder.addObject(shape, transform, areaType);
+        for (const Object& object : objects)
+        {
+            if (object.mTriangulatedShape != nullptr)
+                builder.addObject(*object.mTriangulatedShape, object.mTransform, object.mAreaType);
+            else
+                builder.addObject(object.mShape.get(), object.mTransform, object.mAreaType);
+        }
         return std::move(builder).create(mGeneration, revision);
     }
 
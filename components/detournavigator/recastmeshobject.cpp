@@ -3,6 +3,7 @@
 #include <components/debug/debuglog.hpp>
 
 #include <BulletCollision/CollisionShapes/btCompoundShape.h>
+#include <BulletCollision/CollisionShapes/btConcaveShape.h>
 
 #include <cassert>
 
@@ -37,6 +38,13 @@ namespace DetourNavigator
                 return makeChildrenObjects(static_cast<const btCompoundShape&>(shape), areaType);
             return {};
         }
+
+        std::shared_ptr<const TriangulatedShape> makeTriangulatedShape(const btCollisionShape& shape)
+        {
+            if (shape.isConcave() && shape.getShapeType() != TERRAIN_SHAPE_PROXYTYPE)
+                return getTriangulatedShape(static_cast<const btConcaveShape&>(shape));
+            return nullptr;
+        }
     }
 
     ChildRecastMeshObject::ChildRecastMeshObject(const btCollisionShape& shape, const btTransform& transform,
@@ -45,6 +53,7 @@ namespace DetourNavigator
         , mTransform(transform)
         , mAreaType(areaType)
         , mLocalScaling(shape.getLocalScaling())
+        , mTriangulatedShape(makeTriangulatedShape(shape))
         , mChildren(makeChildrenObjects(shape, mAreaType))
     {
     }
@@ -65,6 +74,7 @@ namespace DetourNavigator
         if (!(mLocalScaling == mShape.get().getLocalScaling()))
         {
             mLocalScaling = mShape.get().getLocalScaling();
+            mTriangulatedShape = makeTriangulatedShape(mShape.get());
             result = true;
         }
         if (mShape.get().isCompound())
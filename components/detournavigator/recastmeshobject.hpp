@@ -2,6 +2,7 @@
 #define OPENMW_COMPONENTS_DETOURNAVIGATOR_RECASTMESHOBJECT_H
 
 #include "areatype.hpp"
+#include "triangulatedshape.hpp"
 
 #include <LinearMath/btTransform.h>
 
@@ -9,6 +10,7 @@
 #include <osg/Referenced>
 
 #include <functional>
+#include <memory>
 #include <vector>
 
 class btCollisionShape;
@@ -45,11 +47,17 @@ namespace DetourNavigator
 
             AreaType getAreaType() const { return mAreaType; }
 
+            /// Not null for concave shapes except heightfields
+            const std::shared_ptr<const TriangulatedShape>& getTriangulatedShape() const { return mTriangulatedShape; }
+
+            const std::vector<ChildRecastMeshObject>& getChildren() const { return mChildren; }
+
         private:
             std::reference_wrapper<const btCollisionShape> mShape;
             btTransform mTransform;
             AreaType mAreaType;
             btVector3 mLocalScaling;
+            std::shared_ptr<const TriangulatedShape> mTriangulatedShape;
             std::vector<ChildRecastMeshObject> mChildren;
     };
 
@@ -68,6 +76,8 @@ namespace DetourNavigator
 
             AreaType getAreaType() const { return mImpl.getAreaType(); }
 
+            const ChildRecastMeshObject& getImpl() const { return mImpl; }
+
         private:
             osg::ref_ptr<const osg::Referenced> mHolder;
             ChildRecastMeshObject mImpl;
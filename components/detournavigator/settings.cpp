@@ -3,6 +3,8 @@
 #include <components/settings/settings.hpp>
 #include <components/misc/constants.hpp>
 
+#include <algorithm>
+
 namespace DetourNavigator
 {
     Settings makeSettingsFromSettingsManager()
@@ -29,6 +31,7 @@ namespace DetourNavigator
         navigatorSettings.mTileSize = ::Settings::Manager::getInt("tile size", "Navigator");
         navigatorSettings.mWaitUntilMinDistanceToPlayer = ::Settings::Manager::getInt("wait until min distance to player", "Navigator");
         navigatorSettings.mAsyncNavMeshUpdaterThreads = static_cast<std::size_t>(::Settings::Manager::getInt("async nav mesh updater threads", "Navigator"));
+        navigatorSettings.mAsyncPathQueryThreads = static_cast<std::size_t>(std::max(0, ::Settings::Manager::getInt("async path query threads", "Navigator")));
         navigatorSettings.mMaxNavMeshTilesCacheSize = static_cast<std::size_t>(::Settings::Manager::getInt("max nav mesh tiles cache size", "Navigator"));
         navigatorSettings.mMaxPolygonPathSize = static_cast<std::size_t>(::Settings::Manager::getInt("max polygon path size", "Navigator"));
         navigatorSettings.mMaxSmoothPathSize = static_cast<std::size_t>(::Settings::Manager::getInt("max smooth path size", "Navigator"));
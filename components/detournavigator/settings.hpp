@@ -32,6 +32,7 @@ namespace DetourNavigator
         int mTileSize = 0;
         int mWaitUntilMinDistanceToPlayer = 0;
         std::size_t mAsyncNavMeshUpdaterThreads = 0;
+        std::size_t mAsyncPathQueryThreads = 0;
         std::size_t mMaxNavMeshTilesCacheSize = 0;
         std::size_t mMaxPolygonPathSize = 0;
         std::size_t mMaxSmoothPathSize = 0;
@@ -20,6 +20,11 @@ namespace DetourNavigator
         return std::tie(lhs.mMin, lhs.mMax) < std::tie(rhs.mMin, rhs.mMax);
     }
 
+    inline bool operator==(const TileBounds& lhs, const TileBounds& rhs) noexcept
+    {
+        return lhs.mMin == rhs.mMin && lhs.mMax == rhs.mMax;
+    }
+
     inline std::optional<TileBounds> getIntersection(const TileBounds& a, const TileBounds& b) noexcept
     {
         const float minX = std::max(a.mMin.x(), b.mMin.x());
@@ -0,0 +1,354 @@
+#include "tilegraph.hpp"
+
+#include <DetourNavMesh.h>
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace DetourNavigator
+{
+    namespace
+    {
+        constexpr std::size_t noNode = std::numeric_limits<std::size_t>::max();
+        constexpr std::size_t unresolvedTile = noNode - 1;
+        constexpr float portalEpsilon = 1e-3f;
+
+        struct VisitedTile
+        {
+            TilePosition mPosition;
+            const TileClusters* mClusters;
+            /// Index of the first cluster node in the visits
+            std::size_t mFirstNode;
+            /// Indexed by side, noNode when there is no tile
+            std::array<std::size_t, 4> mNeighbours {{unresolvedTile, unresolvedTile, unresolvedTile, unresolvedTile}};
+        };
+
+        struct Visit
+        {
+            std::size_t mTile;
+            std::uint16_t mCluster;
+            float mCost = std::numeric_limits<float>::max();
+            std::size_t mPrevious = noNode;
+        };
+
+        const std::array<TilePosition, 4> neighbourOffsets {{
+            TilePosition(1, 0),
+            TilePosition(0, 1),
+            TilePosition(-1, 0),
+            TilePosition(0, -1),
+        }};
+
+        // Detour side of the tile border edge to portal index
+        std::optional<std::size_t> getPortalIndex(unsigned short neighbour)
+        {
+            if ((neighbour & DT_EXT_LINK) == 0)
+                return std::nullopt;
+            switch (neighbour & 0xff)
+            {
+                case 0: return 0;
+                case 2: return 1;
+                case 4: return 2;
+                case 6: return 3;
+            }
+            return std::nullopt;
+        }
+
+        osg::Vec3f getVertex(const dtMeshTile& tile, unsigned short index)
+        {
+            return osg::Vec3f(tile.verts[index * 3], tile.verts[index * 3 + 1], tile.verts[index * 3 + 2]);
+        }
+
+        osg::Vec3f getPolygonCenter(const dtMeshTile& tile, const dtPoly& polygon)
+        {
+            osg::Vec3f result;
+            for (unsigned char i = 0; i < polygon.vertCount; ++i)
+                result += getVertex(tile, polygon.verts[i]);
+            return result / static_cast<float>(polygon.vertCount);
+        }
+
+        void addPortalEdge(std::vector<TileCluster::Portal>& portals, std::size_t portalIndex,
+            const osg::Vec3f& begin, const osg::Vec3f& end)
+        {
+            // Portals on x sides go along z axis and on z sides along x axis
+            const std::size_t axis = portalIndex % 2 == 0 ? 2 : 0;
+            portals.push_back(TileCluster::Portal {
+                std::min(begin[axis], end[axis]),
+                std::max(begin[axis], end[axis]),
+                std::min(begin.y(), end.y()),
+                std::max(begin.y(), end.y()),
+            });
+        }
+
+        // Joins edges touching each other into spans, so the edges separated by a wall or a gap are not joined
+        void mergePortalEdges(std::vector<TileCluster::Portal>& portals)
+        {
+            if (portals.empty())
+                return;
+            std::sort(portals.begin(), portals.end(),
+                [] (const TileCluster::Portal& lhs, const TileCluster::Portal& rhs) { return lhs.mMin < rhs.mMin; });
+            auto last = portals.begin();
+            for (auto it = std::next(portals.begin()); it != portals.end(); ++it)
+            {
+                if (it->mMin > last->mMax + portalEpsilon)
+                {
+                    *++last = *it;
+                    continue;
+                }
+                last->mMax = std::max(last->mMax, it->mMax);
+                last->mMinHeight = std::min(last->mMinHeight, it->mMinHeight);
+                last->mMaxHeight = std::max(last->mMaxHeight, it->mMaxHeight);
+            }
+            portals.erase(std::next(last), portals.end());
+        }
+
+        bool overlap(const TileCluster::Portal& lhs, const TileCluster::Portal& rhs, float maxClimb)
+        {
+            return lhs.mMin <= rhs.mMax + portalEpsilon && rhs.mMin <= lhs.mMax + portalEpsilon
+                && lhs.mMinHeight <= rhs.mMaxHeight + maxClimb && rhs.mMinHeight <= lhs.mMaxHeight + maxClimb;
+        }
+
+        bool overlap(const std::vector<TileCluster::Portal>& lhs, const std::vector<TileCluster::Portal>& rhs,
+            float maxClimb)
+        {
+            return std::any_of(lhs.begin(), lhs.end(), [&] (const TileCluster::Portal& l)
+            {
+                return std::any_of(rhs.begin(), rhs.end(),
+                    [&] (const TileCluster::Portal& r) { return overlap(l, r, maxClimb); });
+            });
+        }
+
+        const TileCluster& getCluster(const std::vector<VisitedTile>& tiles, const Visit& visit)
+        {
+            return tiles[visit.mTile].mClusters->mClusters[visit.mCluster];
+        }
+
+        std::vector<osg::Vec3f> makeRoute(const std::vector<Visit>& visits, const std::vector<VisitedTile>& tiles,
+            std::size_t last)
+        {
+            std::vector<osg::Vec3f> result;
+            for (std::size_t node = last; visits[node].mPrevious != noNode; node = visits[node].mPrevious)
+                result.push_back(getCluster(tiles, visits[node]).mCenter);
+            std::reverse(result.begin(), result.end());
+            return result;
+        }
+    }
+
+    TileClusters makeTileClusters(const dtMeshTile& tile)
+    {
+        TileClusters result;
+        const int polygonsCount = tile.header == nullptr ? 0 : tile.header->polyCount;
+        if (polygonsCount == 0)
+            return result;
+
+        result.mMaxClimb = tile.header->walkableClimb;
+        result.mPolygonClusters.resize(static_cast<std::size_t>(polygonsCount), TileClusters::sNoCluster);
+
+        std::vector<int> polygons;
+        std::vector<int> stack;
+
+        for (int i = 0; i < polygonsCount; ++i)
+        {
+            if (tile.polys[i].getType() == DT_POLYTYPE_OFFMESH_CONNECTION
+                    || result.mPolygonClusters[i] != TileClusters::sNoCluster)
+                continue;
+
+            const auto clusterIndex = static_cast<std::uint16_t>(result.mClusters.size());
+            TileCluster& cluster = result.mClusters.emplace_back();
+            polygons.clear();
+            stack.push_back(i);
+            result.mPolygonClusters[i] = clusterIndex;
+
+            while (!stack.empty())
+            {
+                const int polygonIndex = stack.back();
+                stack.pop_back();
+                polygons.push_back(polygonIndex);
+                const dtPoly& polygon = tile.polys[polygonIndex];
+                cluster.mFlags |= polygon.flags;
+
+                for (unsigned char j = 0; j < polygon.vertCount; ++j)
+                {
+                    const unsigned short neighbour = polygon.neis[j];
+                    if (neighbour == 0)
+                        continue;
+                    if (const auto portalIndex = getPortalIndex(neighbour))
+                    {
+                        addPortalEdge(cluster.mPortals[*portalIndex], *portalIndex,
+                            getVertex(tile, polygon.verts[j]),
+                            getVertex(tile, polygon.verts[(j + 1) % polygon.vertCount]));
+                        continue;
+                    }
+                    if ((neighbour & DT_EXT_LINK) != 0)
+                        continue;
+                    const int neighbourIndex = neighbour - 1;
+                    if (neighbourIndex >= polygonsCount
+                            || tile.polys[neighbourIndex].getType() == DT_POLYTYPE_OFFMESH_CONNECTION
+                            || result.mPolygonClusters[neighbourIndex] != TileClusters::sNoCluster)
+                        continue;
+                    result.mPolygonClusters[neighbourIndex] = clusterIndex;
+                    stack.push_back(neighbourIndex);
+                }
+            }
+
+            for (std::size_t side = 0; side < cluster.mPortals.size(); ++side)
+                mergePortalEdges(cluster.mPortals[side]);
+
+            osg::Vec3f average;
+            for (const int polygonIndex : polygons)
+                average += getPolygonCenter(tile, tile.polys[polygonIndex]);
+            average /= static_cast<float>(polygons.size());
+
+            float minDistance = std::numeric_limits<float>::max();
+            for (const int polygonIndex : polygons)
+            {
+                const osg::Vec3f center = getPolygonCenter(tile, tile.polys[polygonIndex]);
+                const float distance = (center - average).length2();
+                if (distance < minDistance)
+                {
+                    minDistance = distance;
+                    cluster.mCenter = center;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    void TileGraph::updateTile(const TilePosition& position, const dtMeshTile& tile)
+    {
+        mTiles.insert_or_assign(position, makeTileClusters(tile));
+    }
+
+    void TileGraph::removeTile(const TilePosition& position)
+    {
+        mTiles.erase(position);
+    }
+
+    std::optional<std::vector<osg::Vec3f>> TileGraph::findRoute(const TilePosition& startTile, int startPolygon,
+        const osg::Vec3f& end, const std::optional<std::pair<TilePosition, int>>& endPolygon,
+        const Flags includeFlags) const
+    {
+        // Nodes of a tile are added to the flat visits all at once when the search reaches the tile
+        std::vector<VisitedTile> tiles;
+        std::vector<Visit> visits;
+        std::map<TilePosition, std::size_t> tileIndices;
+
+        const auto getTile = [&] (const TilePosition& tilePosition) -> std::size_t
+        {
+            const auto [index, inserted] = tileIndices.emplace(tilePosition, noNode);
+            if (!inserted)
+                return index->second;
+            const auto tile = mTiles.find(tilePosition);
+            if (tile == mTiles.end())
+                return noNode;
+            index->second = tiles.size();
+            tiles.push_back(VisitedTile {tilePosition, &tile->second, visits.size()});
+            for (std::size_t i = 0; i < tile->second.mClusters.size(); ++i)
+                visits.push_back(Visit {index->second, static_cast<std::uint16_t>(i)});
+            return index->second;
+        };
+
+        const auto getNeighbourTile = [&] (std::size_t tile, std::size_t side)
+        {
+            if (tiles[tile].mNeighbours[side] == unresolvedTile)
+            {
+                // Resolved before the assignment because the tiles may grow
+                const std::size_t neighbour = getTile(tiles[tile].mPosition + neighbourOffsets[side]);
+                tiles[tile].mNeighbours[side] = neighbour;
+            }
+            return tiles[tile].mNeighbours[side];
+        };
+
+        const auto getNode = [&] (const TilePosition& tilePosition, int polygon) -> std::size_t
+        {
+            const std::size_t tile = getTile(tilePosition);
+            if (tile == noNode || polygon < 0)
+                return noNode;
+            const TileClusters& clusters = *tiles[tile].mClusters;
+            if (static_cast<std::size_t>(polygon) >= clusters.mPolygonClusters.size())
+                return noNode;
+            const std::uint16_t cluster = clusters.mPolygonClusters[static_cast<std::size_t>(polygon)];
+            if (cluster == TileClusters::sNoCluster)
+                return noNode;
+            return tiles[tile].mFirstNode + cluster;
+        };
+
+        const std::size_t start = getNode(startTile, startPolygon);
+        if (start == noNode)
+            return std::nullopt;
+
+        std::size_t target = noNode;
+        if (endPolygon.has_value())
+        {
+            target = getNode(endPolygon->first, endPolygon->second);
+            if (target == noNode)
+                return std::nullopt;
+        }
+
+        using Entry = std::pair<float, std::size_t>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+
+        visits[start].mCost = 0;
+        float closestDistance = (getCluster(tiles, visits[start]).mCenter - end).length();
+        std::size_t closest = start;
+        queue.emplace(closestDistance, start);
+
+        while (!queue.empty())
+        {
+            const auto [priority, node] = queue.top();
+            queue.pop();
+            // Visits may grow while the neighbours are resolved
+            const Visit visit = visits[node];
+            const TileCluster& cluster = getCluster(tiles, visit);
+            const float distance = (cluster.mCenter - end).length();
+
+            if (priority > visit.mCost + distance)
+                continue;
+
+            if (node == target)
+                return makeRoute(visits, tiles, node);
+
+            if (distance < closestDistance)
+            {
+                closestDistance = distance;
+                closest = node;
+            }
+
+            const float maxClimb = tiles[visit.mTile].mClusters->mMaxClimb;
+
+            for (std::size_t side = 0; side < neighbourOffsets.size(); ++side)
+            {
+                if (cluster.mPortals[side].empty())
+                    continue;
+                const std::size_t neighbourTile = getNeighbourTile(visit.mTile, side);
+                if (neighbourTile == noNode)
+                    continue;
+                const std::size_t opposite = (side + 2) % neighbourOffsets.size();
+                const TileClusters& neighbourClusters = *tiles[neighbourTile].mClusters;
+                const float climb = std::max(maxClimb, neighbourClusters.mMaxClimb);
+                for (std::size_t i = 0; i < neighbourClusters.mClusters.size(); ++i)
+                {
+                    const TileCluster& neighbour = neighbourClusters.mClusters[i];
+                    if ((neighbour.mFlags & includeFlags) == 0
+                            || !overlap(cluster.mPortals[side], neighbour.mPortals[opposite], climb))
+                        continue;
+                    const std::size_t neighbourNode = tiles[neighbourTile].mFirstNode + i;
+                    const float neighbourCost = visit.mCost + (neighbour.mCenter - cluster.mCenter).length();
+                    Visit& neighbourVisit = visits[neighbourNode];
+                    if (neighbourVisit.mCost <= neighbourCost)
+                        continue;
+                    neighbourVisit.mCost = neighbourCost;
+                    neighbourVisit.mPrevious = node;
+                    queue.emplace(neighbourCost + (neighbour.mCenter - end).length(), neighbourNode);
+                }
+            }
+        }
+
+        if (target != noNode)
+            return std::nullopt;
+
+        return makeRoute(visits, tiles, closest);
+    }
+}
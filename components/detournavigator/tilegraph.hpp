@@ -0,0 +1,76 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_TILEGRAPH_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_TILEGRAPH_H
+
+#include "flags.hpp"
+#include "tileposition.hpp"
+
+#include <osg/Vec3f>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <vector>
+
+struct dtMeshTile;
+
+namespace DetourNavigator
+{
+    /// Part of a navmesh tile where all polygons are connected to each other without leaving the tile
+    struct TileCluster
+    {
+        /// Bounds of a continuous span of the tile border edges through which the cluster is connected to the neighbour
+        /// tile
+        struct Portal
+        {
+            float mMin;
+            float mMax;
+            float mMinHeight;
+            float mMaxHeight;
+        };
+
+        /// Center of the cluster polygon closest to the average center of all cluster polygons
+        osg::Vec3f mCenter;
+        /// Union of the cluster polygons flags
+        Flags mFlags = Flag_none;
+        /// Indexed by side: +x, +z, -x, -z. Separate spans are sorted by mMin and do not touch each other
+        std::array<std::vector<Portal>, 4> mPortals;
+    };
+
+    struct TileClusters
+    {
+        static constexpr std::uint16_t sNoCluster = std::numeric_limits<std::uint16_t>::max();
+
+        float mMaxClimb = 0;
+        std::vector<TileCluster> mClusters;
+        /// Cluster index for each tile polygon, sNoCluster for off mesh connections
+        std::vector<std::uint16_t> mPolygonClusters;
+    };
+
+    TileClusters makeTileClusters(const dtMeshTile& tile);
+
+    /// @brief Coarse graph over navmesh tiles used to plan routes longer than a single Detour query can find.
+    /// @par Nodes are tile clusters. Clusters of adjacent tiles are connected when any of their portal spans on the
+    /// facing sides overlap. Connections are found during the search, so adding or removing a tile rebuilds only its
+    /// own clusters. Off mesh connections are not a part of the graph. All coordinates are navmesh coordinates.
+    class TileGraph
+    {
+    public:
+        void updateTile(const TilePosition& position, const dtMeshTile& tile);
+
+        void removeTile(const TilePosition& position);
+
+        /// @param endPolygon when is not set, route leads to the reachable cluster closest to end
+        /// @return centers of the route clusters excluding the start one, empty when start and end are in the same
+        /// cluster and std::nullopt when there is no route or start polygon is not a part of the graph
+        std::optional<std::vector<osg::Vec3f>> findRoute(const TilePosition& startTile, int startPolygon,
+            const osg::Vec3f& end, const std::optional<std::pair<TilePosition, int>>& endPolygon,
+            const Flags includeFlags) const;
+
+    private:
+        std::map<TilePosition, TileClusters> mTiles;
+    };
+}
+
+#endif
@@ -0,0 +1,135 @@
+#include "triangulatedshape.hpp"
+
+#include <components/bullethelpers/processtrianglecallback.hpp>
+
+#include <BulletCollision/CollisionShapes/btConcaveShape.h>
+#include <BulletCollision/CollisionShapes/btScaledBvhTriangleMeshShape.h>
+#include <BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
+#include <LinearMath/btTransform.h>
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+namespace DetourNavigator
+{
+    namespace
+    {
+        using Key = std::tuple<const btConcaveShape*, btScalar, btScalar, btScalar>;
+
+        struct Registry
+        {
+            std::mutex mMutex;
+            std::map<Key, std::weak_ptr<const TriangulatedShape>> mShapes;
+            std::size_t mSweepSize = 64;
+        };
+
+        Registry& getRegistry()
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        void removeExpired(std::map<Key, std::weak_ptr<const TriangulatedShape>>& shapes)
+        {
+            for (auto it = shapes.begin(); it != shapes.end(); )
+            {
+                if (it->second.expired())
+                    it = shapes.erase(it);
+                else
+                    ++it;
+            }
+        }
+    }
+
+    TriangulatedShape::TriangulatedShape(const btConcaveShape& shape, const btVector3& scaling)
+        : mShape(shape)
+        , mScaling(scaling)
+        , mAabbMin(0, 0, 0)
+        , mAabbMax(0, 0, 0)
+    {
+    }
+
+    const std::vector<btVector3>& TriangulatedShape::getVertices() const
+    {
+        std::call_once(mInitialized, [this] { initialize(); });
+        return mVertices;
+    }
+
+    const btVector3& TriangulatedShape::getAabbMin() const
+    {
+        std::call_once(mInitialized, [this] { initialize(); });
+        return mAabbMin;
+    }
+
+    const btVector3& TriangulatedShape::getAabbMax() const
+    {
+        std::call_once(mInitialized, [this] { initialize(); });
+        return mAabbMax;
+    }
+
+    void TriangulatedShape::initialize() const
+    {
+        btVector3 aabbMin;
+        btVector3 aabbMax;
+        mShape.getAabb(btTransform::getIdentity(), aabbMin, aabbMax);
+
+        auto callback = BulletHelpers::makeProcessTriangleCallback([&] (btVector3* triangle, int, int)
+        {
+            for (std::size_t i = 0; i < 3; ++i)
+                mVertices.push_back(triangle[i] * mScaling);
+        });
+        mShape.processAllTriangles(&callback, aabbMin, aabbMax);
+
+        if (mVertices.empty())
+            return;
+
+        mAabbMin = mVertices.front();
+        mAabbMax = mVertices.front();
+        for (const btVector3& vertex : mVertices)
+        {
+            mAabbMin.setMin(vertex);
+            mAabbMax.setMax(vertex);
+        }
+    }
+
+    std::shared_ptr<const TriangulatedShape> getTriangulatedShape(const btConcaveShape& shape)
+    {
+        const btConcaveShape* base = &shape;
+        btVector3 scaling(1, 1, 1);
+        // Object instances wrap the same triangle mesh into scaled shapes
+        if (shape.getShapeType() == SCALED_TRIANGLE_MESH_SHAPE_PROXYTYPE)
+        {
+            const auto& scaled = static_cast<const btScaledBvhTriangleMeshShape&>(shape);
+            base = scaled.getChildShape();
+            scaling = scaled.getLocalScaling();
+        }
+
+        const btVector3& baseScaling = base->getLocalScaling();
+        const Key key(base, scaling.x() * baseScaling.x(), scaling.y() * baseScaling.y(),
+                      scaling.z() * baseScaling.z());
+
+        Registry& registry = getRegistry();
+        const std::lock_guard lock(registry.mMutex);
+
+        auto it = registry.mShapes.find(key);
+        if (it != registry.mShapes.end())
+        {
+            if (auto existing = it->second.lock())
+                return existing;
+        }
+        else
+        {
+            if (registry.mShapes.size() >= registry.mSweepSize)
+            {
+                removeExpired(registry.mShapes);
+                registry.mSweepSize = std::max<std::size_t>(64, 2 * registry.mShapes.size());
+            }
+            it = registry.mShapes.emplace(key, std::weak_ptr<const TriangulatedShape>()).first;
+        }
+
+        auto result = std::make_shared<const TriangulatedShape>(*base, scaling);
+        it->second = result;
+        return result;
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_TRIANGULATEDSHAPE_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_TRIANGULATEDSHAPE_H
+
+#include <LinearMath/btVector3.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class btConcaveShape;
+
+namespace DetourNavigator
+{
+    /// @brief Triangles of a concave shape in its local space with scaling applied.
+    /// @par Triangles are produced on the first use from any thread and then reused for each placement of the shape
+    /// and each tile it touches. The shape must outlive all owners.
+    class TriangulatedShape
+    {
+    public:
+        TriangulatedShape(const btConcaveShape& shape, const btVector3& scaling);
+
+        /// Three vertices for each triangle as given by the shape triangle callback
+        const std::vector<btVector3>& getVertices() const;
+
+        const btVector3& getAabbMin() const;
+
+        const btVector3& getAabbMax() const;
+
+    private:
+        const btConcaveShape& mShape;
+        const btVector3 mScaling;
+        mutable std::once_flag mInitialized;
+        mutable std::vector<btVector3> mVertices;
+        mutable btVector3 mAabbMin;
+        mutable btVector3 mAabbMax;
+
+        void initialize() const;
+    };
+
+    /// @return triangles shared by all objects of the same concave shape and scaling, scaled triangle mesh shapes
+    /// share triangles of the mesh they wrap
+    std::shared_ptr<const TriangulatedShape> getTriangulatedShape(const btConcaveShape& shape);
+}
+
+#endif
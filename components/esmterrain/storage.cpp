@@ -1,11 +1,13 @@
 #include "storage.hpp"
 
+#include <algorithm>
 #include <set>
 
 #include <osg/Image>
 #include <osg/Plane>
 
 #include <components/debug/debuglog.hpp>
+#include <components/misc/parallelfor.hpp>
 #include <components/misc/resourcehelpers.hpp>
 #include <components/misc/stringops.hpp>
 #include <components/vfs/manager.hpp>
@@ -177,12 +179,13 @@ namespace ESMTerrain
                                             osg::ref_ptr<osg::Vec4ubArray> colours)
     {
         // LOD level n means every 2^n-th vertex is kept
-        size_t increment = static_cast<size_t>(1) << lodLevel;
+        int increment = 1 << lodLevel;
 
         osg::Vec2f origin = center - osg::Vec2f(size/2.f, size/2.f);
 
         int startCellX = static_cast<int>(std::floor(origin.x()));
         int startCellY = static_cast<int>(std::floor(origin.y()));
+        int numCells = static_cast<int>(std::ceil(size));
 
         size_t numVerts = static_cast<size_t>(size*(ESM::Land::LAND_SIZE - 1) / increment + 1);
 
@@ -190,41 +193,26 @@ namespace ESMTerrain
         normals->resize(numVerts*numVerts);
         colours->resize(numVerts*numVerts);
 
-        osg::Vec3f normal;
-        osg::Vec4ub color;
+        const auto countVertices = [&] (int start, int end) { return end > start ? static_cast<size_t>((end - start + increment - 1) / increment) : 0; };
 
-        float vertY = 0;
-        float vertX = 0;
+        std::vector<VertexBlock> blocks;
+        blocks.reserve(numCells * numCells);
 
-        LandCache cache;
-
-        bool alteration = useAlteration();
-
-        float vertY_ = 0; // of current cell corner
-        for (int cellY = startCellY; cellY < startCellY + std::ceil(size); ++cellY)
+        size_t vertY = 0;
+        for (int cellY = startCellY; cellY < startCellY + numCells; ++cellY)
         {
-            float vertX_ = 0; // of current cell corner
-            for (int cellX = startCellX; cellX < startCellX + std::ceil(size); ++cellX)
+            size_t vertX = 0;
+            size_t numCols = 0;
+            for (int cellX = startCellX; cellX < startCellX + numCells; ++cellX)
             {
-                const LandObject* land = getLand(cellX, cellY, cache);
-                const ESM::Land::LandData *heightData = nullptr;
-                const ESM::Land::LandData *normalData = nullptr;
-                const ESM::Land::LandData *colourData = nullptr;
-                if (land)
-                {
-                    heightData = land->getData(ESM::Land::DATA_VHGT);
-                    normalData = land->getData(ESM::Land::DATA_VNML);
-                    colourData = land->getData(ESM::Land::DATA_VCLR);
-                }
-
                 int rowStart = 0;
                 int colStart = 0;
                 // Skip the first row / column unless we're at a chunk edge,
                 // since this row / column is already contained in a previous cell
                 // This is only relevant if we're creating a chunk spanning multiple cells
-                if (vertY_ != 0)
+                if (vertY != 0)
                     colStart += increment;
-                if (vertX_ != 0)
+                if (vertX != 0)
                     rowStart += increment;
 
                 // Only relevant for chunks smaller than (contained in) one cell
@@ -233,85 +221,154 @@ namespace ESMTerrain
                 int rowEnd = std::min(static_cast<int>(rowStart + std::min(1.f, size) * (ESM::Land::LAND_SIZE-1) + 1), static_cast<int>(ESM::Land::LAND_SIZE));
                 int colEnd = std::min(static_cast<int>(colStart + std::min(1.f, size) * (ESM::Land::LAND_SIZE-1) + 1), static_cast<int>(ESM::Land::LAND_SIZE));
 
-                vertY = vertY_;
-                for (int col=colStart; col<colEnd; col += increment)
-                {
-                    vertX = vertX_;
-                    for (int row=rowStart; row<rowEnd; row += increment)
-                    {
-                        int srcArrayIndex = col*ESM::Land::LAND_SIZE*3+row*3;
-
-                        assert(row >= 0 && row < ESM::Land::LAND_SIZE);
-                        assert(col >= 0 && col < ESM::Land::LAND_SIZE);
+                blocks.push_back(VertexBlock {cellX, cellY, rowStart, rowEnd, colStart, colEnd, vertX, vertY});
 
-                        assert (vertX < numVerts);
-                        assert (vertY < numVerts);
+                vertX += countVertices(rowStart, rowEnd);
+                numCols = countVertices(colStart, colEnd);
+            }
+            vertY += numCols;
 
-                        float height = defaultHeight;
-                        if (heightData)
-                            height = heightData->mHeights[col*ESM::Land::LAND_SIZE + row];
-                        if (alteration)
-                            height += getAlteredHeight(col, row);
-                        (*positions)[static_cast<unsigned int>(vertX*numVerts + vertY)]
-                            = osg::Vec3f((vertX / float(numVerts - 1) - 0.5f) * size * Constants::CellSizeInUnits,
-                                         (vertY / float(numVerts - 1) - 0.5f) * size * Constants::CellSizeInUnits,
-                                         height);
+            assert(vertX == numVerts); // Ensure we covered whole area
+        }
+        assert(vertY == numVerts);  // Ensure we covered whole area
 
-                        if (normalData)
-                        {
-                            for (int i=0; i<3; ++i)
-                                normal[i] = normalData->mNormals[srcArrayIndex+i];
+        LandCache cache;
 
-                            normal.normalize();
-                        }
-                        else
-                            normal = osg::Vec3f(0,0,1);
+        // Blocks only share the land cache, so they can be filled concurrently once it holds every cell that can be looked up,
+        // including the neighbours used to fix normals and colours at the chunk borders.
+        const unsigned int threads = useAlteration() ? 1 : std::min<unsigned int>(mMaxVertexThreads, blocks.size());
+        if (threads > 1)
+        {
+            for (int cellY = startCellY - 1; cellY <= startCellY + numCells; ++cellY)
+                for (int cellX = startCellX - 1; cellX <= startCellX + numCells; ++cellX)
+                    getLand(cellX, cellY, cache);
+        }
 
-                        // Normals apparently don't connect seamlessly between cells
-                        if (col == ESM::Land::LAND_SIZE-1 || row == ESM::Land::LAND_SIZE-1)
-                            fixNormal(normal, cellX, cellY, col, row, cache);
+        Misc::parallelFor(Misc::getSharedJobPool(), blocks.size(), threads, [&] (size_t i)
+        {
+            fillVertexBlock(blocks[i], increment, size, numVerts, cache, *positions, *normals, *colours);
+        });
+    }
 
-                        // some corner normals appear to be complete garbage (z < 0)
-                        if ((row == 0 || row == ESM::Land::LAND_SIZE-1) && (col == 0 || col == ESM::Land::LAND_SIZE-1))
-                            averageNormal(normal, cellX, cellY, col, row, cache);
+    void Storage::fillVertexBlock(const VertexBlock& block, int increment, float size, size_t numVerts, LandCache& cache,
+                                  osg::Vec3Array& positions, osg::Vec3Array& normals, osg::Vec4ubArray& colours)
+    {
+        const LandObject* land = getLand(block.mCellX, block.mCellY, cache);
+        const ESM::Land::LandData *heightData = nullptr;
+        const ESM::Land::LandData *normalData = nullptr;
+        const ESM::Land::LandData *colourData = nullptr;
+        if (land)
+        {
+            heightData = land->getData(ESM::Land::DATA_VHGT);
+            normalData = land->getData(ESM::Land::DATA_VNML);
+            colourData = land->getData(ESM::Land::DATA_VCLR);
+        }
 
-                        assert(normal.z() > 0);
+        const size_t count = block.mColEnd > block.mColStart ? (block.mColEnd - block.mColStart + increment - 1) / increment : 0;
+        if (count == 0)
+            return;
+        const int lastCol = block.mColStart + static_cast<int>(count - 1) * increment;
+        assert(block.mVertY + count <= numVerts);
+
+        const bool alteration = useAlteration();
+        const float vertDivisor = float(numVerts - 1);
+        const float chunkSize = size * Constants::CellSizeInUnits;
+        const int colStride = ESM::Land::LAND_SIZE * increment;
+
+        // Every row of the block is written to consecutive vertices, so each attribute is generated
+        // by a branch-free loop over the whole row and the cell border fixups are applied afterwards.
+        size_t vertX = block.mVertX;
+        for (int row = block.mRowStart; row < block.mRowEnd; row += increment, ++vertX)
+        {
+            assert(row >= 0 && row < ESM::Land::LAND_SIZE);
+            assert(vertX < numVerts);
 
-                        (*normals)[static_cast<unsigned int>(vertX*numVerts + vertY)] = normal;
+            const size_t first = vertX * numVerts + block.mVertY;
+            const int srcFirst = block.mColStart * ESM::Land::LAND_SIZE + row;
 
-                        if (colourData)
-                        {
-                            for (int i=0; i<3; ++i)
-                                color[i] = colourData->mColours[srcArrayIndex+i];
-                        }
-                        else
-                        {
-                            color.r() = 255;
-                            color.g() = 255;
-                            color.b() = 255;
-                        }
-                        if (alteration)
-                            adjustColor(col, row, heightData, color); //Does nothing by default, override in OpenMW-CS
+            osg::Vec3f* const position = &positions[first];
+            osg::Vec3f* const normal = &normals[first];
+            osg::Vec4ub* const colour = &colours[first];
 
-                        // Unlike normals, colors mostly connect seamlessly between cells, but not always...
-                        if (col == ESM::Land::LAND_SIZE-1 || row == ESM::Land::LAND_SIZE-1)
-                            fixColour(color, cellX, cellY, col, row, cache);
+            const float x = (vertX / vertDivisor - 0.5f) * chunkSize;
+            if (heightData)
+            {
+                const float* heights = &heightData->mHeights[srcFirst];
+                for (size_t i = 0; i < count; ++i)
+                    position[i] = osg::Vec3f(x, ((block.mVertY + i) / vertDivisor - 0.5f) * chunkSize, heights[i * colStride]);
+            }
+            else
+            {
+                for (size_t i = 0; i < count; ++i)
+                    position[i] = osg::Vec3f(x, ((block.mVertY + i) / vertDivisor - 0.5f) * chunkSize, defaultHeight);
+            }
+            if (alteration)
+            {
+                for (size_t i = 0; i < count; ++i)
+                    position[i].z() += getAlteredHeight(block.mColStart + static_cast<int>(i) * increment, row);
+            }
 
-                        color.a() = 255;
+            if (normalData)
+            {
+                const signed char* src = &normalData->mNormals[srcFirst * 3];
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const signed char* n = src + i * colStride * 3;
+                    normal[i] = osg::Vec3f(n[0], n[1], n[2]);
+                    normal[i].normalize();
+                }
+            }
+            else
+                std::fill(normal, normal + count, osg::Vec3f(0,0,1));
 
-                        (*colours)[static_cast<unsigned int>(vertX*numVerts + vertY)] = color;
+            if (colourData)
+            {
+                const unsigned char* src = &colourData->mColours[srcFirst * 3];
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const unsigned char* c = src + i * colStride * 3;
+                    colour[i] = osg::Vec4ub(c[0], c[1], c[2], 255);
+                }
+            }
+            else
+                std::fill(colour, colour + count, osg::Vec4ub(255,255,255,255));
 
-                        ++vertX;
-                    }
-                    ++vertY;
+            if (alteration)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    adjustColor(block.mColStart + static_cast<int>(i) * increment, row, heightData, colour[i]); //Does nothing by default, override in OpenMW-CS
+                    colour[i].a() = 255;
                 }
-                vertX_ = vertX;
             }
-            vertY_ = vertY;
 
-            assert(vertX_ == numVerts); // Ensure we covered whole area
+            // Normals apparently don't connect seamlessly between cells.
+            // Unlike normals, colors mostly connect seamlessly between cells, but not always...
+            const auto fixBorder = [&] (size_t i, int col)
+            {
+                fixNormal(normal[i], block.mCellX, block.mCellY, col, row, cache);
+                fixColour(colour[i], block.mCellX, block.mCellY, col, row, cache);
+            };
+            if (row == ESM::Land::LAND_SIZE-1)
+            {
+                for (size_t i = 0; i < count; ++i)
+                    fixBorder(i, block.mColStart + static_cast<int>(i) * increment);
+            }
+            else if (lastCol == ESM::Land::LAND_SIZE-1)
+                fixBorder(count - 1, lastCol);
+
+            // some corner normals appear to be complete garbage (z < 0)
+            if (row == 0 || row == ESM::Land::LAND_SIZE-1)
+            {
+                if (block.mColStart == 0)
+                    averageNormal(normal[0], block.mCellX, block.mCellY, 0, row, cache);
+                if (lastCol == ESM::Land::LAND_SIZE-1)
+                    averageNormal(normal[count - 1], block.mCellX, block.mCellY, lastCol, row, cache);
+            }
+
+            for (size_t i = 0; i < count; ++i)
+                assert(normal[i].z() > 0);
         }
-        assert(vertY_ == numVerts);  // Ensure we covered whole area
     }
 
     Storage::UniqueTextureId Storage::getVtexIndexAt(int cellX, int cellY,
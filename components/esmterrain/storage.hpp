@@ -104,6 +104,10 @@ namespace ESMTerrain
 
         int getBlendmapScale(float chunkSize) override;
 
+        /// Set the maximum number of threads, including the calling thread, used by fillVertexBuffers
+        /// for chunks spanning several cells. The other threads are taken from the shared job pool.
+        void setMaxVertexThreads(unsigned int threads) { mMaxVertexThreads = threads; }
+
         float getVertexHeight (const ESM::Land::LandData* data, int x, int y)
         {
             assert(x < ESM::Land::LAND_SIZE);
@@ -114,6 +118,24 @@ namespace ESMTerrain
     private:
         const VFS::Manager* mVFS;
 
+        unsigned int mMaxVertexThreads = 1;
+
+        /// Part of a terrain chunk contained in a single cell
+        struct VertexBlock
+        {
+            int mCellX;
+            int mCellY;
+            int mRowStart;
+            int mRowEnd;
+            int mColStart;
+            int mColEnd;
+            std::size_t mVertX;
+            std::size_t mVertY;
+        };
+
+        void fillVertexBlock(const VertexBlock& block, int increment, float size, std::size_t numVerts, LandCache& cache,
+                             osg::Vec3Array& positions, osg::Vec3Array& normals, osg::Vec4ubArray& colours);
+
         inline void fixNormal (osg::Vec3f& normal, int cellX, int cellY, int col, int row, LandCache& cache);
         inline void fixColour (osg::Vec4ub& colour, int cellX, int cellY, int col, int row, LandCache& cache);
         inline void averageNormal (osg::Vec3f& normal, int cellX, int cellY, int col, int row, LandCache& cache);
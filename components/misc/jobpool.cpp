@@ -0,0 +1,188 @@
+#include "jobpool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace Misc
+{
+    namespace
+    {
+        thread_local const JobPool* sCurrentPool = nullptr;
+        thread_local std::size_t sCurrentQueue = 0;
+    }
+
+    JobPool::JobPool(std::size_t threadCount)
+    {
+        mQueues.reserve(std::max<std::size_t>(1, threadCount));
+        for (std::size_t i = 0; i < std::max<std::size_t>(1, threadCount); ++i)
+            mQueues.push_back(std::make_unique<Queue>());
+        mThreads.reserve(threadCount);
+        for (std::size_t i = 0; i < threadCount; ++i)
+            mThreads.emplace_back([this, i] { run(i); });
+    }
+
+    JobPool::~JobPool()
+    {
+        {
+            const std::lock_guard lock(mMutex);
+            mQuit = true;
+        }
+        mHasJob.notify_all();
+        for (std::thread& thread : mThreads)
+            thread.join();
+    }
+
+    void JobPool::push(Job job)
+    {
+        const std::size_t index = sCurrentPool == this
+            ? sCurrentQueue
+            : mNextQueue.fetch_add(1, std::memory_order_relaxed) % mQueues.size();
+        // Counted first so a worker taking the job right away never sees it go below zero
+        {
+            const std::lock_guard lock(mMutex);
+            ++mPendingJobs;
+        }
+        {
+            Queue& queue = *mQueues[index];
+            const std::lock_guard lock(queue.mMutex);
+            queue.mJobs.push_back(std::move(job));
+        }
+        mHasJob.notify_one();
+    }
+
+    void JobPool::runUntil(const std::function<bool()>& done)
+    {
+        while (!done())
+        {
+            if (tryRunJob(sCurrentPool == this ? sCurrentQueue : 0))
+                continue;
+            std::unique_lock lock(mMutex);
+            mHasJob.wait(lock, [&] { return mPendingJobs > 0 || done(); });
+        }
+    }
+
+    void JobPool::notify()
+    {
+        {
+            const std::lock_guard lock(mMutex);
+        }
+        mHasJob.notify_all();
+    }
+
+    bool JobPool::tryRunJob(std::size_t queueIndex)
+    {
+        const bool own = sCurrentPool == this && sCurrentQueue == queueIndex;
+        Job job;
+        for (std::size_t i = 0; i < mQueues.size() && !job; ++i)
+        {
+            Queue& queue = *mQueues[(queueIndex + i) % mQueues.size()];
+            const std::lock_guard lock(queue.mMutex);
+            if (queue.mJobs.empty())
+                continue;
+            // Own jobs are taken newest first as their data is most likely still in cache, stolen ones oldest first
+            if (i == 0 && own)
+            {
+                job = std::move(queue.mJobs.back());
+                queue.mJobs.pop_back();
+            }
+            else
+            {
+                job = std::move(queue.mJobs.front());
+                queue.mJobs.pop_front();
+            }
+        }
+        if (!job)
+            return false;
+        {
+            const std::lock_guard lock(mMutex);
+            --mPendingJobs;
+        }
+        job();
+        return true;
+    }
+
+    void JobPool::run(std::size_t queueIndex)
+    {
+        sCurrentPool = this;
+        sCurrentQueue = queueIndex;
+        while (true)
+        {
+            if (tryRunJob(queueIndex))
+                continue;
+            std::unique_lock lock(mMutex);
+            mHasJob.wait(lock, [&] { return mQuit || mPendingJobs > 0; });
+            if (mQuit && mPendingJobs == 0)
+                return;
+        }
+    }
+
+    JobPool& getSharedJobPool()
+    {
+        // The thread waiting for a job takes part in the work, so one thread less than the hardware runs is enough
+        static JobPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+        return pool;
+    }
+
+    JobGraph::Id JobGraph::add(JobPool::Job job)
+    {
+        mNodes.emplace_back().mJob = std::move(job);
+        return mNodes.size() - 1;
+    }
+
+    void JobGraph::addDependency(Id job, Id dependency)
+    {
+        assert(job != dependency);
+        mNodes[dependency].mDependents.push_back(job);
+        ++mNodes[job].mDependencies;
+    }
+
+    void JobGraph::start(JobPool& pool)
+    {
+        assert(isDone());
+        mPool = &pool;
+        mError = nullptr;
+        for (Node& node : mNodes)
+            node.mRemainingDependencies.store(node.mDependencies, std::memory_order_relaxed);
+        mRemaining.store(mNodes.size(), std::memory_order_release);
+        for (Id id = 0; id < mNodes.size(); ++id)
+            if (mNodes[id].mDependencies == 0)
+                push(id);
+    }
+
+    void JobGraph::wait()
+    {
+        if (mPool == nullptr)
+            return;
+        mPool->runUntil([this] { return isDone(); });
+        if (mError)
+            std::rethrow_exception(std::exchange(mError, nullptr));
+    }
+
+    void JobGraph::push(Id id)
+    {
+        mPool->push([this, id] { run(id); });
+    }
+
+    void JobGraph::run(Id id)
+    {
+        Node& node = mNodes[id];
+        try
+        {
+            node.mJob();
+        }
+        catch (...)
+        {
+            const std::lock_guard lock(mErrorMutex);
+            if (!mError)
+                mError = std::current_exception();
+        }
+        for (const Id dependent : node.mDependents)
+            if (mNodes[dependent].mRemainingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                push(dependent);
+        // The graph may be destroyed by a waiting thread as soon as the last job is counted
+        JobPool& pool = *mPool;
+        if (mRemaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            pool.notify();
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef OPENMW_COMPONENTS_MISC_JOBPOOL_H
+#define OPENMW_COMPONENTS_MISC_JOBPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Misc
+{
+    /// @brief Pool of threads running jobs from one queue per thread.
+    /// @par Jobs pushed from a worker thread go to the back of its own queue and are taken from there first, jobs pushed
+    /// from other threads are spread over the queues. A thread with an empty queue steals from the front of the others
+    /// before going to sleep. Threads waiting for jobs to finish with runUntil() run queued jobs meanwhile, so a pool
+    /// without threads runs everything in the waiting thread.
+    class JobPool
+    {
+        public:
+            using Job = std::function<void()>;
+
+            /// @param threadCount number of worker threads, may be 0
+            explicit JobPool(std::size_t threadCount);
+            ~JobPool();
+
+            JobPool(const JobPool&) = delete;
+            JobPool& operator=(const JobPool&) = delete;
+
+            std::size_t getThreadCount() const { return mThreads.size(); }
+
+            void push(Job job);
+
+            /// @brief Run queued jobs in the calling thread until done() returns true, sleep when there are none.
+            /// @note Whatever makes done() return true has to call notify() afterwards.
+            void runUntil(const std::function<bool()>& done);
+
+            /// Wake up the threads sleeping in runUntil() to check their condition.
+            void notify();
+
+        private:
+            struct Queue
+            {
+                std::mutex mMutex;
+                std::deque<Job> mJobs;
+            };
+
+            std::vector<std::unique_ptr<Queue>> mQueues;
+            std::vector<std::thread> mThreads;
+            std::atomic<std::size_t> mNextQueue {0};
+            std::size_t mPendingJobs = 0;
+            bool mQuit = false;
+            std::mutex mMutex;
+            std::condition_variable mHasJob;
+
+            bool tryRunJob(std::size_t queueIndex);
+
+            void run(std::size_t queueIndex);
+    };
+
+    /// Pool for work without a pool of its own, like loading and generating data spread over several threads
+    JobPool& getSharedJobPool();
+
+    /// @brief Set of jobs which run only after the jobs they depend on have finished.
+    /// @par Jobs and dependencies are added before start() is called. The graph must not be destroyed or changed until
+    /// wait() returned. The first exception thrown by a job is rethrown by wait(), jobs depending on the failed one
+    /// still run.
+    class JobGraph
+    {
+        public:
+            using Id = std::size_t;
+
+            Id add(JobPool::Job job);
+
+            /// Make job run after dependency is finished.
+            void addDependency(Id job, Id dependency);
+
+            std::size_t getSize() const { return mNodes.size(); }
+
+            void start(JobPool& pool);
+
+            bool isDone() const { return mRemaining.load(std::memory_order_acquire) == 0; }
+
+            /// Run jobs of the pool in the calling thread until every job of the graph is finished.
+            void wait();
+
+        private:
+            struct Node
+            {
+                JobPool::Job mJob;
+                std::vector<Id> mDependents;
+                std::size_t mDependencies = 0;
+                std::atomic<std::size_t> mRemainingDependencies {0};
+            };
+
+            std::deque<Node> mNodes;
+            JobPool* mPool = nullptr;
+            std::atomic<std::size_t> mRemaining {0};
+            std::exception_ptr mError;
+            std::mutex mErrorMutex;
+
+            void push(Id id);
+
+            void run(Id id);
+    };
+}
+
+#endif
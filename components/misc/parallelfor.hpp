@@ -0,0 +1,76 @@
+#ifndef OPENMW_COMPONENTS_MISC_PARALLELFOR_H
+#define OPENMW_COMPONENTS_MISC_PARALLELFOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <utility>
+
+#include "jobpool.hpp"
+
+namespace Misc
+{
+    /// @brief Call function(index) for every index in [0, count) using up to maxThreads threads of pool instead of
+    /// starting new ones.
+    /// @note The calling thread takes part in the work and counts as one of maxThreads. It may run other jobs of the
+    /// pool while waiting for the rest. The first exception thrown by function is rethrown in the calling thread once
+    /// every job is finished.
+    template <class Function>
+    void parallelFor(JobPool& pool, std::size_t count, std::size_t maxThreads, Function&& function)
+    {
+        const std::size_t jobCount = std::min({pool.getThreadCount(), std::max<std::size_t>(1, maxThreads) - 1,
+                                               count > 0 ? count - 1 : 0});
+        if (jobCount == 0)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                function(i);
+            return;
+        }
+
+        std::atomic<std::size_t> next {0};
+        std::atomic<std::size_t> remainingJobs {jobCount};
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        const auto run = [&]
+        {
+            try
+            {
+                for (std::size_t i = next++; i < count; i = next++)
+                    function(i);
+            }
+            catch (...)
+            {
+                next = count;
+                const std::lock_guard lock(errorMutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        };
+
+        for (std::size_t i = 0; i < jobCount; ++i)
+            pool.push([&]
+            {
+                run();
+                if (remainingJobs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    pool.notify();
+            });
+        run();
+        pool.runUntil([&] { return remainingJobs.load(std::memory_order_acquire) == 0; });
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    /// @brief Call function(index) for every index in [0, count) using every thread of pool.
+    template <class Function>
+    void parallelFor(JobPool& pool, std::size_t count, Function&& function)
+    {
+        parallelFor(pool, count, std::numeric_limits<std::size_t>::max(), std::forward<Function>(function));
+    }
+}
+
+#endif
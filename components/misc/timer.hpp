@@ -33,8 +33,8 @@ namespace Misc
             void reset(float timeLeft) { mTimeLeft = timeLeft; }
 
         private:
-            const float mPeriod;
-            const float mDeviation;
+            float mPeriod;
+            float mDeviation;
             float mTimeLeft;
     };
 }
@@ -1,5 +1,6 @@
 #include "particle.hpp"
 
+#include <cmath>
 #include <limits>
 
 #include <osg/Version>
@@ -12,6 +13,89 @@
 #include <components/nif/controlled.hpp>
 #include <components/nif/data.hpp>
 
+namespace
+{
+    constexpr float gravityMagic = 1.6f;
+
+    template <class Function>
+    void forEachAliveParticle(osgParticle::ParticleSystem* ps, Function&& function)
+    {
+        const int count = ps->numParticles();
+        for (int i = 0; i < count; ++i)
+        {
+            osgParticle::Particle& particle = *ps->getParticle(i);
+            if (particle.isAlive())
+                function(particle);
+        }
+    }
+
+    float getGrowFadeSize(const osgParticle::Particle& particle, float defaultSize, float growTime, float fadeTime)
+    {
+        float size = defaultSize;
+        if (particle.getAge() < growTime && growTime != 0.f)
+            size *= particle.getAge() / growTime;
+        if (particle.getLifeTime() - particle.getAge() < fadeTime && fadeTime != 0.f)
+            size *= (particle.getLifeTime() - particle.getAge()) / fadeTime;
+        return size;
+    }
+
+    void bounceOffPlane(osgParticle::Particle& particle, const osg::Plane& plane, float bounceFactor)
+    {
+        const osg::Vec3f normal = plane.getNormal();
+        const float dotproduct = particle.getVelocity() * normal;
+
+        // Same as plane.intersect() with a zero radius sphere at the particle position
+        if (dotproduct > 0 && plane.distance(particle.getPosition()) > 0)
+        {
+            osg::Vec3 reflectedVelocity = particle.getVelocity() - normal * (2 * dotproduct);
+            reflectedVelocity *= bounceFactor;
+            particle.setVelocity(reflectedVelocity);
+        }
+    }
+
+    void bounceOffSphere(osgParticle::Particle& particle, const osg::Vec3f& center, float radius2, float bounceFactor, double dt)
+    {
+        const osg::Vec3f& velocity = particle.getVelocity();
+        osg::Vec3f cent = (particle.getPosition() - center); // vector from sphere center to particle
+
+        bool insideSphere = cent.length2() <= radius2;
+
+        if (insideSphere
+                || (cent * velocity < 0.0f)) // if outside, make sure the particle is flying towards the sphere
+        {
+            // Collision test (finding point of contact) is performed by solving a quadratic equation:
+            // ||vec(cent) + vec(vel)*k|| = R      /^2
+            // k^2 + 2*k*(vec(cent)*vec(vel))/||vec(vel)||^2 + (||vec(cent)||^2 - R^2)/||vec(vel)||^2 = 0
+
+            float b = -(cent * velocity) / velocity.length2();
+
+            osg::Vec3f u = cent + velocity * b;
+
+            if (insideSphere
+                    || (u.length2() < radius2))
+            {
+                float d = (radius2 - u.length2()) / velocity.length2();
+                float k = insideSphere ? (std::sqrt(d) + b) : (b - std::sqrt(d));
+
+                if (k < dt)
+                {
+                    // collision detected; reflect off the tangent plane
+                    osg::Vec3f contact = particle.getPosition() + velocity * k;
+
+                    osg::Vec3 normal = (contact - center);
+                    normal.normalize();
+
+                    float dotproduct = velocity * normal;
+
+                    osg::Vec3 reflectedVelocity = velocity - normal * (2 * dotproduct);
+                    reflectedVelocity *= bounceFactor;
+                    particle.setVelocity(reflectedVelocity);
+                }
+            }
+        }
+    }
+}
+
 namespace NifOsg
 {
 
@@ -153,14 +237,34 @@ void GrowFadeAffector::beginOperate(osgParticle::Program *program)
 
 void GrowFadeAffector::operate(osgParticle::Particle* particle, double /* dt */)
 {
-    float size = mCachedDefaultSize;
-    if (particle->getAge() < mGrowTime && mGrowTime != 0.f)
-        size *= particle->getAge() / mGrowTime;
-    if (particle->getLifeTime() - particle->getAge() < mFadeTime && mFadeTime != 0.f)
-        size *= (particle->getLifeTime() - particle->getAge()) / mFadeTime;
+    const float size = getGrowFadeSize(*particle, mCachedDefaultSize, mGrowTime, mFadeTime);
     particle->setSizeRange(osgParticle::rangef(size, size));
 }
 
+void GrowFadeAffector::operateParticles(osgParticle::ParticleSystem* ps, double /* dt */)
+{
+    if (!isEnabled())
+        return;
+
+    const float defaultSize = mCachedDefaultSize;
+    const float growTime = mGrowTime;
+    const float fadeTime = mFadeTime;
+    if (growTime == 0.f && fadeTime == 0.f)
+    {
+        forEachAliveParticle(ps, [&] (osgParticle::Particle& particle)
+        {
+            particle.setSizeRange(osgParticle::rangef(defaultSize, defaultSize));
+        });
+        return;
+    }
+
+    forEachAliveParticle(ps, [&] (osgParticle::Particle& particle)
+    {
+        const float size = getGrowFadeSize(particle, defaultSize, growTime, fadeTime);
+        particle.setSizeRange(osgParticle::rangef(size, size));
+    });
+}
+
 ParticleColorAffector::ParticleColorAffector(const Nif::NiColorData *clrdata)
     : mData(clrdata->mKeyMap, osg::Vec4f(1,1,1,1))
 {
@@ -189,6 +293,14 @@ void ParticleColorAffector::operate(osgParticle::Particle* particle, double /* d
     particle->setAlphaRange(osgParticle::rangef(alpha, alpha));
 }
 
+void ParticleColorAffector::operateParticles(osgParticle::ParticleSystem* ps, double dt)
+{
+    if (!isEnabled())
+        return;
+
+    forEachAliveParticle(ps, [&] (osgParticle::Particle& particle) { ParticleColorAffector::operate(&particle, dt); });
+}
+
 GravityAffector::GravityAffector(const Nif::NiGravity *gravity)
     : mForce(gravity->mForce)
     , mType(static_cast<ForceType>(gravity->mType))
@@ -229,7 +341,6 @@ void GravityAffector::beginOperate(osgParticle::Program* program)
 
 void GravityAffector::operate(osgParticle::Particle *particle, double dt)
 {
-    const float magic = 1.6f;
     switch (mType)
     {
         case Type_Wind:
@@ -242,7 +353,7 @@ void GravityAffector::operate(osgParticle::Particle *particle, double dt)
                 decayFactor = std::exp(-1.f * mDecay * distance);
             }
 
-            particle->addVelocity(mCachedWorldDirection * mForce * dt * decayFactor * magic);
+            particle->addVelocity(mCachedWorldDirection * mForce * dt * decayFactor * gravityMagic);
 
             break;
         }
@@ -256,7 +367,51 @@ void GravityAffector::operate(osgParticle::Particle *particle, double dt)
 
             diff.normalize();
 
-            particle->addVelocity(diff * mForce * dt * decayFactor * magic);
+            particle->addVelocity(diff * mForce * dt * decayFactor * gravityMagic);
+            break;
+        }
+    }
+}
+
+void GravityAffector::operateParticles(osgParticle::ParticleSystem* ps, double dt)
+{
+    if (!isEnabled())
+        return;
+
+    const float scale = static_cast<float>(mForce * dt * gravityMagic);
+    const osg::Vec3f position = mCachedWorldPosition;
+    const osg::Vec3f direction = mCachedWorldDirection;
+    const float decay = mDecay;
+
+    switch (mType)
+    {
+        case Type_Wind:
+        {
+            if (decay == 0.f)
+            {
+                // Every particle gets the same push
+                const osg::Vec3f velocity = direction * scale;
+                forEachAliveParticle(ps, [&] (osgParticle::Particle& particle) { particle.addVelocity(velocity); });
+                break;
+            }
+
+            const osg::Plane gravityPlane(direction, position);
+            forEachAliveParticle(ps, [&] (osgParticle::Particle& particle)
+            {
+                const float distance = std::abs(gravityPlane.distance(particle.getPosition()));
+                particle.addVelocity(direction * (scale * std::exp(-decay * distance)));
+            });
+            break;
+        }
+        case Type_Point:
+        {
+            forEachAliveParticle(ps, [&] (osgParticle::Particle& particle)
+            {
+                osg::Vec3f diff = position - particle.getPosition();
+                const float length = diff.normalize();
+                const float decayFactor = decay != 0.f ? std::exp(-decay * length) : 1.f;
+                particle.addVelocity(diff * (scale * decayFactor));
+            });
             break;
         }
     }
@@ -416,20 +571,19 @@ void PlanarCollider::beginOperate(osgParticle::Program *program)
         mPlaneInParticleSpace.transform(program->getLocalToWorldMatrix());
 }
 
-void PlanarCollider::operate(osgParticle::Particle *particle, double dt)
+void PlanarCollider::operate(osgParticle::Particle *particle, double /* dt */)
 {
-    float dotproduct = particle->getVelocity() * mPlaneInParticleSpace.getNormal();
+    bounceOffPlane(*particle, mPlaneInParticleSpace, mBounceFactor);
+}
 
-    if (dotproduct > 0)
-    {
-        osg::BoundingSphere bs(particle->getPosition(), 0.f);
-        if (mPlaneInParticleSpace.intersect(bs) == 1)
-        {
-            osg::Vec3 reflectedVelocity = particle->getVelocity() - mPlaneInParticleSpace.getNormal() * (2 * dotproduct);
-            reflectedVelocity *= mBounceFactor;
-            particle->setVelocity(reflectedVelocity);
-        }
-    }
+void PlanarCollider::operateParticles(osgParticle::ParticleSystem* ps, double /* dt */)
+{
+    if (!isEnabled())
+        return;
+
+    const osg::Plane plane = mPlaneInParticleSpace;
+    const float bounceFactor = mBounceFactor;
+    forEachAliveParticle(ps, [&] (osgParticle::Particle& particle) { bounceOffPlane(particle, plane, bounceFactor); });
 }
 
 SphericalCollider::SphericalCollider(const Nif::NiSphericalCollider* collider)
@@ -462,43 +616,21 @@ void SphericalCollider::beginOperate(osgParticle::Program* program)
 
 void SphericalCollider::operate(osgParticle::Particle* particle, double dt)
 {
-    osg::Vec3f cent = (particle->getPosition() - mSphereInParticleSpace.center()); // vector from sphere center to particle
+    bounceOffSphere(*particle, mSphereInParticleSpace.center(), mSphereInParticleSpace.radius2(), mBounceFactor, dt);
+}
 
-    bool insideSphere = cent.length2() <= mSphereInParticleSpace.radius2();
+void SphericalCollider::operateParticles(osgParticle::ParticleSystem* ps, double dt)
+{
+    if (!isEnabled())
+        return;
 
-    if (insideSphere
-            || (cent * particle->getVelocity() < 0.0f)) // if outside, make sure the particle is flying towards the sphere
+    const osg::Vec3f center = mSphereInParticleSpace.center();
+    const float radius2 = mSphereInParticleSpace.radius2();
+    const float bounceFactor = mBounceFactor;
+    forEachAliveParticle(ps, [&] (osgParticle::Particle& particle)
     {
-        // Collision test (finding point of contact) is performed by solving a quadratic equation:
-        // ||vec(cent) + vec(vel)*k|| = R      /^2
-        // k^2 + 2*k*(vec(cent)*vec(vel))/||vec(vel)||^2 + (||vec(cent)||^2 - R^2)/||vec(vel)||^2 = 0
-
-        float b = -(cent * particle->getVelocity()) / particle->getVelocity().length2();
-
-        osg::Vec3f u = cent + particle->getVelocity() * b;
-
-        if (insideSphere
-                || (u.length2() < mSphereInParticleSpace.radius2()))
-        {
-            float d = (mSphereInParticleSpace.radius2() - u.length2()) / particle->getVelocity().length2();
-            float k = insideSphere ? (std::sqrt(d) + b) : (b - std::sqrt(d));
-
-            if (k < dt)
-            {
-                // collision detected; reflect off the tangent plane
-                osg::Vec3f contact = particle->getPosition() + particle->getVelocity() * k;
-
-                osg::Vec3 normal = (contact - mSphereInParticleSpace.center());
-                normal.normalize();
-
-                float dotproduct = particle->getVelocity() * normal;
-
-                osg::Vec3 reflectedVelocity = particle->getVelocity() - normal * (2 * dotproduct);
-                reflectedVelocity *= mBounceFactor;
-                particle->setVelocity(reflectedVelocity);
-            }
-        }
-    }
+        bounceOffSphere(particle, center, radius2, bounceFactor, dt);
+    });
 }
 
 }
@@ -98,6 +98,8 @@ namespace NifOsg
         float mLifetimeRandom;
     };
 
+    // The operators below also override operateParticles() to update all live particles of a system in one loop with
+    // the per-frame state hoisted out of it, instead of one virtual operate() call per particle.
     class PlanarCollider : public osgParticle::Operator
     {
     public:
@@ -109,6 +111,7 @@ namespace NifOsg
 
         void beginOperate(osgParticle::Program* program) override;
         void operate(osgParticle::Particle* particle, double dt) override;
+        void operateParticles(osgParticle::ParticleSystem* ps, double dt) override;
 
     private:
         float mBounceFactor;
@@ -127,6 +130,7 @@ namespace NifOsg
 
         void beginOperate(osgParticle::Program* program) override;
         void operate(osgParticle::Particle* particle, double dt) override;
+        void operateParticles(osgParticle::ParticleSystem* ps, double dt) override;
     private:
         float mBounceFactor;
         osg::BoundingSphere mSphere;
@@ -146,6 +150,7 @@ namespace NifOsg
 
         void beginOperate(osgParticle::Program* program) override;
         void operate(osgParticle::Particle* particle, double dt) override;
+        void operateParticles(osgParticle::ParticleSystem* ps, double dt) override;
 
     private:
         float mGrowTime;
@@ -166,6 +171,7 @@ namespace NifOsg
         META_Object(NifOsg, ParticleColorAffector)
 
         void operate(osgParticle::Particle* particle, double dt) override;
+        void operateParticles(osgParticle::ParticleSystem* ps, double dt) override;
 
     private:
         Vec4Interpolator mData;
@@ -183,6 +189,7 @@ namespace NifOsg
         META_Object(NifOsg, GravityAffector)
 
         void operate(osgParticle::Particle* particle, double dt) override;
+        void operateParticles(osgParticle::ParticleSystem* ps, double dt) override;
         void beginOperate(osgParticle::Program *) override ;
 
     private:
@@ -384,11 +384,17 @@ void StatsHandler::setUpScene(osgViewer::ViewerBase *viewer)
             "",
             "Groundcover Chunk",
             "Object Chunk",
+            "Object Flatten",
+            "Object Merge",
             "Terrain Chunk",
             "Terrain Texture",
             "Land",
             "Composite",
             "",
+            "Occlusion Occluders",
+            "Occlusion Triangles",
+            "Occlusion Culled",
+            "",
             "NavMesh Jobs",
             "NavMesh Waiting",
             "NavMesh Pushed",
@@ -399,6 +405,8 @@ void StatsHandler::setUpScene(osgViewer::ViewerBase *viewer)
             "NavMesh CacheHitRate",
             "",
             "Mechanics Actors",
+            "Mechanics Updated",
+            "Mechanics Starved",
             "Mechanics Objects",
             "",
             "Physics Actors",
@@ -0,0 +1,283 @@
+#include "occlusionbuffer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace SceneUtil
+{
+    namespace
+    {
+        int roundUpToTile(int value)
+        {
+            const int tiles = std::max(1, (value + OcclusionBuffer::sTileSize - 1) / OcclusionBuffer::sTileSize);
+            return tiles * OcclusionBuffer::sTileSize;
+        }
+
+        struct ScreenVertex
+        {
+            float mX;
+            float mY;
+            float mDepth;
+        };
+
+        ScreenVertex toScreen(const osg::Vec4f& clip, int width, int height)
+        {
+            const float invW = 1.f / clip.w();
+            return ScreenVertex {
+                (clip.x() * invW * 0.5f + 0.5f) * width,
+                (clip.y() * invW * 0.5f + 0.5f) * height,
+                invW
+            };
+        }
+
+        bool isOutsideFrustumSide(const osg::Vec4f& v0, const osg::Vec4f& v1, const osg::Vec4f& v2)
+        {
+            return (v0.x() > v0.w() && v1.x() > v1.w() && v2.x() > v2.w())
+                || (v0.x() < -v0.w() && v1.x() < -v1.w() && v2.x() < -v2.w())
+                || (v0.y() > v0.w() && v1.y() > v1.w() && v2.y() > v2.w())
+                || (v0.y() < -v0.w() && v1.y() < -v1.w() && v2.y() < -v2.w());
+        }
+
+        osg::Vec4f intersectNearPlane(const osg::Vec4f& inside, const osg::Vec4f& outside)
+        {
+            const float t = (inside.w() - OcclusionBuffer::sNearW) / (inside.w() - outside.w());
+            return inside + (outside - inside) * t;
+        }
+    }
+
+    OcclusionBuffer::OcclusionBuffer(int width, int height)
+        : mWidth(roundUpToTile(width))
+        , mHeight(roundUpToTile(height))
+        , mTilesX(mWidth / sTileSize)
+        , mTilesY(mHeight / sTileSize)
+        , mDepth(static_cast<std::size_t>(mWidth * mHeight), 0.f)
+        , mTileMinDepth(static_cast<std::size_t>(mTilesX * mTilesY), 0.f)
+    {
+    }
+
+    void OcclusionBuffer::clear(const osg::Matrixf& viewProjection)
+    {
+        mViewProjection = viewProjection;
+        std::fill(mDepth.begin(), mDepth.end(), 0.f);
+        std::fill(mTileMinDepth.begin(), mTileMinDepth.end(), 0.f);
+        mNumDrawnTriangles = 0;
+    }
+
+    void OcclusionBuffer::drawTriangles(const osg::Vec3f* vertices, std::size_t count)
+    {
+        for (std::size_t i = 0; i + 2 < count; i += 3)
+        {
+            const std::array<osg::Vec4f, 3> clip {
+                osg::Vec4f(vertices[i], 1.f) * mViewProjection,
+                osg::Vec4f(vertices[i + 1], 1.f) * mViewProjection,
+                osg::Vec4f(vertices[i + 2], 1.f) * mViewProjection,
+            };
+
+            if (isOutsideFrustumSide(clip[0], clip[1], clip[2]))
+                continue;
+
+            std::array<bool, 3> inside;
+            int numInside = 0;
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                inside[j] = clip[j].w() >= sNearW;
+                numInside += inside[j];
+            }
+
+            if (numInside == 0)
+                continue;
+
+            if (numInside == 3)
+            {
+                drawClippedTriangle(clip[0], clip[1], clip[2]);
+                continue;
+            }
+
+            // Sutherland-Hodgman against the near plane, gives a triangle or a quad
+            std::array<osg::Vec4f, 4> polygon;
+            std::size_t size = 0;
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                const std::size_t next = (j + 1) % 3;
+                if (inside[j])
+                    polygon[size++] = clip[j];
+                if (inside[j] != inside[next])
+                    polygon[size++] = inside[j] ? intersectNearPlane(clip[j], clip[next]) : intersectNearPlane(clip[next], clip[j]);
+            }
+
+            drawClippedTriangle(polygon[0], polygon[1], polygon[2]);
+            if (size == 4)
+                drawClippedTriangle(polygon[0], polygon[2], polygon[3]);
+        }
+    }
+
+    void OcclusionBuffer::drawClippedTriangle(const osg::Vec4f& v0, const osg::Vec4f& v1, const osg::Vec4f& v2)
+    {
+        const ScreenVertex p0 = toScreen(v0, mWidth, mHeight);
+        ScreenVertex p1 = toScreen(v1, mWidth, mHeight);
+        ScreenVertex p2 = toScreen(v2, mWidth, mHeight);
+
+        float area = (p1.mX - p0.mX) * (p2.mY - p0.mY) - (p1.mY - p0.mY) * (p2.mX - p0.mX);
+        if (!(std::abs(area) > 0.f))
+            return;
+        if (area < 0)
+        {
+            std::swap(p1, p2);
+            area = -area;
+        }
+
+        const float minX = std::max(0.f, std::floor(std::min({p0.mX, p1.mX, p2.mX})));
+        const float maxX = std::min(mWidth - 1.f, std::floor(std::max({p0.mX, p1.mX, p2.mX})));
+        const float minY = std::max(0.f, std::floor(std::min({p0.mY, p1.mY, p2.mY})));
+        const float maxY = std::min(mHeight - 1.f, std::floor(std::max({p0.mY, p1.mY, p2.mY})));
+        if (minX > maxX || minY > maxY)
+            return;
+
+        // Edge functions e(x, y) = a * x + b * y + c, positive inside, evaluated at pixel centers
+        struct Edge
+        {
+            float mA;
+            float mB;
+            float mC;
+        };
+
+        const auto makeEdge = [] (const ScreenVertex& from, const ScreenVertex& to)
+        {
+            const float a = from.mY - to.mY;
+            const float b = to.mX - from.mX;
+            const float c = from.mX * to.mY - from.mY * to.mX;
+            return Edge {a, b, c};
+        };
+
+        const std::array<Edge, 3> edges {makeEdge(p1, p2), makeEdge(p2, p0), makeEdge(p0, p1)};
+
+        // Depth is interpolated at the pixel center and lowered by its largest change inside the pixel, so a box
+        // touching the occluder is never rejected
+        const float invArea = 1.f / area;
+        const float dzdx = ((p1.mY - p2.mY) * p0.mDepth + (p2.mY - p0.mY) * p1.mDepth + (p0.mY - p1.mY) * p2.mDepth) * invArea;
+        const float dzdy = ((p2.mX - p1.mX) * p0.mDepth + (p0.mX - p2.mX) * p1.mDepth + (p1.mX - p0.mX) * p2.mDepth) * invArea;
+        const float depthMargin = 0.5f * (std::abs(dzdx) + std::abs(dzdy));
+        const float minDepth = std::min({p0.mDepth, p1.mDepth, p2.mDepth});
+
+        const float nearestDepth = std::max({p0.mDepth, p1.mDepth, p2.mDepth});
+        const int xBegin = static_cast<int>(minX);
+        const int xEnd = static_cast<int>(maxX);
+        const int yBegin = static_cast<int>(minY);
+        const int yEnd = static_cast<int>(maxY);
+        bool drawn = false;
+
+        for (int tileY = yBegin / sTileSize; tileY <= yEnd / sTileSize; ++tileY)
+        {
+            for (int tileX = xBegin / sTileSize; tileX <= xEnd / sTileSize; ++tileX)
+            {
+                // Skip tiles where everything drawn so far is closer than the whole triangle
+                float& tileMinDepth = mTileMinDepth[static_cast<std::size_t>(tileY * mTilesX + tileX)];
+                if (tileMinDepth >= nearestDepth)
+                    continue;
+
+                const int tileXBegin = std::max(xBegin, tileX * sTileSize);
+                const int tileXEnd = std::min(xEnd, (tileX + 1) * sTileSize - 1);
+                const int tileYBegin = std::max(yBegin, tileY * sTileSize);
+                const int tileYEnd = std::min(yEnd, (tileY + 1) * sTileSize - 1);
+                bool tileDrawn = false;
+
+                for (int y = tileYBegin; y <= tileYEnd; ++y)
+                {
+                    const float py = y + 0.5f;
+                    const float px = tileXBegin + 0.5f;
+                    float e0 = edges[0].mA * px + edges[0].mB * py + edges[0].mC;
+                    float e1 = edges[1].mA * px + edges[1].mB * py + edges[1].mC;
+                    float e2 = edges[2].mA * px + edges[2].mB * py + edges[2].mC;
+                    float depth = p0.mDepth + (px - p0.mX) * dzdx + (py - p0.mY) * dzdy;
+                    float* row = mDepth.data() + static_cast<std::size_t>(y * mWidth);
+                    for (int x = tileXBegin; x <= tileXEnd; ++x)
+                    {
+                        const bool inside = e0 >= 0 && e1 >= 0 && e2 >= 0;
+                        const float value = inside ? std::max(minDepth, depth - depthMargin) : 0.f;
+                        row[x] = std::max(row[x], value);
+                        tileDrawn |= inside;
+                        e0 += edges[0].mA;
+                        e1 += edges[1].mA;
+                        e2 += edges[2].mA;
+                        depth += dzdx;
+                    }
+                }
+
+                if (!tileDrawn)
+                    continue;
+
+                drawn = true;
+                float newMinDepth = nearestDepth;
+                for (int y = tileY * sTileSize; y < (tileY + 1) * sTileSize; ++y)
+                {
+                    const float* row = mDepth.data() + static_cast<std::size_t>(y * mWidth + tileX * sTileSize);
+                    newMinDepth = std::min(newMinDepth, *std::min_element(row, row + sTileSize));
+                }
+                tileMinDepth = newMinDepth;
+            }
+        }
+
+        mNumDrawnTriangles += drawn;
+    }
+
+    bool OcclusionBuffer::isOccluded(const osg::BoundingBox& box, const osg::Matrixf& modelViewProjection) const
+    {
+        if (!box.valid())
+            return false;
+
+        float minX = std::numeric_limits<float>::max();
+        float maxX = -std::numeric_limits<float>::max();
+        float minY = std::numeric_limits<float>::max();
+        float maxY = -std::numeric_limits<float>::max();
+        float boxDepth = 0;
+
+        for (unsigned i = 0; i < 8; ++i)
+        {
+            const osg::Vec4f clip = osg::Vec4f(box.corner(i), 1.f) * modelViewProjection;
+            if (clip.w() < sNearW)
+                return false;
+            const ScreenVertex p = toScreen(clip, mWidth, mHeight);
+            minX = std::min(minX, p.mX);
+            maxX = std::max(maxX, p.mX);
+            minY = std::min(minY, p.mY);
+            maxY = std::max(maxY, p.mY);
+            boxDepth = std::max(boxDepth, p.mDepth);
+        }
+
+        // Boxes outside of the buffer are left to frustum culling
+        if (maxX < 0 || maxY < 0 || minX >= mWidth || minY >= mHeight)
+            return false;
+
+        // Occluders cover the pixels whose centers they cover, so such a pixel may still be partially visible at their
+        // silhouette. Requiring one more covered pixel around the box erodes the occluders by a pixel instead.
+        const int xBegin = static_cast<int>(std::max(0.f, std::floor(minX) - 1));
+        const int xEnd = static_cast<int>(std::min(mWidth - 1.f, std::floor(maxX) + 1));
+        const int yBegin = static_cast<int>(std::max(0.f, std::floor(minY) - 1));
+        const int yEnd = static_cast<int>(std::min(mHeight - 1.f, std::floor(maxY) + 1));
+
+        for (int tileY = yBegin / sTileSize; tileY <= yEnd / sTileSize; ++tileY)
+        {
+            for (int tileX = xBegin / sTileSize; tileX <= xEnd / sTileSize; ++tileX)
+            {
+                if (mTileMinDepth[static_cast<std::size_t>(tileY * mTilesX + tileX)] > boxDepth)
+                    continue;
+
+                const int tileXBegin = std::max(xBegin, tileX * sTileSize);
+                const int tileXEnd = std::min(xEnd, (tileX + 1) * sTileSize - 1);
+                const int tileYBegin = std::max(yBegin, tileY * sTileSize);
+                const int tileYEnd = std::min(yEnd, (tileY + 1) * sTileSize - 1);
+                for (int y = tileYBegin; y <= tileYEnd; ++y)
+                {
+                    const float* row = mDepth.data() + static_cast<std::size_t>(y * mWidth);
+                    for (int x = tileXBegin; x <= tileXEnd; ++x)
+                        if (!(row[x] > boxDepth))
+                            return false;
+                }
+            }
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_OCCLUSIONBUFFER_H
+#define OPENMW_COMPONENTS_SCENEUTIL_OCCLUSIONBUFFER_H
+
+#include <osg/BoundingBox>
+#include <osg/Matrixf>
+#include <osg/Vec3f>
+
+#include <cstddef>
+#include <vector>
+
+namespace SceneUtil
+{
+    /// @brief Low resolution depth buffer rasterized on the CPU, used to test bounding boxes against large occluders.
+    /// @par Depth is stored as 1/w of the clip space position, which is linear in screen space and does not depend on
+    /// the depth range or direction of the projection, so regular and reversed depth projections can be used. Larger
+    /// values are closer to the viewer, 0 means that nothing was drawn. Each tile of sTileSize x sTileSize pixels
+    /// additionally keeps the farthest depth drawn into it, so boxes behind fully covered tiles are rejected without
+    /// looking at the pixels and triangles behind them are not rasterized there. Occluders are best drawn from the
+    /// closest to the farthest. Only perspective projections are supported.
+    class OcclusionBuffer
+    {
+    public:
+        static constexpr int sTileSize = 8;
+
+        /// Clip space w of the near plane used for clipping occluders and rejecting boxes crossing it.
+        static constexpr float sNearW = 1.f;
+
+        /// @param width, height are rounded up to a multiple of sTileSize
+        OcclusionBuffer(int width, int height);
+
+        int getWidth() const { return mWidth; }
+
+        int getHeight() const { return mHeight; }
+
+        /// Empty the buffer and set the transformation of occluders from world to clip space.
+        void clear(const osg::Matrixf& viewProjection);
+
+        /// Rasterize occluder triangles, three consecutive world space vertices each. Both faces are drawn.
+        void drawTriangles(const osg::Vec3f* vertices, std::size_t count);
+
+
+        /// @param modelViewProjection transforms the box to clip space
+        /// @return true if the box and the pixels around it are hidden behind the drawn occluders
+        bool isOccluded(const osg::BoundingBox& box, const osg::Matrixf& modelViewProjection) const;
+
+        float getDepth(int x, int y) const { return mDepth[static_cast<std::size_t>(y * mWidth + x)]; }
+
+        /// @return number of triangles covering at least one pixel since clear(), after clipping to the near plane
+        std::size_t getNumDrawnTriangles() const { return mNumDrawnTriangles; }
+
+    private:
+        int mWidth;
+        int mHeight;
+        int mTilesX;
+        int mTilesY;
+        osg::Matrixf mViewProjection;
+        std::vector<float> mDepth;
+        std::vector<float> mTileMinDepth;
+        std::size_t mNumDrawnTriangles = 0;
+
+        void drawClippedTriangle(const osg::Vec4f& v0, const osg::Vec4f& v1, const osg::Vec4f& v2);
+    };
+}
+
+#endif
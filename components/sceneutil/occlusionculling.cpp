@@ -0,0 +1,165 @@
+#include "occlusionculling.hpp"
+
+#include <osg/Camera>
+#include <osg/Stats>
+#include <osgUtil/CullVisitor>
+
+#include <algorithm>
+#include <utility>
+
+namespace SceneUtil
+{
+    namespace
+    {
+        float getDistance(const osg::BoundingBox& box, const osg::Vec3f& point)
+        {
+            osg::Vec3f closest;
+            for (int i = 0; i < 3; ++i)
+                closest[i] = std::clamp(point[i], box._min[i], box._max[i]);
+            return (closest - point).length();
+        }
+
+        /// Cull callbacks of a transform are called with the transform already applied to the model view matrix,
+        /// while its own bounds are in the parent's space
+        osg::BoundingBox getCullCallbackBounds(const osg::Node& node)
+        {
+            osg::BoundingBox box;
+            if (node.asTransform() == nullptr)
+            {
+                box.expandBy(node.getBound());
+                return box;
+            }
+            const osg::Group& group = *node.asGroup();
+            for (unsigned int i = 0; i < group.getNumChildren(); ++i)
+                box.expandBy(group.getChild(i)->getBound());
+            return box;
+        }
+    }
+
+    thread_local OcclusionCuller::ActiveTraversal OcclusionCuller::sActiveTraversal;
+
+    OcclusionCuller::OcclusionCuller(int width, int height, float maxDistance, std::size_t triangleBudget)
+        : mWidth(width)
+        , mHeight(height)
+        , mMaxDistance(maxDistance)
+        , mTriangleBudget(triangleBudget)
+    {
+    }
+
+    void OcclusionCuller::setCamera(const osg::Camera* camera)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mCamera = camera;
+    }
+
+    void OcclusionCuller::addOccluder(const void* id, osg::ref_ptr<const OccluderMesh> mesh)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mOccluders[id] = std::move(mesh);
+    }
+
+    void OcclusionCuller::removeOccluder(const void* id)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mOccluders.erase(id);
+    }
+
+    bool OcclusionCuller::beginTraversal(osgUtil::CullVisitor& cv)
+    {
+        const osg::Vec3f eye = cv.getEyePoint();
+
+        std::vector<std::pair<float, osg::ref_ptr<const OccluderMesh>>> occluders;
+        Traversal* traversal = nullptr;
+        const osg::Camera* camera = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mCamera == nullptr || cv.getCurrentCamera() != mCamera)
+                return false;
+            camera = mCamera;
+
+            std::unique_ptr<Traversal>& found = mTraversals[&cv];
+            if (found == nullptr)
+                found = std::make_unique<Traversal>(mWidth, mHeight);
+            traversal = found.get();
+
+            for (const auto& [id, mesh] : mOccluders)
+            {
+                const float distance = getDistance(mesh->mBounds, eye);
+                if (distance <= mMaxDistance)
+                    occluders.emplace_back(distance, mesh);
+            }
+        }
+
+        std::sort(occluders.begin(), occluders.end(),
+                  [] (const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+        traversal->mBuffer.clear(osg::Matrixf((*cv.getModelViewMatrix()) * (*cv.getProjectionMatrix())));
+        std::size_t numTriangles = 0;
+        for (const auto& [distance, mesh] : occluders)
+        {
+            const std::size_t meshTriangles = mesh->mVertices.size() / 3;
+            if (numTriangles + meshTriangles > mTriangleBudget)
+                continue;
+            if (cv.isCulled(mesh->mBounds))
+                continue;
+            traversal->mBuffer.drawTriangles(mesh->mVertices.data(), mesh->mVertices.size());
+            numTriangles += meshTriangles;
+        }
+        traversal->mNumOccluded = 0;
+        sActiveTraversal = ActiveTraversal {this, &cv, camera, traversal};
+        return true;
+    }
+
+    void OcclusionCuller::endTraversal(osgUtil::CullVisitor& cv)
+    {
+        sActiveTraversal = ActiveTraversal {};
+        std::lock_guard<std::mutex> lock(mMutex);
+        const auto it = mTraversals.find(&cv);
+        if (it == mTraversals.end())
+            return;
+        Traversal& traversal = *it->second;
+        mLastNumTriangles = traversal.mBuffer.getNumDrawnTriangles();
+        mLastNumOccluded = traversal.mNumOccluded;
+    }
+
+    bool OcclusionCuller::isOccluded(osgUtil::CullVisitor& cv, const osg::Node& node)
+    {
+        const ActiveTraversal& active = sActiveTraversal;
+        if (active.mCuller != this || active.mVisitor != &cv || cv.getCurrentCamera() != active.mCamera)
+            return false;
+
+        const osg::BoundingBox box = getCullCallbackBounds(node);
+        if (!box.valid())
+            return false;
+
+        const osg::Matrixf modelViewProjection((*cv.getModelViewMatrix()) * (*cv.getProjectionMatrix()));
+        if (!active.mTraversal->mBuffer.isOccluded(box, modelViewProjection))
+            return false;
+
+        ++active.mTraversal->mNumOccluded;
+        return true;
+    }
+
+    void OcclusionCuller::reportStats(unsigned int frameNumber, osg::Stats* stats) const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        stats->setAttribute(frameNumber, "Occlusion Occluders", mOccluders.size());
+        stats->setAttribute(frameNumber, "Occlusion Triangles", mLastNumTriangles);
+        stats->setAttribute(frameNumber, "Occlusion Culled", mLastNumOccluded);
+    }
+
+    void OcclusionBuildCallback::operator()(osg::Node* node, osgUtil::CullVisitor* cv)
+    {
+        const bool active = mCuller->beginTraversal(*cv);
+        traverse(node, cv);
+        if (active)
+            mCuller->endTraversal(*cv);
+    }
+
+    void OcclusionTestCallback::operator()(osg::Node* node, osgUtil::CullVisitor* cv)
+    {
+        if (mCuller->isOccluded(*cv, *node))
+            return;
+        traverse(node, cv);
+    }
+}
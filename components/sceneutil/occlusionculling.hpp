@@ -0,0 +1,129 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_OCCLUSIONCULLING_H
+#define OPENMW_COMPONENTS_SCENEUTIL_OCCLUSIONCULLING_H
+
+#include <osg/BoundingBox>
+#include <osg/Referenced>
+#include <osg/ref_ptr>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "nodecallback.hpp"
+#include "occlusionbuffer.hpp"
+
+namespace osg
+{
+    class Camera;
+    class Stats;
+}
+
+namespace osgUtil
+{
+    class CullVisitor;
+}
+
+namespace SceneUtil
+{
+    /// World space triangles of an occluder, three vertices each.
+    struct OccluderMesh : public osg::Referenced
+    {
+        std::vector<osg::Vec3f> mVertices;
+        osg::BoundingBox mBounds;
+    };
+
+    /// @brief Rejects scene nodes hidden behind large occluders using an OcclusionBuffer.
+    /// @par Once per cull traversal of the main camera, OcclusionBuildCallback draws the occluders closest to the
+    /// viewer into a buffer owned by the traversing CullVisitor, then nodes with an OcclusionTestCallback are skipped
+    /// by that traversal when their bounds are hidden. Traversals of other cameras, like shadow and reflection
+    /// cameras, are not affected.
+    /// @note Occluders are never tested against themselves, so they must lie within the visible geometry they stand for.
+    class OcclusionCuller : public osg::Referenced
+    {
+    public:
+        /// @param width, height size of the occlusion buffer
+        /// @param maxDistance occluders further than this from the viewer are not drawn
+        /// @param triangleBudget maximum number of occluder triangles drawn per traversal
+        OcclusionCuller(int width, int height, float maxDistance, std::size_t triangleBudget);
+
+        /// Only traversals of this camera are culled.
+        void setCamera(const osg::Camera* camera);
+
+        void addOccluder(const void* id, osg::ref_ptr<const OccluderMesh> mesh);
+
+        void removeOccluder(const void* id);
+
+        /// @return true if the occlusion buffer was drawn and endTraversal() needs to be called
+        bool beginTraversal(osgUtil::CullVisitor& cv);
+
+        void endTraversal(osgUtil::CullVisitor& cv);
+
+        /// Called from a cull callback of the node, so the bounds of a transform's children are tested.
+        /// @return true if the node's bounds are hidden in the traversal of the visitor
+        bool isOccluded(osgUtil::CullVisitor& cv, const osg::Node& node);
+
+        void reportStats(unsigned int frameNumber, osg::Stats* stats) const;
+
+    private:
+        struct Traversal
+        {
+            OcclusionBuffer mBuffer;
+            std::size_t mNumOccluded = 0;
+
+            Traversal(int width, int height) : mBuffer(width, height) {}
+        };
+
+        /// Set for the thread running a traversal between beginTraversal() and endTraversal(), so testing a node
+        /// does not need to lock or look up the traversal
+        struct ActiveTraversal
+        {
+            const OcclusionCuller* mCuller = nullptr;
+            const osgUtil::CullVisitor* mVisitor = nullptr;
+            const osg::Camera* mCamera = nullptr;
+            Traversal* mTraversal = nullptr;
+        };
+
+        static thread_local ActiveTraversal sActiveTraversal;
+
+        const int mWidth;
+        const int mHeight;
+        const float mMaxDistance;
+        const std::size_t mTriangleBudget;
+        const osg::Camera* mCamera = nullptr;
+
+        mutable std::mutex mMutex;
+        std::unordered_map<const void*, osg::ref_ptr<const OccluderMesh>> mOccluders;
+        std::map<const osgUtil::CullVisitor*, std::unique_ptr<Traversal>> mTraversals;
+        std::size_t mLastNumTriangles = 0;
+        std::size_t mLastNumOccluded = 0;
+    };
+
+    /// Cull callback drawing the occlusion buffer, for the root node of the culled scene.
+    class OcclusionBuildCallback : public SceneUtil::NodeCallback<OcclusionBuildCallback, osg::Node*, osgUtil::CullVisitor*>
+    {
+    public:
+        explicit OcclusionBuildCallback(osg::ref_ptr<OcclusionCuller> culler) : mCuller(std::move(culler)) {}
+
+        void operator()(osg::Node* node, osgUtil::CullVisitor* cv);
+
+    private:
+        osg::ref_ptr<OcclusionCuller> mCuller;
+    };
+
+    /// Cull callback skipping the traversal of a node hidden behind occluders.
+    class OcclusionTestCallback : public SceneUtil::NodeCallback<OcclusionTestCallback, osg::Node*, osgUtil::CullVisitor*>
+    {
+    public:
+        explicit OcclusionTestCallback(osg::ref_ptr<OcclusionCuller> culler) : mCuller(std::move(culler)) {}
+
+        void operator()(osg::Node* node, osgUtil::CullVisitor* cv);
+
+    private:
+        osg::ref_ptr<OcclusionCuller> mCuller;
+    };
+}
+
+#endif
@@ -38,10 +38,12 @@
 
 #include <typeinfo>
 #include <algorithm>
+#include <cmath>
 #include <numeric>
 
 #include <iterator>
 
+#include <components/misc/parallelfor.hpp>
 #include <components/sceneutil/depth.hpp>
 
 using namespace osgUtil;
@@ -57,6 +59,9 @@ void Optimizer::optimize(osg::Node* node, unsigned int options)
 {
     StatsVisitor stats;
 
+    _timings = Timings();
+    osg::Timer_t startTick = osg::Timer::instance()->tick();
+
     if (osg::getNotifyLevel()>=osg::INFO)
     {
         node->accept(stats);
@@ -84,6 +89,10 @@ void Optimizer::optimize(osg::Node* node, unsigned int options)
         CombineStaticTransformsVisitor cstv(this);
         node->accept(cstv);
         cstv.removeTransforms(node);
+
+        osg::Timer_t endTick = osg::Timer::instance()->tick();
+        _timings._flattenStaticTransforms = osg::Timer::instance()->delta_s(startTick, endTick);
+        startTick = endTick;
     }
 
     if (options & SHARE_DUPLICATE_STATE && _sharedStateManager)
@@ -107,23 +116,29 @@ void Optimizer::optimize(osg::Node* node, unsigned int options)
 
         MergeGroupsVisitor mgrp(this);
         node->accept(mgrp);
+
+        osg::Timer_t endTick = osg::Timer::instance()->tick();
+        _timings._removeRedundantNodes = osg::Timer::instance()->delta_s(startTick, endTick);
+        startTick = endTick;
     }
 
     if (options & MERGE_GEOMETRY)
     {
         OSG_INFO<<"Optimizer::optimize() doing MERGE_GEOMETRY"<<std::endl;
 
-        osg::Timer_t startTick = osg::Timer::instance()->tick();
+        startTick = osg::Timer::instance()->tick();
 
         MergeGeometryVisitor mgv(this);
         mgv.setTargetMaximumNumberOfVertices(1000000);
         mgv.setMergeAlphaBlending(_mergeAlphaBlending);
         mgv.setViewPoint(_viewPoint);
+        mgv.setJobPool(_jobPool);
         node->accept(mgv);
 
         osg::Timer_t endTick = osg::Timer::instance()->tick();
+        _timings._mergeGeometry = osg::Timer::instance()->delta_s(startTick, endTick);
 
-        OSG_INFO<<"MERGE_GEOMETRY took "<<osg::Timer::instance()->delta_s(startTick,endTick)<<std::endl;
+        OSG_INFO<<"MERGE_GEOMETRY took "<<_timings._mergeGeometry<<std::endl;
     }
 
     if (options & VERTEX_POSTTRANSFORM)
@@ -372,6 +387,55 @@ class CollectLowestTransformsVisitor : public BaseOptimizerVisitor
 };
 
 
+bool isAffine(const osg::Matrix& matrix)
+{
+    return matrix(0,3) == 0.0 && matrix(1,3) == 0.0 && matrix(2,3) == 0.0 && matrix(3,3) == 1.0;
+}
+
+/// Transform float vertices and normals in tight loops over the raw arrays, so that the compiler can vectorize them.
+/// Equivalent to osgUtil::TransformAttributeFunctor for affine matrices.
+bool transformVec3Arrays(osg::Geometry& geom, const osg::Matrix& matrix, const osg::Matrix& inverse)
+{
+    osg::Vec3Array* vertices = dynamic_cast<osg::Vec3Array*>(geom.getVertexArray());
+    osg::Array* normalArray = geom.getNormalArray();
+    osg::Vec3Array* normals = dynamic_cast<osg::Vec3Array*>(normalArray);
+    if (!vertices || (normalArray && !normals) || !isAffine(matrix))
+        return false;
+
+    const osg::Matrixf m(matrix);
+    const std::size_t numVertices = vertices->size();
+    float* v = numVertices ? (*vertices)[0].ptr() : nullptr;
+    for (std::size_t i = 0; i < numVertices; ++i, v += 3)
+    {
+        const float x = v[0], y = v[1], z = v[2];
+        v[0] = x * m(0,0) + y * m(1,0) + z * m(2,0) + m(3,0);
+        v[1] = x * m(0,1) + y * m(1,1) + z * m(2,1) + m(3,1);
+        v[2] = x * m(0,2) + y * m(1,2) + z * m(2,2) + m(3,2);
+    }
+    vertices->dirty();
+
+    if (normals)
+    {
+        const osg::Matrixf im(inverse);
+        const std::size_t numNormals = normals->size();
+        float* n = numNormals ? (*normals)[0].ptr() : nullptr;
+        for (std::size_t i = 0; i < numNormals; ++i, n += 3)
+        {
+            const float x = n[0], y = n[1], z = n[2];
+            const float nx = im(0,0) * x + im(0,1) * y + im(0,2) * z;
+            const float ny = im(1,0) * x + im(1,1) * y + im(1,2) * z;
+            const float nz = im(2,0) * x + im(2,1) * y + im(2,2) * z;
+            const float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+            const float scale = length > 0.f ? 1.f / length : 1.f;
+            n[0] = nx * scale;
+            n[1] = ny * scale;
+            n[2] = nz * scale;
+        }
+        normals->dirty();
+    }
+    return true;
+}
+
 void CollectLowestTransformsVisitor::doTransform(osg::Object* obj,osg::Matrix& matrix)
 {
     osg::Node* node = obj->asNode();
@@ -381,7 +445,9 @@ void CollectLowestTransformsVisitor::doTransform(osg::Object* obj,osg::Matrix& m
     if (drawable)
     {
         osgUtil::TransformAttributeFunctor tf(matrix);
-        drawable->accept(tf);
+        osg::Geometry* geometry = drawable->asGeometry();
+        if (!geometry || !transformVec3Arrays(*geometry, matrix, tf._im))
+            drawable->accept(tf);
 
         osg::Geometry *geom = drawable->asGeometry();
         osg::Vec4Array* tangents = geom ? dynamic_cast<osg::Vec4Array*>(geom->getTexCoordArray(7)) : nullptr;
@@ -1206,6 +1272,34 @@ bool containsSharedPrimitives(const osg::Geometry* geom)
     return false;
 }
 
+/// Make the per vertex arrays of a merge target unique and large enough to hold numVertices,
+/// so that appending the merged geometries does not reallocate them repeatedly.
+void reserveArrays(osg::Geometry& geom, unsigned int numVertices)
+{
+    osg::VertexBufferObject* vbo = nullptr;
+    const auto reserve = [&] (osg::Array* array, auto&& setArray)
+    {
+        if (!array || array->getBinding() == osg::Array::BIND_OVERALL)
+            return;
+        if (array->referenceCount() > 1)
+        {
+            array = cloneArray(array, vbo, &geom);
+            setArray(array);
+        }
+        array->reserveArray(numVertices);
+    };
+
+    reserve(geom.getVertexArray(), [&] (osg::Array* array) { geom.setVertexArray(array); });
+    reserve(geom.getNormalArray(), [&] (osg::Array* array) { geom.setNormalArray(array); });
+    reserve(geom.getColorArray(), [&] (osg::Array* array) { geom.setColorArray(array); });
+    reserve(geom.getSecondaryColorArray(), [&] (osg::Array* array) { geom.setSecondaryColorArray(array); });
+    reserve(geom.getFogCoordArray(), [&] (osg::Array* array) { geom.setFogCoordArray(array); });
+    for (unsigned int unit = 0; unit < geom.getNumTexCoordArrays(); ++unit)
+        reserve(geom.getTexCoordArray(unit), [&] (osg::Array* array) { geom.setTexCoordArray(unit, array); });
+    for (unsigned int unit = 0; unit < geom.getNumVertexAttribArrays(); ++unit)
+        reserve(geom.getVertexAttribArray(unit), [&] (osg::Array* array) { geom.setVertexAttribArray(unit, array); });
+}
+
 bool Optimizer::MergeGeometryVisitor::mergeGroup(osg::Group& group)
 {
     if (!isOperationPermissibleForObject(&group)) return false;
@@ -1356,29 +1450,41 @@ bool Optimizer::MergeGeometryVisitor::mergeGroup(osg::Group& group)
             }
 
             // now do the merging of geometries
-            for(MergeList::iterator mitr = mergeList.begin();
-                mitr != mergeList.end();
-                ++mitr)
+            if (_alphaBlendingActive)
+            {
+                LessGeometryViewPoint lgvp;
+                lgvp._viewPoint = _viewPoint;
+                for (DuplicateList& duplicateList : mergeList)
+                    std::sort(duplicateList.begin(), duplicateList.end(), lgvp);
+            }
+
+            for (const DuplicateList& duplicateList : mergeList)
             {
-                DuplicateList& duplicateList = *mitr;
                 if (!duplicateList.empty())
-                {
-                    if (_alphaBlendingActive)
-                    {
-                        LessGeometryViewPoint lgvp;
-                        lgvp._viewPoint = _viewPoint;
-                        std::sort(duplicateList.begin(), duplicateList.end(), lgvp);
-                    }
-                    DuplicateList::iterator ditr = duplicateList.begin();
-                    osg::ref_ptr<osg::Geometry> lhs = *ditr++;
-                    group.addChild(lhs.get());
-                    for(;
-                        ditr != duplicateList.end();
-                        ++ditr)
-                    {
-                        mergeGeometry(*lhs, **ditr);
-                    }
-                }
+                    group.addChild(duplicateList.front().get());
+            }
+
+            // each list has its own target geometry, so lists can be merged concurrently
+            const auto mergeDuplicateList = [&] (std::size_t index)
+            {
+                const DuplicateList& duplicateList = mergeList[index];
+                if (duplicateList.size() < 2)
+                    return;
+                osg::Geometry& lhs = *duplicateList.front();
+                unsigned int totalNumberVertices = 0;
+                for (const osg::ref_ptr<osg::Geometry>& geometry : duplicateList)
+                    totalNumberVertices += geometry->getVertexArray() ? geometry->getVertexArray()->getNumElements() : 0;
+                reserveArrays(lhs, totalNumberVertices);
+                for (auto ditr = duplicateList.begin() + 1; ditr != duplicateList.end(); ++ditr)
+                    mergeGeometry(lhs, **ditr);
+            };
+
+            if (_jobPool != nullptr)
+                Misc::parallelFor(*_jobPool, mergeList.size(), mergeDuplicateList);
+            else
+            {
+                for (std::size_t i = 0; i < mergeList.size(); ++i)
+                    mergeDuplicateList(i);
             }
         }
 
@@ -32,6 +32,11 @@ namespace osgDB
     class SharedStateManager;
 }
 
+namespace Misc
+{
+    class JobPool;
+}
+
 //namespace osgUtil {
 namespace SceneUtil {
 
@@ -71,7 +76,7 @@ class Optimizer
 
     public:
 
-        Optimizer() : _mergeAlphaBlending(false), _sharedStateManager(nullptr), _sharedStateMutex(nullptr) {}
+        Optimizer() : _mergeAlphaBlending(false), _sharedStateManager(nullptr), _sharedStateMutex(nullptr), _jobPool(nullptr) {}
         virtual ~Optimizer() {}
 
         enum OptimizationOptions
@@ -129,6 +134,19 @@ class Optimizer
 
         void setSharedStateManager(osgDB::SharedStateManager* sharedStateManager, std::mutex* sharedStateMutex) { _sharedStateMutex = sharedStateMutex; _sharedStateManager = sharedStateManager; }
 
+        /** Set the pool whose threads help the calling thread to merge independent lists of geometries, nullptr to merge them in the calling thread only.*/
+        void setJobPool(Misc::JobPool* jobPool) { _jobPool = jobPool; }
+
+        /** Time spent in each pass during the last call to optimize(), in seconds.*/
+        struct Timings
+        {
+            double _flattenStaticTransforms = 0;
+            double _removeRedundantNodes = 0;
+            double _mergeGeometry = 0;
+        };
+
+        const Timings& getTimings() const { return _timings; }
+
         /** Reset internal data to initial state - the getPermissibleOptionsMap is cleared.*/
         void reset();
 
@@ -269,6 +287,9 @@ class Optimizer
         osgDB::SharedStateManager* _sharedStateManager;
         mutable std::mutex* _sharedStateMutex;
 
+        Misc::JobPool* _jobPool;
+        Timings _timings;
+
     public:
 
         /** Flatten Static Transform nodes by applying their transform to the
@@ -394,7 +415,7 @@ class Optimizer
                 /// default to traversing all children.
                 MergeGeometryVisitor(Optimizer* optimizer=0) :
                     BaseOptimizerVisitor(optimizer, MERGE_GEOMETRY),
-                    _targetMaximumNumberOfVertices(10000), _alphaBlendingActive(false), _mergeAlphaBlending(false) {}
+                    _targetMaximumNumberOfVertices(10000), _alphaBlendingActive(false), _mergeAlphaBlending(false), _jobPool(nullptr) {}
 
                 void setMergeAlphaBlending(bool merge)
                 {
@@ -405,6 +426,11 @@ class Optimizer
                     _viewPoint = viewPoint;
                 }
 
+                void setJobPool(Misc::JobPool* jobPool)
+                {
+                    _jobPool = jobPool;
+                }
+
                 void setTargetMaximumNumberOfVertices(unsigned int num)
                 {
                     _targetMaximumNumberOfVertices = num;
@@ -439,6 +465,7 @@ class Optimizer
                 bool _alphaBlendingActive;
                 bool _mergeAlphaBlending;
                 osg::Vec3f _viewPoint;
+                Misc::JobPool* _jobPool;
         };
 
 };
@@ -2,6 +2,11 @@
 
 #include <osg/MatrixTransform>
 
+#include <osgUtil/CullVisitor>
+
+#include <algorithm>
+#include <atomic>
+
 #include <components/debug/debuglog.hpp>
 #include <components/misc/stringops.hpp>
 
@@ -31,12 +36,28 @@ private:
     std::unordered_map<std::string, TransformPath>& mCache;
 };
 
+namespace
+{
+    unsigned int nextUpdatePhase()
+    {
+        // Skeletons are also created by preloading and other worker threads
+        static std::atomic<unsigned int> counter {0};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
 Skeleton::Skeleton()
     : mBoneCacheInit(false)
     , mNeedToUpdateBoneMatrices(true)
     , mActive(Active)
     , mLastFrameNumber(0)
     , mLastCullFrameNumber(0)
+    , mUpdateInterval(1)
+    , mUpdatePhase(nextUpdatePhase())
+    , mMinPixelSize(0.f)
+    , mMaxPixelSize(0.f)
+    , mTooSmall(false)
+    , mUpdateSkipped(false)
 {
 
 }
@@ -48,6 +69,12 @@ Skeleton::Skeleton(const Skeleton &copy, const osg::CopyOp &copyop)
     , mActive(copy.mActive)
     , mLastFrameNumber(0)
     , mLastCullFrameNumber(0)
+    , mUpdateInterval(copy.mUpdateInterval)
+    , mUpdatePhase(nextUpdatePhase())
+    , mMinPixelSize(copy.mMinPixelSize)
+    , mMaxPixelSize(0.f)
+    , mTooSmall(false)
+    , mUpdateSkipped(false)
 {
 
 }
@@ -125,7 +152,33 @@ void Skeleton::setActive(ActiveType active)
 
 bool Skeleton::getActive() const
 {
-    return mActive != Inactive;
+    return mActive != Inactive && !mUpdateSkipped;
+}
+
+void Skeleton::setUpdateInterval(unsigned int interval)
+{
+    mUpdateInterval = std::max(1u, interval);
+}
+
+void Skeleton::setMinPixelSize(float pixelSize)
+{
+    mMinPixelSize = pixelSize;
+    if (mMinPixelSize <= 0.f)
+        mTooSmall = false;
+}
+
+bool Skeleton::shouldSkipUpdate(unsigned int traversalNumber) const
+{
+    // Always update at least once so that child rigs have a valid pose
+    if (mLastFrameNumber == 0)
+        return false;
+    if (mActive == Inactive)
+        return true;
+    if (mActive == SemiActive && mLastCullFrameNumber+3 <= traversalNumber)
+        return true;
+    if (mTooSmall)
+        return true;
+    return mUpdateInterval > 1 && (traversalNumber + mUpdatePhase) % mUpdateInterval != 0;
 }
 
 void Skeleton::markDirty()
@@ -139,13 +192,26 @@ void Skeleton::traverse(osg::NodeVisitor& nv)
 {
     if (nv.getVisitorType() == osg::NodeVisitor::UPDATE_VISITOR)
     {
-        if (mActive == Inactive && mLastFrameNumber != 0)
-            return;
-        if (mActive == SemiActive && mLastFrameNumber != 0 && mLastCullFrameNumber+3 <= nv.getTraversalNumber())
+        mUpdateSkipped = shouldSkipUpdate(nv.getTraversalNumber());
+        if (mUpdateSkipped)
             return;
     }
     else if (nv.getVisitorType() == osg::NodeVisitor::CULL_VISITOR)
+    {
+        if (mMinPixelSize > 0.f)
+        {
+            // The skeleton may be culled by several cameras (shadows, reflections) in one frame,
+            // so use the largest projected size seen during the previous frame.
+            if (mLastCullFrameNumber != nv.getTraversalNumber())
+            {
+                mTooSmall = mMaxPixelSize < mMinPixelSize;
+                mMaxPixelSize = 0.f;
+            }
+            osgUtil::CullVisitor* cv = static_cast<osgUtil::CullVisitor*>(&nv);
+            mMaxPixelSize = std::max(mMaxPixelSize, cv->clampedPixelSize(getBound()));
+        }
         mLastCullFrameNumber = nv.getTraversalNumber();
+    }
 
     osg::Group::traverse(nv);
 }
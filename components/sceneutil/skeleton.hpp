@@ -61,6 +61,14 @@ namespace SceneUtil
 
         bool getActive() const;
 
+        /// Only run the update traversal (keyframe controllers, bone matrices and skinning) every \a interval frames.
+        /// Skeletons using the same interval are staggered over different frames.
+        void setUpdateInterval(unsigned int interval);
+
+        /// Freeze the skeleton in its current pose while its projected size on screen is below \a pixelSize.
+        /// A value of 0 disables this.
+        void setMinPixelSize(float pixelSize);
+
         void traverse(osg::NodeVisitor& nv) override;
 
         void markDirty();
@@ -83,6 +91,15 @@ namespace SceneUtil
 
         unsigned int mLastFrameNumber;
         unsigned int mLastCullFrameNumber;
+
+        unsigned int mUpdateInterval;
+        unsigned int mUpdatePhase;
+        float mMinPixelSize;
+        float mMaxPixelSize;
+        bool mTooSmall;
+        bool mUpdateSkipped;
+
+        bool shouldSkipUpdate(unsigned int traversalNumber) const;
     };
 
 }
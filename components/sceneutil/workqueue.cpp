@@ -105,6 +105,11 @@ unsigned int WorkQueue::getNumItems() const
     return mQueue.size();
 }
 
+unsigned int WorkQueue::getNumThreads() const
+{
+    return static_cast<unsigned int>(mThreads.size());
+}
+
 unsigned int WorkQueue::getNumActiveThreads() const
 {
     return std::accumulate(mThreads.begin(), mThreads.end(), 0u,
@@ -63,6 +63,8 @@ namespace SceneUtil
 
         unsigned int getNumItems() const;
 
+        unsigned int getNumThreads() const;
+
         unsigned int getNumActiveThreads() const;
 
     private: